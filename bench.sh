@@ -0,0 +1,3 @@
+#!/bin/zsh
+
+cd build && ./RayTracerBench --benchmark_color=true
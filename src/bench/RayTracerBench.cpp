@@ -0,0 +1,538 @@
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../graphics/BoundingBox.h"
+#include "../graphics/BoundingVolumeHierarchy.h"
+#include "../graphics/BvhTree.h"
+#include "../graphics/Camera.h"
+#include "../graphics/Color.h"
+#include "../graphics/Geometry.h"
+#include "../graphics/GeometryList.h"
+#include "../graphics/InstanceHierarchy.h"
+#include "../graphics/PathIntegrator.h"
+#include "../graphics/RandomScene.h"
+#include "../graphics/Ray.h"
+#include "../graphics/Sphere.h"
+#include "../graphics/TileRenderer.h"
+#include "../graphics/WavefrontIntegrator.h"
+#include "../graphics/WideBvhTree.h"
+#include "../graphics/materials/Dielectric.h"
+#include "../graphics/materials/Lambertian.h"
+#include "../graphics/materials/MaterialTable.h"
+#include "../graphics/materials/Metal.h"
+#include "../math/Exponentials.h"
+#include "../math/General.h"
+#include "../math/Point3.h"
+#include "../math/Random.h"
+#include "../math/Transform.h"
+#include "../math/TrigFuncs.h"
+#include "../math/Vec3.h"
+#include "../utils/ConcurrentRingBuffer.h"
+#include "../utils/RingBuffer.h"
+#include "../utils/StaticRingBuffer.h"
+
+namespace bench {
+	using graphics::BoundingBox;
+	using graphics::BoundingVolumeHierarchy;
+	using graphics::BvhBuildMethod;
+	using graphics::BvhTree;
+	using graphics::Camera;
+	using graphics::Color;
+	using graphics::Dielectric;
+	using graphics::GeometryList;
+	using graphics::HitRecord;
+	using graphics::InstanceHierarchy;
+	using graphics::Lambertian;
+	using graphics::MaterialTable;
+	using graphics::Metal;
+	using graphics::PathIntegrator;
+	using graphics::Ray;
+	using graphics::Sphere;
+	using graphics::SurfaceRecord;
+	using graphics::TileRenderer;
+	using graphics::WavefrontIntegrator;
+	using graphics::WideBvhTree;
+	using math::Exponentials;
+	using math::General;
+	using math::Trig;
+	using math::Transform;
+	using utils::ConcurrencyMode;
+	using utils::ConcurrentRingBuffer;
+	using utils::RingBuffer;
+	using utils::StaticRingBuffer;
+
+	/// Seed for every benchmark drawing random values, so runs are comparable
+	static constexpr size_t SEED = 42ULL;
+	/// Number of inputs cycled through by the math and intersection benchmarks
+	static constexpr size_t NUM_INPUTS = 1024;
+
+	/// @brief Generates `NUM_INPUTS` random values in [min, max)
+	inline static auto random_inputs(float min, float max) noexcept -> std::vector<float> {
+		math::seed_random(SEED);
+		auto inputs = std::vector<float>(NUM_INPUTS);
+		for(auto& input : inputs) {
+			input = random_value(min, max);
+		}
+		return inputs;
+	}
+
+	/// @brief Generates `NUM_INPUTS` random rays, originating around the scene and pointed in
+	/// random directions
+	inline static auto random_rays() noexcept -> std::vector<Ray<float>> {
+		math::seed_random(SEED);
+		auto rays = std::vector<Ray<float>>();
+		rays.reserve(NUM_INPUTS);
+		for(auto i = 0U; i < NUM_INPUTS; ++i) {
+			rays.emplace_back(Point3<float>(Vec3<float>::random(-12.0F, 12.0F)),
+							  Vec3<float>::random(-1.0F, 1.0F));
+		}
+		return rays;
+	}
+
+	/// @brief Generates the bounds of `count` small boxes scattered at random, like the
+	/// triangles of a large mesh
+	inline static auto random_bounds(size_t count) noexcept -> std::vector<BoundingBox<float>> {
+		math::seed_random(SEED);
+		auto bounds = std::vector<BoundingBox<float>>();
+		bounds.reserve(count);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto center = Point3<float>(Vec3<float>::random(-100.0F, 100.0F));
+			const auto half_size = Vec3<float>::random(0.01F, 0.5F);
+			bounds.emplace_back(center - half_size, center + half_size);
+		}
+		return bounds;
+	}
+
+	/// @brief Builds the scene rendered by `RayTracer`, with a fixed seed
+	inline static auto
+	random_scene(MaterialTable<float>& materials) noexcept -> GeometryList<float> {
+		math::seed_random(SEED);
+		return graphics::random_scene(materials);
+	}
+
+	/// @brief Builds a grid of `rows` x `rows` instances of the scene rendered by `RayTracer`,
+	/// shrunk to fit in the same space as the original
+	inline static auto instanced_scene(MaterialTable<float>& materials, size_t rows) noexcept
+		-> InstanceHierarchy<float> {
+		const auto object = std::make_shared<const BoundingVolumeHierarchy<float>>(
+			random_scene(materials));
+		const auto spacing = 24.0F / narrow_cast<float>(rows);
+		const auto size = 1.0F / narrow_cast<float>(rows);
+		const auto scale = Transform<float>::scaling(Vec3(size, size, size));
+		auto hierarchy = InstanceHierarchy<float>();
+		for(auto row = 0ULL; row < rows; ++row) {
+			for(auto column = 0ULL; column < rows; ++column) {
+				const auto offset = Vec3(spacing * narrow_cast<float>(column) - 12.0F,
+										 0.0F,
+										 spacing * narrow_cast<float>(row) - 12.0F);
+				ignore(hierarchy.add(object, Transform<float>::translation(offset) * scale));
+			}
+		}
+		hierarchy.rebuild();
+		return hierarchy;
+	}
+
+	/// @brief Returns the camera `RayTracer` renders with, for an image with a 16:9 aspect ratio
+	inline static auto scene_camera() noexcept -> Camera<float> {
+		constexpr auto origin = Point3(13.0F, 2.0F, 3.0F);
+		constexpr auto focal_point = Point3(0.0F, 0.0F, 0.0F);
+		return {16.0F / 9.0F,
+				60.0F,
+				2.0F,
+				(origin - focal_point).as_vec().magnitude(),
+				0.1F,
+				origin,
+				focal_point,
+				Vec3(0.0F, 1.0F, 0.0F)};
+	}
+
+	/// @brief Runs `func` on each of `inputs` in turn, for every iteration of `state`
+	template<typename Input, typename Func>
+	inline static auto
+	run_over(benchmark::State& state, const std::vector<Input>& inputs, Func&& func) noexcept
+		-> void {
+		auto index = 0ULL;
+		for(auto _ : state) {
+			benchmark::DoNotOptimize(func(inputs[index]));
+			index = (index + 1) % inputs.size();
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	/// @brief Runs `func` on all of `inputs` at once, for every iteration of `state`
+	template<typename Func>
+	inline static auto
+	run_batch(benchmark::State& state, const std::vector<float>& inputs, Func&& func) noexcept
+		-> void {
+		auto outputs = std::vector<float>(inputs.size());
+		for(auto _ : state) {
+			func(std::span<const float>(inputs), std::span<float>(outputs));
+			benchmark::DoNotOptimize(outputs.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * narrow_cast<int64_t>(inputs.size()));
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Math
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	inline static auto general_sqrt(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(0.0F, 1000.0F), [](float x) { return General::sqrt(x); });
+	}
+	BENCHMARK(general_sqrt);
+
+	inline static auto trig_sin(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(-10.0F, 10.0F), [](float x) { return Trig::sin(x); });
+	}
+	BENCHMARK(trig_sin);
+
+	inline static auto trig_cos(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(-10.0F, 10.0F), [](float x) { return Trig::cos(x); });
+	}
+	BENCHMARK(trig_cos);
+
+	inline static auto trig_tan(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(-1.5F, 1.5F), [](float x) { return Trig::tan(x); });
+	}
+	BENCHMARK(trig_tan);
+
+	inline static auto trig_atan(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(-10.0F, 10.0F), [](float x) { return Trig::atan(x); });
+	}
+	BENCHMARK(trig_atan);
+
+	inline static auto trig_tanh(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(-5.0F, 5.0F), [](float x) { return Trig::tanh(x); });
+	}
+	BENCHMARK(trig_tanh);
+
+	inline static auto exponentials_pow(benchmark::State& state) noexcept -> void {
+		run_over(state, random_inputs(0.0F, 10.0F), [](float x) {
+			return Exponentials::pow(x, 2.2F);
+		});
+	}
+	BENCHMARK(exponentials_pow);
+
+	inline static auto general_sqrt_batch(benchmark::State& state) noexcept -> void {
+		run_batch(state, random_inputs(0.0F, 1000.0F), [](auto in, auto out) {
+			General::sqrt(in, out);
+		});
+	}
+	BENCHMARK(general_sqrt_batch);
+
+	inline static auto trig_sin_batch(benchmark::State& state) noexcept -> void {
+		run_batch(state, random_inputs(-10.0F, 10.0F), [](auto in, auto out) {
+			Trig::sin(in, out);
+		});
+	}
+	BENCHMARK(trig_sin_batch);
+
+	inline static auto trig_tan_batch(benchmark::State& state) noexcept -> void {
+		run_batch(state, random_inputs(-1.5F, 1.5F), [](auto in, auto out) {
+			Trig::tan(in, out);
+		});
+	}
+	BENCHMARK(trig_tan_batch);
+
+	inline static auto trig_atan_batch(benchmark::State& state) noexcept -> void {
+		run_batch(state, random_inputs(-10.0F, 10.0F), [](auto in, auto out) {
+			Trig::atan(in, out);
+		});
+	}
+	BENCHMARK(trig_atan_batch);
+
+	inline static auto exponentials_pow_batch(benchmark::State& state) noexcept -> void {
+		run_batch(state, random_inputs(0.0F, 10.0F), [](auto in, auto out) {
+			Exponentials::pow(in, 2.2F, out);
+		});
+	}
+	BENCHMARK(exponentials_pow_batch);
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Geometry
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	inline static auto sphere_intersected(benchmark::State& state) noexcept -> void {
+		const auto sphere = Sphere<float>(Point3(0.0F, 0.0F, 0.0F), 4.0F, 0U);
+		run_over(state, random_rays(), [&sphere](const Ray<float>& ray) {
+			auto record = HitRecord<float>();
+			return sphere.intersected(ray, 0.001F, Constants<float>::infinity, &record);
+		});
+	}
+	BENCHMARK(sphere_intersected);
+
+	inline static auto geometry_list_intersected(benchmark::State& state) noexcept -> void {
+		auto materials = MaterialTable<float>();
+		const auto scene = random_scene(materials);
+		run_over(state, random_rays(), [&scene](const Ray<float>& ray) {
+			auto record = HitRecord<float>();
+			return scene.intersected(ray, 0.001F, Constants<float>::infinity, &record);
+		});
+	}
+	BENCHMARK(geometry_list_intersected);
+
+	inline static auto bvh_intersected(benchmark::State& state) noexcept -> void {
+		auto materials = MaterialTable<float>();
+		const auto scene = BoundingVolumeHierarchy<float>(random_scene(materials));
+		run_over(state, random_rays(), [&scene](const Ray<float>& ray) {
+			auto record = HitRecord<float>();
+			return scene.intersected(ray, 0.001F, Constants<float>::infinity, &record);
+		});
+	}
+	BENCHMARK(bvh_intersected);
+
+	inline static auto instance_hierarchy_intersected(benchmark::State& state) noexcept -> void {
+		auto materials = MaterialTable<float>();
+		const auto scene = instanced_scene(materials, 8ULL);
+		run_over(state, random_rays(), [&scene](const Ray<float>& ray) {
+			auto record = HitRecord<float>();
+			return scene.intersected(ray, 0.001F, Constants<float>::infinity, &record);
+		});
+	}
+	BENCHMARK(instance_hierarchy_intersected);
+
+	inline static auto instance_hierarchy_rebuild(benchmark::State& state) noexcept -> void {
+		auto materials = MaterialTable<float>();
+		auto scene = instanced_scene(materials, 32ULL);
+		for(auto _ : state) {
+			scene.rebuild();
+			benchmark::DoNotOptimize(scene.nodes().data());
+		}
+		state.SetItemsProcessed(state.iterations() * narrow_cast<int64_t>(scene.size()));
+	}
+	BENCHMARK(instance_hierarchy_rebuild);
+
+	/// @brief Builds a `BvhTree` over `state.range(0)` primitives with `Method`, on as many
+	/// threads as the machine has. Measured in wall-clock time, as the build is multithreaded
+	template<BvhBuildMethod Method>
+	inline static auto bvh_build(benchmark::State& state) noexcept -> void {
+		const auto bounds = random_bounds(narrow_cast<size_t>(state.range(0)));
+		auto order = std::vector<uint32_t>();
+		for(auto _ : state) {
+			const auto tree = BvhTree<float>(bounds, &order, {Method, 0ULL});
+			benchmark::DoNotOptimize(tree.nodes().data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK_TEMPLATE(bvh_build, BvhBuildMethod::Sweep)
+		->Arg(1 << 17)
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(bvh_build, BvhBuildMethod::Binned)
+		->Arg(1 << 17)
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(bvh_build, BvhBuildMethod::Linear)
+		->Arg(1 << 17)
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+
+	/// @brief Traces rays through a `Tree` (a `BvhTree` or `WideBvhTree`) over `state.range(0)`
+	/// boxes, hitting the boxes themselves, to measure traversal alone
+	template<typename Tree>
+	inline static auto bvh_traversal(benchmark::State& state) noexcept -> void {
+		const auto bounds = random_bounds(narrow_cast<size_t>(state.range(0)));
+		auto order = std::vector<uint32_t>();
+		const auto tree = Tree(bounds, &order);
+		run_over(state, random_rays(), [&](const Ray<float>& ray) {
+			const auto& direction = ray.direction();
+			const auto inverse_direction
+				= Vec3<float>(1.0F / direction.x(), 1.0F / direction.y(), 1.0F / direction.z());
+			auto record = HitRecord<float>();
+			return tree.intersected(
+				ray,
+				0.001F,
+				Constants<float>::infinity,
+				&record,
+				[&](uint32_t index, float closest) noexcept {
+					const auto& box = bounds[order[index]];
+					const auto length = (box.centroid() - ray.origin()).as_vec().dot_prod(direction)
+										/ direction.dot_prod(direction);
+					if(length <= 0.001F || length >= closest
+					   || !box.intersected(ray, inverse_direction, 0.001F, closest))
+					{
+						return false;
+					}
+					record.m_length = length;
+					return true;
+				});
+		});
+		state.counters["node_bytes"] = static_cast<double>(tree.nodes().size_bytes());
+	}
+	BENCHMARK_TEMPLATE(bvh_traversal, BvhTree<float>)->Arg(1 << 17);
+	BENCHMARK_TEMPLATE(bvh_traversal, WideBvhTree<float, false>)->Arg(1 << 17);
+	BENCHMARK_TEMPLATE(bvh_traversal, WideBvhTree<float>)->Arg(1 << 17);
+
+	inline static auto camera_get_ray(benchmark::State& state) noexcept -> void {
+		const auto camera = scene_camera();
+		const auto inputs = random_inputs(0.0F, 1.0F);
+		auto index = 0ULL;
+		for(auto _ : state) {
+			benchmark::DoNotOptimize(
+				camera.get_ray(inputs[index], inputs[(index + 1) % inputs.size()]));
+			index = (index + 1) % inputs.size();
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(camera_get_ray);
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Materials
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Scatters rays off of a unit sphere at the origin with `material`
+	template<typename Material>
+	inline static auto material_scatter(benchmark::State& state, const Material& material) noexcept
+		-> void {
+		math::seed_random(SEED);
+		auto surfaces = std::vector<std::pair<Ray<float>, SurfaceRecord<float>>>();
+		surfaces.reserve(NUM_INPUTS);
+		for(auto i = 0U; i < NUM_INPUTS; ++i) {
+			const auto normal = Vec3<float>::random_unit_vector();
+			const auto outer = random_value<float>() < 0.5F;
+			auto record = SurfaceRecord<float>(Point3<float>(normal), outer ? normal : -normal);
+			record.m_hit_outer_face = outer;
+			// rays come from the side of the surface the record faces
+			const auto direction = -record.m_normal + Vec3<float>::random(-0.5F, 0.5F);
+			surfaces.emplace_back(Ray<float>(record.m_point - direction, direction), record);
+		}
+
+		run_over(state, surfaces, [&material](const auto& surface) {
+			auto attenuation = Color<float>();
+			auto scattered = Ray<float>();
+			const auto did_scatter
+				= material.scatter(surface.first, surface.second, &attenuation, &scattered);
+			benchmark::DoNotOptimize(attenuation);
+			benchmark::DoNotOptimize(scattered);
+			return did_scatter;
+		});
+	}
+
+	inline static auto lambertian_scatter(benchmark::State& state) noexcept -> void {
+		material_scatter(state, Lambertian(Color(0.5F, 0.5F, 0.5F)));
+	}
+	BENCHMARK(lambertian_scatter);
+
+	inline static auto metal_scatter(benchmark::State& state) noexcept -> void {
+		material_scatter(state, Metal(Color(0.7F, 0.6F, 0.5F), 0.25F));
+	}
+	BENCHMARK(metal_scatter);
+
+	inline static auto dielectric_scatter(benchmark::State& state) noexcept -> void {
+		material_scatter(state, Dielectric(1.5F));
+	}
+	BENCHMARK(dielectric_scatter);
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Utilities
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	inline static auto ring_buffer_push_pop(benchmark::State& state) noexcept -> void {
+		auto buffer = RingBuffer<size_t>(NUM_INPUTS);
+		auto value = 0ULL;
+		for(auto _ : state) {
+			buffer.push_back(value++);
+			if(buffer.size() == NUM_INPUTS / 2) {
+				benchmark::DoNotOptimize(buffer.pop_back());
+			}
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(ring_buffer_push_pop);
+
+	inline static auto static_ring_buffer_push_pop(benchmark::State& state) noexcept -> void {
+		auto buffer = StaticRingBuffer<size_t, NUM_INPUTS>();
+		auto value = 0ULL;
+		for(auto _ : state) {
+			buffer.push_back(value++);
+			if(buffer.size() == NUM_INPUTS / 2) {
+				benchmark::DoNotOptimize(buffer.pop_back());
+			}
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(static_ring_buffer_push_pop);
+
+	/// @brief Streams values from a producer thread to the benchmark thread, in bulk
+	template<ConcurrencyMode Mode>
+	inline static auto concurrent_ring_buffer_stream(benchmark::State& state) noexcept -> void {
+		auto buffer = ConcurrentRingBuffer<size_t, Mode>(NUM_INPUTS);
+		auto done = std::atomic<bool>(false);
+		auto producer = std::thread([&buffer, &done]() {
+			auto values = std::vector<size_t>(NUM_INPUTS / 4, 1ULL);
+			while(!done.load(std::memory_order_relaxed)) {
+				if(buffer.push(values) == 0) {
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		auto values = std::vector<size_t>(NUM_INPUTS / 4);
+		auto popped = 0LL;
+		for(auto _ : state) {
+			auto count = buffer.pop(values);
+			benchmark::DoNotOptimize(values.data());
+			popped += static_cast<int64_t>(count);
+		}
+		done.store(true, std::memory_order_relaxed);
+		producer.join();
+		state.SetItemsProcessed(popped);
+	}
+	BENCHMARK_TEMPLATE(concurrent_ring_buffer_stream, ConcurrencyMode::SingleProducerSingleConsumer)
+		->UseRealTime();
+	BENCHMARK_TEMPLATE(concurrent_ring_buffer_stream, ConcurrencyMode::MultiProducerMultiConsumer)
+		->UseRealTime();
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	// Renders
+	//////////////////////////////////////////////////////////////////////////////////////////
+
+	/// @brief Renders the scene `RayTracer` renders at the width given by `state.range(0)`, a
+	/// 16:9 aspect ratio, and `state.range(1)` samples per pixel, on one worker thread so the
+	/// results don't depend on the machine's core count. Rendering happens on the worker, so
+	/// these are measured in wall-clock time
+	template<bool Wavefront>
+	inline static auto render_scene(benchmark::State& state) noexcept -> void {
+		constexpr auto max_depth = 50ULL;
+		const auto width = narrow_cast<size_t>(state.range(0));
+		const auto height = width * 9 / 16;
+		const auto samples_per_pixel = narrow_cast<size_t>(state.range(1));
+
+		auto materials = MaterialTable<float>();
+		const auto scene = BoundingVolumeHierarchy<float>(random_scene(materials));
+		const auto camera = scene_camera();
+		const auto renderer = TileRenderer<float>(width, height, samples_per_pixel, 1);
+
+		for(auto _ : state) {
+			if constexpr(Wavefront) {
+				benchmark::DoNotOptimize(
+					renderer.render(camera,
+									WavefrontIntegrator<float>(scene, materials, max_depth)));
+			}
+			else {
+				benchmark::DoNotOptimize(
+					renderer.render(camera, PathIntegrator<float>(scene, materials, max_depth)));
+			}
+		}
+		state.SetItemsProcessed(state.iterations()
+								* narrow_cast<int64_t>(width * height * samples_per_pixel));
+	}
+	BENCHMARK_TEMPLATE(render_scene, false)
+		->Args({160, 4})
+		->Args({400, 4})
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+	BENCHMARK_TEMPLATE(render_scene, true)
+		->Args({160, 4})
+		->Args({400, 4})
+		->UseRealTime()
+		->Unit(benchmark::kMillisecond);
+} // namespace bench
+
+BENCHMARK_MAIN();
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../math/Sampler.h"
+#include "../utils/FileReplace.h"
+#include "Color.h"
+#include "Framebuffer.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+	using std::uint64_t;
+#endif
+
+	/// @brief The running sums of the samples of every pixel of a progressive render, along with
+	/// everything needed to continue the render from where it left off.
+	///
+	/// A progressive render (see `TileRenderer::render_pass`) takes its samples in passes over the
+	/// whole image, each adding `Settings::m_samples_per_pass` samples to every pixel. The random
+	/// numbers of a pass depend only on the renderer's seed and the index of the pass, so an
+	/// `AccumulationBuffer` saved as a checkpoint after any pass and loaded again continues the
+	/// render with bit-identical results, as if it had never stopped.
+	///
+	/// Checkpoints store data in the native byte order and layout of the build that wrote them,
+	/// and are rejected when loaded by a build with a different one.
+	///
+	/// @tparam T - The floating point type of the accumulated `Color`s
+	template<FloatingPoint T = float>
+	class AccumulationBuffer {
+	  public:
+		using Color = Color<T>;
+		using Framebuffer = Framebuffer<T>;
+
+		/// The version of the checkpoint format written, and the only one read
+		static constexpr uint32_t VERSION = 2;
+		/// The identifier at the start of every checkpoint file
+		static constexpr std::array<char, 8> MAGIC = {'H', 'Y', 'P', 'A', 'C', 'C', 'U', 'M'};
+
+		/// @brief The settings of the render being accumulated. A checkpoint can only be resumed
+		/// by a renderer with the same settings
+		struct Settings {
+			uint64_t m_width = 0;
+			uint64_t m_height = 0;
+			/// The width and height of the renderer's tiles, which select its random streams
+			uint64_t m_tile_size = 0;
+			uint64_t m_seed = 0;
+			uint64_t m_samples_per_pass = 0;
+			/// The sampler the pixel and lens positions of samples are drawn from
+			math::SamplerDescription m_sampler = math::SamplerDescription();
+
+			auto operator==(const Settings& settings) const noexcept -> bool = default;
+		};
+
+		AccumulationBuffer() noexcept = default;
+
+		/// @brief Creates an empty `AccumulationBuffer` for a render with the given settings
+		///
+		/// @param settings - The settings of the render
+		explicit AccumulationBuffer(const Settings& settings) noexcept
+			: m_settings(settings),
+			  m_sums(narrow_cast<size_t>(settings.m_width * settings.m_height),
+					 Color(narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0))) {
+		}
+		AccumulationBuffer(const AccumulationBuffer& buffer) noexcept = default;
+		AccumulationBuffer(AccumulationBuffer&& buffer) noexcept = default;
+		~AccumulationBuffer() noexcept = default;
+
+		/// @brief Returns the settings of the render being accumulated
+		///
+		/// @return The settings
+		[[nodiscard]] inline auto settings() const noexcept -> const Settings& {
+			return m_settings;
+		}
+
+		/// @brief Returns the number of passes accumulated so far
+		///
+		/// @return The number of passes
+		[[nodiscard]] inline auto num_passes() const noexcept -> size_t {
+			return narrow_cast<size_t>(m_num_passes);
+		}
+
+		/// @brief Returns the number of samples accumulated so far, per pixel
+		///
+		/// @return The number of samples
+		[[nodiscard]] inline auto num_samples() const noexcept -> size_t {
+			return narrow_cast<size_t>(m_num_samples);
+		}
+
+		/// @brief Returns the sums of every pixel's samples, row-major, with rows stored
+		/// top-to-bottom
+		///
+		/// @return The sums
+		[[nodiscard]] inline auto sums() const noexcept -> std::span<const Color> {
+			return m_sums;
+		}
+
+		/// @brief Returns the sums of every pixel's samples, row-major, with rows stored
+		/// top-to-bottom
+		///
+		/// @return The sums
+		[[nodiscard]] inline auto sums() noexcept -> std::span<Color> {
+			return m_sums;
+		}
+
+		/// @brief Records that a pass of `num_samples` samples per pixel has been added to the
+		/// sums
+		///
+		/// @param num_samples - The number of samples per pixel taken in the pass
+		inline auto complete_pass(size_t num_samples) noexcept -> void {
+			++m_num_passes;
+			m_num_samples += num_samples;
+		}
+
+		/// @brief Returns the image accumulated so far, with each pixel the average of its
+		/// samples. Black if no samples have been taken
+		///
+		/// @return The image
+		[[nodiscard]] inline auto preview() const noexcept -> Framebuffer {
+			const auto width = narrow_cast<size_t>(m_settings.m_width);
+			auto framebuffer = Framebuffer(width, narrow_cast<size_t>(m_settings.m_height));
+			if(m_num_samples == 0) {
+				return framebuffer;
+			}
+
+			const auto scale = narrow_cast<T>(1) / narrow_cast<T>(m_num_samples);
+			for(auto index = 0ULL; index < m_sums.size(); ++index) {
+				framebuffer.at(index % width, index / width) = m_sums[index] * scale;
+			}
+			return framebuffer;
+		}
+
+		/// @brief Saves the `AccumulationBuffer` as a checkpoint to the file at `path`.
+		/// The checkpoint is written to a temporary file, flushed to storage, and then atomically
+		/// moved over `path`, so `path` always holds a complete checkpoint, previous or new, even
+		/// if the process is killed or the machine loses power part way through
+		///
+		/// @param path - The path of the checkpoint file
+		///
+		/// @return Whether the checkpoint was saved successfully
+		[[nodiscard]] inline auto save(const std::string& path) const noexcept -> bool {
+			const auto temporary = path + ".tmp";
+			{
+				auto file = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+				if(!file) {
+					return false;
+				}
+
+				auto header = Header();
+				header.m_settings = m_settings;
+				header.m_num_passes = m_num_passes;
+				header.m_num_samples = m_num_samples;
+				write_bytes(file, std::as_bytes(std::span<const Header>(&header, 1)));
+				write_bytes(file, std::as_bytes(std::span<const Color>(m_sums)));
+				file.flush();
+				if(!file) {
+					ignore(std::remove(temporary.c_str()));
+					return false;
+				}
+			}
+
+			if(!utils::sync_file(temporary) || !utils::replace_file(temporary, path)) {
+				ignore(std::remove(temporary.c_str()));
+				return false;
+			}
+			return true;
+		}
+
+		/// @brief Loads the checkpoint in the file at `path`
+		///
+		/// @param path - The path of the checkpoint file
+		///
+		/// @return The `AccumulationBuffer`, or `std::nullopt` if the file couldn't be read or
+		/// isn't a checkpoint of this version and layout
+		[[nodiscard]] inline static auto
+		load(const std::string& path) noexcept -> std::optional<AccumulationBuffer> {
+			auto file = std::ifstream(path, std::ios::binary);
+			if(!file) {
+				return std::nullopt;
+			}
+
+			auto header = Header();
+			if(!read_bytes(file, std::as_writable_bytes(std::span<Header>(&header, 1)))
+			   || header.m_magic != MAGIC || header.m_version != VERSION
+			   || header.m_layout != Layout()
+			   || header.m_settings.m_width > MAX_DIMENSION
+			   || header.m_settings.m_height > MAX_DIMENSION)
+			{
+				return std::nullopt;
+			}
+
+			auto buffer = AccumulationBuffer(header.m_settings);
+			buffer.m_num_passes = header.m_num_passes;
+			buffer.m_num_samples = header.m_num_samples;
+			// the file must hold exactly the sums, and nothing more
+			if(!read_bytes(file, std::as_writable_bytes(std::span<Color>(buffer.m_sums)))
+			   || file.peek() != std::ifstream::traits_type::eof())
+			{
+				return std::nullopt;
+			}
+			return buffer;
+		}
+
+		auto operator=(const AccumulationBuffer& buffer) noexcept -> AccumulationBuffer& = default;
+		auto operator=(AccumulationBuffer&& buffer) noexcept -> AccumulationBuffer& = default;
+
+	  private:
+		/// Upper bound on the width and height accepted from a checkpoint, so a corrupt header
+		/// can't trigger an enormous allocation
+		static constexpr uint64_t MAX_DIMENSION = 1ULL << 20U;
+
+		/// @brief The sizes of the types in the file, which must match those of the reading build
+		struct Layout {
+			uint32_t m_float_size = sizeof(T);
+			uint32_t m_color_size = sizeof(Color);
+
+			auto operator==(const Layout& layout) const noexcept -> bool = default;
+		};
+
+		/// @brief The header at the start of the file, followed by the sums
+		struct Header {
+			std::array<char, 8> m_magic = MAGIC;
+			uint32_t m_version = VERSION;
+			Layout m_layout = Layout();
+			/// Aligns the settings explicitly, so no uninitialized padding is written to the file
+			uint32_t m_reserved = 0;
+			Settings m_settings = Settings();
+			uint64_t m_num_passes = 0;
+			uint64_t m_num_samples = 0;
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<Color>,
+					  "Checkpoint records must be trivially copyable");
+
+		Settings m_settings = Settings();
+		uint64_t m_num_passes = 0;
+		uint64_t m_num_samples = 0;
+		std::vector<Color> m_sums = {};
+
+		inline static auto
+		write_bytes(std::ofstream& file, std::span<const std::byte> bytes) noexcept -> void {
+			file.write(reinterpret_cast<const char*>(bytes.data()), // NOLINT
+					   narrow_cast<std::streamsize>(bytes.size()));
+		}
+
+		[[nodiscard]] inline static auto
+		read_bytes(std::ifstream& file, std::span<std::byte> bytes) noexcept -> bool {
+			file.read(reinterpret_cast<char*>(bytes.data()), // NOLINT
+					  narrow_cast<std::streamsize>(bytes.size()));
+			return file.good();
+		}
+	};
+} // namespace graphics
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <limits>
+
+#include "../base/StandardIncludes.h"
+#include "Ray.h"
+
+namespace graphics {
+
+	/// @brief An axis-aligned bounding box.
+	/// A default constructed `BoundingBox` is empty: it contains no points, and merging it with
+	/// any other box results in that other box
+	///
+	/// @tparam T - The floating point type of the box's coordinates
+	template<FloatingPoint T = float>
+	class BoundingBox {
+	  public:
+		using Point3 = Point3<T>;
+		using Vec3 = Vec3<T>;
+		using Ray = Ray<T>;
+
+		/// The relative error bound of the three rounded operations computing each slab distance
+		/// in `intersected`
+		static constexpr T ROUNDING_ERROR_BOUND
+			= narrow_cast<T>(3) * (std::numeric_limits<T>::epsilon() / narrow_cast<T>(2))
+			  / (narrow_cast<T>(1)
+				 - narrow_cast<T>(3) * (std::numeric_limits<T>::epsilon() / narrow_cast<T>(2)));
+
+		constexpr BoundingBox() noexcept = default;
+
+		/// @brief Creates a `BoundingBox` spanning the given minimum and maximum corners
+		///
+		/// @param min - The corner with the smallest coordinates
+		/// @param max - The corner with the largest coordinates
+		constexpr BoundingBox(const Point3& min, const Point3& max) noexcept
+			: m_min(min), m_max(max) {
+		}
+		constexpr BoundingBox(const BoundingBox& box) noexcept = default;
+		constexpr BoundingBox(BoundingBox&& box) noexcept = default;
+		constexpr ~BoundingBox() noexcept = default;
+
+		/// @brief Returns the corner of the box with the smallest coordinates
+		///
+		/// @return The minimum corner
+		[[nodiscard]] inline constexpr auto min() const noexcept -> const Point3& {
+			return m_min;
+		}
+
+		/// @brief Returns the corner of the box with the largest coordinates
+		///
+		/// @return The maximum corner
+		[[nodiscard]] inline constexpr auto max() const noexcept -> const Point3& {
+			return m_max;
+		}
+
+		/// @brief Returns whether this box contains no points
+		///
+		/// @return `true` if the box is empty, `false` otherwise
+		[[nodiscard]] inline constexpr auto is_empty() const noexcept -> bool {
+			return m_min.x() > m_max.x() || m_min.y() > m_max.y() || m_min.z() > m_max.z();
+		}
+
+		/// @brief Returns the size of the box along each axis
+		///
+		/// @return The extent of the box
+		[[nodiscard]] inline constexpr auto extent() const noexcept -> Vec3 {
+			return (m_max - m_min).as_vec();
+		}
+
+		/// @brief Returns the center point of the box
+		///
+		/// @return The centroid
+		[[nodiscard]] inline constexpr auto centroid() const noexcept -> Point3 {
+			return (m_min + m_max) * narrow_cast<T>(0.5);
+		}
+
+		/// @brief Returns the surface area of the box, or zero if the box is empty
+		///
+		/// @return The surface area
+		[[nodiscard]] inline constexpr auto surface_area() const noexcept -> T {
+			if(is_empty()) {
+				return narrow_cast<T>(0);
+			}
+			const auto size = extent();
+			return narrow_cast<T>(2)
+				   * (size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+		}
+
+		/// @brief Returns the axis along which the box is largest
+		///
+		/// @return The largest axis
+		[[nodiscard]] inline constexpr auto largest_axis() const noexcept -> Vec3Idx {
+			const auto size = extent();
+			if(size.x() > size.y() && size.x() > size.z()) {
+				return Vec3Idx::X;
+			}
+			return size.y() > size.z() ? Vec3Idx::Y : Vec3Idx::Z;
+		}
+
+		/// @brief Returns the smallest box containing both this box and `box`
+		///
+		/// @param box - The box to merge with
+		///
+		/// @return The merged box
+		[[nodiscard]] inline constexpr auto
+		merged(const BoundingBox& box) const noexcept -> BoundingBox {
+			return {m_min.min(box.m_min), m_max.max(box.m_max)};
+		}
+
+		/// @brief Returns the smallest box containing both this box and `point`
+		///
+		/// @param point - The point to merge with
+		///
+		/// @return The merged box
+		[[nodiscard]] inline constexpr auto merged(const Point3& point) const noexcept -> BoundingBox {
+			return {m_min.min(point), m_max.max(point)};
+		}
+
+		/// @brief Determines whether `ray` passes through this box within the given range of
+		/// lengths along the ray, using the slab test
+		///
+		/// @param ray - The ray to test
+		/// @param inverse_direction - The component-wise reciprocal of `ray`'s direction.
+		/// Passed in so it can be computed once per ray, instead of once per box
+		/// @param min_length - The minimum length along the ray to consider
+		/// @param max_length - The maximum length along the ray to consider
+		///
+		/// @return Whether the ray intersects the box
+		[[nodiscard]] inline constexpr auto intersected(const Ray& ray,
+														const Vec3& inverse_direction,
+														T min_length,
+														T max_length) const noexcept -> bool {
+			for(const auto axis : {Vec3Idx::X, Vec3Idx::Y, Vec3Idx::Z}) {
+				auto near = (m_min[axis] - ray.origin()[axis]) * inverse_direction[axis];
+				auto far = (m_max[axis] - ray.origin()[axis]) * inverse_direction[axis];
+				if(inverse_direction[axis] < narrow_cast<T>(0)) {
+					std::swap(near, far);
+				}
+				// widen the slab by the rounding error bound of the computation, so rays grazing
+				// (or boxes flat along) an axis aren't culled when the primitives inside are hit
+				far *= narrow_cast<T>(1) + narrow_cast<T>(2) * ROUNDING_ERROR_BOUND;
+				min_length = General::max(near, min_length);
+				max_length = General::min(far, max_length);
+				if(max_length < min_length) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		constexpr auto operator=(const BoundingBox& box) noexcept -> BoundingBox& = default;
+		constexpr auto operator=(BoundingBox&& box) noexcept -> BoundingBox& = default;
+
+	  private:
+		Point3 m_min = {Constants<T>::infinity, Constants<T>::infinity, Constants<T>::infinity};
+		Point3 m_max = {-Constants<T>::infinity, -Constants<T>::infinity, -Constants<T>::infinity};
+	};
+} // namespace graphics
@@ -0,0 +1,899 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/ArrayStorage.h"
+#include "../utils/Instrumentation.h"
+#include "BoundingBox.h"
+#include "Geometry.h"
+#include "Ray.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint16_t;
+	using std::uint32_t;
+#endif
+
+	/// @brief How a `BvhTree` is built, trading the quality of the tree (and so the speed of
+	/// tracing rays through it) for the speed of building it
+	enum class BvhBuildMethod
+	{
+		/// Sorts the primitives along each axis, and evaluates the SAH at every split position.
+		/// The best trees, but the slowest to build
+		Sweep = 0,
+		/// Evaluates the SAH only at the boundaries of a fixed number of equal-width bins of
+		/// primitive centroids along each axis. Trees nearly as good as `Sweep`'s, in a fraction
+		/// of the time
+		Binned,
+		/// Sorts the primitives along a Morton (Z-order) curve through their centroids, and splits
+		/// wherever their positions along the curve first differ (an LBVH). The fastest to build,
+		/// but noticeably slower to trace; for previews and interactive rebuilds
+		Linear
+	};
+
+	IGNORE_PADDING_START
+	/// @brief How to build a `BvhTree`
+	struct BvhBuildSettings {
+		BvhBuildMethod m_method = BvhBuildMethod::Binned;
+		/// The maximum number of threads to build with, or 0 for one per hardware thread.
+		/// Only nodes over at least `BvhTree::MIN_PARALLEL_PRIMITIVES` primitives are built in
+		/// parallel, so small trees are always built on the calling thread
+		size_t m_num_threads = 0;
+		/// The fewest primitives a leaf holds, unless the whole tree holds fewer: nodes over fewer
+		/// than twice this many are made leaves, and larger nodes are only split where both sides
+		/// get at least this many. Bigger leaves make smaller trees, at some cost in the speed of
+		/// tracing rays through them
+		size_t m_min_leaf_size = 1;
+	};
+	IGNORE_PADDING_STOP
+
+	/// @brief A Bounding Volume Hierarchy over a set of primitives, known only by their bounds.
+	/// Primitives are recursively partitioned into two groups, choosing the partition that
+	/// minimizes the Surface Area Heuristic (SAH) estimate of the cost of tracing a ray through the
+	/// resulting tree (or, for `BvhBuildMethod::Linear`, by their order along a Morton curve). The
+	/// tree is stored flattened, depth-first, so the first child of an interior node is always the
+	/// node immediately following it.
+	///
+	/// Large trees are built in parallel: the two subtrees of a large node are built on separate
+	/// threads, and the work of splitting the largest nodes, near the root, is itself split between
+	/// threads. The tree built doesn't depend on the number of threads used.
+	///
+	/// The tree doesn't store the primitives themselves: building it produces the order to store
+	/// them in so that every leaf's primitives are contiguous, and traversing it calls back into
+	/// the owner of the primitives to intersect them. This is what `BoundingVolumeHierarchy` uses
+	/// over `Geometry`s, and `TriangleMesh` over its triangles.
+	///
+	/// A tree can also borrow already built nodes, such as from a mapped `SceneFile`, instead of
+	/// building them.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class BvhTree {
+	  public:
+		using BoundingBox = BoundingBox<T>;
+		using HitRecord = HitRecord<T>;
+		using Point3 = Point3<T>;
+		using Ray = Ray<T>;
+		using Vec3 = Vec3<T>;
+
+		/// The maximum depth the tree is split by the SAH to. Primitives still grouped together at
+		/// this depth are stored in a single leaf, if they fit in one
+		static constexpr size_t MAX_DEPTH = 64;
+		/// The maximum number of primitives stored in a leaf, except at `MAX_DEPTH`
+		static constexpr size_t MAX_PRIMITIVES_IN_LEAF = 4;
+		/// The maximum number of primitives stored in any leaf. Primitives still grouped together
+		/// at `MAX_DEPTH`, or that can't be split apart at all, are halved until they fit
+		static constexpr size_t MAX_PRIMITIVES_IN_ANY_LEAF = std::numeric_limits<uint16_t>::max();
+		/// The maximum depth of any leaf: `MAX_DEPTH`, plus the halvings it takes to fit as many
+		/// primitives as can be indexed into leaves of `MAX_PRIMITIVES_IN_ANY_LEAF`
+		static constexpr size_t MAX_LEAF_DEPTH
+			= MAX_DEPTH
+			  + std::bit_width(std::numeric_limits<uint32_t>::max() / MAX_PRIMITIVES_IN_ANY_LEAF);
+		/// The minimum number of primitives in a node for the node to be built in parallel
+		static constexpr size_t MIN_PARALLEL_PRIMITIVES = 8192;
+
+		/// @brief A node in the flattened tree
+		struct Node {
+			BoundingBox m_bounds = BoundingBox();
+			/// For leaves: the index of the first primitive in the leaf.
+			/// For interior nodes: the index of the second child
+			uint32_t m_offset = 0;
+			/// The number of primitives in the leaf, or 0 for interior nodes
+			uint16_t m_count = 0;
+			/// The axis interior nodes were split along
+			uint16_t m_axis = 0;
+
+			[[nodiscard]] inline constexpr auto is_leaf() const noexcept -> bool {
+				return m_count != 0;
+			}
+		};
+
+		constexpr BvhTree() noexcept = default;
+
+		/// @brief Creates a `BvhTree` borrowing already built nodes. The nodes must outlive the
+		/// tree
+		///
+		/// @param nodes - The nodes of the flattened tree, root first, as returned by `nodes`
+		explicit BvhTree(std::span<const Node> nodes) noexcept : m_nodes(nodes) {
+		}
+
+		/// @brief Builds a `BvhTree` over primitives with the given bounds. The time taken is
+		/// reported to instrumentation as `Stage::BvhBuild`
+		///
+		/// @param bounds - The bounds of each primitive
+		/// @param order - Where to write the order to store the primitives in: the index in
+		/// `bounds` of the primitive the tree's leaves refer to by each index
+		/// @param settings - How to build the tree
+		BvhTree(std::span<const BoundingBox> bounds,
+				NotNull<std::vector<uint32_t>> order,
+				const BvhBuildSettings& settings = BvhBuildSettings()) noexcept {
+			const auto timer
+				= utils::instrumentation::ScopedTimer(utils::instrumentation::Stage::BvhBuild);
+			order->clear();
+			if(bounds.empty()) {
+				return;
+			}
+
+			const auto num_threads
+				= settings.m_num_threads != 0 ?
+					  settings.m_num_threads :
+					  General::max(narrow_cast<size_t>(std::thread::hardware_concurrency()),
+								   1ULL);
+			auto primitives = std::vector<BuildPrimitive>(bounds.size());
+			for_each_chunk(bounds.size(),
+						   num_threads,
+						   [&](size_t /*chunk*/, size_t begin, size_t end) noexcept {
+							   for(auto i = begin; i < end; ++i) {
+								   primitives[i] = {bounds[i],
+													bounds[i].centroid(),
+													narrow_cast<uint32_t>(i)};
+							   }
+						   });
+			const auto extents = extents_of(primitives, num_threads);
+			if(settings.m_method == BvhBuildMethod::Linear) {
+				sort_along_morton_curve(primitives, extents.m_centroids, num_threads);
+			}
+
+			auto& nodes = m_nodes.owned();
+			nodes.reserve(2 * bounds.size());
+			order->reserve(bounds.size());
+			build_recursive(primitives, extents, 0ULL, settings, num_threads, &nodes, order);
+		}
+		constexpr BvhTree(const BvhTree& tree) noexcept = default;
+		constexpr BvhTree(BvhTree&& tree) noexcept = default;
+		constexpr ~BvhTree() noexcept = default;
+
+		/// @brief Returns the nodes of the flattened tree, root first
+		///
+		/// @return The nodes
+		[[nodiscard]] inline constexpr auto nodes() const noexcept -> std::span<const Node> {
+			return m_nodes.span();
+		}
+
+		/// @brief Returns the bounds of the whole tree
+		///
+		/// @return The bounds of the root
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox {
+			return m_nodes.empty() ? BoundingBox() : m_nodes[0].m_bounds;
+		}
+
+		/// @brief Finds the closest hit of `ray` on the tree's primitives, within the given range
+		/// of lengths along the ray
+		///
+		/// @param ray - The ray to test
+		/// @param min_length - The minimum length along the ray to accept a hit at
+		/// @param max_length - The maximum length along the ray to accept a hit at
+		/// @param record - Where to record the closest hit
+		/// @param intersect - Callable taking the index of a primitive, in leaf order, and the
+		/// maximum length to accept a hit at. Intersects `ray` with the primitive as
+		/// `Geometry::intersected` would, recording any hit into `record`
+		///
+		/// @return Whether any primitive was hit
+		template<typename Intersect>
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record,
+								Intersect&& intersect) const noexcept -> bool {
+			const auto nodes = m_nodes.span();
+			if(nodes.empty()) {
+				return false;
+			}
+
+			const auto& direction = ray.direction();
+			const auto inverse_direction = Vec3(narrow_cast<T>(1) / direction.x(),
+												narrow_cast<T>(1) / direction.y(),
+												narrow_cast<T>(1) / direction.z());
+			const auto direction_is_negative
+				= std::array<bool, 3>{inverse_direction.x() < narrow_cast<T>(0),
+									  inverse_direction.y() < narrow_cast<T>(0),
+									  inverse_direction.z() < narrow_cast<T>(0)};
+
+			auto hit_found = false;
+			auto closest = max_length;
+			auto to_visit = std::array<uint32_t, MAX_LEAF_DEPTH + 1>();
+			auto num_to_visit = 0ULL;
+			auto current = 0U;
+			auto num_visited = 0ULL;
+
+			while(true) {
+				const auto& node = nodes[current];
+				++num_visited;
+				if(node.m_bounds.intersected(ray, inverse_direction, min_length, closest)) {
+					if(node.is_leaf()) {
+						for(auto i = node.m_offset; i < node.m_offset + node.m_count; ++i) {
+							if(intersect(i, closest)) {
+								hit_found = true;
+								closest = record->m_length;
+							}
+						}
+					}
+					else {
+						// visit the child nearer the ray origin first, so `closest` shrinks sooner
+						if(direction_is_negative[node.m_axis]) {
+							to_visit[num_to_visit++] = current + 1;
+							current = node.m_offset;
+						}
+						else {
+							to_visit[num_to_visit++] = node.m_offset;
+							current = current + 1;
+						}
+						continue;
+					}
+				}
+
+				if(num_to_visit == 0) {
+					break;
+				}
+				current = to_visit[--num_to_visit];
+			}
+
+			utils::instrumentation::count(utils::instrumentation::Counter::BvhNodesVisited,
+										  num_visited);
+			return hit_found;
+		}
+
+		constexpr auto operator=(const BvhTree& tree) noexcept -> BvhTree& = default;
+		constexpr auto operator=(BvhTree&& tree) noexcept -> BvhTree& = default;
+
+	  private:
+		/// Estimated cost of traversing an interior node, relative to intersecting one primitive
+		static constexpr T TRAVERSAL_COST = narrow_cast<T>(0.125);
+
+		/// The number of bins `BvhBuildMethod::Binned` sorts centroids into along each axis
+		static constexpr size_t NUM_BINS = 32;
+		/// The maximum number of primitives in a node for `BvhBuildMethod::Binned` to sweep every
+		/// split position instead of binning, as it's faster for so few primitives
+		static constexpr size_t MAX_SWEPT_PRIMITIVES = 8;
+		/// The number of bits of each axis in a Morton code
+		static constexpr uint32_t MORTON_BITS_PER_AXIS = 10;
+
+		IGNORE_PADDING_START
+		/// @brief Per-primitive data used while building the tree
+		struct BuildPrimitive {
+			BoundingBox m_bounds;
+			Point3 m_centroid;
+			uint32_t m_index;
+			/// The primitive's position along the Morton curve, for `BvhBuildMethod::Linear`
+			uint32_t m_code = 0;
+		};
+		IGNORE_PADDING_STOP
+
+		/// @brief The bounds of a set of primitives, and of their centroids
+		struct Extents {
+			BoundingBox m_bounds = BoundingBox();
+			BoundingBox m_centroids = BoundingBox();
+		};
+
+		IGNORE_PADDING_START
+		/// @brief The primitives whose centroids fall in one bin, for `BvhBuildMethod::Binned`
+		struct Bin {
+			BoundingBox m_bounds = BoundingBox();
+			size_t m_count = 0;
+		};
+		IGNORE_PADDING_STOP
+
+		/// The bins along each axis
+		using Bins = std::array<std::array<Bin, NUM_BINS>, 3>;
+
+		IGNORE_PADDING_START
+		/// @brief The best partition found for a set of primitives
+		struct Split {
+			/// The estimated cost of the split, relative to intersecting one primitive
+			T m_cost = Constants<T>::infinity;
+			/// The axis the primitives were split along
+			size_t m_axis = 0;
+			/// The number of primitives in the first partition, after partitioning
+			size_t m_position = 0;
+			bool m_valid = false;
+			/// The extents of the two partitions, when found while splitting
+			std::optional<std::array<Extents, 2>> m_extents = std::nullopt;
+		};
+		IGNORE_PADDING_STOP
+
+		utils::ArrayStorage<Node> m_nodes;
+
+		/// @brief Recursively builds the subtree over `primitives`, appending its nodes to
+		/// `nodes` and its leaves' primitives to `order`
+		///
+		/// @param primitives - The primitives to build the subtree over
+		/// @param extents - The extents of `primitives`. The bounds must be exact, but the bounds
+		/// of the centroids only need to contain them
+		/// @param depth - The depth of the subtree's root
+		/// @param settings - How to build the subtree. Its number of threads is ignored
+		/// @param num_threads - The number of threads the subtree can be built with
+		/// @param nodes - The nodes of the tree, depth-first
+		/// @param order - The primitives, in leaf order
+		inline static auto build_recursive(std::span<BuildPrimitive> primitives,
+										   const Extents& extents,
+										   size_t depth,
+										   const BvhBuildSettings& settings,
+										   size_t num_threads,
+										   NotNull<std::vector<Node>> nodes,
+										   NotNull<std::vector<uint32_t>> order) noexcept -> void {
+			const auto index = nodes->size();
+			nodes->emplace_back();
+
+			const auto count = primitives.size();
+			(*nodes)[index].m_bounds = extents.m_bounds;
+
+			// leaves hold fewer than twice the minimum, so the minimum must leave them countable
+			const auto min_leaf_size = General::min(General::max(settings.m_min_leaf_size, 1ULL),
+													(MAX_PRIMITIVES_IN_ANY_LEAF + 1) / 2);
+			auto split = count >= 2 * min_leaf_size && depth < MAX_DEPTH ?
+							 split_primitives(primitives,
+											  extents,
+											  settings.m_method,
+											  min_leaf_size,
+											  num_threads) :
+							 Split();
+			if(!split.m_valid && count > MAX_PRIMITIVES_IN_ANY_LEAF) {
+				// too many to count in one leaf, and nothing better to split them by
+				split = Split{.m_position = count / 2, .m_valid = true};
+			}
+			if(!split.m_valid
+			   || (count <= MAX_PRIMITIVES_IN_LEAF && split.m_cost >= narrow_cast<T>(count)))
+			{
+				// a count of 0 would make the leaf an interior node
+				assert(count != 0 && count <= MAX_PRIMITIVES_IN_ANY_LEAF);
+				(*nodes)[index].m_offset = narrow_cast<uint32_t>(order->size());
+				(*nodes)[index].m_count = narrow_cast<uint16_t>(count);
+				for(const auto& primitive : primitives) {
+					order->push_back(primitive.m_index);
+				}
+				return;
+			}
+
+			(*nodes)[index].m_axis = narrow_cast<uint16_t>(split.m_axis);
+			const auto first = primitives.first(split.m_position);
+			const auto second = primitives.subspan(split.m_position);
+			const auto child_extents = split.m_extents ?
+										   *split.m_extents :
+										   std::array<Extents, 2>{extents_of(first, num_threads),
+																  extents_of(second, num_threads)};
+			if(num_threads == 1 || count < MIN_PARALLEL_PRIMITIVES) {
+				build_recursive(first, child_extents[0], depth + 1, settings, 1ULL, nodes, order);
+				(*nodes)[index].m_offset = narrow_cast<uint32_t>(nodes->size());
+				build_recursive(second, child_extents[1], depth + 1, settings, 1ULL, nodes, order);
+				return;
+			}
+
+			// build the first subtree on another thread, each subtree into its own arrays, then
+			// append them in depth-first order
+			const auto first_threads = num_threads / 2;
+			auto first_nodes = std::vector<Node>();
+			auto first_order = std::vector<uint32_t>();
+			auto second_nodes = std::vector<Node>();
+			auto second_order = std::vector<uint32_t>();
+			first_nodes.reserve(2 * first.size());
+			first_order.reserve(first.size());
+			second_nodes.reserve(2 * second.size());
+			second_order.reserve(second.size());
+			{
+				const auto thread = std::jthread([&]() noexcept {
+					build_recursive(first,
+									child_extents[0],
+									depth + 1,
+									settings,
+									first_threads,
+									&first_nodes,
+									&first_order);
+				});
+				build_recursive(second,
+								child_extents[1],
+								depth + 1,
+								settings,
+								num_threads - first_threads,
+								&second_nodes,
+								&second_order);
+			}
+
+			append_subtree(first_nodes, first_order, nodes, order);
+			(*nodes)[index].m_offset = narrow_cast<uint32_t>(nodes->size());
+			append_subtree(second_nodes, second_order, nodes, order);
+		}
+
+		/// @brief Appends a subtree built into separate arrays to the end of `nodes` and `order`,
+		/// offsetting its nodes' indices to match
+		///
+		/// @param subtree_nodes - The nodes of the subtree, depth-first
+		/// @param subtree_order - The primitives of the subtree, in leaf order
+		/// @param nodes - The nodes to append to
+		/// @param order - The primitives to append to
+		inline static auto append_subtree(std::span<const Node> subtree_nodes,
+										  std::span<const uint32_t> subtree_order,
+										  NotNull<std::vector<Node>> nodes,
+										  NotNull<std::vector<uint32_t>> order) noexcept -> void {
+			const auto node_offset = narrow_cast<uint32_t>(nodes->size());
+			const auto order_offset = narrow_cast<uint32_t>(order->size());
+			for(auto node : subtree_nodes) {
+				node.m_offset += node.is_leaf() ? order_offset : node_offset;
+				nodes->push_back(node);
+			}
+			order->insert(order->end(), subtree_order.begin(), subtree_order.end());
+		}
+
+		/// @brief Partitions `primitives` in two, as `method` chooses
+		///
+		/// @param primitives - The primitives to partition
+		/// @param extents - The extents of all of `primitives`
+		/// @param method - How to choose the partition
+		/// @param min_size - The fewest primitives either partition can hold. At most half of
+		/// `primitives`
+		/// @param num_threads - The number of threads the partition can be chosen with
+		///
+		/// @return The split made
+		[[nodiscard]] inline static auto split_primitives(std::span<BuildPrimitive> primitives,
+														  const Extents& extents,
+														  BvhBuildMethod method,
+														  size_t min_size,
+														  size_t num_threads) noexcept -> Split {
+			if(method == BvhBuildMethod::Sweep) {
+				return split_sweep(primitives, extents.m_bounds, min_size);
+			}
+			if(method == BvhBuildMethod::Binned) {
+				return primitives.size() <= MAX_SWEPT_PRIMITIVES ?
+						   split_sweep(primitives, extents.m_bounds, min_size) :
+						   split_binned(primitives, extents, min_size, num_threads);
+			}
+			return split_linear(primitives, extents.m_centroids, min_size);
+		}
+
+		/// @brief Finds the partition of `primitives` minimizing the SAH cost, by sorting them
+		/// along each axis and sweeping every possible split position, and partitions them by it
+		///
+		/// @param primitives - The primitives to partition
+		/// @param bounds - The bounds of all of `primitives`
+		/// @param min_size - The fewest primitives either partition can hold
+		///
+		/// @return The best split
+		[[nodiscard]] inline static auto split_sweep(std::span<BuildPrimitive> primitives,
+													 const BoundingBox& bounds,
+													 size_t min_size) noexcept -> Split {
+			const auto count = primitives.size();
+			const auto parent_area = bounds.surface_area();
+			auto right_areas = std::vector<T>(count);
+			auto best = Split();
+
+			if(parent_area <= narrow_cast<T>(0)) {
+				// degenerate bounds: every split is equally (in)effective, so split in half
+				return {narrow_cast<T>(count), 0ULL, count / 2, true};
+			}
+
+			for(auto axis = 0ULL; axis < 3; ++axis) {
+				sort_along(primitives, axis);
+
+				auto right = BoundingBox();
+				for(auto i = count - 1; i > 0; --i) {
+					right = right.merged(primitives[i].m_bounds);
+					right_areas[i] = right.surface_area();
+				}
+
+				auto left = BoundingBox();
+				for(auto i = 1ULL; i < count; ++i) {
+					left = left.merged(primitives[i - 1].m_bounds);
+					if(i < min_size || count - i < min_size) {
+						continue;
+					}
+
+					const auto cost = TRAVERSAL_COST
+									  + (left.surface_area() * narrow_cast<T>(i)
+										 + right_areas[i] * narrow_cast<T>(count - i))
+											/ parent_area;
+					if(cost < best.m_cost) {
+						best = {cost, axis, i, true};
+					}
+				}
+			}
+
+			sort_along(primitives, best.m_axis);
+			return best;
+		}
+
+		/// @brief Sorts `primitives` by their centroids along `axis`
+		inline static auto sort_along(std::span<BuildPrimitive> primitives, size_t axis) noexcept
+			-> void {
+			const auto index = static_cast<Vec3Idx>(axis);
+			std::sort(primitives.begin(),
+					  primitives.end(),
+					  [index](const BuildPrimitive& lhs, const BuildPrimitive& rhs) {
+						  return lhs.m_centroid[index] < rhs.m_centroid[index];
+					  });
+		}
+
+		/// @brief Finds the partition of `primitives` minimizing the SAH cost, evaluated at the
+		/// boundaries of `NUM_BINS` equal-width bins of their centroids along each axis, and
+		/// partitions them by it
+		///
+		/// @param primitives - The primitives to partition
+		/// @param extents - The extents of all of `primitives`
+		/// @param min_size - The fewest primitives either partition can hold
+		/// @param num_threads - The number of threads to bin the primitives with
+		///
+		/// @return The best split
+		[[nodiscard]] inline static auto split_binned(std::span<BuildPrimitive> primitives,
+													  const Extents& extents,
+													  size_t min_size,
+													  size_t num_threads) noexcept -> Split {
+			const auto count = primitives.size();
+			const auto parent_area = extents.m_bounds.surface_area();
+			if(parent_area <= narrow_cast<T>(0)) {
+				// degenerate bounds: every split is equally (in)effective, so split in half
+				return {narrow_cast<T>(count), 0ULL, count / 2, true};
+			}
+
+			const auto& centroids = extents.m_centroids;
+			const auto scales = bin_scales(centroids);
+			const auto bins = reduce_chunks<Bins>(
+				count,
+				num_threads,
+				[&](size_t begin, size_t end) noexcept -> Bins {
+					auto chunk_bins = Bins();
+					for(auto i = begin; i < end; ++i) {
+						for(auto axis = 0ULL; axis < 3; ++axis) {
+							auto& bin = chunk_bins[axis][bin_index(primitives[i].m_centroid,
+																	centroids,
+																	scales,
+																	axis)];
+							bin.m_bounds = bin.m_bounds.merged(primitives[i].m_bounds);
+							++bin.m_count;
+						}
+					}
+					return chunk_bins;
+				},
+				[](Bins lhs, const Bins& rhs) noexcept -> Bins {
+					for(auto axis = 0ULL; axis < 3; ++axis) {
+						for(auto bin = 0ULL; bin < NUM_BINS; ++bin) {
+							lhs[axis][bin].m_bounds
+								= lhs[axis][bin].m_bounds.merged(rhs[axis][bin].m_bounds);
+							lhs[axis][bin].m_count += rhs[axis][bin].m_count;
+						}
+					}
+					return lhs;
+				});
+
+			auto best = Split();
+			for(auto axis = 0ULL; axis < 3; ++axis) {
+				if(scales[axis] == narrow_cast<T>(0)) {
+					continue;
+				}
+
+				// empty bins are skipped: splitting either side of one gives the same partition
+				auto right_areas = std::array<T, NUM_BINS>();
+				auto right_counts = std::array<size_t, NUM_BINS>();
+				auto right = BoundingBox();
+				auto right_area = narrow_cast<T>(0);
+				auto right_count = 0ULL;
+				for(auto bin = NUM_BINS - 1; bin > 0; --bin) {
+					if(bins[axis][bin].m_count != 0) {
+						right = right.merged(bins[axis][bin].m_bounds);
+						right_area = right.surface_area();
+						right_count += bins[axis][bin].m_count;
+					}
+					right_areas[bin] = right_area;
+					right_counts[bin] = right_count;
+				}
+
+				auto left = BoundingBox();
+				auto left_count = 0ULL;
+				for(auto bin = 1ULL; bin < NUM_BINS; ++bin) {
+					if(bins[axis][bin - 1].m_count == 0) {
+						continue;
+					}
+					left = left.merged(bins[axis][bin - 1].m_bounds);
+					left_count += bins[axis][bin - 1].m_count;
+					if(right_counts[bin] == 0) {
+						break;
+					}
+					if(left_count < min_size || right_counts[bin] < min_size) {
+						continue;
+					}
+
+					const auto cost = TRAVERSAL_COST
+									  + (left.surface_area() * narrow_cast<T>(left_count)
+										 + right_areas[bin] * narrow_cast<T>(right_counts[bin]))
+											/ parent_area;
+					if(cost < best.m_cost) {
+						best = {cost, axis, bin, true};
+					}
+				}
+			}
+
+			if(!best.m_valid) {
+				// every centroid is in the same place, or too close to the edge of the others, for
+				// a bin boundary to separate them
+				return {narrow_cast<T>(count), 0ULL, count / 2, true};
+			}
+
+			const auto second = std::partition(primitives.begin(),
+											   primitives.end(),
+											   [&](const BuildPrimitive& primitive) {
+												   return bin_index(primitive.m_centroid,
+																	centroids,
+																	scales,
+																	best.m_axis)
+														  < best.m_position;
+											   });
+
+			// the bins give the partitions' bounds exactly, so their primitives don't need to be
+			// visited again to find them. Their centroids are bounded by the boundary between
+			// their bins, which is close enough to bin them by
+			auto child_extents = std::array<Extents, 2>{extents, extents};
+			auto& [first_extents, second_extents] = child_extents;
+			first_extents.m_bounds = BoundingBox();
+			second_extents.m_bounds = BoundingBox();
+			for(auto bin = 0ULL; bin < NUM_BINS; ++bin) {
+				auto& bounds = bin < best.m_position ? first_extents.m_bounds :
+													   second_extents.m_bounds;
+				bounds = bounds.merged(bins[best.m_axis][bin].m_bounds);
+			}
+			const auto axis = static_cast<Vec3Idx>(best.m_axis);
+			auto boundary = centroids.min();
+			boundary[axis] += narrow_cast<T>(best.m_position) / scales[best.m_axis]; // NOLINT
+			auto first_max = centroids.max();
+			first_max[axis] = boundary[axis];
+			first_extents.m_centroids = BoundingBox(centroids.min(), first_max);
+			second_extents.m_centroids = BoundingBox(boundary, centroids.max());
+
+			best.m_position = narrow_cast<size_t>(std::distance(primitives.begin(), second));
+			best.m_extents = child_extents;
+			return best;
+		}
+
+		/// @brief Returns the scale from a centroid's offset from `centroids.min()` to its bin,
+		/// along each axis, or 0 for axes along which all the centroids are in the same place
+		[[nodiscard]] inline static constexpr auto
+		bin_scales(const BoundingBox& centroids) noexcept -> std::array<T, 3> {
+			const auto extent = centroids.extent();
+			auto scales = std::array<T, 3>();
+			for(auto axis = 0ULL; axis < 3; ++axis) {
+				const auto length = extent[static_cast<Vec3Idx>(axis)];
+				scales[axis] = length > narrow_cast<T>(0) ?
+								   narrow_cast<T>(NUM_BINS) / length :
+								   narrow_cast<T>(0);
+			}
+			return scales;
+		}
+
+		/// @brief Returns the bin `centroid` falls in along `axis`
+		[[nodiscard]] inline static constexpr auto bin_index(const Point3& centroid,
+															 const BoundingBox& centroids,
+															 const std::array<T, 3>& scales,
+															 size_t axis) noexcept -> size_t {
+			const auto index = static_cast<Vec3Idx>(axis);
+			// centroid bounds can be loose, so centroids can fall slightly outside the bins
+			const auto offset = General::max(centroid[index] - centroids.min()[index],
+											 narrow_cast<T>(0));
+			const auto bin = narrow_cast<size_t>(offset * scales[axis]); // NOLINT
+			return General::min(bin, NUM_BINS - 1);
+		}
+
+		/// @brief Partitions `primitives`, sorted along the Morton curve, at the first position
+		/// along the curve their codes differ at
+		///
+		/// @param primitives - The primitives to partition, sorted by `m_code`
+		/// @param centroids - The bounds of all of `primitives`' centroids
+		/// @param min_size - The fewest primitives either partition can hold
+		///
+		/// @return The split
+		[[nodiscard]] inline static auto split_linear(std::span<BuildPrimitive> primitives,
+													  const BoundingBox& centroids,
+													  size_t min_size) noexcept -> Split {
+			const auto count = primitives.size();
+			const auto first = primitives.front().m_code;
+			const auto last = primitives.back().m_code;
+			if(first == last) {
+				// the curve doesn't separate the primitives, so split in half
+				return {narrow_cast<T>(count),
+						static_cast<size_t>(centroids.largest_axis()),
+						count / 2,
+						true};
+			}
+
+			// the codes all share the bits above the highest bit that differs between the first
+			// and last, so the sorted primitives have that bit clear up to some point, then set
+			const auto bit = narrow_cast<uint32_t>(std::bit_width(first ^ last) - 1);
+			const auto second = std::partition_point(primitives.begin(),
+													 primitives.end(),
+													 [bit](const BuildPrimitive& primitive) {
+														 return (primitive.m_code & (1U << bit))
+																== 0U;
+													 });
+			// codes interleave the axes' bits as xyz, from the most significant bit down. Without
+			// an SAH estimate to stop at, primitives are split for as long as the curve separates
+			// them, giving tighter leaves
+			// (moved along the curve, if need be, to leave enough primitives on either side)
+			const auto position = narrow_cast<size_t>(std::distance(primitives.begin(), second));
+			return {narrow_cast<T>(0),
+					2ULL - bit % 3ULL,
+					std::clamp(position, min_size, count - min_size),
+					true};
+		}
+
+		/// @brief Assigns each of `primitives` its Morton code, and sorts them by it
+		///
+		/// @param primitives - The primitives to sort
+		/// @param centroids - The bounds of all of `primitives`' centroids
+		/// @param num_threads - The number of threads to sort with
+		inline static auto sort_along_morton_curve(std::span<BuildPrimitive> primitives,
+												   const BoundingBox& centroids,
+												   size_t num_threads) noexcept -> void {
+			const auto extent = centroids.extent();
+			constexpr auto max_coordinate = (1U << MORTON_BITS_PER_AXIS) - 1U;
+			auto scales = std::array<T, 3>();
+			for(auto axis = 0ULL; axis < 3; ++axis) {
+				const auto length = extent[static_cast<Vec3Idx>(axis)];
+				scales[axis] = length > narrow_cast<T>(0) ?
+								   narrow_cast<T>(max_coordinate) / length :
+								   narrow_cast<T>(0);
+			}
+
+			const auto by_code = [](const BuildPrimitive& lhs, const BuildPrimitive& rhs) {
+				// ties are broken by index, so the order doesn't depend on how the sort is split
+				return lhs.m_code < rhs.m_code
+					   || (lhs.m_code == rhs.m_code && lhs.m_index < rhs.m_index);
+			};
+
+			// sort chunks of the primitives in parallel, then merge them
+			const auto assign_and_sort = [&](size_t /*chunk*/, size_t begin, size_t end) noexcept {
+				for(auto i = begin; i < end; ++i) {
+					auto code = 0U;
+					for(auto axis = 0ULL; axis < 3; ++axis) {
+						const auto index = static_cast<Vec3Idx>(axis);
+						const auto coordinate = narrow_cast<uint32_t>(
+							(primitives[i].m_centroid[index] - centroids.min()[index])
+							* scales[axis]); // NOLINT
+						code = (code << 1U)
+							   | expand_bits(General::min(coordinate, max_coordinate));
+					}
+					primitives[i].m_code = code;
+				}
+				std::sort(primitives.begin() + narrow_cast<std::ptrdiff_t>(begin),
+						  primitives.begin() + narrow_cast<std::ptrdiff_t>(end),
+						  by_code);
+			};
+			for_each_chunk(primitives.size(), num_threads, assign_and_sort);
+
+			const auto count = primitives.size();
+			const auto chunks = num_chunks(count, num_threads);
+			for(auto chunk = 1ULL; chunk < chunks; ++chunk) {
+				const auto middle = chunk_begin(count, chunks, chunk);
+				const auto end = chunk_begin(count, chunks, chunk + 1);
+				std::inplace_merge(primitives.begin(),
+								   primitives.begin() + narrow_cast<std::ptrdiff_t>(middle),
+								   primitives.begin() + narrow_cast<std::ptrdiff_t>(end),
+								   by_code);
+			}
+		}
+
+		/// @brief Spreads the low `MORTON_BITS_PER_AXIS` bits of `value` out to every third bit
+		[[nodiscard]] inline static constexpr auto expand_bits(uint32_t value) noexcept
+			-> uint32_t {
+			value = (value * 0x00010001U) & 0xFF0000FFU; // NOLINT
+			value = (value * 0x00000101U) & 0x0F00F00FU; // NOLINT
+			value = (value * 0x00000011U) & 0xC30C30C3U; // NOLINT
+			value = (value * 0x00000005U) & 0x49249249U; // NOLINT
+			return value;
+		}
+
+		/// @brief Returns the extents of `primitives`
+		[[nodiscard]] inline static auto
+		extents_of(std::span<const BuildPrimitive> primitives, size_t num_threads) noexcept
+			-> Extents {
+			return reduce_chunks<Extents>(
+				primitives.size(),
+				num_threads,
+				[primitives](size_t begin, size_t end) noexcept -> Extents {
+					auto extents = Extents();
+					for(auto i = begin; i < end; ++i) {
+						extents.m_bounds = extents.m_bounds.merged(primitives[i].m_bounds);
+						extents.m_centroids = extents.m_centroids.merged(primitives[i].m_centroid);
+					}
+					return extents;
+				},
+				[](const Extents& lhs, const Extents& rhs) noexcept -> Extents {
+					return {lhs.m_bounds.merged(rhs.m_bounds),
+							lhs.m_centroids.merged(rhs.m_centroids)};
+				});
+		}
+
+		/// @brief Returns the number of chunks to split work over `count` primitives into: one
+		/// per thread for nodes large enough to build in parallel, otherwise one
+		[[nodiscard]] inline static constexpr auto
+		num_chunks(size_t count, size_t num_threads) noexcept -> size_t {
+			return count >= MIN_PARALLEL_PRIMITIVES ? num_threads : 1ULL;
+		}
+
+		/// @brief Returns the index of the first of `count` primitives in `chunk` of `chunks`
+		[[nodiscard]] inline static constexpr auto
+		chunk_begin(size_t count, size_t chunks, size_t chunk) noexcept -> size_t {
+			return count * chunk / chunks;
+		}
+
+		/// @brief Calls `function` with the range of indices of each chunk of `count` primitives,
+		/// the first on the calling thread and the rest on their own threads
+		///
+		/// @param count - The number of primitives
+		/// @param num_threads - The number of threads that can be used
+		/// @param function - Callable taking the index of a chunk, and the indices of the first and
+		/// one past the last primitive in it
+		template<typename Function>
+		inline static auto
+		for_each_chunk(size_t count, size_t num_threads, Function&& function) noexcept -> void {
+			const auto chunks = num_chunks(count, num_threads);
+			auto threads = std::vector<std::jthread>();
+			threads.reserve(chunks - 1);
+			for(auto chunk = 1ULL; chunk < chunks; ++chunk) {
+				threads.emplace_back([&function, count, chunks, chunk]() noexcept {
+					function(chunk,
+							 chunk_begin(count, chunks, chunk),
+							 chunk_begin(count, chunks, chunk + 1));
+				});
+			}
+			function(0ULL, 0ULL, chunk_begin(count, chunks, 1ULL));
+		}
+
+		/// @brief Maps each chunk of `count` primitives to a `Result` with `map`, in parallel, then
+		/// merges the results, in order, with `merge`
+		///
+		/// @param count - The number of primitives
+		/// @param num_threads - The number of threads that can be used
+		/// @param map - Callable taking the indices of the first and one past the last primitive
+		/// in a chunk, returning the chunk's `Result`
+		/// @param merge - Callable taking two `Result`s, returning their merged `Result`
+		///
+		/// @return The merged result
+		template<typename Result, typename Map, typename Merge>
+		[[nodiscard]] inline static auto reduce_chunks(size_t count,
+													   size_t num_threads,
+													   Map&& map,
+													   Merge&& merge) noexcept -> Result {
+			const auto chunks = num_chunks(count, num_threads);
+			if(chunks == 1) {
+				return map(0ULL, count);
+			}
+
+			auto results = std::vector<Result>(chunks);
+			const auto map_chunk = [&](size_t chunk, size_t begin, size_t end) noexcept {
+				results[chunk] = map(begin, end);
+			};
+			for_each_chunk(count, num_threads, map_chunk);
+
+			auto result = results.front();
+			for(auto chunk = 1ULL; chunk < results.size(); ++chunk) {
+				result = merge(result, results[chunk]);
+			}
+			return result;
+		}
+	};
+} // namespace graphics
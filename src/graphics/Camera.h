@@ -9,6 +9,7 @@ namespace graphics {
 	template<FloatingPoint T = float>
 	class Camera {
 	  public:
+		using Point2 = math::Point2<T>;
 		using Point3 = math::Point3<T>;
 		using Vec3 = math::Vec3<T>;
 		constexpr Camera() noexcept = default;
@@ -253,6 +254,22 @@ namespace graphics {
 						.as_vec()};
 		}
 
+		/// @brief Returns the ray through (`s`, `t`) on the viewport, starting from the point on
+		/// the lens selected by `lens_sample`, instead of a random one
+		///
+		/// @param s - The horizontal position on the viewport, in [0, 1]
+		/// @param t - The vertical position on the viewport, in [0, 1]
+		/// @param lens_sample - A sample in [0, 1)^2, mapped uniformly onto the lens
+		///
+		/// @return The ray
+		inline auto get_ray(T s, T t, const Point2& lens_sample) const noexcept -> Ray<T> {
+			const auto disk = math::Sampling::unit_disk(lens_sample.x(), lens_sample.y());
+			auto offset = m_u * (m_lens_radius * disk.m_x) + m_v * (m_lens_radius * disk.m_y);
+			return {m_origin + offset,
+					(m_lower_left + s * m_horizontal_axes + t * m_vertical_axes - m_origin - offset)
+						.as_vec()};
+		}
+
 		constexpr auto operator=(const Camera& camera) noexcept -> Camera& = default;
 		constexpr auto operator=(Camera&& camera) noexcept -> Camera& = default;
 
@@ -55,6 +55,14 @@ namespace graphics {
 			return m_vec;
 		}
 
+		/// @brief Returns the relative luminance of this color, using the Rec. 709 weights
+		///
+		/// @return The luminance
+		[[nodiscard]] inline constexpr auto luminance() const noexcept -> T {
+			return narrow_cast<T>(0.2126) * r() + narrow_cast<T>(0.7152) * g()
+				   + narrow_cast<T>(0.0722) * b();
+		}
+
 		inline constexpr auto
 		write(std::ostream& out, size_t samples_per_pixel, T gamma) noexcept -> void {
 			Color col{*this};
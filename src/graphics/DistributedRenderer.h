@@ -0,0 +1,574 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/ConcurrentRingBuffer.h"
+#include "../utils/Instrumentation.h"
+#include "../utils/Socket.h"
+#include "Camera.h"
+#include "Color.h"
+#include "Framebuffer.h"
+#include "Ray.h"
+#include "TileRenderer.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+	using std::uint64_t;
+#endif
+
+	namespace detail {
+		/// The version of the distributed rendering protocol spoken, and the only one understood
+		static constexpr uint32_t DISTRIBUTED_VERSION = 1;
+		/// The identifier at the start of every worker's greeting
+		static constexpr std::array<char, 8> DISTRIBUTED_MAGIC
+			= {'H', 'Y', 'P', 'W', 'O', 'R', 'K', 'R'};
+
+		/// @brief Everything the coordinator and a worker must agree on to render the same image.
+		/// The scene key stands in for everything else that determines the image (the scene, the
+		/// camera, the sampler, etc.) and is chosen by the application
+		struct DistributedSettings {
+			uint64_t m_width = 0;
+			uint64_t m_height = 0;
+			uint64_t m_samples_per_pixel = 0;
+			uint64_t m_tile_size = 0;
+			uint64_t m_seed = 0;
+			uint64_t m_scene_key = 0;
+			uint32_t m_float_size = 0;
+			uint32_t m_color_size = 0;
+			uint32_t m_adaptive_sampling = 0;
+			uint32_t m_has_sampler = 0;
+
+			auto operator==(const DistributedSettings& settings) const noexcept -> bool = default;
+
+			template<FloatingPoint T>
+			[[nodiscard]] inline static auto
+			of(const TileRenderer<T>& renderer, uint64_t scene_key) noexcept
+				-> DistributedSettings {
+				return {renderer.width(),
+						renderer.height(),
+						renderer.samples_per_pixel(),
+						renderer.tile_size(),
+						renderer.seed(),
+						scene_key,
+						sizeof(T),
+						sizeof(Color<T>),
+						renderer.adaptive_sampling() ? 1U : 0U,
+						renderer.sampler() != nullptr ? 1U : 0U};
+			}
+		};
+
+		/// @brief Sent by a worker when it connects to the coordinator
+		struct WorkerHello {
+			std::array<char, 8> m_magic = DISTRIBUTED_MAGIC;
+			uint32_t m_version = DISTRIBUTED_VERSION;
+			/// The number of tiles the worker renders at once
+			uint32_t m_num_threads = 1;
+			DistributedSettings m_settings = DistributedSettings();
+		};
+
+		/// @brief The kinds of message sent by the coordinator to a worker
+		enum class JobKind : uint32_t {
+			/// Render the tile and send back its pixels
+			RenderTile = 0,
+			/// Every tile has been rendered; disconnect
+			Finish = 1
+		};
+
+		/// @brief Sent by the coordinator to a worker
+		struct Job {
+			JobKind m_kind = JobKind::RenderTile;
+			uint32_t m_reserved = 0;
+			/// The index of the tile to render
+			uint64_t m_tile = 0;
+		};
+
+		/// @brief Sent by a worker to the coordinator, followed by the tile's pixels
+		struct TileResult {
+			uint64_t m_tile = 0;
+			uint64_t m_num_pixels = 0;
+		};
+
+		static_assert(std::is_trivially_copyable_v<WorkerHello> && std::is_trivially_copyable_v<Job>
+						  && std::is_trivially_copyable_v<TileResult>,
+					  "Distributed rendering messages must be trivially copyable");
+
+		template<typename Message>
+		[[nodiscard]] inline auto
+		send_message(NotNull<utils::Socket> socket, const Message& message) noexcept -> bool {
+			return socket->send_all(std::as_bytes(std::span<const Message>(&message, 1)));
+		}
+
+		template<typename Message>
+		[[nodiscard]] inline auto
+		receive_message(NotNull<utils::Socket> socket) noexcept -> std::optional<Message> {
+			auto message = Message();
+			if(!socket->receive_all(std::as_writable_bytes(std::span<Message>(&message, 1)))) {
+				return std::nullopt;
+			}
+			return message;
+		}
+	} // namespace detail
+
+	/// @brief Renders an image by handing its tiles out to worker processes (see `RenderWorker`),
+	/// possibly on other machines, connected over TCP or Unix domain sockets, and assembling the
+	/// tiles they send back.
+	///
+	/// Each worker owns its own copy of the scene, and renders tiles with a `TileRenderer` with the
+	/// same settings as the coordinator's. Tiles are rendered exactly as `TileRenderer::render`
+	/// would, so the assembled image is identical to one rendered by a single process, however the
+	/// tiles are distributed. Workers announce their settings, along with an application chosen
+	/// scene key identifying the scene and camera, when they connect, and are turned away if these
+	/// don't match the coordinator's.
+	///
+	/// Workers can join at any time during a render. A worker that disconnects, or stays silent
+	/// for longer than the worker timeout while it has tiles to render, is presumed dead, and its
+	/// unfinished tiles are handed out again.
+	///
+	/// The coordinator never waits on any one connection: greetings and finished tiles are
+	/// received a piece at a time, as their bytes arrive, so a slow or stalled connection (or one
+	/// that never greets the coordinator at all) doesn't hold up the rest of the render.
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class RenderCoordinator {
+	  public:
+		using Color = Color<T>;
+		using Framebuffer = Framebuffer<T>;
+		using TileRenderer = TileRenderer<T>;
+
+		/// Default time a worker can go without sending a finished tile before it's presumed dead
+		static constexpr auto DEFAULT_WORKER_TIMEOUT = std::chrono::milliseconds(60000);
+		/// The most tiles handed to a worker at once
+		static constexpr size_t MAX_JOBS_PER_WORKER = 256;
+		/// The longest a new connection can take to greet the coordinator before it's dropped
+		static constexpr auto HANDSHAKE_TIMEOUT = std::chrono::milliseconds(5000);
+
+		/// @brief Creates a `RenderCoordinator` rendering with the settings of `renderer`, for
+		/// the workers connecting to `listener`
+		///
+		/// @param renderer - The renderer whose settings the workers must share. It determines the
+		/// tiles the image is split into
+		/// @param listener - The listener workers connect to
+		/// @param scene_key - Identifies the scene and camera; workers must have the same key
+		RenderCoordinator(TileRenderer renderer, utils::Listener&& listener, uint64_t scene_key)
+			: m_renderer(std::move(renderer)), m_listener(std::move(listener)),
+			  m_settings(detail::DistributedSettings::of(m_renderer, scene_key)) {
+		}
+		RenderCoordinator(const RenderCoordinator& coordinator) noexcept = delete;
+		RenderCoordinator(RenderCoordinator&& coordinator) noexcept = default;
+		~RenderCoordinator() noexcept = default;
+
+		/// @brief Sets how long a worker can go without sending a finished tile, while it has
+		/// tiles to render, before it's presumed dead
+		///
+		/// @param timeout - The worker timeout
+		inline auto set_worker_timeout(std::chrono::milliseconds timeout) noexcept -> void {
+			m_worker_timeout = timeout;
+		}
+
+		/// @brief Sets how long to wait, without any worker connected, before giving up on the
+		/// render. Zero (the default) waits forever
+		///
+		/// @param timeout - The idle timeout
+		inline auto set_idle_timeout(std::chrono::milliseconds timeout) noexcept -> void {
+			m_idle_timeout = timeout;
+		}
+
+		/// @brief Renders the image, handing its tiles out to the workers that connect, and
+		/// returning once every tile has been rendered. Workers are then told to disconnect
+		///
+		/// @return The rendered image, or `std::nullopt` if the idle timeout expired
+		[[nodiscard]] inline auto render() noexcept -> std::optional<Framebuffer> {
+			using utils::instrumentation::Counter;
+
+			const auto tiles = m_renderer.tiles();
+			auto framebuffer = Framebuffer(m_renderer.width(), m_renderer.height());
+			auto pending = std::deque<size_t>(tiles.size());
+			for(auto index = 0ULL; index < tiles.size(); ++index) {
+				pending[index] = index;
+			}
+			utils::instrumentation::count(Counter::TilesQueued, tiles.size());
+
+			auto workers = std::vector<Worker>();
+			auto handshakes = std::vector<Handshake>();
+			auto num_rendered = 0ULL;
+			auto last_progress = Clock::now();
+			auto sockets = std::vector<utils::NativeSocket>();
+			while(num_rendered < tiles.size()) {
+				const auto assigned_at = Clock::now();
+				for(auto& worker : workers) {
+					assign_jobs(&worker, &pending, assigned_at);
+				}
+				drop_dead_workers(&workers, &pending);
+
+				// the listener, then the workers, then the connections yet to greet us
+				sockets.clear();
+				sockets.push_back(m_listener.native());
+				for(const auto& worker : workers) {
+					sockets.push_back(worker.m_socket.native());
+				}
+				for(const auto& handshake : handshakes) {
+					sockets.push_back(handshake.m_socket.native());
+				}
+				const auto ready = utils::wait_readable(sockets, POLL_INTERVAL);
+
+				const auto now = Clock::now();
+				const auto num_workers = workers.size();
+				for(auto i = 0ULL; i < num_workers; ++i) {
+					auto& worker = workers[i];
+					if(ready[i + 1]) {
+						switch(receive_tile(&worker, tiles, &framebuffer)) {
+							case Received::Complete:
+								worker.m_last_activity = now;
+								last_progress = now;
+								++num_rendered;
+								utils::instrumentation::count(Counter::TilesRendered);
+								break;
+							case Received::Partial: break;
+							case Received::Failed: worker.m_is_dead = true; break;
+						}
+					}
+					else if(!worker.m_tiles.empty()
+							&& now - worker.m_last_activity > m_worker_timeout) {
+						worker.m_is_dead = true;
+					}
+				}
+				drop_dead_workers(&workers, &pending);
+
+				for(auto i = 0ULL; i < handshakes.size(); ++i) {
+					auto& handshake = handshakes[i];
+					if(ready[num_workers + i + 1]) {
+						switch(handshake.m_hello.receive(&handshake.m_socket)) {
+							case Received::Complete:
+								if(auto worker = greeted_worker(std::move(handshake), now)) {
+									workers.push_back(std::move(*worker));
+									last_progress = now;
+								}
+								handshake.m_is_done = true;
+								break;
+							case Received::Partial: break;
+							case Received::Failed: handshake.m_is_done = true; break;
+						}
+					}
+					else if(now > handshake.m_deadline) {
+						handshake.m_is_done = true;
+					}
+				}
+				std::erase_if(handshakes,
+							  [](const Handshake& handshake) { return handshake.m_is_done; });
+
+				if(ready[0]) {
+					if(auto socket = m_listener.accept()) {
+						const auto timeout = std::min(HANDSHAKE_TIMEOUT, m_worker_timeout);
+						handshakes.push_back({std::move(*socket), now + timeout});
+					}
+				}
+
+				if(workers.empty() && m_idle_timeout.count() > 0
+				   && now - last_progress > m_idle_timeout) {
+					return std::nullopt;
+				}
+			}
+
+			for(auto& worker : workers) {
+				const auto finish = detail::Job{detail::JobKind::Finish};
+				ignore(detail::send_message(&worker.m_socket, finish));
+			}
+			return framebuffer;
+		}
+
+		auto operator=(const RenderCoordinator& coordinator) noexcept
+			-> RenderCoordinator& = delete;
+		auto operator=(RenderCoordinator&& coordinator) noexcept -> RenderCoordinator& = default;
+
+	  private:
+		using Clock = std::chrono::steady_clock;
+
+		/// How often to check for workers that have timed out
+		static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+
+		/// @brief How much of a message has been received
+		enum class Received
+		{
+			/// Some, or none, of the message has arrived so far
+			Partial = 0,
+			/// The whole message has arrived
+			Complete,
+			/// The connection failed or was closed, or the message was invalid
+			Failed
+		};
+
+		/// @brief A message being received a piece at a time, as its bytes arrive
+		struct Incoming {
+			std::vector<std::byte> m_bytes = {};
+			/// The number of bytes of the message received so far
+			size_t m_num_received = 0;
+
+			/// @brief Starts receiving a new message of `size` bytes
+			inline auto expect(size_t size) noexcept -> void {
+				m_bytes.resize(size);
+				m_num_received = 0;
+			}
+
+			/// @brief Receives the bytes of the message that have arrived on `socket`, which
+			/// `utils::wait_readable` has reported ready, without waiting for the rest
+			[[nodiscard]] inline auto receive(NotNull<utils::Socket> socket) noexcept -> Received {
+				const auto received
+					= socket->receive_some(std::span(m_bytes).subspan(m_num_received));
+				if(!received) {
+					return Received::Failed;
+				}
+				m_num_received += *received;
+				return m_num_received == m_bytes.size() ? Received::Complete : Received::Partial;
+			}
+
+			/// @brief Returns the received message, as a `Message`
+			template<typename Message>
+			[[nodiscard]] inline auto as() const noexcept -> Message {
+				auto message = Message();
+				std::memcpy(&message, m_bytes.data(), sizeof(Message));
+				return message;
+			}
+		};
+
+		IGNORE_PADDING_START
+		/// @brief A new connection that hasn't greeted the coordinator yet
+		struct Handshake {
+			utils::Socket m_socket;
+			/// When the connection is dropped if it still hasn't greeted the coordinator
+			Clock::time_point m_deadline;
+			Incoming m_hello = Incoming{std::vector<std::byte>(sizeof(detail::WorkerHello))};
+			/// Whether the connection has greeted the coordinator, or been dropped
+			bool m_is_done = false;
+		};
+
+		/// @brief A connected worker
+		struct Worker {
+			utils::Socket m_socket;
+			/// The most tiles to hand the worker at once
+			size_t m_capacity = 1;
+			/// The tiles handed to the worker that it hasn't sent back yet
+			std::vector<size_t> m_tiles = {};
+			/// When the worker last sent a tile, or was handed one while it had none
+			Clock::time_point m_last_activity = Clock::now();
+			/// The finished tile being received: its `TileResult`, then its pixels
+			Incoming m_incoming = Incoming{std::vector<std::byte>(sizeof(detail::TileResult))};
+			/// The result whose pixels are being received, if its `TileResult` has been
+			std::optional<detail::TileResult> m_result = std::nullopt;
+			bool m_is_dead = false;
+		};
+		IGNORE_PADDING_STOP
+
+		TileRenderer m_renderer;
+		utils::Listener m_listener;
+		detail::DistributedSettings m_settings;
+		std::chrono::milliseconds m_worker_timeout = DEFAULT_WORKER_TIMEOUT;
+		std::chrono::milliseconds m_idle_timeout = std::chrono::milliseconds(0);
+
+		/// @brief Makes a worker of a connection that has greeted the coordinator, checking it
+		/// renders with the same settings
+		///
+		/// @return The worker, or `std::nullopt` if it didn't greet the coordinator correctly
+		[[nodiscard]] inline auto greeted_worker(Handshake&& handshake, Clock::time_point now)
+			const noexcept -> std::optional<Worker> {
+			const auto hello = handshake.m_hello.template as<detail::WorkerHello>();
+			if(hello.m_magic != detail::DISTRIBUTED_MAGIC
+			   || hello.m_version != detail::DISTRIBUTED_VERSION || hello.m_settings != m_settings)
+			{
+				return std::nullopt;
+			}
+
+			const auto capacity = General::min(narrow_cast<size_t>(hello.m_num_threads) + 1,
+											   MAX_JOBS_PER_WORKER);
+			auto worker = Worker{std::move(handshake.m_socket)};
+			worker.m_capacity = capacity;
+			worker.m_last_activity = now;
+			return worker;
+		}
+
+		/// @brief Hands pending tiles to `worker`, up to its capacity
+		inline static auto assign_jobs(NotNull<Worker> worker,
+									   NotNull<std::deque<size_t>> pending,
+									   Clock::time_point now) noexcept -> void {
+			while(!worker->m_is_dead && !pending->empty()
+				  && worker->m_tiles.size() < worker->m_capacity) {
+				const auto tile = pending->front();
+				if(!detail::send_message(&worker->m_socket,
+										 detail::Job{detail::JobKind::RenderTile, 0, tile})) {
+					worker->m_is_dead = true;
+					return;
+				}
+
+				if(worker->m_tiles.empty()) {
+					worker->m_last_activity = now;
+				}
+				pending->pop_front();
+				worker->m_tiles.push_back(tile);
+			}
+		}
+
+		/// @brief Receives the part of a finished tile from `worker` that has arrived, writing the
+		/// tile into `framebuffer` once all of it has
+		///
+		/// @return `Received::Complete` once the whole of a tile the worker was rendering has been
+		/// received, or `Received::Failed` if the connection failed or the tile wasn't one of the
+		/// worker's
+		[[nodiscard]] inline static auto
+		receive_tile(NotNull<Worker> worker,
+					 std::span<const Tile> tiles,
+					 NotNull<Framebuffer> framebuffer) noexcept -> Received {
+			auto& incoming = worker->m_incoming;
+			const auto received = incoming.receive(&worker->m_socket);
+			if(received != Received::Complete) {
+				return received;
+			}
+
+			auto& assigned = worker->m_tiles;
+			if(!worker->m_result) {
+				const auto result = incoming.template as<detail::TileResult>();
+				const auto position = std::find(assigned.begin(), assigned.end(), result.m_tile);
+				if(position == assigned.end()) {
+					return Received::Failed;
+				}
+				const auto& tile = tiles[*position];
+				if(result.m_num_pixels != tile.m_width * tile.m_height) {
+					return Received::Failed;
+				}
+
+				worker->m_result = result;
+				incoming.expect(tile.m_width * tile.m_height * sizeof(Color));
+				return Received::Partial;
+			}
+
+			const auto& tile = tiles[worker->m_result->m_tile];
+			auto pixels = std::vector<Color>(tile.m_width * tile.m_height);
+			std::memcpy(pixels.data(), incoming.m_bytes.data(), incoming.m_bytes.size());
+			framebuffer->write(tile.m_x, tile.m_y, tile.m_width, pixels);
+			std::erase(assigned, worker->m_result->m_tile);
+			worker->m_result = std::nullopt;
+			incoming.expect(sizeof(detail::TileResult));
+			return Received::Complete;
+		}
+
+		/// @brief Disconnects dead workers, returning their unfinished tiles to the front of
+		/// `pending`, to be handed out again first
+		inline static auto drop_dead_workers(NotNull<std::vector<Worker>> workers,
+											 NotNull<std::deque<size_t>> pending) noexcept
+			-> void {
+			for(auto& worker : *workers) {
+				if(worker.m_is_dead) {
+					pending->insert(pending->begin(), worker.m_tiles.begin(), worker.m_tiles.end());
+				}
+			}
+			std::erase_if(*workers, [](const Worker& worker) { return worker.m_is_dead; });
+		}
+	};
+
+	/// @brief Renders tiles handed out by a `RenderCoordinator`, and sends them back.
+	/// Tiles are rendered concurrently on the renderer's number of threads. The connection is read
+	/// by the calling thread, which hands tiles to the rendering threads through a lock-free queue
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class RenderWorker {
+	  public:
+		using Camera = Camera<T>;
+		using Color = Color<T>;
+		using Ray = Ray<T>;
+		using TileRenderer = TileRenderer<T>;
+
+		/// @brief Renders the tiles handed out by the coordinator at the other end of
+		/// `connection`, until it has no more tiles to hand out
+		///
+		/// @param connection - The connection to the coordinator
+		/// @param renderer - The renderer to render tiles with. Its settings must match the
+		/// coordinator's
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`.
+		/// Called concurrently from all rendering threads, so must be safe to call concurrently
+		/// @param scene_key - Identifies the scene and camera; must match the coordinator's
+		///
+		/// @return Whether the coordinator finished the render. `false` if it turned this worker
+		/// away, or the connection failed
+		template<typename Shader>
+		requires std::is_invocable_r_v<Color, const Shader&, const Ray&> || BatchShader<Shader, T>
+		[[nodiscard]] inline static auto run(utils::Socket connection,
+											 const TileRenderer& renderer,
+											 const Camera& camera,
+											 const Shader& shade,
+											 uint64_t scene_key) noexcept -> bool {
+			const auto num_threads = renderer.num_threads();
+			auto hello = detail::WorkerHello();
+			hello.m_num_threads = narrow_cast<uint32_t>(num_threads);
+			hello.m_settings = detail::DistributedSettings::of(renderer, scene_key);
+			if(!detail::send_message(&connection, hello)) {
+				return false;
+			}
+
+			const auto tiles = renderer.tiles();
+			// the coordinator never hands out more tiles at once than this
+			auto jobs = utils::MpmcRingBuffer<uint64_t>(
+				General::min(num_threads + 1, RenderCoordinator<T>::MAX_JOBS_PER_WORKER));
+			auto available = std::counting_semaphore<>(0);
+			auto stopping = std::atomic_bool(false);
+			auto send_mutex = std::mutex();
+
+			auto render = [&]() noexcept {
+				while(true) {
+					available.acquire();
+					const auto tile = jobs.try_pop();
+					if(stopping.load(std::memory_order_acquire) || !tile) {
+						return;
+					}
+
+					const auto pixels = renderer.render_tile(tiles[*tile], camera, shade);
+					const auto result = detail::TileResult{*tile, pixels.size()};
+					auto lock = std::scoped_lock(send_mutex);
+					ignore(detail::send_message(&connection, result)
+						   && connection.send_all(std::as_bytes(std::span<const Color>(pixels))));
+				}
+			};
+
+			auto finished = false;
+			{
+				auto threads = std::vector<std::jthread>();
+				threads.reserve(num_threads);
+				for(auto i = 0ULL; i < num_threads; ++i) {
+					threads.emplace_back(render);
+				}
+
+				while(const auto job = detail::receive_message<detail::Job>(&connection)) {
+					if(job->m_kind == detail::JobKind::Finish) {
+						finished = true;
+						break;
+					}
+					if(job->m_kind != detail::JobKind::RenderTile || job->m_tile >= tiles.size()
+					   || !jobs.try_push(job->m_tile)) {
+						break;
+					}
+					available.release();
+				}
+
+				stopping.store(true, std::memory_order_release);
+				available.release(narrow_cast<std::ptrdiff_t>(num_threads));
+			}
+			return finished;
+		}
+	};
+} // namespace graphics
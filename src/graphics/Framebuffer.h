@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "Color.h"
+
+namespace graphics {
+
+	/// @brief A two-dimensional, row-major buffer of `Color`s.
+	/// Rows are stored top-to-bottom, in the order they are written to image files
+	///
+	/// @tparam T - The floating point type of the stored `Color`s
+	template<FloatingPoint T = float>
+	class Framebuffer {
+	  public:
+		using Color = Color<T>;
+
+		constexpr Framebuffer() noexcept = default;
+
+		/// @brief Creates a `Framebuffer` of the given dimensions, filled with black
+		///
+		/// @param width - The width of the buffer, in pixels
+		/// @param height - The height of the buffer, in pixels
+		constexpr Framebuffer(size_t width, size_t height) noexcept
+			: m_width(width), m_height(height), m_pixels(width * height) {
+		}
+		constexpr Framebuffer(const Framebuffer& buffer) noexcept = default;
+		constexpr Framebuffer(Framebuffer&& buffer) noexcept = default;
+		constexpr ~Framebuffer() noexcept = default;
+
+		/// @brief Returns the width of the buffer, in pixels
+		///
+		/// @return The width
+		[[nodiscard]] inline constexpr auto width() const noexcept -> size_t {
+			return m_width;
+		}
+
+		/// @brief Returns the height of the buffer, in pixels
+		///
+		/// @return The height
+		[[nodiscard]] inline constexpr auto height() const noexcept -> size_t {
+			return m_height;
+		}
+
+		/// @brief Returns the total number of pixels in the buffer
+		///
+		/// @return The number of pixels
+		[[nodiscard]] inline constexpr auto size() const noexcept -> size_t {
+			return m_pixels.size();
+		}
+
+		/// @brief Returns the pixel at the given column and row
+		///
+		/// @param x - The column of the pixel
+		/// @param y - The row of the pixel, counted from the top of the image
+		///
+		/// @return A const ref to the pixel
+		[[nodiscard]] inline constexpr auto at(size_t x, size_t y) const noexcept -> const Color& {
+			return m_pixels[y * m_width + x];
+		}
+
+		/// @brief Returns the pixel at the given column and row
+		///
+		/// @param x - The column of the pixel
+		/// @param y - The row of the pixel, counted from the top of the image
+		///
+		/// @return A mutable ref to the pixel
+		[[nodiscard]] inline constexpr auto at(size_t x, size_t y) noexcept -> Color& {
+			return m_pixels[y * m_width + x];
+		}
+
+		/// @brief Returns the pixels in the given row
+		///
+		/// @param y - The row, counted from the top of the image
+		///
+		/// @return The row's pixels, left to right
+		[[nodiscard]] inline constexpr auto row(size_t y) const noexcept -> std::span<const Color> {
+			return std::span<const Color>(m_pixels).subspan(y * m_width, m_width);
+		}
+
+		/// @brief Copies a rectangular block of pixels into the buffer
+		///
+		/// @param x - The column of the block's left-most pixels
+		/// @param y - The row of the block's top-most pixels, counted from the top of the image
+		/// @param width - The width of the block, in pixels
+		/// @param pixels - The block's pixels, row-major, with rows stored top-to-bottom
+		inline constexpr auto
+		write(size_t x, size_t y, size_t width, std::span<const Color> pixels) noexcept -> void {
+			for(auto offset = 0ULL; offset < pixels.size(); offset += width) {
+				std::copy_n(pixels.begin() + narrow_cast<std::ptrdiff_t>(offset),
+							width,
+							m_pixels.begin()
+								+ narrow_cast<std::ptrdiff_t>((y + offset / width) * m_width + x));
+			}
+		}
+
+		[[nodiscard]] inline constexpr auto begin() noexcept {
+			return m_pixels.begin();
+		}
+		[[nodiscard]] inline constexpr auto begin() const noexcept {
+			return m_pixels.begin();
+		}
+
+		[[nodiscard]] inline constexpr auto end() noexcept {
+			return m_pixels.end();
+		}
+		[[nodiscard]] inline constexpr auto end() const noexcept {
+			return m_pixels.end();
+		}
+
+		constexpr auto operator=(const Framebuffer& buffer) noexcept -> Framebuffer& = default;
+		constexpr auto operator=(Framebuffer&& buffer) noexcept -> Framebuffer& = default;
+
+	  private:
+		size_t m_width = 0;
+		size_t m_height = 0;
+		std::vector<Color> m_pixels;
+	};
+} // namespace graphics
@@ -1,99 +1,137 @@
 #pragma once
 
-#include <atomic>
 #include <memory>
+#include <type_traits>
 
 #include "../base/StandardIncludes.h"
+#include "BoundingBox.h"
 #include "Ray.h"
 #include "materials/Material.h"
 
 namespace graphics {
 
-	IGNORE_UNUSED_TEMPLATES_START
-	template<FloatingPoint T = float>
-	static std::atomic_bool DEFAULT_INITIALIZED;
-	template<FloatingPoint T = float>
-	[[clang::no_destroy]] static DefaultMaterial<T> DEFAULT_MATERIAL;
-
-	template<FloatingPoint T = float>
-	[[nodiscard]] inline static constexpr auto
-	initalize_default() noexcept -> NotNull<DefaultMaterial<T>> {
-		bool expected = false;
-		if(DEFAULT_INITIALIZED<T>.compare_exchange_strong(expected,
-														  true,
-														  std::memory_order_seq_cst)) {
-			DEFAULT_MATERIAL<T> = DefaultMaterial<T>();
-		}
-		return &DEFAULT_MATERIAL<T>;
-	}
-	IGNORE_UNUSED_TEMPLATES_STOP
+	template<FloatingPoint T>
+	class Geometry;
 
 	IGNORE_PADDING_START
+	/// @brief The surface at a ray's closest hit: everything a `Material` needs to scatter the
+	/// ray. Computed once the closest hit is known, from its `HitRecord`
+	///
+	/// @tparam T - The floating point type used for geometry and rays
 	template<FloatingPoint T = float>
-	struct HitRecord {
+	struct SurfaceRecord {
+		using Point2 = Point2<T>;
 		using Point3 = Point3<T>;
 		using Vec3 = Vec3<T>;
 		using Ray = Ray<T>;
 		using Material = Material<T>;
-		using DefaultMaterial = DefaultMaterial<T>;
 
 		Point3 m_point = Point3();
 		Vec3 m_normal = Vec3();
-		NotNull<Material> m_material = initalize_default<T>();
+		/// The surface's texture coordinates, for geometry that has them
+		Point2 m_uv = Point2();
+		/// The surface's material, if it isn't in a `MaterialTable`. A surface with neither this
+		/// nor a material id absorbs every ray
+		const Material* m_material = nullptr;
+		/// The id of the surface's material in the scene's `MaterialTable`, or `NO_MATERIAL_ID`
+		/// if the surface's material is `m_material`
+		uint32_t m_material_id = NO_MATERIAL_ID;
 		T m_length = static_cast<T>(0);
 		bool m_hit_outer_face = true;
 
-		constexpr HitRecord() noexcept = default;
-		explicit constexpr HitRecord(const Point3& point) noexcept : m_point(point) {
+		constexpr SurfaceRecord() noexcept = default;
+		explicit constexpr SurfaceRecord(const Point3& point) noexcept : m_point(point) {
 		}
-		explicit constexpr HitRecord(Point3&& point) noexcept : m_point(std::move(point)) {
+		explicit constexpr SurfaceRecord(Point3&& point) noexcept : m_point(std::move(point)) {
 		}
-		explicit constexpr HitRecord(const Vec3& normal) noexcept : m_normal(normal) {
+		explicit constexpr SurfaceRecord(const Vec3& normal) noexcept : m_normal(normal) {
 		}
-		explicit constexpr HitRecord(Vec3&& normal) noexcept : m_normal(std::move(normal)) {
+		explicit constexpr SurfaceRecord(Vec3&& normal) noexcept : m_normal(std::move(normal)) {
 		}
-		constexpr HitRecord(const Point3& point, const Vec3& normal) noexcept
+		constexpr SurfaceRecord(const Point3& point, const Vec3& normal) noexcept
 			: m_point(point), m_normal(normal) {
 		}
-		constexpr HitRecord(Point3&& point, const Vec3& normal) noexcept
+		constexpr SurfaceRecord(Point3&& point, const Vec3& normal) noexcept
 			: m_point(std::move(point)), m_normal(normal) {
 		}
-		constexpr HitRecord(const Point3& point, Vec3&& normal) noexcept
+		constexpr SurfaceRecord(const Point3& point, Vec3&& normal) noexcept
 			: m_point(point), m_normal(std::move(normal)) {
 		}
-		constexpr HitRecord(Point3&& point, Vec3&& normal) noexcept
+		constexpr SurfaceRecord(Point3&& point, Vec3&& normal) noexcept
 			: m_point(std::move(point)), m_normal(std::move(normal)) {
 		}
-		constexpr HitRecord(const Point3& point, const Vec3& normal, T length) noexcept
+		constexpr SurfaceRecord(const Point3& point, const Vec3& normal, T length) noexcept
 			: m_point(point), m_normal(normal), m_length(length) {
 		}
-		constexpr HitRecord(Point3&& point, const Vec3& normal, T length) noexcept
+		constexpr SurfaceRecord(Point3&& point, const Vec3& normal, T length) noexcept
 			: m_point(std::move(point)), m_normal(normal), m_length(length) {
 		}
-		constexpr HitRecord(const Point3& point, Vec3&& normal, T length) noexcept
+		constexpr SurfaceRecord(const Point3& point, Vec3&& normal, T length) noexcept
 			: m_point(point), m_normal(std::move(normal)), m_length(length) {
 		}
-		constexpr HitRecord(Point3&& point, Vec3&& normal, T length) noexcept
+		constexpr SurfaceRecord(Point3&& point, Vec3&& normal, T length) noexcept
 			: m_point(std::move(point)), m_normal(std::move(normal)), m_length(length) {
 		}
-		constexpr HitRecord(const HitRecord& record) noexcept = default;
-		constexpr HitRecord(HitRecord&& record) noexcept = default;
+		constexpr SurfaceRecord(const SurfaceRecord& record) noexcept = default;
+		constexpr SurfaceRecord(SurfaceRecord&& record) noexcept = default;
 
 		constexpr inline auto set_normal(const Ray& ray, const Vec3& normal) noexcept -> void {
 			m_hit_outer_face = ray.direction().dot_prod(normal) < 0;
 			m_normal = m_hit_outer_face ? normal : -normal;
 		}
 
-		constexpr auto operator=(const HitRecord& record) noexcept -> HitRecord& = default;
-		constexpr auto operator=(HitRecord&& record) noexcept -> HitRecord& = default;
+		constexpr auto operator=(const SurfaceRecord& record) noexcept -> SurfaceRecord& = default;
+		constexpr auto operator=(SurfaceRecord&& record) noexcept -> SurfaceRecord& = default;
+	};
+
+	/// @brief A hit of a ray on a geometry, as found while searching for the closest hit.
+	/// Holds only what that search needs, so it's small and trivially constructible: the surface
+	/// at the hit (point, normal, etc.) is computed afterwards, for the closest hit only, with
+	/// `surface`.
+	///
+	/// Like any trivial type, a default-initialized `HitRecord` is uninitialized; it's only
+	/// meaningful once a geometry has reported a hit through it
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	struct HitRecord {
+		using Ray = Ray<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+
+		/// The length along the ray of the hit
+		T m_length;
+		/// The index of the hit primitive within `m_geometry`
+		uint32_t m_primitive_id;
+		/// The id of the hit surface's material in the scene's `MaterialTable`, or
+		/// `NO_MATERIAL_ID`
+		uint32_t m_material_id;
+		/// The (leaf) geometry that was hit
+		const Geometry<T>* m_geometry;
+		/// The `Instance` `m_geometry` was hit through, or `nullptr` if it was hit directly.
+		/// Its surface is then computed in the instance's object space
+		const Geometry<T>* m_instance;
+
+		/// @brief Computes the surface at this hit
+		///
+		/// @param ray - The ray that hit the surface
+		///
+		/// @return The surface at the hit
+		[[nodiscard]] inline auto surface(const Ray& ray) const noexcept -> SurfaceRecord;
 	};
 	IGNORE_PADDING_STOP
 
+	static_assert(std::is_trivially_default_constructible_v<HitRecord<float>>
+					  && std::is_trivially_copyable_v<HitRecord<float>>,
+				  "HitRecord must stay trivial, so traversal can create records for free");
+	static_assert(sizeof(HitRecord<double>) <= 32, "HitRecord should stay within 32 bytes");
+
 	template<FloatingPoint T = float>
 	class Geometry {
 	  public:
 		using Ray = Ray<T>;
 		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
 
 		constexpr Geometry() noexcept = default;
 		constexpr Geometry(const Geometry& entity) noexcept = default;
@@ -106,7 +144,33 @@ namespace graphics {
 										   NotNull<HitRecord> record) const noexcept -> bool
 			= 0;
 
+		/// @brief Computes the surface at a hit this geometry reported through `intersected`.
+		/// Only leaf geometries, which set `HitRecord::m_geometry` to themselves, and instances,
+		/// which set `HitRecord::m_instance`, are asked for surfaces directly
+		///
+		/// @param ray - The ray that hit the geometry
+		/// @param record - The hit
+		///
+		/// @return The surface at the hit. `HitRecord::surface` fills in its length and
+		/// material id
+		[[nodiscard]] virtual auto
+		surface(const Ray& ray, const HitRecord& record) const noexcept -> SurfaceRecord = 0;
+
+		/// @brief Returns the axis-aligned box bounding this geometry
+		///
+		/// @return The bounding box
+		[[nodiscard]] virtual constexpr auto bounding_box() const noexcept -> BoundingBox = 0;
+
 		constexpr auto operator=(const Geometry& entity) noexcept -> Geometry& = default;
 		constexpr auto operator=(Geometry&& entity) noexcept -> Geometry& = default;
 	};
+
+	template<FloatingPoint T>
+	inline auto HitRecord<T>::surface(const Ray& ray) const noexcept -> SurfaceRecord {
+		auto record = m_instance != nullptr ? m_instance->surface(ray, *this) :
+											  m_geometry->surface(ray, *this);
+		record.m_length = m_length;
+		record.m_material_id = m_material_id;
+		return record;
+	}
 } // namespace graphics
@@ -14,6 +14,8 @@ namespace graphics {
 		using Geometry = Geometry<T>;
 		using Ray = Ray<T>;
 		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
 
 	  public:
 		constexpr GeometryList() noexcept = default;
@@ -40,25 +42,58 @@ namespace graphics {
 			m_geometries.push_back(std::make_unique<GeometryType>(args...));
 		}
 
+		/// @brief Returns the number of geometries in the list
+		///
+		/// @return The number of geometries
+		[[nodiscard]] inline constexpr auto size() const noexcept -> size_t {
+			return m_geometries.size();
+		}
+
+		/// @brief Releases ownership of the geometries in the list to the caller,
+		/// leaving the list empty
+		///
+		/// @return The geometries previously in the list
+		[[nodiscard]] inline constexpr auto
+		release() noexcept -> std::vector<std::unique_ptr<Geometry>> {
+			auto geometries = std::move(m_geometries);
+			m_geometries.clear();
+			return geometries;
+		}
+
 		inline constexpr auto intersected(const Ray& ray,
 										  T min_length,
 										  T max_length,
 										  NotNull<HitRecord> record) const noexcept -> bool final {
-			HitRecord temp_record = {};
 			auto hit_found = false;
 			auto closest = max_length;
 
+			// geometries only write to `record` when they find a closer hit, so it always holds
+			// the closest hit so far
 			for(const auto& geometry : m_geometries) {
-				if(geometry->intersected(ray, min_length, closest, &temp_record)) {
+				if(geometry->intersected(ray, min_length, closest, record)) {
 					hit_found = true;
-					closest = temp_record.m_length;
-					*record = temp_record;
+					closest = record->m_length;
 				}
 			}
 
 			return hit_found;
 		}
 
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			// hits are reported by the leaf geometry that was hit, or by the `Instance` it was hit
+			// through, if any, and `HitRecord::surface` asks whichever it was
+			return record.surface(ray);
+		}
+
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox final {
+			auto box = BoundingBox();
+			for(const auto& geometry : m_geometries) {
+				box = box.merged(geometry->bounding_box());
+			}
+			return box;
+		}
+
 		constexpr auto operator=(const GeometryList& list) noexcept -> GeometryList& = default;
 		constexpr auto operator=(GeometryList&& list) noexcept -> GeometryList& = default;
 
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "Color.h"
+#include "Framebuffer.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint8_t;
+#endif
+
+	/// @brief Encodes linear color values as 8-bit, gamma corrected values, in bulk.
+	/// Rather than computing `pow` for every channel of every pixel, the linear-space threshold
+	/// of each of the 256 output codes is computed once, up front. Encoding a channel is then a
+	/// branchless binary search over those thresholds. The result is that of quantizing
+	/// `value^(1 / gamma)` to [0, 255], as `Color::write` does, except that values within
+	/// rounding error of a code's threshold can land one code either side of it
+	///
+	/// @tparam T - The floating point type of the linear color values
+	template<FloatingPoint T = float>
+	class GammaEncoder {
+	  public:
+		using Color = Color<T>;
+
+		/// @brief Creates a `GammaEncoder` for the given gamma
+		///
+		/// @param gamma - The gamma to encode with
+		explicit GammaEncoder(T gamma) noexcept {
+			// code `k` covers linear values in [(k / 256)^gamma, ((k + 1) / 256)^gamma)
+			m_thresholds[0] = -Constants<T>::infinity;
+			for(auto code = 1ULL; code < NUM_CODES; ++code) {
+				m_thresholds[code] = std::pow(narrow_cast<T>(code) / narrow_cast<T>(NUM_CODES),
+											  gamma);
+			}
+		}
+		GammaEncoder(const GammaEncoder& encoder) noexcept = default;
+		GammaEncoder(GammaEncoder&& encoder) noexcept = default;
+		~GammaEncoder() noexcept = default;
+
+		/// @brief Encodes a single linear value
+		///
+		/// @param value - The linear value to encode
+		///
+		/// @return The 8-bit, gamma corrected value
+		[[nodiscard]] inline auto encode(T value) const noexcept -> uint8_t {
+			// find the last threshold <= value, ie: the code whose range contains value
+			auto code = 0ULL;
+			for(auto step = NUM_CODES / 2; step > 0; step /= 2) {
+				code += m_thresholds[code + step] <= value ? step : 0ULL;
+			}
+			return narrow_cast<uint8_t>(code);
+		}
+
+		/// @brief Encodes a row of colors as packed, 8-bit RGB triples
+		///
+		/// @param colors - The colors to encode
+		/// @param out - Where to write the encoded colors. Must hold `3 * colors.size()` bytes
+		inline auto
+		encode(std::span<const Color> colors, std::span<uint8_t> out) const noexcept -> void {
+			for(auto i = 0ULL; i < colors.size(); ++i) {
+				out[3 * i] = encode(colors[i].r());
+				out[3 * i + 1] = encode(colors[i].g());
+				out[3 * i + 2] = encode(colors[i].b());
+			}
+		}
+
+		auto operator=(const GammaEncoder& encoder) noexcept -> GammaEncoder& = default;
+		auto operator=(GammaEncoder&& encoder) noexcept -> GammaEncoder& = default;
+
+	  private:
+		static constexpr size_t NUM_CODES = 256;
+
+		std::array<T, NUM_CODES> m_thresholds = {};
+	};
+
+	/// @brief Writes `Framebuffer`s to binary image files.
+	/// Pixels are converted and written a row at a time, with one bulk write per row
+	///
+	/// @tparam T - The floating point type of the framebuffer's `Color`s
+	template<FloatingPoint T = float>
+	class ImageWriter {
+	  public:
+		using Framebuffer = Framebuffer<T>;
+		using GammaEncoder = GammaEncoder<T>;
+
+		/// @brief Writes `framebuffer` to `out` as a binary (P6) PPM, gamma corrected with
+		/// `gamma`.
+		/// `out` should be opened in binary mode
+		///
+		/// @param out - The stream to write to
+		/// @param framebuffer - The image to write
+		/// @param gamma - The gamma to correct the image with
+		///
+		/// @return Whether the image was written successfully
+		inline static auto
+		write_ppm(std::ostream& out, const Framebuffer& framebuffer, T gamma) noexcept -> bool {
+			out << "P6\n" << framebuffer.width() << ' ' << framebuffer.height() << "\n255\n";
+
+			const auto encoder = GammaEncoder(gamma);
+			auto row = std::vector<uint8_t>(3 * framebuffer.width());
+			for(auto y = 0ULL; y < framebuffer.height(); ++y) {
+				encoder.encode(framebuffer.row(y), row);
+				out.write(reinterpret_cast<const char*>(row.data()), // NOLINT
+						  narrow_cast<std::streamsize>(row.size()));
+			}
+
+			return out.good();
+		}
+
+		/// @brief Writes `framebuffer` to `out` as a Portable Float Map (PFM): linear, 32-bit
+		/// floating point RGB with no loss of dynamic range.
+		/// `out` should be opened in binary mode
+		///
+		/// @param out - The stream to write to
+		/// @param framebuffer - The image to write
+		///
+		/// @return Whether the image was written successfully
+		inline static auto
+		write_pfm(std::ostream& out, const Framebuffer& framebuffer) noexcept -> bool {
+			// a negative scale marks the data as little-endian, positive as big-endian
+			out << "PF\n"
+				<< framebuffer.width() << ' ' << framebuffer.height() << '\n'
+				<< (std::endian::native == std::endian::little ? "-1.0" : "1.0") << '\n';
+
+			auto row = std::vector<float>(3 * framebuffer.width());
+			// PFM stores rows bottom-to-top
+			for(auto y = framebuffer.height(); y > 0; --y) {
+				const auto colors = framebuffer.row(y - 1);
+				for(auto x = 0ULL; x < colors.size(); ++x) {
+					row[3 * x] = narrow_cast<float>(colors[x].r());
+					row[3 * x + 1] = narrow_cast<float>(colors[x].g());
+					row[3 * x + 2] = narrow_cast<float>(colors[x].b());
+				}
+				out.write(reinterpret_cast<const char*>(row.data()), // NOLINT
+						  narrow_cast<std::streamsize>(row.size() * sizeof(float)));
+			}
+
+			return out.good();
+		}
+
+		/// @brief Writes `framebuffer` to the file at `path`, choosing the format from its
+		/// extension: PFM for ".pfm", otherwise binary PPM
+		///
+		/// @param path - The path of the file to write
+		/// @param framebuffer - The image to write
+		/// @param gamma - The gamma to correct the image with, if the format is not linear
+		///
+		/// @return Whether the image was written successfully
+		inline static auto
+		write(const std::string& path, const Framebuffer& framebuffer, T gamma) noexcept -> bool {
+			auto file = std::ofstream(path, std::ios::binary);
+			if(!file) {
+				return false;
+			}
+
+			const auto extension = std::string(".pfm");
+			if(path.size() >= extension.size()
+			   && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+			{
+				return write_pfm(file, framebuffer);
+			}
+			return write_ppm(file, framebuffer, gamma);
+		}
+	};
+} // namespace graphics
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "../base/StandardIncludes.h"
+#include "../math/Transform.h"
+#include "BoundingBox.h"
+#include "Geometry.h"
+#include "Ray.h"
+
+namespace graphics {
+
+	/// @brief A placement of a shared object in the scene, through an affine transform.
+	/// The object (typically a pre-built `BoundingVolumeHierarchy` or `TriangleMesh`) is defined in
+	/// its own object space, and shared between any number of instances, so the memory used by a
+	/// scene scales with its unique geometry rather than with how often that geometry is placed.
+	///
+	/// Rays are intersected with the object by transforming them into object space. Directions
+	/// aren't renormalized, so lengths along a ray are the same in both spaces, and hits on
+	/// different instances can be compared directly. The surface at a hit is computed in object
+	/// space, and transformed back into world space.
+	///
+	/// Instances are a single level deep: an instance's object must not itself contain instances.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class Instance final : public Geometry<T> {
+		using Geometry = Geometry<T>;
+		using Point3 = Point3<T>;
+		using Ray = Ray<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
+
+	  public:
+		using Transform = math::Transform<T>;
+
+		/// @brief Creates an `Instance` of `object`, placed by `object_to_world`
+		///
+		/// @param object - The object to place. Must not be null
+		/// @param object_to_world - The transform from the object's space to world space. Must be
+		/// invertible
+		Instance(std::shared_ptr<const Geometry> object, const Transform& object_to_world) noexcept
+			: m_object(std::move(object)) {
+			set_transform(object_to_world);
+		}
+		Instance(const Instance& instance) noexcept = default;
+		Instance(Instance&& instance) noexcept = default;
+		~Instance() noexcept final = default;
+
+		/// @brief Returns the instanced object
+		///
+		/// @return The object
+		[[nodiscard]] inline auto
+		object() const noexcept -> const std::shared_ptr<const Geometry>& {
+			return m_object;
+		}
+
+		/// @brief Returns the transform from the object's space to world space
+		///
+		/// @return The transform
+		[[nodiscard]] inline constexpr auto transform() const noexcept -> const Transform& {
+			return m_object_to_world;
+		}
+
+		/// @brief Moves the instance, placing the object by `object_to_world` instead
+		///
+		/// @param object_to_world - The transform from the object's space to world space. Must be
+		/// invertible
+		inline auto set_transform(const Transform& object_to_world) noexcept -> void {
+			m_object_to_world = object_to_world;
+			m_world_to_object = object_to_world.inverse();
+			m_bounds = transformed_bounds(m_object->bounding_box());
+		}
+
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record) const noexcept -> bool final {
+			if(!m_object->intersected(to_object(ray), min_length, max_length, record)) {
+				return false;
+			}
+
+			record->m_instance = this;
+			return true;
+		}
+
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			auto surface = record.m_geometry->surface(to_object(ray), record);
+			surface.m_point = m_object_to_world.transform_point(surface.m_point);
+			// the transposed inverse keeps the normal perpendicular to the transformed surface,
+			// and on the same side of it as the ray
+			surface.m_normal = m_world_to_object.transform_normal(surface.m_normal).normalized();
+			return surface;
+		}
+
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox final {
+			return m_bounds;
+		}
+
+		auto operator=(const Instance& instance) noexcept -> Instance& = default;
+		auto operator=(Instance&& instance) noexcept -> Instance& = default;
+
+	  private:
+		std::shared_ptr<const Geometry> m_object;
+		Transform m_object_to_world = Transform();
+		Transform m_world_to_object = Transform();
+		/// The world space bounds of the transformed object
+		BoundingBox m_bounds = BoundingBox();
+
+		/// @brief Transforms `ray` from world space into the object's space
+		[[nodiscard]] inline auto to_object(const Ray& ray) const noexcept -> Ray {
+			return {m_world_to_object.transform_point(ray.origin()),
+					m_world_to_object.transform_vector(ray.direction())};
+		}
+
+		/// @brief Returns the world space box bounding the transformed corners of `bounds`
+		[[nodiscard]] inline auto
+		transformed_bounds(const BoundingBox& bounds) const noexcept -> BoundingBox {
+			if(bounds.is_empty()) {
+				return BoundingBox();
+			}
+
+			const auto corners = std::array<Point3, 2>{bounds.min(), bounds.max()};
+			auto transformed = BoundingBox();
+			for(auto corner = 0U; corner < 8U; ++corner) {
+				const auto point = Point3(corners[corner & 1U].x(),
+										  corners[(corner >> 1U) & 1U].y(),
+										  corners[(corner >> 2U) & 1U].z());
+				transformed = transformed.merged(m_object_to_world.transform_point(point));
+			}
+			return transformed;
+		}
+	};
+} // namespace graphics
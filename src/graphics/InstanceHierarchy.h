@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "BoundingBox.h"
+#include "BvhTree.h"
+#include "Geometry.h"
+#include "Instance.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
+	/// @brief The top level of a two-level acceleration structure: a Bounding Volume Hierarchy
+	/// (see `BvhTree`) over `Instance`s of shared, pre-built objects, which are the bottom level.
+	///
+	/// Only the instances' bounds are in the tree, so moving instances (see `set_transform`) only
+	/// requires rebuilding the tree over the instances, which is cheap compared to rebuilding the
+	/// structures of the objects themselves.
+	///
+	/// Instances added or moved aren't traced until the tree is rebuilt with `rebuild`.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class InstanceHierarchy final : public Geometry<T> {
+		using Geometry = Geometry<T>;
+		using Ray = Ray<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
+		using BvhTree = BvhTree<T>;
+
+	  public:
+		using Instance = Instance<T>;
+		using Transform = typename Instance::Transform;
+
+		InstanceHierarchy() noexcept = default;
+
+		/// @brief Builds an `InstanceHierarchy` over the given instances
+		///
+		/// @param instances - The instances to build the hierarchy over
+		/// @param settings - How to build the tree over the instances, whenever it's rebuilt
+		explicit InstanceHierarchy(std::vector<Instance>&& instances,
+								   const BvhBuildSettings& settings = BvhBuildSettings()) noexcept
+			: m_instances(std::move(instances)), m_settings(settings) {
+			rebuild();
+		}
+		InstanceHierarchy(const InstanceHierarchy& hierarchy) noexcept = delete;
+		InstanceHierarchy(InstanceHierarchy&& hierarchy) noexcept = default;
+		~InstanceHierarchy() noexcept final = default;
+
+		/// @brief Adds an instance of `object`, placed by `object_to_world`.
+		/// It isn't traced until the hierarchy is rebuilt
+		///
+		/// @param object - The object to place
+		/// @param object_to_world - The transform from the object's space to world space
+		///
+		/// @return The index of the new instance
+		inline auto add(std::shared_ptr<const Geometry> object,
+						const Transform& object_to_world) noexcept -> size_t {
+			m_instances.emplace_back(std::move(object), object_to_world);
+			return m_instances.size() - 1;
+		}
+
+		/// @brief Returns the number of instances in the hierarchy
+		///
+		/// @return The number of instances
+		[[nodiscard]] inline auto size() const noexcept -> size_t {
+			return m_instances.size();
+		}
+
+		/// @brief Returns the instances, in the order they were added
+		///
+		/// @return The instances
+		[[nodiscard]] inline auto instances() const noexcept -> std::span<const Instance> {
+			return m_instances;
+		}
+
+		/// @brief Moves the instance at `index`, placing its object by `object_to_world`.
+		/// The move isn't traced until the hierarchy is rebuilt
+		///
+		/// @param index - The index of the instance to move
+		/// @param object_to_world - The transform from the object's space to world space
+		inline auto set_transform(size_t index, const Transform& object_to_world) noexcept -> void {
+			m_instances[index].set_transform(object_to_world);
+		}
+
+		/// @brief Sets how to build the tree over the instances, from the next rebuild on.
+		/// Eg: `BvhBuildMethod::Linear` for instances moved every frame
+		///
+		/// @param settings - How to build the tree
+		inline auto set_build_settings(const BvhBuildSettings& settings) noexcept -> void {
+			m_settings = settings;
+		}
+
+		/// @brief Rebuilds the tree over the instances' current bounds
+		inline auto rebuild() noexcept -> void {
+			auto bounds = std::vector<BoundingBox>();
+			bounds.reserve(m_instances.size());
+			for(const auto& instance : m_instances) {
+				bounds.push_back(instance.bounding_box());
+			}
+
+			m_tree = BvhTree(bounds, &m_order, m_settings);
+		}
+
+		/// @brief Returns the nodes of the flattened tree, root first
+		///
+		/// @return The nodes
+		[[nodiscard]] inline constexpr auto
+		nodes() const noexcept -> std::span<const typename BvhTree::Node> {
+			return m_tree.nodes();
+		}
+
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record) const noexcept -> bool final {
+			return m_tree.intersected(ray,
+									  min_length,
+									  max_length,
+									  record,
+									  [&](uint32_t index, T closest) noexcept -> bool {
+										  return m_instances[m_order[index]].intersected(ray,
+																						 min_length,
+																						 closest,
+																						 record);
+									  });
+		}
+
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			// hits are always reported through the instance that was hit
+			return record.m_instance->surface(ray, record);
+		}
+
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox final {
+			return m_tree.bounding_box();
+		}
+
+		auto operator=(const InstanceHierarchy& hierarchy) noexcept -> InstanceHierarchy& = delete;
+		auto operator=(InstanceHierarchy&& hierarchy) noexcept -> InstanceHierarchy& = default;
+
+	  private:
+		/// The instances, in the order they were added
+		std::vector<Instance> m_instances;
+		/// The index in `m_instances` of the instance the tree's leaves refer to by each index
+		std::vector<uint32_t> m_order;
+		BvhBuildSettings m_settings = BvhBuildSettings();
+		BvhTree m_tree;
+	};
+} // namespace graphics
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "../base/StandardIncludes.h"
+#include "../utils/Instrumentation.h"
+#include "Color.h"
+#include "Geometry.h"
+#include "Ray.h"
+#include "materials/MaterialTable.h"
+
+namespace graphics {
+
+	/// @brief Computes the color seen along a camera ray by tracing a single path through the
+	/// scene, bounce by bounce.
+	/// The path's throughput (the product of the attenuations along it so far) is carried forward
+	/// iteratively instead of recursing once per bounce. After `min_bounces` bounces, paths are
+	/// terminated by Russian roulette with a probability based on their throughput, and surviving
+	/// paths are reweighted to compensate. Low-contribution paths therefore end early, while the
+	/// expected value of every pixel, and so the image, stays unbiased.
+	///
+	/// `PathIntegrator` is callable with a `Ray`, so it can be passed to `TileRenderer::render`
+	/// directly as the shader.
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class PathIntegrator {
+	  public:
+		using Color = Color<T>;
+		using Geometry = Geometry<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using MaterialTable = MaterialTable<T>;
+		using Ray = Ray<T>;
+
+		/// Default maximum number of bounces along a path
+		static constexpr size_t DEFAULT_MAX_DEPTH = 50;
+		/// Default number of bounces before Russian roulette starts terminating paths
+		static constexpr size_t DEFAULT_MIN_BOUNCES = 3;
+
+		/// @brief Creates a `PathIntegrator` tracing paths through `scene`, whose geometry refers
+		/// to its materials by pointer. Geometry with material ids needs a `MaterialTable`; see
+		/// the constructor below. Hits on such geometry are counted as
+		/// `Counter::UnresolvedMaterialIds`
+		///
+		/// @param scene - The scene to trace paths through. Must outlive the integrator
+		/// @param max_depth - The maximum number of bounces along a path
+		/// @param min_bounces - The number of bounces before Russian roulette starts. Pass
+		/// `max_depth` or greater to disable Russian roulette
+		explicit PathIntegrator(const Geometry& scene,
+								size_t max_depth = DEFAULT_MAX_DEPTH,
+								size_t min_bounces = DEFAULT_MIN_BOUNCES) noexcept
+			: m_scene(&scene), m_max_depth(max_depth), m_min_bounces(min_bounces) {
+		}
+
+		/// @brief Creates a `PathIntegrator` tracing paths through `scene`, whose geometry refers
+		/// to materials in `materials` by id
+		///
+		/// @param scene - The scene to trace paths through. Must outlive the integrator
+		/// @param materials - The materials of the scene. Must outlive the integrator
+		/// @param max_depth - The maximum number of bounces along a path
+		/// @param min_bounces - The number of bounces before Russian roulette starts. Pass
+		/// `max_depth` or greater to disable Russian roulette
+		PathIntegrator(const Geometry& scene,
+					   const MaterialTable& materials,
+					   size_t max_depth = DEFAULT_MAX_DEPTH,
+					   size_t min_bounces = DEFAULT_MIN_BOUNCES) noexcept
+			: m_scene(&scene),
+			  m_materials(&materials),
+			  m_max_depth(max_depth),
+			  m_min_bounces(min_bounces) {
+		}
+		PathIntegrator(const PathIntegrator& integrator) noexcept = default;
+		PathIntegrator(PathIntegrator&& integrator) noexcept = default;
+		~PathIntegrator() noexcept = default;
+
+		/// @brief Traces a path starting along `ray`
+		///
+		/// @param ray - The ray to start the path along
+		///
+		/// @return The color seen along `ray`
+		[[nodiscard]] inline auto operator()(const Ray& ray) const noexcept -> Color {
+			auto throughput = Color(narrow_cast<T>(1), narrow_cast<T>(1), narrow_cast<T>(1));
+			auto current = ray;
+
+			for(auto bounce = 0ULL; bounce < m_max_depth; ++bounce) {
+				auto hit = HitRecord();
+				if(!m_scene->intersected(current, narrow_cast<T>(0), Constants<T>::infinity, &hit))
+				{
+					return throughput * background(current);
+				}
+				const auto record = hit.surface(current);
+
+				auto attenuation = Color();
+				auto scattered = Ray();
+				if(!scatter(current, record, &attenuation, &scattered)) {
+					return BLACK;
+				}
+				throughput *= attenuation;
+
+				if(bounce + 1 >= m_min_bounces && !survives_roulette(&throughput)) {
+					return BLACK;
+				}
+
+				current = scattered;
+				utils::instrumentation::count(utils::instrumentation::Counter::SecondaryRays);
+			}
+
+			return BLACK;
+		}
+
+		/// @brief Returns the color seen along a ray that leaves the scene: a vertical gradient
+		/// from white to light blue
+		///
+		/// @param ray - The ray leaving the scene
+		///
+		/// @return The background color
+		[[nodiscard]] inline static constexpr auto background(const Ray& ray) noexcept -> Color {
+			const auto normalized_dir = ray.direction().template normalized<T>();
+			const auto length = narrow_cast<T>(0.5) * (normalized_dir.y() + narrow_cast<T>(1));
+			return (narrow_cast<T>(1) - length)
+					   * Color(narrow_cast<T>(1), narrow_cast<T>(1), narrow_cast<T>(1))
+				   + length * Color(narrow_cast<T>(0.5), narrow_cast<T>(0.7), narrow_cast<T>(1));
+		}
+
+		/// @brief Plays Russian roulette with a path: terminates it with a probability based on its
+		/// throughput, and otherwise reweights its throughput to compensate, so the expected
+		/// color along it is unchanged
+		///
+		/// @param throughput - The throughput of the path, reweighted if it survives
+		///
+		/// @return Whether the path survives
+		[[nodiscard]] inline static auto survives_roulette(NotNull<Color> throughput) noexcept
+			-> bool {
+			const auto survival_probability = General::min(
+				General::max(throughput->r(), General::max(throughput->g(), throughput->b())),
+				MAX_SURVIVAL_PROBABILITY);
+			if(random_value<T>() >= survival_probability) {
+				return false;
+			}
+			*throughput /= survival_probability;
+			return true;
+		}
+
+		auto operator=(const PathIntegrator& integrator) noexcept -> PathIntegrator& = default;
+		auto operator=(PathIntegrator&& integrator) noexcept -> PathIntegrator& = default;
+
+	  private:
+		/// @brief Scatters `ray` off the surface described by `record`, through the material
+		/// table if the integrator has one, otherwise through the virtual `Material` interface
+		inline auto scatter(const Ray& ray,
+							const SurfaceRecord& record,
+							NotNull<Color> attenuation,
+							NotNull<Ray> scattered) const noexcept -> bool {
+			if(m_materials != nullptr) {
+				return m_materials->scatter(ray, record, attenuation, scattered);
+			}
+			if(record.m_material_id != NO_MATERIAL_ID) {
+				utils::instrumentation::count(
+					utils::instrumentation::Counter::UnresolvedMaterialIds);
+			}
+			if(record.m_material == nullptr) {
+				return false;
+			}
+			utils::instrumentation::count(utils::instrumentation::Counter::VirtualScatters);
+			return record.m_material->scatter(ray, record, attenuation, scattered);
+		}
+
+		static constexpr Color BLACK = Color(narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0));
+		/// Upper bound on the Russian roulette survival probability, so paths bouncing between
+		/// (nearly) perfect reflectors still terminate
+		static constexpr T MAX_SURVIVAL_PROBABILITY = narrow_cast<T>(0.95);
+
+		NotNull<const Geometry> m_scene;
+		const MaterialTable* m_materials = nullptr;
+		size_t m_max_depth;
+		size_t m_min_bounces;
+	};
+} // namespace graphics
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+
+#include "../base/StandardIncludes.h"
+#include "Color.h"
+#include "GeometryList.h"
+#include "Sphere.h"
+#include "materials/Dielectric.h"
+#include "materials/Lambertian.h"
+#include "materials/MaterialTable.h"
+#include "materials/Metal.h"
+
+namespace graphics {
+
+	/// @brief Builds the scene rendered by `RayTracer`: three large spheres, one of each material
+	/// kind, amid a grid of small spheres of random materials, on a large ground sphere.
+	/// The small spheres are drawn from the calling thread's random number generator, so seed it
+	/// first (see `math::seed_random`) for the same scene every time
+	///
+	/// @param materials - The table to add the scene's materials to
+	///
+	/// @return The scene's spheres, referring to their materials in `materials` by id
+	template<FloatingPoint T = float>
+	inline auto random_scene(MaterialTable<T>& materials) noexcept -> GeometryList<T> {
+		using Color = Color<T>;
+		using Point3 = Point3<T>;
+		using Sphere = Sphere<T>;
+		using Vec3 = Vec3<T>;
+
+		auto list = GeometryList<T>();
+		const auto gray = narrow_cast<T>(0.5);
+		list.template add<Sphere>(std::make_unique<Sphere>(
+			Point3(narrow_cast<T>(0), narrow_cast<T>(-1000), narrow_cast<T>(0)),
+			narrow_cast<T>(1000),
+			materials.add(Lambertian<T>(Color(gray, gray, gray)))));
+
+		const auto small_radius = narrow_cast<T>(0.2);
+		const auto jitter = narrow_cast<T>(0.9);
+		for(auto a = -11; a < 11; ++a) {
+			for(auto b = -11; b < 11; ++b) {
+				const auto choose_mat = random_value<T>();
+				const auto center = Point3(narrow_cast<T>(a) + jitter * random_value<T>(),
+										   small_radius,
+										   narrow_cast<T>(b) + jitter * random_value<T>());
+				const auto clearing = Point3(narrow_cast<T>(4), small_radius, narrow_cast<T>(0));
+				if((center - clearing).as_vec().magnitude() <= jitter) {
+					continue;
+				}
+
+				auto material_id = 0U;
+				if(choose_mat < narrow_cast<T>(0.8)) {
+					const auto albedo = Color(Vec3::random()) * Color(Vec3::random());
+					material_id = materials.add(Lambertian<T>(albedo));
+				}
+				else if(choose_mat < narrow_cast<T>(0.95)) {
+					const auto albedo = Color(Vec3::random(narrow_cast<T>(0.5), narrow_cast<T>(1)));
+					const auto fuzz = random_value(narrow_cast<T>(0), narrow_cast<T>(0.5));
+					material_id = materials.add(Metal<T>(albedo, fuzz));
+				}
+				else {
+					material_id = materials.add(Dielectric<T>(narrow_cast<T>(1.5)));
+				}
+				list.template add<Sphere>(
+					std::make_unique<Sphere>(center, small_radius, material_id));
+			}
+		}
+
+		list.template add<Sphere>(std::make_unique<Sphere>(
+			Point3(narrow_cast<T>(0), narrow_cast<T>(1), narrow_cast<T>(0)),
+			narrow_cast<T>(1),
+			materials.add(Dielectric<T>(narrow_cast<T>(1.5)))));
+		list.template add<Sphere>(std::make_unique<Sphere>(
+			Point3(narrow_cast<T>(-4), narrow_cast<T>(1), narrow_cast<T>(0)),
+			narrow_cast<T>(1),
+			materials.add(Lambertian<T>(
+				Color(narrow_cast<T>(0.4), narrow_cast<T>(0.2), narrow_cast<T>(0.1))))));
+		list.template add<Sphere>(std::make_unique<Sphere>(
+			Point3(narrow_cast<T>(4), narrow_cast<T>(1), narrow_cast<T>(0)),
+			narrow_cast<T>(1),
+			materials.add(Metal<T>(
+				Color(narrow_cast<T>(0.7), narrow_cast<T>(0.6), narrow_cast<T>(0.5)),
+				narrow_cast<T>(0)))));
+		return list;
+	}
+} // namespace graphics
@@ -0,0 +1,602 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/MappedFile.h"
+#include "BoundingBox.h"
+#include "BvhTree.h"
+#include "Geometry.h"
+#include "Ray.h"
+#include "SphereSet.h"
+#include "TriangleMesh.h"
+#include "materials/MaterialTable.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+	using std::uint64_t;
+#endif
+
+	/// @brief A scene stored in a versioned binary file laid out exactly as the scene's arrays
+	/// are in memory, loaded by mapping the file into memory.
+	/// The sphere blocks of a `SphereSet`, and the vertex, index, and tree node arrays of each
+	/// `TriangleMesh`, are used in place, straight from the mapped file: loading a scene involves
+	/// no parsing, copying, or allocation per primitive, so takes (nearly) constant time
+	/// regardless of the scene's size. Pages are read from disk lazily, as they're first touched
+	/// while rendering, and are shared through the page cache with any other process rendering
+	/// the same file. Only the (few) material records are decoded, into a `MaterialTable`.
+	///
+	/// The file stores data in the native byte order and layout of the build that wrote it, and
+	/// is rejected when loaded by a build with a different one (eg: a different floating point
+	/// type, or with SIMD disabled).
+	///
+	/// A loaded `SceneFile` is itself a `Geometry`: the union of its spheres and meshes, found
+	/// through a top-level `BvhTree` over its sphere blocks and meshes, which is built when the
+	/// file is written and mapped along with everything else. Only materials of the built-in kinds
+	/// can be stored; materials used through the virtual `Material` interface can't.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class SceneFile final : public Geometry<T> {
+		using Ray = Ray<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
+		using Color = Color<T>;
+		using Point2 = Point2<T>;
+		using Point3 = Point3<T>;
+		using Vec3 = Vec3<T>;
+		using BvhTree = BvhTree<T>;
+		using Node = typename BvhTree::Node;
+		using MeshNode = typename TriangleMesh<T>::Node;
+		using Entry = typename MaterialTable<T>::Entry;
+
+	  public:
+		using MaterialTable = MaterialTable<T>;
+		using SphereSet = SphereSet<T>;
+		using TriangleMesh = TriangleMesh<T>;
+
+		/// The version of the file format written, and the only one read
+		static constexpr uint32_t VERSION = 3;
+		/// The identifier at the start of every scene file
+		static constexpr std::array<char, 8> MAGIC = {'H', 'Y', 'P', 'S', 'C', 'E', 'N', 'E'};
+		/// The alignment of every array in the file
+		static constexpr size_t ALIGNMENT = 64;
+
+		SceneFile(const SceneFile& file) noexcept = delete;
+		SceneFile(SceneFile&& file) noexcept = default;
+		~SceneFile() noexcept final = default;
+
+		/// @brief Writes a scene to the file at `path`
+		///
+		/// @param path - The path of the file to write
+		/// @param materials - The scene's materials. Must all be of the built-in kinds
+		/// @param spheres - The scene's spheres
+		/// @param meshes - The scene's meshes
+		///
+		/// @return Whether the scene was written successfully
+		inline static auto write(const std::string& path,
+								 const MaterialTable& materials,
+								 const SphereSet& spheres,
+								 std::span<const TriangleMesh* const> meshes) noexcept -> bool {
+			auto records = std::vector<MaterialRecord>();
+			records.reserve(materials.size());
+			for(auto id = 0U; id < materials.size(); ++id) {
+				const auto& entry = materials.at(id);
+				auto record = MaterialRecord();
+				record.m_kind = narrow_cast<uint32_t>(entry.index());
+				if(const auto* lambertian = std::get_if<Lambertian<T>>(&entry)) {
+					record.m_parameters = {lambertian->albedo().r(),
+										   lambertian->albedo().g(),
+										   lambertian->albedo().b(),
+										   narrow_cast<T>(0)};
+				}
+				else if(const auto* metal = std::get_if<Metal<T>>(&entry)) {
+					record.m_parameters = {metal->albedo().r(),
+										   metal->albedo().g(),
+										   metal->albedo().b(),
+										   metal->reflection_fuzziness()};
+				}
+				else if(const auto* dielectric = std::get_if<Dielectric<T>>(&entry)) {
+					record.m_parameters = {dielectric->refraction_index(),
+										   narrow_cast<T>(0),
+										   narrow_cast<T>(0),
+										   narrow_cast<T>(0)};
+				}
+				else {
+					// arbitrary virtual materials have no known representation
+					return false;
+				}
+				records.push_back(record);
+			}
+
+			auto file = std::ofstream(path, std::ios::binary);
+			if(!file) {
+				return false;
+			}
+
+			// write the header and mesh records as placeholders, then rewrite them once the
+			// offsets of the arrays they refer to are known
+			auto header = Header();
+			header.m_num_materials = narrow_cast<uint32_t>(records.size());
+			header.m_num_spheres = spheres.size();
+			header.m_num_meshes = narrow_cast<uint32_t>(meshes.size());
+			auto mesh_records = std::vector<MeshRecord>(meshes.size());
+			write_bytes(file, object_bytes(header));
+
+			header.m_materials = write_array(file, std::span<const MaterialRecord>(records));
+			header.m_sphere_blocks = write_array(file, spheres.blocks());
+			header.m_meshes = write_array(file, std::span<const MeshRecord>(mesh_records));
+
+			// the top-level tree's primitives are the sphere blocks, then the meshes
+			const auto num_blocks = spheres.blocks().size();
+			auto bounds = std::vector<BoundingBox>();
+			bounds.reserve(num_blocks + meshes.size());
+			for(auto block = 0ULL; block < num_blocks; ++block) {
+				bounds.push_back(spheres.block_bounds(block));
+			}
+			for(const auto* mesh : meshes) {
+				bounds.push_back(mesh->bounding_box());
+			}
+			auto items = std::vector<uint32_t>();
+			const auto tree = BvhTree(bounds, &items);
+			header.m_tree_nodes = write_array(file, tree.nodes());
+			header.m_tree_items = write_array(file, std::span<const uint32_t>(items));
+
+			for(auto i = 0ULL; i < meshes.size(); ++i) {
+				const auto arrays = meshes[i]->arrays();
+				auto& record = mesh_records[i];
+				record.m_material_id = meshes[i]->material_id();
+				record.m_positions = write_array(file, arrays.m_positions);
+				record.m_normals = write_array(file, arrays.m_normals);
+				record.m_uvs = write_array(file, arrays.m_uvs);
+				record.m_indices = write_array(file, arrays.m_indices);
+				record.m_nodes = write_array(file, arrays.m_nodes);
+			}
+
+			file.seekp(0);
+			write_bytes(file, object_bytes(header));
+			file.seekp(narrow_cast<std::streamoff>(header.m_meshes.m_offset));
+			write_bytes(file, std::as_bytes(std::span<const MeshRecord>(mesh_records)));
+			return static_cast<bool>(file.flush());
+		}
+
+		/// @brief Loads the scene in the file at `path`, by mapping it into memory.
+		/// The header and the bounds of every array are always checked. Checking the contents of
+		/// the arrays (material ids, mesh indices, and tree nodes), so a malformed file can't cause
+		/// out of bounds reads while rendering, reads every page of them, so can be skipped for
+		/// trusted files, making loading take constant time in the size of the scene
+		///
+		/// @param path - The path of the file to load
+		/// @param check_contents - Whether to check the contents of the meshes' arrays
+		///
+		/// @return The scene, or `std::nullopt` if the file couldn't be mapped, isn't a scene
+		/// file of this version and layout, or is malformed
+		[[nodiscard]] inline static auto
+		open(const std::string& path, bool check_contents = true) noexcept
+			-> std::optional<SceneFile> {
+			auto mapped = utils::MappedFile::open(path);
+			if(!mapped) {
+				return std::nullopt;
+			}
+
+			const auto bytes = mapped->bytes();
+			auto header = Header();
+			if(bytes.size() < sizeof(Header)) {
+				return std::nullopt;
+			}
+			std::memcpy(&header, bytes.data(), sizeof(Header));
+			if(header.m_magic != MAGIC || header.m_version != VERSION
+			   || header.m_layout != Layout())
+			{
+				return std::nullopt;
+			}
+
+			auto records = std::span<const MaterialRecord>();
+			auto blocks = std::span<const typename SphereSet::Block>();
+			auto mesh_records = std::span<const MeshRecord>();
+			if(!view_array<MaterialRecord>(bytes, header.m_materials, &records)
+			   || records.size() != header.m_num_materials
+			   || !view_array<typename SphereSet::Block>(bytes, header.m_sphere_blocks, &blocks)
+			   || !valid_sphere_blocks(blocks, header.m_num_spheres)
+			   || !view_array<MeshRecord>(bytes, header.m_meshes, &mesh_records)
+			   || mesh_records.size() != header.m_num_meshes)
+			{
+				return std::nullopt;
+			}
+
+			auto tree_nodes = std::span<const Node>();
+			auto items = std::span<const uint32_t>();
+			if(!view_array<Node>(bytes, header.m_tree_nodes, &tree_nodes)
+			   || !view_array<uint32_t>(bytes, header.m_tree_items, &items)
+			   || (check_contents
+				   && !valid_items(tree_nodes, items, blocks.size() + mesh_records.size())))
+			{
+				return std::nullopt;
+			}
+
+			auto scene = SceneFile();
+			scene.m_materials.reserve(records.size());
+			for(const auto& record : records) {
+				const auto& parameters = record.m_parameters;
+				const auto albedo = Color(parameters[0], parameters[1], parameters[2]);
+				switch(record.m_kind) {
+					case LAMBERTIAN_KIND: scene.m_materials.add(Lambertian<T>(albedo)); break;
+					case METAL_KIND: scene.m_materials.add(Metal<T>(albedo, parameters[3])); break;
+					case DIELECTRIC_KIND:
+						scene.m_materials.add(Dielectric<T>(parameters[0]));
+						break;
+					default: return std::nullopt;
+				}
+			}
+
+			if(check_contents) {
+				for(auto i = 0ULL; i < header.m_num_spheres; ++i) {
+					if(blocks[i / SphereSet::LANES].m_material_id[i % SphereSet::LANES]
+					   >= records.size()) {
+						return std::nullopt;
+					}
+				}
+			}
+			scene.m_spheres = SphereSet(blocks, header.m_num_spheres);
+			scene.m_meshes.reserve(mesh_records.size());
+			for(const auto& record : mesh_records) {
+				auto arrays = typename TriangleMesh::Arrays();
+				if(!view_array<Point3>(bytes, record.m_positions, &arrays.m_positions)
+				   || !view_array<Vec3>(bytes, record.m_normals, &arrays.m_normals)
+				   || !view_array<Point2>(bytes, record.m_uvs, &arrays.m_uvs)
+				   || !view_array<uint32_t>(bytes, record.m_indices, &arrays.m_indices)
+				   || !view_array<MeshNode>(bytes, record.m_nodes, &arrays.m_nodes)
+				   || record.m_material_id >= records.size()
+				   || (check_contents && !valid_mesh(arrays)))
+				{
+					return std::nullopt;
+				}
+				scene.m_meshes.emplace_back(arrays, record.m_material_id);
+			}
+			scene.m_tree = BvhTree(tree_nodes);
+			scene.m_items = items;
+
+			scene.m_file = std::move(mapped);
+			return scene;
+		}
+
+		/// @brief Returns the scene's materials
+		///
+		/// @return The materials
+		[[nodiscard]] inline auto materials() const noexcept -> const MaterialTable& {
+			return m_materials;
+		}
+
+		/// @brief Returns the scene's spheres
+		///
+		/// @return The spheres
+		[[nodiscard]] inline auto spheres() const noexcept -> const SphereSet& {
+			return m_spheres;
+		}
+
+		/// @brief Returns the scene's meshes
+		///
+		/// @return The meshes
+		[[nodiscard]] inline auto meshes() const noexcept -> std::span<const TriangleMesh> {
+			return m_meshes;
+		}
+
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record) const noexcept -> bool final {
+			const auto num_blocks = m_spheres.blocks().size();
+			return m_tree.intersected(
+				ray,
+				min_length,
+				max_length,
+				record,
+				[&](uint32_t index, T closest) noexcept {
+					const auto item = m_items[index];
+					return item < num_blocks ?
+							   m_spheres.block_intersected(item, ray, min_length, closest, record) :
+							   m_meshes[item - num_blocks].intersected(ray,
+																	   min_length,
+																	   closest,
+																	   record);
+				});
+		}
+
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			// hits are reported by the leaf geometry that was hit, or by the `Instance` it was hit
+			// through, if any, and `HitRecord::surface` asks whichever it was
+			return record.surface(ray);
+		}
+
+		[[nodiscard]] inline auto bounding_box() const noexcept -> BoundingBox final {
+			return m_tree.bounding_box();
+		}
+
+		auto operator=(const SceneFile& file) noexcept -> SceneFile& = delete;
+		auto operator=(SceneFile&& file) noexcept -> SceneFile& = default;
+
+	  private:
+		static constexpr uint32_t LAMBERTIAN_KIND = 0;
+		static constexpr uint32_t METAL_KIND = 1;
+		static constexpr uint32_t DIELECTRIC_KIND = 2;
+		static_assert(std::is_same_v<std::variant_alternative_t<LAMBERTIAN_KIND, Entry>,
+									 Lambertian<T>>
+						  && std::is_same_v<std::variant_alternative_t<METAL_KIND, Entry>, Metal<T>>
+						  && std::is_same_v<std::variant_alternative_t<DIELECTRIC_KIND, Entry>,
+											Dielectric<T>>,
+					  "Material kinds in scene files must match MaterialTable's kinds");
+
+		/// @brief The location of an array in the file
+		struct Section {
+			/// The offset of the array from the start of the file, in bytes
+			uint64_t m_offset = 0;
+			/// The number of elements in the array
+			uint64_t m_count = 0;
+		};
+
+		/// @brief The sizes of the types stored in the file, and the native byte order.
+		/// A file can only be loaded by builds with the same layout
+		struct Layout {
+			uint32_t m_byte_order = 0x01020304U;
+			uint32_t m_scalar_size = sizeof(T);
+			uint32_t m_point_size = sizeof(Point3);
+			uint32_t m_block_size = sizeof(typename SphereSet::Block);
+			uint32_t m_node_size = sizeof(Node);
+			uint32_t m_mesh_node_size = sizeof(MeshNode);
+			uint32_t m_lanes = SphereSet::LANES;
+
+			auto operator==(const Layout& layout) const noexcept -> bool = default;
+		};
+
+		/// @brief The header at the start of the file
+		struct Header {
+			std::array<char, 8> m_magic = MAGIC;
+			uint32_t m_version = VERSION;
+			Layout m_layout = Layout();
+			uint32_t m_num_materials = 0;
+			uint32_t m_num_meshes = 0;
+			uint64_t m_num_spheres = 0;
+			/// The `MaterialRecord`s
+			Section m_materials = Section();
+			/// The `SphereSet::Block`s
+			Section m_sphere_blocks = Section();
+			/// The `MeshRecord`s
+			Section m_meshes = Section();
+			/// The nodes of the top-level tree
+			Section m_tree_nodes = Section();
+			/// The sphere blocks and meshes, in the top-level tree's leaf order. Ids below the
+			/// number of blocks are blocks, the rest are meshes
+			Section m_tree_items = Section();
+		};
+
+		/// @brief A material: its kind (the index of its type in `MaterialTable::Entry`), and
+		/// its parameters. (albedo, fuzziness) for `Metal`, albedo for `Lambertian`, and
+		/// refraction index for `Dielectric`
+		struct MaterialRecord {
+			uint32_t m_kind = 0;
+			std::array<T, 4> m_parameters = {};
+		};
+
+		/// @brief A mesh: its material and the locations of its arrays
+		struct MeshRecord {
+			uint32_t m_material_id = 0;
+			Section m_positions = Section();
+			Section m_normals = Section();
+			Section m_uvs = Section();
+			Section m_indices = Section();
+			Section m_nodes = Section();
+		};
+
+		static_assert(std::is_trivially_copyable_v<Header>
+						  && std::is_trivially_copyable_v<MaterialRecord>
+						  && std::is_trivially_copyable_v<MeshRecord>,
+					  "Scene file records must be trivially copyable");
+
+		std::optional<utils::MappedFile> m_file = std::nullopt;
+		MaterialTable m_materials = MaterialTable();
+		SphereSet m_spheres = SphereSet();
+		std::vector<TriangleMesh> m_meshes = {};
+		BvhTree m_tree = BvhTree();
+		std::span<const uint32_t> m_items = {};
+
+		SceneFile() noexcept = default;
+
+		template<typename Object>
+		[[nodiscard]] inline static auto
+		object_bytes(const Object& object) noexcept -> std::span<const std::byte> {
+			return std::as_bytes(std::span<const Object>(&object, 1));
+		}
+
+		inline static auto
+		write_bytes(std::ofstream& file, std::span<const std::byte> bytes) noexcept -> void {
+			file.write(reinterpret_cast<const char*>(bytes.data()), // NOLINT
+					   narrow_cast<std::streamsize>(bytes.size()));
+		}
+
+		/// @brief Writes `elements` to `file`, aligned to `ALIGNMENT`
+		///
+		/// @return The location the elements were written at
+		template<typename Element>
+		inline static auto
+		write_array(std::ofstream& file, std::span<const Element> elements) noexcept -> Section {
+			static constexpr auto padding = std::array<std::byte, ALIGNMENT>();
+			const auto position = narrow_cast<size_t>(static_cast<std::streamoff>(file.tellp()));
+			const auto offset = (position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+			write_bytes(file, std::span(padding).first(offset - position));
+			write_bytes(file, std::as_bytes(elements));
+			return {offset, elements.size()};
+		}
+
+		/// @brief Views the array at `section` in the mapped file, checking it lies within the
+		/// file and is suitably aligned
+		///
+		/// @return Whether the array is valid
+		template<typename Element>
+		[[nodiscard]] inline static auto
+		view_array(std::span<const std::byte> bytes,
+				   const Section& section,
+				   NotNull<std::span<const Element>> view) noexcept -> bool {
+			if(section.m_count == 0) {
+				*view = {};
+				return true;
+			}
+			if(section.m_offset % alignof(Element) != 0 || section.m_offset > bytes.size()
+			   || section.m_count > (bytes.size() - section.m_offset) / sizeof(Element))
+			{
+				return false;
+			}
+
+			// the file was written from arrays of `Element`s, so its bytes hold `Element`s
+			const auto* data = reinterpret_cast<const Element*>( // NOLINT
+				bytes.subspan(narrow_cast<size_t>(section.m_offset)).data());
+			*view = std::span<const Element>(data, narrow_cast<size_t>(section.m_count));
+			return true;
+		}
+
+		/// @brief Checks that `blocks` hold exactly `num_spheres` spheres: that there are just
+		/// enough blocks for them, and that the lanes after the last sphere are padding, with a
+		/// NaN radius. `SphereSet` tests every lane of every block, so any other lane could be hit,
+		/// and its material id used unchecked
+		///
+		/// @return Whether the blocks are valid
+		[[nodiscard]] inline static auto
+		valid_sphere_blocks(std::span<const typename SphereSet::Block> blocks,
+							uint64_t num_spheres) noexcept -> bool {
+			constexpr auto lanes = SphereSet::LANES;
+			if(num_spheres > blocks.size() * lanes || num_spheres + lanes <= blocks.size() * lanes)
+			{
+				return false;
+			}
+			for(auto lane = num_spheres % lanes; lane != 0 && lane < lanes; ++lane) {
+				if(!std::isnan(blocks.back().m_radius[lane])) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Checks that the indices of a mesh loaded from a file refer to its vertices, and
+		/// that its tree refers to its triangles, so a malformed file can't cause reads out of
+		/// bounds while rendering
+		///
+		/// @return Whether the mesh is valid
+		[[nodiscard]] inline static auto
+		valid_mesh(const typename TriangleMesh::Arrays& arrays) noexcept -> bool {
+			const auto num_vertices = arrays.m_positions.size();
+			const auto num_triangles = arrays.m_indices.size() / 3;
+			if(arrays.m_indices.size() % 3 != 0
+			   || (!arrays.m_normals.empty() && arrays.m_normals.size() != num_vertices)
+			   || (!arrays.m_uvs.empty() && arrays.m_uvs.size() != num_vertices))
+			{
+				return false;
+			}
+
+			for(const auto index : arrays.m_indices) {
+				if(index >= num_vertices) {
+					return false;
+				}
+			}
+			return valid_mesh_tree(arrays.m_nodes, num_triangles);
+		}
+
+		/// @brief Checks that the top-level tree refers to its items, and its items to the
+		/// scene's sphere blocks and meshes
+		///
+		/// @return Whether the tree and items are valid
+		[[nodiscard]] inline static auto valid_items(std::span<const Node> nodes,
+													 std::span<const uint32_t> items,
+													 size_t num_primitives) noexcept -> bool {
+			for(const auto item : items) {
+				if(item >= num_primitives) {
+					return false;
+				}
+			}
+			return valid_tree(nodes, items.size());
+		}
+
+		/// @brief Checks that a tree loaded from a file refers only to its own nodes and to
+		/// `num_primitives` primitives, and that traversing it can't overflow traversal's stack
+		///
+		/// @return Whether the tree is valid
+		[[nodiscard]] inline static auto
+		valid_tree(std::span<const Node> nodes, size_t num_primitives) noexcept -> bool {
+			// children must follow their parents, so the tree has no cycles, and have only one
+			// parent, so each node's depth is known before it's reached. The tree must be no
+			// deeper than traversal's fixed size stack
+			auto depths = std::vector<uint32_t>(nodes.size(), 0U);
+			auto has_parent = std::vector<bool>(nodes.size(), false);
+			for(auto index = 0ULL; index < nodes.size(); ++index) {
+				const auto& node = nodes[index];
+				if(node.is_leaf()) {
+					if(static_cast<size_t>(node.m_offset) + node.m_count > num_primitives) {
+						return false;
+					}
+					continue;
+				}
+
+				if(node.m_offset <= index + 1 || node.m_offset >= nodes.size() || node.m_axis >= 3
+				   || depths[index] >= BvhTree::MAX_LEAF_DEPTH || has_parent[index + 1]
+				   || has_parent[node.m_offset])
+				{
+					return false;
+				}
+				has_parent[index + 1] = true;
+				has_parent[node.m_offset] = true;
+				depths[index + 1] = depths[index] + 1;
+				depths[node.m_offset] = depths[index] + 1;
+			}
+			return true;
+		}
+
+		/// @brief Checks that a mesh's tree loaded from a file refers only to its own nodes and to
+		/// `num_triangles` triangles, and that traversing it can't overflow traversal's queue
+		///
+		/// @return Whether the tree is valid
+		[[nodiscard]] inline static auto
+		valid_mesh_tree(std::span<const MeshNode> nodes, size_t num_triangles) noexcept -> bool {
+			// as in `valid_tree`, children must follow their parents and have only one parent, and
+			// the tree must be no deeper than the size of traversal's queue allows
+			auto depths = std::vector<uint32_t>(nodes.size(), 0U);
+			auto has_parent = std::vector<bool>(nodes.size(), false);
+			for(auto index = 0ULL; index < nodes.size(); ++index) {
+				const auto& node = nodes[index];
+				if(node.m_num_children == 0 || node.m_num_children > TriangleMesh::Tree::WIDTH) {
+					return false;
+				}
+
+				for(auto child = 0ULL; child < node.m_num_children; ++child) {
+					const auto next = node.m_child[child];	// NOLINT
+					const auto count = node.m_count[child]; // NOLINT
+					if(count != 0) {
+						if(static_cast<size_t>(next) + count > num_triangles) {
+							return false;
+						}
+						continue;
+					}
+
+					if(next <= index || next >= nodes.size()
+					   || depths[index] >= BvhTree::MAX_LEAF_DEPTH || has_parent[next])
+					{
+						return false;
+					}
+					has_parent[next] = true;
+					depths[next] = depths[index] + 1;
+				}
+			}
+			return true;
+		}
+	};
+} // namespace graphics
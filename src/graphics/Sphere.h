@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../base/StandardIncludes.h"
+#include "../utils/Instrumentation.h"
 #include "Geometry.h"
 #include "Ray.h"
 
@@ -13,7 +14,9 @@ namespace graphics {
 		using Point3 = Point3<T>;
 		using Ray = Ray<T>;
 		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 		using Material = Material<T>;
+		using BoundingBox = BoundingBox<T>;
 
 		constexpr Sphere() noexcept = default;
 		explicit constexpr Sphere(const Point3& center) noexcept : m_center(center) {
@@ -57,6 +60,15 @@ namespace graphics {
 						 std::unique_ptr<MaterialType>&& material) noexcept
 			: m_center(std::move(center)), m_material(std::move(material)), m_radius(radius) {
 		}
+
+		/// @brief Creates a `Sphere` whose material is in the scene's `MaterialTable`
+		///
+		/// @param center - The center of the sphere
+		/// @param radius - The radius of the sphere
+		/// @param material_id - The id of the sphere's material in the scene's `MaterialTable`
+		constexpr Sphere(const Point3& center, T radius, uint32_t material_id) noexcept
+			: m_center(center), m_radius(radius), m_material_id(material_id) {
+		}
 		constexpr Sphere(const Sphere& sphere) noexcept = default;
 		constexpr Sphere(Sphere&& sphere) noexcept = default;
 
@@ -64,6 +76,7 @@ namespace graphics {
 										  T min_length,
 										  T max_length,
 										  NotNull<HitRecord> record) const noexcept -> bool final {
+			utils::instrumentation::count(utils::instrumentation::Counter::IntersectionTests);
 			auto origin_minus_center = ray.origin() - m_center;
 			auto oc_vec = origin_minus_center.as_vec();
 			auto oc_mag = oc_vec.template magnitude<T>();
@@ -79,22 +92,36 @@ namespace graphics {
 			auto sqrt_discrim = General::sqrt(discriminant);
 
 			auto root = (-half_b - sqrt_discrim) / a;
-			if(root < min_length + HIT_THRESHOLD || root > max_length - HIT_THRESHOLD) {
+			if(root < min_length + HIT_THRESHOLD || root > max_length) {
 				root = (-half_b + sqrt_discrim) / a;
-				if(root < min_length + HIT_THRESHOLD || root > max_length - HIT_THRESHOLD) {
+				if(root < min_length + HIT_THRESHOLD || root > max_length) {
 					return false;
 				}
 			}
 
 			record->m_length = root;
-			record->m_point = ray.point_at(root);
-			auto normal = ((record->m_point - m_center) / m_radius).as_vec();
-			record->set_normal(ray, normal);
-			record->m_material = m_material.get();
+			record->m_primitive_id = 0;
+			record->m_material_id = m_material_id;
+			record->m_geometry = this;
+			record->m_instance = nullptr;
 
 			return true;
 		}
 
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			auto surface = SurfaceRecord(ray.point_at(record.m_length));
+			auto normal = ((surface.m_point - m_center) / m_radius).as_vec();
+			surface.set_normal(ray, normal);
+			surface.m_material = m_material.get();
+			return surface;
+		}
+
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox final {
+			const auto radius = Vec3<T>(m_radius, m_radius, m_radius);
+			return {m_center - radius, m_center + radius};
+		}
+
 		constexpr auto operator=(const Sphere& sphere) noexcept -> Sphere& = default;
 		constexpr auto operator=(Sphere&& sphere) noexcept -> Sphere& = default;
 
@@ -102,7 +129,11 @@ namespace graphics {
 		Point3 m_center = Point3();
 		std::unique_ptr<Material> m_material;
 		T m_radius = static_cast<T>(1);
+		uint32_t m_material_id = NO_MATERIAL_ID;
 
+		/// Hits this close to the start of the accepted range are rejected, so rays leaving a
+		/// surface don't hit it again. The end of the range is exact, so the closest hit found
+		/// doesn't depend on the order geometries are tested in
 		static const constexpr T HIT_THRESHOLD = narrow_cast<T>(0.005);
 	};
 	IGNORE_PADDING_STOP
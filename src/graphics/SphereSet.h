@@ -0,0 +1,334 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/ArrayStorage.h"
+#include "../utils/Instrumentation.h"
+#include "Geometry.h"
+#include "Ray.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
+	/// @brief A set of spheres stored structure-of-arrays, for intersecting one ray against
+	/// several spheres at once.
+	/// Spheres are grouped into aligned blocks of `LANES` spheres, each storing the spheres'
+	/// centers, radii, and material ids in separate arrays, so that a block can be tested against
+	/// a ray with one pass of SIMD instructions (see `math::simd::Float4`). Spheres reference
+	/// their materials by 32-bit id in the scene's `MaterialTable`, so many spheres can share one
+	/// material.
+	///
+	/// Compared to a `GeometryList` of `Sphere`s, this removes a virtual call and a pointer chase
+	/// per sphere, and tests `LANES` spheres per iteration.
+	///
+	/// The blocks can also be borrowed from memory owned elsewhere, such as a mapped `SceneFile`,
+	/// rather than built sphere by sphere.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class SphereSet final : public Geometry<T> {
+		using Ray = Ray<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
+		using Point3 = Point3<T>;
+		using Vec3 = Vec3<T>;
+
+	  public:
+		/// The number of spheres tested together
+		static constexpr size_t LANES = math::simd::LANES;
+
+		/// @brief `LANES` spheres, stored structure-of-arrays.
+		/// Unused lanes have a NaN radius, which makes every comparison in the intersection test
+		/// fail, so they are never hit
+		struct alignas(sizeof(T) * LANES) Block {
+			T m_center_x[LANES] = {};
+			T m_center_y[LANES] = {};
+			T m_center_z[LANES] = {};
+			T m_radius[LANES] = {std::numeric_limits<T>::quiet_NaN(),
+								 std::numeric_limits<T>::quiet_NaN(),
+								 std::numeric_limits<T>::quiet_NaN(),
+								 std::numeric_limits<T>::quiet_NaN()};
+			uint32_t m_material_id[LANES] = {};
+		};
+		static_assert(LANES == 4, "Block initialization assumes 4 lanes");
+
+		constexpr SphereSet() noexcept = default;
+		/// @brief Creates a `SphereSet` borrowing already built blocks of spheres. The blocks must
+		/// outlive the set
+		///
+		/// @param blocks - The blocks of spheres
+		/// @param size - The number of spheres in `blocks`
+		SphereSet(std::span<const Block> blocks, size_t size) noexcept
+			: m_blocks(blocks), m_size(size) {
+		}
+		SphereSet(const SphereSet& set) noexcept = delete;
+		constexpr SphereSet(SphereSet&& set) noexcept = default;
+		constexpr ~SphereSet() noexcept final = default;
+
+		/// @brief Adds a sphere to the set
+		///
+		/// @param center - The center of the sphere
+		/// @param radius - The radius of the sphere
+		/// @param material_id - The id of the sphere's material in the scene's `MaterialTable`
+		inline auto add(const Point3& center, T radius, uint32_t material_id) noexcept -> void {
+			auto& blocks = m_blocks.owned();
+			const auto lane = m_size % LANES;
+			if(lane == 0) {
+				blocks.emplace_back();
+			}
+
+			auto& block = blocks.back();
+			block.m_center_x[lane] = center.x();
+			block.m_center_y[lane] = center.y();
+			block.m_center_z[lane] = center.z();
+			block.m_radius[lane] = radius;
+			block.m_material_id[lane] = material_id;
+			++m_size;
+		}
+
+		/// @brief Returns the number of spheres in the set
+		///
+		/// @return The number of spheres
+		[[nodiscard]] inline constexpr auto size() const noexcept -> size_t {
+			return m_size;
+		}
+
+		/// @brief Returns the blocks of spheres in the set
+		///
+		/// @return The blocks
+		[[nodiscard]] inline constexpr auto blocks() const noexcept -> std::span<const Block> {
+			return m_blocks.span();
+		}
+
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record) const noexcept -> bool final {
+			const auto blocks = m_blocks.span();
+			utils::instrumentation::count(utils::instrumentation::Counter::IntersectionTests,
+										  m_size);
+			auto closest = max_length;
+			auto closest_index = NO_HIT;
+
+			for(auto i = 0ULL; i < blocks.size(); ++i) {
+				const auto hit = intersected_block(blocks[i], ray, min_length, closest);
+				if(hit.m_lane != NO_HIT) {
+					closest = hit.m_length;
+					closest_index = i * LANES + hit.m_lane;
+				}
+			}
+
+			if(closest_index == NO_HIT) {
+				return false;
+			}
+
+			record_hit(closest_index, closest, record);
+			return true;
+		}
+
+		/// @brief Intersects `ray` with only the spheres in the block at index `block`, as
+		/// `intersected` would with the whole set. This lets an acceleration structure over
+		/// whole sets, such as `SceneFile`'s, treat each block as a primitive of its own
+		///
+		/// @param block - The index of the block to test
+		/// @param ray - The ray to test
+		/// @param min_length - The minimum length along the ray to accept a hit at
+		/// @param max_length - The maximum length along the ray to accept a hit at
+		/// @param record - Where to record the hit, if any
+		///
+		/// @return Whether any sphere in the block was hit
+		inline auto block_intersected(size_t block,
+									  const Ray& ray,
+									  T min_length,
+									  T max_length,
+									  NotNull<HitRecord> record) const noexcept -> bool {
+			utils::instrumentation::count(utils::instrumentation::Counter::IntersectionTests,
+										  num_in_block(block));
+			const auto hit = intersected_block(m_blocks[block], ray, min_length, max_length);
+			if(hit.m_lane == NO_HIT) {
+				return false;
+			}
+
+			record_hit(block * LANES + hit.m_lane, hit.m_length, record);
+			return true;
+		}
+
+		/// @brief Returns the bounds of the spheres in the block at index `block`
+		///
+		/// @param block - The index of the block
+		///
+		/// @return The bounds of the block
+		[[nodiscard]] inline constexpr auto
+		block_bounds(size_t block) const noexcept -> BoundingBox {
+			const auto& spheres = m_blocks[block];
+			auto box = BoundingBox();
+			for(auto lane = 0ULL; lane < num_in_block(block); ++lane) {
+				const auto center = Point3(spheres.m_center_x[lane],
+										   spheres.m_center_y[lane],
+										   spheres.m_center_z[lane]);
+				const auto radius
+					= Vec3(spheres.m_radius[lane], spheres.m_radius[lane], spheres.m_radius[lane]);
+				box = box.merged(BoundingBox(center - radius, center + radius));
+			}
+			return box;
+		}
+
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			const auto& block = m_blocks[record.m_primitive_id / LANES];
+			const auto lane = record.m_primitive_id % LANES;
+			const auto center
+				= Point3(block.m_center_x[lane], block.m_center_y[lane], block.m_center_z[lane]);
+			auto surface = SurfaceRecord(ray.point_at(record.m_length));
+			auto normal = ((surface.m_point - center) / block.m_radius[lane]).as_vec();
+			surface.set_normal(ray, normal);
+			return surface;
+		}
+
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox final {
+			auto box = BoundingBox();
+			for(auto block = 0ULL; block < m_blocks.size(); ++block) {
+				box = box.merged(block_bounds(block));
+			}
+			return box;
+		}
+
+		auto operator=(const SphereSet& set) noexcept -> SphereSet& = delete;
+		constexpr auto operator=(SphereSet&& set) noexcept -> SphereSet& = default;
+
+	  private:
+		/// Hits this close to the start of the accepted range are rejected, as by `Sphere`
+		static constexpr T HIT_THRESHOLD = narrow_cast<T>(0.005);
+		static constexpr size_t NO_HIT = std::numeric_limits<size_t>::max();
+
+		IGNORE_PADDING_START
+		/// @brief The closest hit within a block
+		struct BlockHit {
+			T m_length = Constants<T>::infinity;
+			/// The lane of the hit sphere, or `NO_HIT`
+			size_t m_lane = NO_HIT;
+		};
+		IGNORE_PADDING_STOP
+
+		utils::ArrayStorage<Block> m_blocks;
+		size_t m_size = 0;
+
+		/// @brief Returns the number of spheres in the block at index `block`
+		[[nodiscard]] inline constexpr auto num_in_block(size_t block) const noexcept -> size_t {
+			return General::min(m_size - block * LANES, LANES);
+		}
+
+		/// @brief Records a hit on the sphere at index `index`, at `length` along the ray
+		inline auto
+		record_hit(size_t index, T length, NotNull<HitRecord> record) const noexcept -> void {
+			record->m_length = length;
+			record->m_primitive_id = narrow_cast<uint32_t>(index);
+			record->m_material_id = m_blocks[index / LANES].m_material_id[index % LANES];
+			record->m_geometry = this;
+			record->m_instance = nullptr;
+		}
+
+		/// @brief Finds the closest sphere in `block` hit by `ray` within the given lengths
+		///
+		/// @param block - The spheres to test
+		/// @param ray - The ray to test
+		/// @param min_length - The minimum length along the ray to accept a hit at
+		/// @param max_length - The maximum length along the ray to accept a hit at
+		///
+		/// @return The closest hit, if any
+		[[nodiscard]] inline static auto
+		intersected_block(const Block& block, const Ray& ray, T min_length, T max_length) noexcept
+			-> BlockHit {
+			const auto& origin = ray.origin();
+			const auto& direction = ray.direction();
+			const auto a = direction.dot_prod(direction);
+			const auto lower = min_length + HIT_THRESHOLD;
+			const auto upper = max_length;
+
+			if constexpr(std::is_same_v<T, float>) {
+				using math::simd::Float4;
+
+				const auto direction_x = Float4::broadcast(direction.x());
+				const auto direction_y = Float4::broadcast(direction.y());
+				const auto direction_z = Float4::broadcast(direction.z());
+				const auto origin_to_center_x
+					= Float4::broadcast(origin.x()) - Float4::load(block.m_center_x);
+				const auto origin_to_center_y
+					= Float4::broadcast(origin.y()) - Float4::load(block.m_center_y);
+				const auto origin_to_center_z
+					= Float4::broadcast(origin.z()) - Float4::load(block.m_center_z);
+				const auto radius = Float4::load(block.m_radius);
+				const auto a_lanes = Float4::broadcast(a);
+
+				const auto half_b = origin_to_center_x * direction_x
+									+ origin_to_center_y * direction_y
+									+ origin_to_center_z * direction_z;
+				const auto c = origin_to_center_x * origin_to_center_x
+							   + origin_to_center_y * origin_to_center_y
+							   + origin_to_center_z * origin_to_center_z - radius * radius;
+				const auto discriminant = half_b * half_b - a_lanes * c;
+				const auto zero = Float4::broadcast(0.0F);
+				const auto has_roots = discriminant >= zero;
+				const auto sqrt_discrim = sqrt(max(discriminant, zero));
+
+				const auto lower_lanes = Float4::broadcast(lower);
+				const auto upper_lanes = Float4::broadcast(upper);
+				const auto near_root = (-half_b - sqrt_discrim) / a_lanes;
+				const auto far_root = (-half_b + sqrt_discrim) / a_lanes;
+				const auto near_valid = (near_root >= lower_lanes) & (near_root <= upper_lanes);
+				const auto far_valid = (far_root >= lower_lanes) & (far_root <= upper_lanes);
+
+				const auto infinity = Float4::broadcast(Constants<float>::infinity);
+				const auto lengths = select(has_roots & near_valid,
+											near_root,
+											select(has_roots & far_valid, far_root, infinity));
+				const auto closest = lengths.horizontal_min();
+				if(closest == Constants<float>::infinity) {
+					return {};
+				}
+
+				const auto lanes = (lengths <= Float4::broadcast(closest)).bits();
+				return {closest, narrow_cast<size_t>(std::countr_zero(lanes))};
+			}
+			else {
+				auto hit = BlockHit();
+				for(auto lane = 0ULL; lane < LANES; ++lane) {
+					const auto origin_to_center
+						= (origin - Point3(block.m_center_x[lane],
+										   block.m_center_y[lane],
+										   block.m_center_z[lane]))
+							  .as_vec();
+					const auto radius = block.m_radius[lane];
+					const auto half_b = origin_to_center.dot_prod(direction);
+					const auto c = origin_to_center.dot_prod(origin_to_center) - radius * radius;
+					const auto discriminant = half_b * half_b - a * c;
+					if(!(discriminant >= narrow_cast<T>(0))) {
+						continue;
+					}
+
+					const auto sqrt_discrim = General::sqrt(discriminant);
+					auto root = (-half_b - sqrt_discrim) / a;
+					if(root < lower || root > upper) {
+						root = (-half_b + sqrt_discrim) / a;
+						if(root < lower || root > upper) {
+							continue;
+						}
+					}
+					if(root < hit.m_length) {
+						hit = {root, lane};
+					}
+				}
+				return hit;
+			}
+		}
+	};
+} // namespace graphics
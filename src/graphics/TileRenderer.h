@@ -0,0 +1,774 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../math/Sampler.h"
+#include "../utils/Instrumentation.h"
+#include "AccumulationBuffer.h"
+#include "Camera.h"
+#include "Color.h"
+#include "Framebuffer.h"
+#include "Ray.h"
+
+namespace graphics {
+
+	/// @brief A rectangular region of the image, rendered by a single worker as one unit of work
+	struct Tile {
+		/// The index of this tile in the renderer's tile list. Also selects its random stream
+		size_t m_index = 0;
+		/// The left-most column of the tile
+		size_t m_x = 0;
+		/// The top-most row of the tile, counted from the top of the image
+		size_t m_y = 0;
+		size_t m_width = 0;
+		size_t m_height = 0;
+	};
+
+	/// @brief A shader that computes the colors seen along many rays at once, like
+	/// `WavefrontIntegrator`, rather than one ray at a time
+	///
+	/// @tparam Shader - The shader type
+	/// @tparam T - The floating point type used for rendering
+	template<typename Shader, typename T>
+	concept BatchShader
+		= requires(const Shader& shade, std::span<const Ray<T>> rays, std::span<Color<T>> colors) {
+			  shade(rays, colors);
+		  };
+
+	IGNORE_PADDING_START
+	/// @brief Settings for adaptive sampling.
+	/// With adaptive sampling, every pixel first takes `m_min_samples` samples. Then, in rounds,
+	/// pixels whose estimate has not yet converged share `m_batch_size` samples per pixel, in
+	/// proportion to their estimated relative error, until every pixel has converged or reached
+	/// `m_max_samples`, or the tile's sample budget is exhausted.
+	/// A tile's budget is the same as without adaptive sampling (its pixel count times the
+	/// renderer's samples per pixel), so samples saved on pixels that converge quickly (eg: flat
+	/// sky) are spent on noisy ones instead.
+	///
+	/// A pixel has converged when the 95% confidence interval of the mean of its samples'
+	/// luminance is within `m_error_threshold` of that mean, relative to the mean
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	struct AdaptiveSampling {
+		/// The number of samples every pixel takes before its convergence is first checked
+		size_t m_min_samples = 16;
+		/// The maximum number of samples any one pixel can take
+		size_t m_max_samples = 2048;
+		/// The number of samples taken by an unconverged pixel at a time
+		size_t m_batch_size = 8;
+		/// The relative error at which a pixel is considered converged
+		T m_error_threshold = narrow_cast<T>(0.02);
+	};
+	IGNORE_PADDING_STOP
+
+	/// @brief Renders an image by splitting it into `Tile`s and distributing them across a pool
+	/// of worker threads, each of which writes its finished pixels into a shared `Framebuffer`.
+	///
+	/// Before rendering a tile, the rendering thread's random number generator is reseeded with the
+	/// renderer's seed, on the stream selected by the tile's index. Tiles therefore get
+	/// uncorrelated random sequences, and the resulting image is identical regardless of the number
+	/// of threads used or the order in which tiles are picked up.
+	///
+	/// By default every pixel takes the same number of samples. See `AdaptiveSampling` for
+	/// distributing samples according to each pixel's estimated error instead.
+	///
+	/// By default the position of each sample within its pixel, and on the camera's lens, is
+	/// drawn from the random number generator. A `math::Sampler` can be supplied to draw them
+	/// from a (typically low-discrepancy) sample sequence instead, which converges faster for
+	/// the same number of samples.
+	///
+	/// The shader can compute the color seen along one ray at a time, or be a `BatchShader`, in
+	/// which case it is given all the camera rays of a round of samples of a tile at once (up to
+	/// `MAX_BATCH_SIZE` at a time).
+	///
+	/// Rather than all at once, the image can also be rendered progressively, in passes over the
+	/// whole image that each add a few samples per pixel to an `AccumulationBuffer`. Between
+	/// passes, the accumulated image can be previewed, or checkpointed to disk and later resumed
+	/// with bit-identical results. Before rendering a tile in a pass, the random number generator
+	/// is reseeded on a stream selected by both the index of the pass and the tile's index.
+	/// Adaptive sampling doesn't apply to progressive renders.
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class TileRenderer {
+	  public:
+		using Camera = Camera<T>;
+		using Color = Color<T>;
+		using Framebuffer = Framebuffer<T>;
+		using Ray = Ray<T>;
+		using AdaptiveSampling = AdaptiveSampling<T>;
+		using Sampler = math::Sampler<T>;
+		using AccumulationBuffer = AccumulationBuffer<T>;
+
+		/// Default width and height of a tile, in pixels
+		static constexpr size_t DEFAULT_TILE_SIZE = 32;
+		/// Default seed for the random number generator
+		static constexpr size_t DEFAULT_SEED = math::PermutedCongruentialEngine::DEFAULT_STATE;
+		/// The maximum number of camera rays given to a `BatchShader` at once
+		static constexpr size_t MAX_BATCH_SIZE = 16384;
+
+		/// @brief Creates a `TileRenderer` for an image of the given dimensions
+		///
+		/// @param width - The width of the image, in pixels
+		/// @param height - The height of the image, in pixels
+		/// @param samples_per_pixel - The number of samples to take for each pixel
+		/// @param num_threads - The number of worker threads to render with
+		/// @param tile_size - The width and height of each tile, in pixels
+		/// @param seed - The seed for the random number generator
+		TileRenderer(size_t width,
+					 size_t height,
+					 size_t samples_per_pixel,
+					 size_t num_threads = default_thread_count(),
+					 size_t tile_size = DEFAULT_TILE_SIZE,
+					 size_t seed = DEFAULT_SEED) noexcept
+			: m_width(width), m_height(height), m_samples_per_pixel(samples_per_pixel),
+			  m_num_threads(General::max(num_threads, narrow_cast<size_t>(1))),
+			  m_tile_size(General::max(tile_size, narrow_cast<size_t>(1))), m_seed(seed) {
+		}
+		TileRenderer(const TileRenderer& renderer) noexcept = default;
+		TileRenderer(TileRenderer&& renderer) noexcept = default;
+		~TileRenderer() noexcept = default;
+
+		/// @brief Returns the number of worker threads used to render when none is specified:
+		/// the number of hardware threads available
+		///
+		/// @return The default number of worker threads
+		[[nodiscard]] inline static auto default_thread_count() noexcept -> size_t {
+			return General::max(narrow_cast<size_t>(std::thread::hardware_concurrency()),
+								narrow_cast<size_t>(1));
+		}
+
+		/// @brief Enables (or, with `std::nullopt`, disables) adaptive sampling
+		///
+		/// @param settings - The adaptive sampling settings to render with
+		inline auto
+		set_adaptive_sampling(std::optional<AdaptiveSampling> settings) noexcept -> void {
+			m_adaptive_sampling = settings;
+		}
+
+		/// @brief Returns the adaptive sampling settings, if adaptive sampling is enabled
+		///
+		/// @return The adaptive sampling settings
+		[[nodiscard]] inline auto
+		adaptive_sampling() const noexcept -> const std::optional<AdaptiveSampling>& {
+			return m_adaptive_sampling;
+		}
+
+		/// @brief Sets the sampler to draw the pixel and lens positions of samples from. With
+		/// `nullptr`, they are drawn from the random number generator
+		///
+		/// @param sampler - The sampler to render with
+		inline auto set_sampler(std::shared_ptr<const Sampler> sampler) noexcept -> void {
+			m_sampler = std::move(sampler);
+		}
+
+		/// @brief Returns the sampler samples are drawn from, if one has been set
+		///
+		/// @return The sampler
+		[[nodiscard]] inline auto
+		sampler() const noexcept -> const std::shared_ptr<const Sampler>& {
+			return m_sampler;
+		}
+
+		/// @brief Returns the tiles the image is split into, ordered left-to-right, top-to-bottom
+		///
+		/// @return The tiles
+		[[nodiscard]] inline auto tiles() const noexcept -> std::vector<Tile> {
+			auto tiles = std::vector<Tile>();
+			for(auto y = 0ULL; y < m_height; y += m_tile_size) {
+				for(auto x = 0ULL; x < m_width; x += m_tile_size) {
+					tiles.push_back({tiles.size(),
+									 x,
+									 y,
+									 General::min(m_tile_size, m_width - x),
+									 General::min(m_tile_size, m_height - y)});
+				}
+			}
+			return tiles;
+		}
+
+		/// @brief Renders the image as seen by `camera`, using `shade` to determine the color
+		/// seen along each camera ray
+		///
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`.
+		/// Called concurrently from all worker threads, so must be safe to call concurrently
+		///
+		/// @return The rendered image, with each pixel the average of its samples
+		template<typename Shader>
+		requires std::is_invocable_r_v<Color, const Shader&, const Ray&> || BatchShader<Shader, T>
+		[[nodiscard]] inline auto
+		render(const Camera& camera, const Shader& shade) const noexcept -> Framebuffer {
+			auto framebuffer = Framebuffer(m_width, m_height);
+			for_each_tile([&](const Tile& tile) noexcept {
+				const auto pixels = render_tile(tile, camera, shade);
+				framebuffer.write(tile.m_x, tile.m_y, tile.m_width, pixels);
+			});
+
+			return framebuffer;
+		}
+
+		/// @brief Renders a single tile of the image as seen by `camera`. Its pixels are identical
+		/// to those of the tile in the image returned by `render`, so tiles can be rendered
+		/// separately (eg: by other processes) and assembled into the same image
+		///
+		/// @param tile - The tile to render; one of `tiles()`
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`
+		///
+		/// @return The tile's pixels, row-major, with rows stored top-to-bottom
+		template<typename Shader>
+		requires std::is_invocable_r_v<Color, const Shader&, const Ray&> || BatchShader<Shader, T>
+		[[nodiscard]] inline auto render_tile(const Tile& tile,
+											  const Camera& camera,
+											  const Shader& shade) const noexcept
+			-> std::vector<Color> {
+			auto pixels = std::vector<Color>(tile.m_width * tile.m_height);
+			render_tile(tile, camera, shade, pixels);
+			return pixels;
+		}
+
+		/// @brief Returns the width of the image, in pixels
+		///
+		/// @return The width
+		[[nodiscard]] inline auto width() const noexcept -> size_t {
+			return m_width;
+		}
+
+		/// @brief Returns the height of the image, in pixels
+		///
+		/// @return The height
+		[[nodiscard]] inline auto height() const noexcept -> size_t {
+			return m_height;
+		}
+
+		/// @brief Returns the number of samples taken for each pixel
+		///
+		/// @return The number of samples per pixel
+		[[nodiscard]] inline auto samples_per_pixel() const noexcept -> size_t {
+			return m_samples_per_pixel;
+		}
+
+		/// @brief Returns the number of worker threads rendered with
+		///
+		/// @return The number of worker threads
+		[[nodiscard]] inline auto num_threads() const noexcept -> size_t {
+			return m_num_threads;
+		}
+
+		/// @brief Returns the width and height of each tile, in pixels
+		///
+		/// @return The tile size
+		[[nodiscard]] inline auto tile_size() const noexcept -> size_t {
+			return m_tile_size;
+		}
+
+		/// @brief Returns the seed for the random number generator
+		///
+		/// @return The seed
+		[[nodiscard]] inline auto seed() const noexcept -> size_t {
+			return m_seed;
+		}
+
+		/// @brief Creates an empty `AccumulationBuffer` for progressively rendering the image
+		/// with this renderer's settings
+		///
+		/// @param samples_per_pass - The number of samples to take for each pixel in each pass
+		///
+		/// @return The `AccumulationBuffer`
+		[[nodiscard]] inline auto
+		accumulation_buffer(size_t samples_per_pass) const noexcept -> AccumulationBuffer {
+			return AccumulationBuffer({m_width,
+									   m_height,
+									   m_tile_size,
+									   m_seed,
+									   General::max(samples_per_pass, narrow_cast<size_t>(1)),
+									   sampler_description()});
+		}
+
+		/// @brief Returns whether `accumulation` accumulates a render with this renderer's
+		/// settings, including its sampler, and so can be rendered to (or resumed) by it
+		///
+		/// @param accumulation - The `AccumulationBuffer` to check
+		///
+		/// @return Whether `accumulation` is compatible with this renderer
+		[[nodiscard]] inline auto
+		is_compatible(const AccumulationBuffer& accumulation) const noexcept -> bool {
+			const auto& settings = accumulation.settings();
+			return settings.m_width == m_width && settings.m_height == m_height
+				   && settings.m_tile_size == m_tile_size && settings.m_seed == m_seed
+				   && settings.m_samples_per_pass > 0
+				   && settings.m_sampler == sampler_description();
+		}
+
+		/// @brief Renders the next pass of a progressive render, adding its samples to
+		/// `accumulation`. The last pass takes fewer samples than the others if needed, so that no
+		/// pixel takes more than the renderer's samples per pixel in total
+		///
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`.
+		/// Called concurrently from all worker threads, so must be safe to call concurrently
+		/// @param accumulation - The `AccumulationBuffer` to add the pass's samples to
+		///
+		/// @return Whether a pass was rendered. `false` if `accumulation` is incompatible with
+		/// this renderer, or already holds all the samples
+		template<typename Shader>
+		requires std::is_invocable_r_v<Color, const Shader&, const Ray&> || BatchShader<Shader, T>
+		inline auto render_pass(const Camera& camera,
+								const Shader& shade,
+								NotNull<AccumulationBuffer> accumulation) const noexcept -> bool {
+			const auto first_sample = accumulation->num_samples();
+			if(!is_compatible(*accumulation) || first_sample >= m_samples_per_pixel) {
+				return false;
+			}
+
+			const auto pass = Pass{accumulation->num_passes(),
+								   first_sample,
+								   General::min(accumulation->settings().m_samples_per_pass,
+												m_samples_per_pixel - first_sample)};
+			const auto num_tiles = tiles().size();
+			for_each_tile([&](const Tile& tile) noexcept {
+				render_tile_pass(tile, pass, num_tiles, camera, shade, accumulation);
+			});
+
+			accumulation->complete_pass(pass.m_num_samples);
+			return true;
+		}
+
+		/// @brief Progressively renders the image as seen by `camera` into `accumulation`, a pass
+		/// at a time, until every pixel has taken the renderer's samples per pixel. After each
+		/// pass, `on_pass` is called with the accumulated image so far, and can stop the render
+		/// (eg: to be resumed later, from a checkpoint) by returning `false`
+		///
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`.
+		/// Called concurrently from all worker threads, so must be safe to call concurrently
+		/// @param accumulation - The `AccumulationBuffer` to render into. Either empty, or holding
+		/// the passes of a previous, unfinished render with the same settings
+		/// @param on_pass - Callable taking the `AccumulationBuffer` after each pass, returning
+		/// whether to continue rendering
+		///
+		/// @return Whether the render finished. `false` if stopped by `on_pass`, or if
+		/// `accumulation` is incompatible with this renderer
+		template<typename Shader, typename Callback>
+		requires(std::is_invocable_r_v<Color, const Shader&, const Ray&> || BatchShader<Shader, T>)
+				&& std::is_invocable_r_v<bool, Callback&, const AccumulationBuffer&>
+		inline auto render_progressive(const Camera& camera,
+									   const Shader& shade,
+									   NotNull<AccumulationBuffer> accumulation,
+									   Callback&& on_pass) const noexcept -> bool {
+			if(!is_compatible(*accumulation)) {
+				return false;
+			}
+
+			while(render_pass(camera, shade, accumulation)) {
+				if(!on_pass(std::as_const(*accumulation))
+				   && accumulation->num_samples() < m_samples_per_pixel) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		auto operator=(const TileRenderer& renderer) noexcept -> TileRenderer& = default;
+		auto operator=(TileRenderer&& renderer) noexcept -> TileRenderer& = default;
+
+	  private:
+		size_t m_width;
+		size_t m_height;
+		size_t m_samples_per_pixel;
+		size_t m_num_threads;
+		size_t m_tile_size;
+		size_t m_seed;
+		std::optional<AdaptiveSampling> m_adaptive_sampling = std::nullopt;
+		std::shared_ptr<const Sampler> m_sampler = nullptr;
+
+		/// The sampler dimensions used for the position of a sample within its pixel
+		static constexpr size_t PIXEL_DIMENSION = 0;
+		/// The sampler dimensions used for the position of a sample on the camera's lens
+		static constexpr size_t LENS_DIMENSION = 2;
+
+		IGNORE_PADDING_START
+		/// @brief The running estimate of a pixel's color, for adaptive sampling
+		struct PixelEstimate {
+			Color m_sum = Color(narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0));
+			/// Running mean of the samples' luminance
+			T m_mean = narrow_cast<T>(0);
+			/// Running sum of squared differences from the mean of the samples' luminance
+			T m_squared_deviations = narrow_cast<T>(0);
+			size_t m_num_samples = 0;
+			bool m_converged = false;
+
+			/// @brief Adds `sample` to the estimate, updating the running mean and variance of
+			/// its luminance with Welford's algorithm
+			inline constexpr auto add(const Color& sample) noexcept -> void {
+				m_sum += sample;
+				++m_num_samples;
+				const auto luminance = sample.luminance();
+				const auto delta = luminance - m_mean;
+				m_mean += delta / narrow_cast<T>(m_num_samples);
+				m_squared_deviations += delta * (luminance - m_mean);
+			}
+
+			/// @brief Returns the standard deviation of the samples' luminance, relative to
+			/// their mean. Requires at least two samples
+			[[nodiscard]] inline auto relative_error() const noexcept -> T {
+				const auto variance = m_squared_deviations / narrow_cast<T>(m_num_samples - 1);
+				return General::sqrt(variance) / General::max(m_mean, MIN_CONVERGENCE_LUMINANCE);
+			}
+
+			/// @brief Returns whether the 95% confidence interval of the mean luminance is within
+			/// `threshold` of the mean, relative to the mean
+			[[nodiscard]] inline auto has_converged(T threshold) const noexcept -> bool {
+				if(m_num_samples < 2) {
+					return false;
+				}
+				const auto num_samples = narrow_cast<T>(m_num_samples);
+				const auto variance_of_mean
+					= m_squared_deviations / ((num_samples - narrow_cast<T>(1)) * num_samples);
+				const auto tolerance = threshold * General::max(m_mean, MIN_CONVERGENCE_LUMINANCE);
+				return CONFIDENCE_95 * CONFIDENCE_95 * variance_of_mean <= tolerance * tolerance;
+			}
+		};
+		IGNORE_PADDING_STOP
+
+		/// @brief A pass of a progressive render
+		struct Pass {
+			/// The index of the pass, which (with the tile's index) selects its random streams
+			size_t m_index = 0;
+			/// The index of the first sample of each pixel taken in the pass
+			size_t m_first_sample = 0;
+			/// The number of samples of each pixel taken in the pass
+			size_t m_num_samples = 0;
+		};
+
+		/// @brief Returns the description of the sampler samples are drawn from, or of no sampler
+		/// if they're drawn from the random number generator
+		[[nodiscard]] inline auto sampler_description() const noexcept -> math::SamplerDescription {
+			return m_sampler != nullptr ? m_sampler->description() : math::SamplerDescription();
+		}
+
+		/// @brief Renders each tile exactly once, distributing the tiles across the worker
+		/// threads
+		///
+		/// @param render - Callable rendering the tile it's given. Called concurrently from all
+		/// worker threads
+		template<typename Function>
+		inline auto for_each_tile(Function&& render) const noexcept -> void {
+			const auto tiles = this->tiles();
+			auto next_tile = std::atomic_size_t(0);
+			utils::instrumentation::count(utils::instrumentation::Counter::TilesQueued,
+										  tiles.size());
+
+			auto worker = [&]() noexcept {
+				for(auto index = next_tile.fetch_add(1, std::memory_order_relaxed);
+					index < tiles.size();
+					index = next_tile.fetch_add(1, std::memory_order_relaxed))
+				{
+					render(tiles[index]);
+					utils::instrumentation::count(utils::instrumentation::Counter::TilesRendered);
+				}
+			};
+
+			auto workers = std::vector<std::jthread>();
+			workers.reserve(m_num_threads);
+			for(auto i = 0ULL; i < m_num_threads; ++i) {
+				workers.emplace_back(worker);
+			}
+		}
+
+		/// z-score of the two-sided 95% confidence interval
+		static constexpr T CONFIDENCE_95 = narrow_cast<T>(1.96);
+		/// Lower bound on the luminance that a pixel's error is taken relative to, so near-black
+		/// pixels aren't held to an impossibly tight absolute tolerance
+		static constexpr T MIN_CONVERGENCE_LUMINANCE = narrow_cast<T>(0.05);
+
+		/// @brief Renders all the pixels in `tile` into `pixels`
+		///
+		/// @param tile - The tile to render
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray
+		/// @param pixels - The tile's pixels, row-major, to write the finished pixels to
+		template<typename Shader>
+		inline auto render_tile(const Tile& tile,
+								const Camera& camera,
+								const Shader& shade,
+								std::span<Color> pixels) const noexcept -> void {
+			const auto timer
+				= utils::instrumentation::ScopedTimer(utils::instrumentation::Stage::Tiles);
+			math::seed_random(m_seed, tile.m_index);
+
+			if(m_adaptive_sampling) {
+				render_tile_adaptive(tile, camera, shade, pixels);
+				return;
+			}
+
+			if constexpr(BatchShader<Shader, T>) {
+				const auto num_pixels = tile.m_width * tile.m_height;
+				auto estimates = std::vector<PixelEstimate>(num_pixels);
+				auto requests = std::vector<SampleRequest>();
+				requests.reserve(num_pixels);
+				for(auto index = 0ULL; index < num_pixels; ++index) {
+					requests.push_back({index, m_samples_per_pixel});
+				}
+				take_samples(tile, requests, camera, shade, estimates);
+				write_estimates(estimates, pixels);
+			}
+			else {
+				const auto scale = narrow_cast<T>(1) / narrow_cast<T>(m_samples_per_pixel);
+				auto index = 0ULL;
+				for(auto row = tile.m_y; row < tile.m_y + tile.m_height; ++row) {
+					for(auto x = tile.m_x; x < tile.m_x + tile.m_width; ++x, ++index) {
+						auto pixel = Color(narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0));
+						for(auto sample = 0ULL; sample < m_samples_per_pixel; ++sample) {
+							pixel += shade(camera_ray(x, row, sample, camera));
+						}
+						pixels[index] = pixel * scale;
+					}
+				}
+			}
+		}
+
+		/// @brief Takes the samples of `pass` of all the pixels in `tile`, adding them to the sums
+		/// in `accumulation`
+		///
+		/// @param tile - The tile to render
+		/// @param pass - The pass to render
+		/// @param num_tiles - The number of tiles in the image
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`
+		/// @param accumulation - The `AccumulationBuffer` to add the samples to
+		template<typename Shader>
+		inline auto render_tile_pass(const Tile& tile,
+									 const Pass& pass,
+									 size_t num_tiles,
+									 const Camera& camera,
+									 const Shader& shade,
+									 NotNull<AccumulationBuffer> accumulation) const noexcept
+			-> void {
+			const auto timer
+				= utils::instrumentation::ScopedTimer(utils::instrumentation::Stage::Tiles);
+			// the first pass uses the same streams as `render`
+			math::seed_random(m_seed, pass.m_index * num_tiles + tile.m_index);
+
+			const auto num_pixels = tile.m_width * tile.m_height;
+			auto estimates = std::vector<PixelEstimate>(num_pixels);
+			auto requests = std::vector<SampleRequest>();
+			requests.reserve(num_pixels);
+			for(auto index = 0ULL; index < num_pixels; ++index) {
+				// continue each pixel's sample sequence from where the previous pass left off
+				estimates[index].m_num_samples = pass.m_first_sample;
+				requests.push_back({index, pass.m_num_samples});
+			}
+			take_samples(tile, requests, camera, shade, estimates);
+
+			// tiles don't overlap, so each pixel's sum is only updated by one thread
+			auto sums = accumulation->sums();
+			for(auto index = 0ULL; index < num_pixels; ++index) {
+				const auto x = tile.m_x + index % tile.m_width;
+				const auto row = tile.m_y + index / tile.m_width;
+				sums[row * m_width + x] += estimates[index].m_sum;
+			}
+		}
+
+		/// @brief Renders all the pixels in `tile` into `pixels`, distributing the tile's
+		/// sample budget according to the `m_adaptive_sampling` settings
+		///
+		/// @param tile - The tile to render
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`
+		/// @param pixels - The tile's pixels, row-major, to write the finished pixels to
+		template<typename Shader>
+		inline auto render_tile_adaptive(const Tile& tile,
+										 const Camera& camera,
+										 const Shader& shade,
+										 std::span<Color> pixels) const noexcept -> void {
+			const auto& settings = *m_adaptive_sampling;
+			const auto min_samples = General::max(settings.m_min_samples, narrow_cast<size_t>(2));
+			const auto max_samples = General::max(settings.m_max_samples, min_samples);
+			const auto batch_size = General::max(settings.m_batch_size, narrow_cast<size_t>(1));
+			const auto num_pixels = tile.m_width * tile.m_height;
+			auto estimates = std::vector<PixelEstimate>(num_pixels);
+			auto budget = num_pixels * m_samples_per_pixel;
+			auto requests = std::vector<SampleRequest>();
+			requests.reserve(num_pixels);
+
+			// takes the samples in `requests`, then updates the sampled pixels' convergence
+			auto sample = [&]() noexcept {
+				take_samples(tile, requests, camera, shade, estimates);
+				for(const auto& request : requests) {
+					auto& estimate = estimates[request.m_pixel];
+					estimate.m_converged = estimate.m_num_samples >= max_samples
+										   || estimate.has_converged(settings.m_error_threshold);
+				}
+			};
+
+			// when the budget is smaller than `min_samples`, every pixel takes its whole share up
+			// front instead
+			const auto initial_samples = General::min(min_samples, m_samples_per_pixel);
+			for(auto index = 0ULL; index < num_pixels; ++index) {
+				requests.push_back({index, initial_samples});
+			}
+			budget -= num_pixels * initial_samples;
+			sample();
+
+			// each round, unconverged pixels share `batch_size` samples per pixel, in proportion
+			// to their estimated error
+			auto errors = std::vector<T>(num_pixels);
+			while(budget > 0) {
+				auto total_error = narrow_cast<T>(0);
+				auto num_unconverged = 0ULL;
+				for(auto index = 0ULL; index < num_pixels; ++index) {
+					errors[index] = estimates[index].m_converged ? narrow_cast<T>(0) :
+																	 estimates[index].relative_error();
+					total_error += errors[index];
+					num_unconverged += estimates[index].m_converged ? 0ULL : 1ULL;
+				}
+				if(num_unconverged == 0 || total_error <= narrow_cast<T>(0)) {
+					break;
+				}
+
+				const auto round_budget
+					= narrow_cast<T>(General::min(num_unconverged * batch_size, budget));
+				requests.clear();
+				for(auto index = 0ULL; index < num_pixels && budget > 0; ++index) {
+					const auto share = narrow_cast<size_t>(
+						round_budget * errors[index] / total_error + narrow_cast<T>(0.5));
+					const auto num_samples = General::min(
+						General::min(share, max_samples - estimates[index].m_num_samples),
+						budget);
+					if(num_samples > 0) {
+						requests.push_back({index, num_samples});
+						budget -= num_samples;
+					}
+				}
+				if(requests.empty()) {
+					break;
+				}
+				sample();
+			}
+
+			write_estimates(estimates, pixels);
+		}
+
+		/// @brief A number of samples to take of a pixel
+		struct SampleRequest {
+			/// The index of the pixel within its tile
+			size_t m_pixel = 0;
+			size_t m_num_samples = 0;
+		};
+
+		/// @brief Takes the samples in `requests` of pixels in `tile`, in order, adding them to
+		/// the pixels' estimates. `BatchShader`s are given the camera rays of as many samples at
+		/// once as `MAX_BATCH_SIZE` allows
+		///
+		/// @param tile - The tile the pixels are in
+		/// @param requests - The samples to take
+		/// @param camera - The camera to render from
+		/// @param shade - Callable returning the color seen along a given ray, or a `BatchShader`
+		/// @param estimates - The estimates of the tile's pixels
+		template<typename Shader>
+		inline auto take_samples(const Tile& tile,
+								 std::span<const SampleRequest> requests,
+								 const Camera& camera,
+								 const Shader& shade,
+								 std::span<PixelEstimate> estimates) const noexcept -> void {
+			if constexpr(BatchShader<Shader, T>) {
+				auto rays = std::vector<Ray>();
+				auto colors = std::vector<Color>();
+				auto pixels = std::vector<size_t>();
+				rays.reserve(MAX_BATCH_SIZE);
+				pixels.reserve(MAX_BATCH_SIZE);
+
+				auto flush = [&]() noexcept {
+					colors.resize(rays.size());
+					shade(std::span<const Ray>(rays), std::span<Color>(colors));
+					for(auto i = 0ULL; i < rays.size(); ++i) {
+						estimates[pixels[i]].add(colors[i]);
+					}
+					rays.clear();
+					pixels.clear();
+				};
+
+				for(const auto& request : requests) {
+					const auto x = tile.m_x + request.m_pixel % tile.m_width;
+					const auto row = tile.m_y + request.m_pixel / tile.m_width;
+					const auto first_sample = estimates[request.m_pixel].m_num_samples;
+					for(auto i = 0ULL; i < request.m_num_samples; ++i) {
+						rays.push_back(camera_ray(x, row, first_sample + i, camera));
+						pixels.push_back(request.m_pixel);
+						if(rays.size() == MAX_BATCH_SIZE) {
+							flush();
+						}
+					}
+				}
+				if(!rays.empty()) {
+					flush();
+				}
+			}
+			else {
+				for(const auto& request : requests) {
+					const auto x = tile.m_x + request.m_pixel % tile.m_width;
+					const auto row = tile.m_y + request.m_pixel / tile.m_width;
+					auto& estimate = estimates[request.m_pixel];
+					for(auto i = 0ULL; i < request.m_num_samples; ++i) {
+						estimate.add(shade(camera_ray(x, row, estimate.m_num_samples, camera)));
+					}
+				}
+			}
+		}
+
+		/// @brief Writes the average of each pixel's samples in `estimates` to `pixels`
+		///
+		/// @param estimates - The estimates of the tile's pixels
+		/// @param pixels - The tile's pixels, to write the finished pixels to
+		inline static auto write_estimates(std::span<const PixelEstimate> estimates,
+										   std::span<Color> pixels) noexcept -> void {
+			for(auto index = 0ULL; index < estimates.size(); ++index) {
+				const auto& estimate = estimates[index];
+				pixels[index] = estimate.m_sum / narrow_cast<T>(estimate.m_num_samples);
+			}
+		}
+
+		/// @brief Generates the camera ray for a single sample of the pixel at (`x`, `row`)
+		///
+		/// @param x - The column of the pixel
+		/// @param row - The row of the pixel, counted from the top of the image
+		/// @param index - The index of the sample within the pixel
+		/// @param camera - The camera to render from
+		///
+		/// @return The camera ray of the sample
+		[[nodiscard]] inline auto
+		camera_ray(size_t x, size_t row, size_t index, const Camera& camera) const noexcept -> Ray {
+			utils::instrumentation::count(utils::instrumentation::Counter::PrimaryRays);
+
+			// camera space `v` runs bottom-to-top, but rows are stored top-to-bottom
+			const auto column = narrow_cast<T>(x);
+			const auto line = narrow_cast<T>(m_height - 1 - row);
+			const auto width = narrow_cast<T>(m_width - 1);
+			const auto height = narrow_cast<T>(m_height - 1);
+
+			if(m_sampler == nullptr) {
+				const auto u = (column + random_value<T>()) / width;
+				const auto v = (line + random_value<T>()) / height;
+				return camera.get_ray(u, v);
+			}
+
+			const auto pixel = row * m_width + x;
+			const auto jitter = m_sampler->sample_2d(pixel, index, PIXEL_DIMENSION);
+			const auto lens = m_sampler->sample_2d(pixel, index, LENS_DIMENSION);
+			return camera.get_ray((column + jitter.x()) / width,
+								  (line + jitter.y()) / height,
+								  lens);
+		}
+	};
+} // namespace graphics
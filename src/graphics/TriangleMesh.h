@@ -0,0 +1,373 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/ArrayStorage.h"
+#include "../utils/Instrumentation.h"
+#include "BoundingBox.h"
+#include "BvhTree.h"
+#include "Geometry.h"
+#include "Ray.h"
+#include "WideBvhTree.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
+	IGNORE_PADDING_START
+	/// @brief A mesh of triangles sharing a pool of vertices.
+	/// Vertex positions, and optionally normals and texture coordinates, are stored in flat
+	/// arrays, and each triangle is three 32-bit indices into them, so there is no per-triangle
+	/// heap object. The triangles are kept in the leaf order of a quantized `WideBvhTree` built
+	/// over them, so a mesh can be placed in any acceleration structure over `Geometry`s as a
+	/// single geometry, and still be intersected in roughly logarithmic time in its number of
+	/// triangles.
+	///
+	/// The tree is kept small: its leaves hold at least `MIN_LEAF_SIZE` triangles, and its nodes
+	/// are 64 bytes each, with an average of around three children. It takes 3 to 4 bytes per
+	/// triangle, so together with its 12 bytes of indices a triangle takes about 16 bytes, besides
+	/// its share of the vertices.
+	///
+	/// Rays are intersected with triangles by the watertight algorithm of Woop, Benthin, and Wald
+	/// (2013): rays passing through an edge or vertex shared by several triangles hit at least one
+	/// of them, so there are no cracks between neighbouring triangles.
+	///
+	/// The surface normal at a hit is the interpolated vertex normal, if the mesh has normals, or
+	/// the triangle's face normal otherwise.
+	///
+	/// A mesh can also borrow its arrays, including its tree, from memory owned elsewhere, such as
+	/// a mapped `SceneFile`, so loading it involves no copying or rebuilding.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	template<FloatingPoint T = float>
+	class TriangleMesh final : public Geometry<T> {
+		using Ray = Ray<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using BoundingBox = BoundingBox<T>;
+		using Point2 = Point2<T>;
+		using Point3 = Point3<T>;
+		using Vec3 = Vec3<T>;
+
+	  public:
+		using Tree = WideBvhTree<T, true>;
+		using Node = typename Tree::Node;
+
+		/// The fewest triangles in a leaf of the tree, unless the mesh has fewer. Testing a ray
+		/// against a few more triangles per leaf costs less than the memory the nodes that would
+		/// split them further take, for meshes too large to stay in cache
+		static constexpr size_t MIN_LEAF_SIZE = 8;
+
+		/// @brief Views of the arrays making up a mesh
+		struct Arrays {
+			std::span<const Point3> m_positions;
+			/// The normal of each vertex, or empty
+			std::span<const Vec3> m_normals;
+			/// The texture coordinates of each vertex, or empty
+			std::span<const Point2> m_uvs;
+			/// The vertices of each triangle, three per triangle, in the tree's leaf order
+			std::span<const uint32_t> m_indices;
+			/// The nodes of the tree over the triangles
+			std::span<const Node> m_nodes;
+		};
+
+		/// @brief Creates a `TriangleMesh`
+		///
+		/// @param positions - The positions of the vertices
+		/// @param indices - The indices of the vertices of each triangle, three per triangle, in
+		/// counter-clockwise order as seen from the side the face normal points out of
+		/// @param material_id - The id of the mesh's material in the scene's `MaterialTable`
+		/// @param normals - The normal of each vertex, or empty to use face normals
+		/// @param uvs - The texture coordinates of each vertex, or empty
+		/// @param settings - How to build the tree over the triangles. Its minimum leaf size is
+		/// raised to `MIN_LEAF_SIZE`
+		TriangleMesh(std::vector<Point3>&& positions,
+					 std::vector<uint32_t>&& indices,
+					 uint32_t material_id,
+					 std::vector<Vec3>&& normals = {},
+					 std::vector<Point2>&& uvs = {},
+					 BvhBuildSettings settings = BvhBuildSettings()) noexcept
+			: m_positions(std::move(positions)), m_normals(std::move(normals)),
+			  m_uvs(std::move(uvs)), m_material_id(material_id) {
+			const auto vertices = m_positions.span();
+			const auto num_triangles = indices.size() / 3;
+			auto bounds = std::vector<BoundingBox>();
+			bounds.reserve(num_triangles);
+			for(auto triangle = 0ULL; triangle < num_triangles; ++triangle) {
+				bounds.push_back(BoundingBox()
+									 .merged(vertices[indices[3 * triangle]])
+									 .merged(vertices[indices[3 * triangle + 1]])
+									 .merged(vertices[indices[3 * triangle + 2]]));
+			}
+
+			settings.m_min_leaf_size = General::max(settings.m_min_leaf_size, MIN_LEAF_SIZE);
+			auto order = std::vector<uint32_t>();
+			m_tree = Tree(bounds, &order, settings);
+			auto& ordered = m_indices.owned();
+			ordered.reserve(3 * num_triangles);
+			for(const auto triangle : order) {
+				ordered.push_back(indices[3ULL * triangle]);
+				ordered.push_back(indices[3ULL * triangle + 1]);
+				ordered.push_back(indices[3ULL * triangle + 2]);
+			}
+		}
+
+		/// @brief Creates a `TriangleMesh` borrowing already built arrays, as returned by
+		/// `arrays`. The arrays must outlive the mesh
+		///
+		/// @param arrays - The mesh's arrays
+		/// @param material_id - The id of the mesh's material in the scene's `MaterialTable`
+		TriangleMesh(const Arrays& arrays, uint32_t material_id) noexcept
+			: m_positions(arrays.m_positions), m_normals(arrays.m_normals), m_uvs(arrays.m_uvs),
+			  m_indices(arrays.m_indices), m_tree(arrays.m_nodes), m_material_id(material_id) {
+		}
+		TriangleMesh(const TriangleMesh& mesh) noexcept = default;
+		TriangleMesh(TriangleMesh&& mesh) noexcept = default;
+		~TriangleMesh() noexcept final = default;
+
+		/// @brief Returns the number of triangles in the mesh
+		///
+		/// @return The number of triangles
+		[[nodiscard]] inline auto num_triangles() const noexcept -> size_t {
+			return m_indices.size() / 3;
+		}
+
+		/// @brief Returns the number of vertices in the mesh
+		///
+		/// @return The number of vertices
+		[[nodiscard]] inline auto num_vertices() const noexcept -> size_t {
+			return m_positions.size();
+		}
+
+		/// @brief Returns the id of the mesh's material
+		///
+		/// @return The material id
+		[[nodiscard]] inline auto material_id() const noexcept -> uint32_t {
+			return m_material_id;
+		}
+
+		/// @brief Returns views of the arrays making up the mesh
+		///
+		/// @return The mesh's arrays
+		[[nodiscard]] inline auto arrays() const noexcept -> Arrays {
+			return {m_positions.span(),
+					m_normals.span(),
+					m_uvs.span(),
+					m_indices.span(),
+					m_tree.nodes()};
+		}
+
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record) const noexcept -> bool final {
+			const auto transform = RayTransform(ray);
+			auto num_tested = 0ULL;
+			const auto found = m_tree.intersected(
+				ray,
+				min_length,
+				max_length,
+				record,
+				[&](uint32_t triangle, T closest) noexcept -> bool {
+					++num_tested;
+					const auto hit = intersect_triangle(transform, triangle, min_length, closest);
+					if(!hit) {
+						return false;
+					}
+					record->m_length = hit.m_length;
+					record->m_primitive_id = triangle;
+					record->m_material_id = m_material_id;
+					record->m_geometry = this;
+					record->m_instance = nullptr;
+					return true;
+				});
+			utils::instrumentation::count(utils::instrumentation::Counter::IntersectionTests,
+										  num_tested);
+			return found;
+		}
+
+		[[nodiscard]] inline auto surface(const Ray& ray, const HitRecord& record) const noexcept
+			-> SurfaceRecord final {
+			const auto triangle = record.m_primitive_id;
+			const auto hit = intersect_triangle(RayTransform(ray),
+												triangle,
+												-Constants<T>::infinity,
+												Constants<T>::infinity);
+			const auto [first, second, third] = vertices(triangle);
+			const auto& p0 = m_positions[first];
+			const auto& p1 = m_positions[second];
+			const auto& p2 = m_positions[third];
+
+			auto surface = SurfaceRecord(Point3((p0.as_vec() * hit.m_barycentrics[0]
+												 + p1.as_vec() * hit.m_barycentrics[1]
+												 + p2.as_vec() * hit.m_barycentrics[2])));
+			const auto face_normal = (p1 - p0).as_vec().cross_prod((p2 - p0).as_vec()).normalized();
+			surface.set_normal(ray, face_normal);
+
+			if(!m_normals.empty()) {
+				const auto normal = (m_normals[first] * hit.m_barycentrics[0]
+									 + m_normals[second] * hit.m_barycentrics[1]
+									 + m_normals[third] * hit.m_barycentrics[2])
+										.normalized();
+				// keep the shading normal on the side of the surface the ray arrived from
+				surface.m_normal = normal.dot_prod(surface.m_normal) < narrow_cast<T>(0) ? -normal :
+																						   normal;
+			}
+			if(!m_uvs.empty()) {
+				surface.m_uv = m_uvs[first] * hit.m_barycentrics[0]
+							   + (m_uvs[second] * hit.m_barycentrics[1]).as_vec()
+							   + (m_uvs[third] * hit.m_barycentrics[2]).as_vec();
+			}
+
+			return surface;
+		}
+
+		[[nodiscard]] inline auto bounding_box() const noexcept -> BoundingBox final {
+			return m_tree.bounding_box();
+		}
+
+		auto operator=(const TriangleMesh& mesh) noexcept -> TriangleMesh& = default;
+		auto operator=(TriangleMesh&& mesh) noexcept -> TriangleMesh& = default;
+
+	  private:
+		/// Hits this close to the start of the accepted range are rejected, as by `Sphere`
+		static constexpr T HIT_THRESHOLD = narrow_cast<T>(0.005);
+
+		utils::ArrayStorage<Point3> m_positions;
+		utils::ArrayStorage<Vec3> m_normals;
+		utils::ArrayStorage<Point2> m_uvs;
+		/// The vertices of each triangle, three per triangle, in the tree's leaf order
+		utils::ArrayStorage<uint32_t> m_indices;
+		Tree m_tree;
+		uint32_t m_material_id;
+
+		/// @brief A ray, transformed so that its direction is the unit z axis of a shear space.
+		/// Computed once per ray and shared by every triangle it's tested against
+		struct RayTransform {
+			Point3 m_origin;
+			/// The axis the ray's direction is largest along, mapped to z
+			Vec3Idx m_kz;
+			/// The axes mapped to x and y, chosen to preserve the triangles' winding
+			Vec3Idx m_kx;
+			Vec3Idx m_ky;
+			/// The shear mapping the ray's direction to the z axis
+			T m_shear_x;
+			T m_shear_y;
+			T m_shear_z;
+
+			explicit RayTransform(const Ray& ray) noexcept : m_origin(ray.origin()) {
+				const auto& direction = ray.direction();
+				const auto x = General::abs(direction.x());
+				const auto y = General::abs(direction.y());
+				const auto z = General::abs(direction.z());
+				const auto kz = x > y ? (x > z ? 0ULL : 2ULL) : (y > z ? 1ULL : 2ULL);
+				auto kx = (kz + 1) % 3;
+				auto ky = (kx + 1) % 3;
+				if(direction[static_cast<Vec3Idx>(kz)] < narrow_cast<T>(0)) {
+					std::swap(kx, ky);
+				}
+
+				m_kx = static_cast<Vec3Idx>(kx);
+				m_ky = static_cast<Vec3Idx>(ky);
+				m_kz = static_cast<Vec3Idx>(kz);
+				m_shear_x = direction[m_kx] / direction[m_kz];
+				m_shear_y = direction[m_ky] / direction[m_kz];
+				m_shear_z = narrow_cast<T>(1) / direction[m_kz];
+			}
+		};
+
+		/// @brief The result of testing a ray against a triangle
+		struct TriangleHit {
+			T m_length = narrow_cast<T>(0);
+			/// The weights of the triangle's vertices at the hit
+			std::array<T, 3> m_barycentrics = {};
+			bool m_hit = false;
+
+			explicit constexpr operator bool() const noexcept {
+				return m_hit;
+			}
+		};
+
+		/// @brief Returns the indices of the vertices of `triangle`
+		[[nodiscard]] inline auto vertices(uint32_t triangle) const noexcept
+			-> std::array<uint32_t, 3> {
+			return {m_indices[3ULL * triangle],
+					m_indices[3ULL * triangle + 1],
+					m_indices[3ULL * triangle + 2]};
+		}
+
+		/// @brief Tests a ray against `triangle` with the watertight algorithm
+		///
+		/// @param ray - The transformed ray to test
+		/// @param triangle - The index of the triangle, in leaf order
+		/// @param min_length - The minimum length along the ray to accept a hit at
+		/// @param max_length - The maximum length along the ray to accept a hit at
+		///
+		/// @return The hit, if any
+		[[nodiscard]] inline auto intersect_triangle(const RayTransform& ray,
+													 uint32_t triangle,
+													 T min_length,
+													 T max_length) const noexcept -> TriangleHit {
+			const auto [first, second, third] = vertices(triangle);
+			const auto a = (m_positions[first] - ray.m_origin).as_vec();
+			const auto b = (m_positions[second] - ray.m_origin).as_vec();
+			const auto c = (m_positions[third] - ray.m_origin).as_vec();
+
+			// shear and scale the vertices into the ray's space, where it runs along +z
+			const auto ax = a[ray.m_kx] - ray.m_shear_x * a[ray.m_kz];
+			const auto ay = a[ray.m_ky] - ray.m_shear_y * a[ray.m_kz];
+			const auto bx = b[ray.m_kx] - ray.m_shear_x * b[ray.m_kz];
+			const auto by = b[ray.m_ky] - ray.m_shear_y * b[ray.m_kz];
+			const auto cx = c[ray.m_kx] - ray.m_shear_x * c[ray.m_kz];
+			const auto cy = c[ray.m_ky] - ray.m_shear_y * c[ray.m_kz];
+
+			// scaled barycentric coordinates: twice the signed areas of the sub-triangles
+			// opposite each vertex
+			auto u = cx * by - cy * bx;
+			auto v = ax * cy - ay * cx;
+			auto w = bx * ay - by * ax;
+
+			// on an edge, fall back to double precision, so the edge test is exact
+			if constexpr(std::is_same_v<T, float>) {
+				if(u == 0.0F || v == 0.0F || w == 0.0F) {
+					u = narrow_cast<T>(static_cast<double>(cx) * static_cast<double>(by)
+									   - static_cast<double>(cy) * static_cast<double>(bx));
+					v = narrow_cast<T>(static_cast<double>(ax) * static_cast<double>(cy)
+									   - static_cast<double>(ay) * static_cast<double>(cx));
+					w = narrow_cast<T>(static_cast<double>(bx) * static_cast<double>(ay)
+									   - static_cast<double>(by) * static_cast<double>(ax));
+				}
+			}
+
+			const auto zero = narrow_cast<T>(0);
+			if((u < zero || v < zero || w < zero) && (u > zero || v > zero || w > zero)) {
+				return {};
+			}
+
+			const auto determinant = u + v + w;
+			if(determinant == zero) {
+				return {};
+			}
+
+			const auto az = ray.m_shear_z * a[ray.m_kz];
+			const auto bz = ray.m_shear_z * b[ray.m_kz];
+			const auto cz = ray.m_shear_z * c[ray.m_kz];
+			const auto inverse_determinant = narrow_cast<T>(1) / determinant;
+			const auto length = (u * az + v * bz + w * cz) * inverse_determinant;
+			if(length < min_length + HIT_THRESHOLD || length > max_length) {
+				return {};
+			}
+
+			return {length,
+					{u * inverse_determinant, v * inverse_determinant, w * inverse_determinant},
+					true};
+		}
+	};
+	IGNORE_PADDING_STOP
+} // namespace graphics
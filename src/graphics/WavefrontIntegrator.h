@@ -0,0 +1,329 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../utils/Instrumentation.h"
+#include "Color.h"
+#include "Geometry.h"
+#include "PathIntegrator.h"
+#include "Ray.h"
+#include "materials/MaterialTable.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
+	/// @brief Computes the colors seen along a batch of camera rays by tracing their paths
+	/// through the scene together, one bounce at a time (a "wavefront" or "stream" path tracer).
+	///
+	/// Where `PathIntegrator` follows one path to its end before starting the next, this keeps a
+	/// queue of every active path in the batch, stored structure-of-arrays, and runs each stage
+	/// of a bounce over the whole queue before moving on to the next:
+	/// 1. Extension: find the closest hit of every path's ray. Paths that miss are finished
+	/// 2. Shading: compute the surface at every hit, group the hits by the kind of their material
+	/// (see `MaterialTable::kind`), then scatter each group with its material's scatter function.
+	/// Paths that are absorbed, or terminated by Russian roulette, are finished; the rest are
+	/// compacted into the queue for the next bounce
+	///
+	/// Each stage therefore runs the same code over many paths in a row, rather than alternating
+	/// between traversal and the scatter functions of unrelated materials on every bounce, which
+	/// is friendlier to the instruction cache and branch predictors.
+	///
+	/// Paths are terminated by Russian roulette by `PathIntegrator::survives_roulette`, exactly as
+	/// in `PathIntegrator`, so for the same settings both produce the same expected image.
+	///
+	/// `WavefrontIntegrator` is callable with a span of `Ray`s and a span of `Color`s, so it can
+	/// be passed to `TileRenderer::render` directly as a batch shader.
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class WavefrontIntegrator {
+	  public:
+		using Color = Color<T>;
+		using Geometry = Geometry<T>;
+		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using MaterialTable = MaterialTable<T>;
+		using Ray = Ray<T>;
+
+		/// Default maximum number of bounces along a path
+		static constexpr size_t DEFAULT_MAX_DEPTH = PathIntegrator<T>::DEFAULT_MAX_DEPTH;
+		/// Default number of bounces before Russian roulette starts terminating paths
+		static constexpr size_t DEFAULT_MIN_BOUNCES = PathIntegrator<T>::DEFAULT_MIN_BOUNCES;
+
+		/// @brief Creates a `WavefrontIntegrator` tracing paths through `scene`
+		///
+		/// @param scene - The scene to trace paths through. Must outlive the integrator
+		/// @param materials - The materials of the scene. Must outlive the integrator
+		/// @param max_depth - The maximum number of bounces along a path
+		/// @param min_bounces - The number of bounces before Russian roulette starts. Pass
+		/// `max_depth` or greater to disable Russian roulette
+		WavefrontIntegrator(const Geometry& scene,
+							const MaterialTable& materials,
+							size_t max_depth = DEFAULT_MAX_DEPTH,
+							size_t min_bounces = DEFAULT_MIN_BOUNCES) noexcept
+			: m_scene(&scene),
+			  m_materials(&materials),
+			  m_max_depth(max_depth),
+			  m_min_bounces(min_bounces) {
+		}
+		WavefrontIntegrator(const WavefrontIntegrator& integrator) noexcept = default;
+		WavefrontIntegrator(WavefrontIntegrator&& integrator) noexcept = default;
+		~WavefrontIntegrator() noexcept = default;
+
+		/// @brief Traces a path starting along each of `rays`
+		///
+		/// @param rays - The rays to start paths along
+		/// @param colors - Where to write the color seen along each ray. Must be the same size as
+		/// `rays`
+		inline auto
+		operator()(std::span<const Ray> rays, std::span<Color> colors) const noexcept -> void {
+			// the queues are reused across batches, so they're only allocated once per thread
+			static thread_local auto queues = Queues(); // NOLINT
+			auto& [paths, next, hits] = queues;
+			paths.clear();
+			next.clear();
+			paths.reserve(rays.size());
+			next.reserve(rays.size());
+			hits.reserve(rays.size());
+
+			for(auto i = 0ULL; i < rays.size(); ++i) {
+				paths.push(rays[i], WHITE, narrow_cast<uint32_t>(i));
+				colors[i] = BLACK;
+			}
+
+			using utils::instrumentation::Stage;
+			for(auto bounce = 0ULL; bounce < m_max_depth && !paths.empty(); ++bounce) {
+				{
+					const auto timer = utils::instrumentation::ScopedTimer(Stage::Extend);
+					extend(paths, &hits, colors);
+				}
+				{
+					const auto timer = utils::instrumentation::ScopedTimer(Stage::Shade);
+					shade(paths, bounce, &hits, &next);
+				}
+				utils::instrumentation::count(utils::instrumentation::Counter::SecondaryRays,
+											  next.size());
+				std::swap(paths, next);
+				next.clear();
+			}
+		}
+
+		auto operator=(const WavefrontIntegrator& integrator) noexcept
+			-> WavefrontIntegrator& = default;
+		auto operator=(WavefrontIntegrator&& integrator) noexcept -> WavefrontIntegrator& = default;
+
+	  private:
+		static constexpr Color WHITE
+			= Color(narrow_cast<T>(1), narrow_cast<T>(1), narrow_cast<T>(1));
+		static constexpr Color BLACK
+			= Color(narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0));
+		/// @brief The active paths of a batch, structure-of-arrays
+		struct PathQueue {
+			/// The ray each path continues along
+			std::vector<Ray> m_rays;
+			/// The product of the attenuations along each path so far
+			std::vector<Color> m_throughputs;
+			/// The index of each path's color in the batch's output
+			std::vector<uint32_t> m_slots;
+
+			inline auto reserve(size_t capacity) noexcept -> void {
+				m_rays.reserve(capacity);
+				m_throughputs.reserve(capacity);
+				m_slots.reserve(capacity);
+			}
+
+			inline auto push(const Ray& ray, const Color& throughput, uint32_t slot) noexcept
+				-> void {
+				m_rays.push_back(ray);
+				m_throughputs.push_back(throughput);
+				m_slots.push_back(slot);
+			}
+
+			inline auto clear() noexcept -> void {
+				m_rays.clear();
+				m_throughputs.clear();
+				m_slots.clear();
+			}
+
+			[[nodiscard]] inline auto size() const noexcept -> size_t {
+				return m_rays.size();
+			}
+
+			[[nodiscard]] inline auto empty() const noexcept -> bool {
+				return m_rays.empty();
+			}
+		};
+
+		/// @brief The paths that hit something this bounce, structure-of-arrays
+		struct HitQueue {
+			/// The index in the `PathQueue` of each path that hit something
+			std::vector<uint32_t> m_paths;
+			/// The closest hit of each path
+			std::vector<HitRecord> m_hits;
+			/// The surface at each hit
+			std::vector<SurfaceRecord> m_surfaces;
+			/// The kind of material of each surface. See `MaterialTable::kind`
+			std::vector<uint32_t> m_kinds;
+			/// The hits, ordered by the kind of their material
+			std::vector<uint32_t> m_order;
+			/// The ray each path was scattered along
+			std::vector<Ray> m_scattered;
+			/// The throughput of each path after scattering
+			std::vector<Color> m_throughputs;
+			/// Whether each path continues to the next bounce
+			std::vector<uint8_t> m_continues;
+
+			inline auto reserve(size_t capacity) noexcept -> void {
+				m_paths.reserve(capacity);
+				m_hits.reserve(capacity);
+				m_surfaces.reserve(capacity);
+				m_kinds.reserve(capacity);
+				m_order.reserve(capacity);
+				m_scattered.reserve(capacity);
+				m_throughputs.reserve(capacity);
+				m_continues.reserve(capacity);
+			}
+
+			inline auto clear() noexcept -> void {
+				m_paths.clear();
+				m_hits.clear();
+				m_surfaces.clear();
+				m_kinds.clear();
+				m_order.clear();
+			}
+		};
+
+		/// @brief The queues used to trace a batch
+		struct Queues {
+			PathQueue m_paths;
+			PathQueue m_next;
+			HitQueue m_hits;
+		};
+
+		NotNull<const Geometry> m_scene;
+		NotNull<const MaterialTable> m_materials;
+		size_t m_max_depth;
+		size_t m_min_bounces;
+
+		/// @brief Finds the closest hit of every path in `paths`, gathering them into `hits`.
+		/// Paths that miss the scene are finished with the background color
+		///
+		/// @param paths - The active paths
+		/// @param hits - Where to gather the hits
+		/// @param colors - The batch's output colors
+		inline auto extend(const PathQueue& paths,
+						   NotNull<HitQueue> hits,
+						   std::span<Color> colors) const noexcept -> void {
+			hits->clear();
+			for(auto path = 0ULL; path < paths.size(); ++path) {
+				auto hit = HitRecord();
+				if(m_scene->intersected(paths.m_rays[path],
+										narrow_cast<T>(0),
+										Constants<T>::infinity,
+										&hit))
+				{
+					hits->m_paths.push_back(narrow_cast<uint32_t>(path));
+					hits->m_hits.push_back(hit);
+				}
+				else {
+					const auto& ray = paths.m_rays[path];
+					colors[paths.m_slots[path]]
+						= paths.m_throughputs[path] * PathIntegrator<T>::background(ray);
+				}
+			}
+		}
+
+		/// @brief Scatters every path in `hits` off the surface it hit, grouped by the kind of the
+		/// surface's material, then pushes the paths that continue onto `next`, in their original
+		/// order
+		///
+		/// @param paths - The active paths
+		/// @param bounce - The index of the current bounce
+		/// @param hits - The hits of the active paths
+		/// @param next - Where to push the paths that continue to the next bounce
+		inline auto shade(const PathQueue& paths,
+						  size_t bounce,
+						  NotNull<HitQueue> hits,
+						  NotNull<PathQueue> next) const noexcept -> void {
+			const auto num_hits = hits->m_hits.size();
+			auto counts = std::array<size_t, MaterialTable::NUM_KINDS + 1>();
+			for(auto i = 0ULL; i < num_hits; ++i) {
+				hits->m_surfaces.push_back(
+					hits->m_hits[i].surface(paths.m_rays[hits->m_paths[i]]));
+				const auto kind = narrow_cast<uint32_t>(m_materials->kind(hits->m_surfaces[i]));
+				hits->m_kinds.push_back(kind);
+				++counts[kind + 1];
+			}
+
+			// counting sort the hits by kind; `counts[kind]` becomes the start of the kind's run
+			for(auto kind = 1ULL; kind < counts.size(); ++kind) {
+				counts[kind] += counts[kind - 1];
+			}
+			const auto starts = counts;
+			hits->m_order.resize(num_hits);
+			for(auto i = 0ULL; i < num_hits; ++i) {
+				hits->m_order[counts[hits->m_kinds[i]]++] = narrow_cast<uint32_t>(i);
+			}
+
+			hits->m_scattered.resize(num_hits);
+			hits->m_throughputs.resize(num_hits);
+			hits->m_continues.resize(num_hits);
+			[&]<size_t... Kinds>(std::index_sequence<Kinds...>) noexcept {
+				(scatter_run<Kinds>(
+					 paths,
+					 bounce,
+					 std::span<const uint32_t>(hits->m_order)
+						 .subspan(starts[Kinds], starts[Kinds + 1] - starts[Kinds]),
+					 hits),
+				 ...);
+			}(std::make_index_sequence<MaterialTable::NUM_KINDS>());
+
+			// compact in the original order, which keeps paths from neighbouring pixels together
+			for(auto i = 0ULL; i < num_hits; ++i) {
+				if(hits->m_continues[i] != 0) {
+					next->push(hits->m_scattered[i],
+							   hits->m_throughputs[i],
+							   paths.m_slots[hits->m_paths[i]]);
+				}
+			}
+		}
+
+		/// @brief Scatters the paths of the hits in `run`, all of whose materials are of kind
+		/// `Kind`, recording whether each continues to the next bounce, and if so along which ray
+		template<size_t Kind>
+		inline auto scatter_run(const PathQueue& paths,
+								size_t bounce,
+								std::span<const uint32_t> run,
+								NotNull<HitQueue> hits) const noexcept -> void {
+			for(const auto hit : run) {
+				const auto path = hits->m_paths[hit];
+				auto attenuation = Color();
+				hits->m_continues[hit] = 0;
+				if(!m_materials->template scatter_as<Kind>(paths.m_rays[path],
+														   hits->m_surfaces[hit],
+														   &attenuation,
+														   &hits->m_scattered[hit]))
+				{
+					continue;
+				}
+
+				auto throughput = paths.m_throughputs[path] * attenuation;
+				if(bounce + 1 >= m_min_bounces
+				   && !PathIntegrator<T>::survives_roulette(&throughput))
+				{
+					continue;
+				}
+
+				hits->m_throughputs[hit] = throughput;
+				hits->m_continues[hit] = 1;
+			}
+		}
+	};
+} // namespace graphics
@@ -0,0 +1,575 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/StandardIncludes.h"
+#include "../math/Simd.h"
+#include "../utils/ArrayStorage.h"
+#include "../utils/Instrumentation.h"
+#include "BoundingBox.h"
+#include "BvhTree.h"
+#include "Ray.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::int8_t;
+	using std::uint16_t;
+	using std::uint32_t;
+	using std::uint8_t;
+#endif
+
+	/// @brief A 4-wide Bounding Volume Hierarchy, for tracing rays through large sets of
+	/// primitives with fewer, smaller nodes than a (binary) `BvhTree`.
+	/// The tree is built by collapsing a `BvhTree`, pulling the children of a node's largest
+	/// children up into it until it has `WIDTH` children. Each node stores the bounds of its
+	/// children structure-of-arrays, so a ray is tested against all of them with one pass of SIMD
+	/// instructions (see `math::simd::Float4`), and its children are visited nearest first.
+	///
+	/// With `Quantized`, the children's bounds are stored as 8-bit offsets on a grid spanning the
+	/// node, rounded outwards so that they always contain the children. A `float` node then fits
+	/// in a 64-byte cache line, and the tree takes around a third of the memory of the `BvhTree`
+	/// it was collapsed from, at the cost of rays being tested against slightly larger boxes.
+	///
+	/// Like `BvhTree`, the tree doesn't store the primitives themselves: building it produces the
+	/// order to store them in, and traversing it calls back into the owner of the primitives to
+	/// intersect them. Also like `BvhTree`, it can borrow its nodes from memory owned elsewhere.
+	///
+	/// @tparam T - The floating point type used for geometry and rays
+	/// @tparam Quantized - Whether to store the children's bounds quantized
+	template<FloatingPoint T = float, bool Quantized = true>
+	class WideBvhTree {
+	  public:
+		using BoundingBox = BoundingBox<T>;
+		using BvhTree = BvhTree<T>;
+		using HitRecord = HitRecord<T>;
+		using Point3 = Point3<T>;
+		using Ray = Ray<T>;
+		using Vec3 = Vec3<T>;
+
+		/// The maximum number of children of a node, tested against a ray together
+		static constexpr size_t WIDTH = math::simd::LANES;
+		/// The largest offset of a quantized bound on its node's grid
+		static constexpr uint32_t MAX_QUANTIZED = std::numeric_limits<uint8_t>::max();
+
+		/// The type the children's bounds are stored as: an offset on the node's grid when
+		/// `Quantized`, or the coordinate itself
+		using Bound = std::conditional_t<Quantized, uint8_t, T>;
+
+		/// @brief A node in the tree, storing the bounds of its children structure-of-arrays
+		struct alignas(64) Node {
+			/// The minimum corner of the grid the children's bounds are quantized to.
+			/// Only used when `Quantized`
+			T m_origin[3] = {};
+			/// The spacing of the grid along each axis, as the exponent of a power of two.
+			/// Only used when `Quantized`
+			int8_t m_exponent[3] = {};
+			/// The number of children
+			uint8_t m_num_children = 0;
+			/// The minimum corners of the children's bounds, by axis then child
+			Bound m_min[3][WIDTH] = {};
+			/// The maximum corners of the children's bounds, by axis then child
+			Bound m_max[3][WIDTH] = {};
+			/// For leaf children: the index of the first primitive in the leaf.
+			/// For interior children: the index of the child node
+			uint32_t m_child[WIDTH] = {};
+			/// The number of primitives in each leaf child, or 0 for interior children
+			uint16_t m_count[WIDTH] = {};
+		};
+
+		constexpr WideBvhTree() noexcept = default;
+
+		/// @brief Creates a `WideBvhTree` borrowing already built nodes. The nodes must outlive
+		/// the tree. Its bounds are those of the root's children, as they're tested against rays,
+		/// so when `Quantized` can be slightly larger than those of the tree the nodes were
+		/// collapsed from
+		///
+		/// @param nodes - The nodes of the tree, root first, as returned by `nodes`
+		explicit WideBvhTree(std::span<const Node> nodes) noexcept : m_nodes(nodes) {
+			if(nodes.empty()) {
+				return;
+			}
+
+			for(auto child = 0ULL; child < nodes[0].m_num_children; ++child) {
+				m_bounds = m_bounds.merged(child_bounds(nodes[0], child));
+			}
+		}
+
+		/// @brief Builds a `WideBvhTree` over primitives with the given bounds, by building a
+		/// `BvhTree` over them and collapsing it
+		///
+		/// @param bounds - The bounds of each primitive
+		/// @param order - Where to write the order to store the primitives in: the index in
+		/// `bounds` of the primitive the tree's leaves refer to by each index
+		/// @param settings - How to build the `BvhTree`
+		WideBvhTree(std::span<const BoundingBox> bounds,
+					NotNull<std::vector<uint32_t>> order,
+					const BvhBuildSettings& settings = BvhBuildSettings()) noexcept
+			: WideBvhTree(BvhTree(bounds, order, settings)) {
+		}
+
+		/// @brief Builds a `WideBvhTree` by collapsing `tree`. The leaves of `tree`, and so the
+		/// order its primitives are stored in, are kept as they are
+		///
+		/// @param tree - The tree to collapse
+		explicit WideBvhTree(const BvhTree& tree) noexcept {
+			const auto nodes = tree.nodes();
+			if(nodes.empty()) {
+				return;
+			}
+
+			m_bounds = nodes[0].m_bounds;
+			ignore(collapse(nodes, 0U));
+			m_nodes.owned().shrink_to_fit();
+		}
+		constexpr WideBvhTree(const WideBvhTree& tree) noexcept = default;
+		constexpr WideBvhTree(WideBvhTree&& tree) noexcept = default;
+		constexpr ~WideBvhTree() noexcept = default;
+
+		/// @brief Returns the nodes of the tree, root first
+		///
+		/// @return The nodes
+		[[nodiscard]] inline constexpr auto nodes() const noexcept -> std::span<const Node> {
+			return m_nodes.span();
+		}
+
+		/// @brief Returns the bounds of the whole tree
+		///
+		/// @return The bounds of the root
+		[[nodiscard]] inline constexpr auto bounding_box() const noexcept -> BoundingBox {
+			return m_bounds;
+		}
+
+		/// @brief Returns the bounds of one of `node`'s children, as the child is tested against
+		/// rays. When `Quantized`, this contains the child's exact bounds
+		///
+		/// @param node - The node to get the bounds of a child of
+		/// @param child - The index of the child in `node`
+		///
+		/// @return The bounds of the child
+		[[nodiscard]] inline static auto
+		child_bounds(const Node& node, size_t child) noexcept -> BoundingBox {
+			return {Point3(plane(node, 0, node.m_min[0][child]), // NOLINT
+						   plane(node, 1, node.m_min[1][child]), // NOLINT
+						   plane(node, 2, node.m_min[2][child])), // NOLINT
+					Point3(plane(node, 0, node.m_max[0][child]), // NOLINT
+						   plane(node, 1, node.m_max[1][child]), // NOLINT
+						   plane(node, 2, node.m_max[2][child]))}; // NOLINT
+		}
+
+		/// @brief Finds the closest hit of `ray` on the tree's primitives, within the given range
+		/// of lengths along the ray
+		///
+		/// @param ray - The ray to test
+		/// @param min_length - The minimum length along the ray to accept a hit at
+		/// @param max_length - The maximum length along the ray to accept a hit at
+		/// @param record - Where to record the closest hit
+		/// @param intersect - Callable taking the index of a primitive, in leaf order, and the
+		/// maximum length to accept a hit at. Intersects `ray` with the primitive as
+		/// `Geometry::intersected` would, recording any hit into `record`
+		///
+		/// @return Whether any primitive was hit
+		template<typename Intersect>
+		inline auto intersected(const Ray& ray,
+								T min_length,
+								T max_length,
+								NotNull<HitRecord> record,
+								Intersect&& intersect) const noexcept -> bool {
+			const auto nodes = m_nodes.span();
+			if(nodes.empty()) {
+				return false;
+			}
+
+			const auto& direction = ray.direction();
+			const auto inverse_direction = Vec3(narrow_cast<T>(1) / direction.x(),
+												narrow_cast<T>(1) / direction.y(),
+												narrow_cast<T>(1) / direction.z());
+
+			auto hit_found = false;
+			auto closest = max_length;
+			// left uninitialized, as only the queued entries are ever read, and initializing the
+			// whole queue would cost more than traversing a small tree
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+			std::array<Visit, MAX_TO_VISIT> to_visit;
+			to_visit[0] = {0U, min_length};
+			auto num_to_visit = 1ULL;
+			auto num_visited = 0ULL;
+
+			while(num_to_visit != 0) {
+				const auto visit = to_visit[--num_to_visit];
+				// a hit found since the node was queued may have put it out of reach
+				if(visit.m_near > closest) {
+					continue;
+				}
+
+				const auto& node = nodes[visit.m_node];
+				++num_visited;
+				const auto hits = intersected_children(node,
+													   ray.origin(),
+													   inverse_direction,
+													   min_length,
+													   closest);
+
+				// sort the children hit nearest first, so `closest` shrinks sooner
+				auto nearest = std::array<uint32_t, WIDTH>();
+				auto num_hit = 0ULL;
+				for(auto lanes = hits.m_lanes; lanes != 0U; lanes &= lanes - 1U) {
+					const auto child = narrow_cast<uint32_t>(std::countr_zero(lanes));
+					auto position = num_hit++;
+					while(position > 0 && hits.m_near[nearest[position - 1]] > hits.m_near[child]) {
+						nearest[position] = nearest[position - 1];
+						--position;
+					}
+					nearest[position] = child;
+				}
+
+				// intersect the leaves straight away, then queue the interior children farthest
+				// first, so the nearest is visited next
+				for(auto i = 0ULL; i < num_hit; ++i) {
+					const auto child = nearest[i];
+					if(node.m_count[child] == 0 || hits.m_near[child] > closest) {
+						continue;
+					}
+
+					const auto first = node.m_child[child];
+					const auto last = first + node.m_count[child];
+					for(auto primitive = first; primitive < last; ++primitive) {
+						if(intersect(primitive, closest)) {
+							hit_found = true;
+							closest = record->m_length;
+						}
+					}
+				}
+				for(auto i = num_hit; i > 0; --i) {
+					const auto child = nearest[i - 1];
+					if(node.m_count[child] == 0) {
+						to_visit[num_to_visit++] = {node.m_child[child], hits.m_near[child]};
+					}
+				}
+			}
+
+			utils::instrumentation::count(utils::instrumentation::Counter::BvhNodesVisited,
+										  num_visited);
+			return hit_found;
+		}
+
+		constexpr auto operator=(const WideBvhTree& tree) noexcept -> WideBvhTree& = default;
+		constexpr auto operator=(WideBvhTree&& tree) noexcept -> WideBvhTree& = default;
+
+	  private:
+		/// The smallest exponent of a grid spacing, the smallest normal `float` power of two
+		static constexpr int MIN_EXPONENT = -126;
+		/// The largest exponent of a grid spacing
+		static constexpr int MAX_EXPONENT = std::numeric_limits<int8_t>::max();
+		/// The maximum number of nodes queued during traversal: each node visited replaces itself
+		/// with at most `WIDTH` children, on at most `BvhTree::MAX_LEAF_DEPTH` levels
+		static constexpr size_t MAX_TO_VISIT = (WIDTH - 1) * BvhTree::MAX_LEAF_DEPTH + 1;
+
+		IGNORE_PADDING_START
+		/// @brief A node queued during traversal
+		struct Visit {
+			uint32_t m_node;
+			/// The length along the ray at which the ray enters the node
+			T m_near;
+		};
+		IGNORE_PADDING_STOP
+
+		IGNORE_PADDING_START
+		/// @brief The children of a node hit by a ray
+		struct ChildHits {
+			/// The length along the ray at which the ray enters each child hit
+			alignas(16) T m_near[WIDTH] = {};
+			/// The children hit, with child `i` in bit `i`
+			uint32_t m_lanes = 0;
+		};
+		IGNORE_PADDING_STOP
+
+		utils::ArrayStorage<Node> m_nodes;
+		BoundingBox m_bounds = BoundingBox();
+
+		/// @brief Appends the node taking the place of the subtree of `binary` rooted at `index`,
+		/// followed by its descendants
+		///
+		/// @param binary - The nodes of the `BvhTree` being collapsed
+		/// @param index - The index of the root of the subtree in `binary`
+		///
+		/// @return The index of the appended node
+		inline auto collapse(std::span<const typename BvhTree::Node> binary,
+							 uint32_t index) noexcept -> uint32_t {
+			auto children = std::array<uint32_t, WIDTH>();
+			auto num_children = 0ULL;
+			if(binary[index].is_leaf()) {
+				children[num_children++] = index;
+			}
+			else {
+				children[num_children++] = index + 1;
+				children[num_children++] = binary[index].m_offset;
+			}
+
+			// open up the largest interior child, which rays are the most likely to hit, until the
+			// node is full or only has leaves left
+			while(num_children < WIDTH) {
+				auto largest = num_children;
+				auto largest_area = narrow_cast<T>(-1);
+				for(auto i = 0ULL; i < num_children; ++i) {
+					const auto& child = binary[children[i]];
+					const auto area = child.m_bounds.surface_area();
+					if(!child.is_leaf() && area > largest_area) {
+						largest = i;
+						largest_area = area;
+					}
+				}
+				if(largest == num_children) {
+					break;
+				}
+
+				const auto opened = children[largest];
+				children[largest] = opened + 1;
+				children[num_children++] = binary[opened].m_offset;
+			}
+
+			auto& nodes = m_nodes.owned();
+			const auto wide = narrow_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+			set_bounds(&nodes[wide], binary, std::span(children).first(num_children));
+			for(auto i = 0ULL; i < num_children; ++i) {
+				const auto& child = binary[children[i]];
+				if(child.is_leaf()) {
+					nodes[wide].m_child[i] = child.m_offset;
+					nodes[wide].m_count[i] = child.m_count;
+				}
+				else {
+					// appending may move the nodes, so the index is only looked up after
+					const auto child_index = collapse(binary, children[i]);
+					nodes[wide].m_child[i] = child_index;
+				}
+			}
+			return wide;
+		}
+
+		/// @brief Stores the bounds of the children of `node`
+		///
+		/// @param node - The node to store the bounds in
+		/// @param binary - The nodes of the `BvhTree` being collapsed
+		/// @param children - The indices in `binary` of the children of `node`
+		inline static auto set_bounds(NotNull<Node> node,
+									  std::span<const typename BvhTree::Node> binary,
+									  std::span<const uint32_t> children) noexcept -> void {
+			node->m_num_children = narrow_cast<uint8_t>(children.size());
+			auto bounds = BoundingBox();
+			for(const auto child : children) {
+				bounds = bounds.merged(binary[child].m_bounds);
+			}
+
+			for(auto axis = 0ULL; axis < 3; ++axis) {
+				const auto index = static_cast<Vec3Idx>(axis);
+				if constexpr(Quantized) {
+					node->m_origin[axis] = bounds.min()[index];		   // NOLINT
+					node->m_exponent[axis] = grid_exponent(bounds.min()[index], // NOLINT
+														   bounds.max()[index]);
+				}
+
+				for(auto i = 0ULL; i < children.size(); ++i) {
+					const auto& child = binary[children[i]].m_bounds;
+					if constexpr(Quantized) {
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+						node->m_min[axis][i] = quantized_min(*node, axis, child.min()[index]);
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+						node->m_max[axis][i] = quantized_max(*node, axis, child.max()[index]);
+					}
+					else {
+						node->m_min[axis][i] = child.min()[index]; // NOLINT
+						node->m_max[axis][i] = child.max()[index]; // NOLINT
+					}
+				}
+			}
+		}
+
+		/// @brief Returns the exponent of the smallest power of two grid spacing whose
+		/// `MAX_QUANTIZED`th step from `min` reaches `max`
+		[[nodiscard]] inline static auto grid_exponent(T min, T max) noexcept -> int8_t {
+			const auto extent = max - min;
+			auto exponent = MIN_EXPONENT;
+			if(extent > narrow_cast<T>(0)) {
+				exponent = General::min(
+					General::max(std::ilogb(extent / narrow_cast<T>(MAX_QUANTIZED)), MIN_EXPONENT),
+					MAX_EXPONENT);
+			}
+			while(exponent < MAX_EXPONENT && step(min, MAX_QUANTIZED, power_of_two(exponent)) < max)
+			{
+				++exponent;
+			}
+			return narrow_cast<int8_t>(exponent);
+		}
+
+		/// @brief Returns the largest step on the grid of `node` along `axis` not above `value`
+		[[nodiscard]] inline static auto
+		quantized_min(const Node& node, size_t axis, T value) noexcept -> uint8_t {
+			const auto origin = node.m_origin[axis];				   // NOLINT
+			const auto spacing = power_of_two(node.m_exponent[axis]); // NOLINT
+			const auto steps = (value - origin) / spacing;
+			auto quantized = steps > narrow_cast<T>(0) ?
+								 (steps < narrow_cast<T>(MAX_QUANTIZED) ?
+									  narrow_cast<uint32_t>(std::floor(steps)) :
+									  MAX_QUANTIZED) :
+								 0U;
+			// the division may have rounded up past `value`
+			while(quantized > 0 && step(origin, quantized, spacing) > value) {
+				--quantized;
+			}
+			return narrow_cast<uint8_t>(quantized);
+		}
+
+		/// @brief Returns the smallest step on the grid of `node` along `axis` not below `value`
+		[[nodiscard]] inline static auto
+		quantized_max(const Node& node, size_t axis, T value) noexcept -> uint8_t {
+			const auto origin = node.m_origin[axis];				   // NOLINT
+			const auto spacing = power_of_two(node.m_exponent[axis]); // NOLINT
+			const auto steps = (value - origin) / spacing;
+			auto quantized = steps > narrow_cast<T>(0) ?
+								 (steps < narrow_cast<T>(MAX_QUANTIZED) ?
+									  narrow_cast<uint32_t>(std::ceil(steps)) :
+									  MAX_QUANTIZED) :
+								 0U;
+			// the division may have rounded down past `value`
+			while(quantized < MAX_QUANTIZED && step(origin, quantized, spacing) < value) {
+				++quantized;
+			}
+			return narrow_cast<uint8_t>(quantized);
+		}
+
+		/// @brief Returns the position of the `steps`th step of a grid.
+		/// `steps * spacing` is exact, so the result is rounded once however it's computed
+		/// (including by a fused multiply-add, or in SIMD lanes), and rounding can't move it past
+		/// a bound it was checked against when quantizing
+		[[nodiscard]] inline static constexpr auto
+		step(T origin, uint32_t steps, T spacing) noexcept -> T {
+			return origin + narrow_cast<T>(steps) * spacing;
+		}
+
+		/// @brief Returns 2 to the power of `exponent`
+		[[nodiscard]] inline static auto power_of_two(int exponent) noexcept -> T {
+			if constexpr(std::is_same_v<T, float>) {
+				constexpr auto MANTISSA_BITS = 23U;
+				constexpr auto BIAS = 127;
+				const auto bits = narrow_cast<uint32_t>(exponent + BIAS) << MANTISSA_BITS;
+				return std::bit_cast<float>(bits);
+			}
+			else {
+				return std::ldexp(narrow_cast<T>(1), exponent);
+			}
+		}
+
+		/// @brief Returns the coordinate along `axis` of a bound of a child of `node`
+		[[nodiscard]] inline static auto
+		plane(const Node& node, size_t axis, Bound bound) noexcept -> T {
+			if constexpr(Quantized) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+				return step(node.m_origin[axis], bound, power_of_two(node.m_exponent[axis]));
+			}
+			else {
+				ignore(node, axis);
+				return bound;
+			}
+		}
+
+		/// @brief Tests `ray` against every child of `node` at once, with the slab test of
+		/// `BoundingBox::intersected`
+		///
+		/// @param node - The node to test the children of
+		/// @param origin - The origin of the ray
+		/// @param inverse_direction - The component-wise reciprocal of the ray's direction
+		/// @param min_length - The minimum length along the ray to consider
+		/// @param max_length - The maximum length along the ray to consider
+		///
+		/// @return The children hit, and where the ray enters them
+		[[nodiscard]] inline static auto intersected_children(const Node& node,
+															  const Point3& origin,
+															  const Vec3& inverse_direction,
+															  T min_length,
+															  T max_length) noexcept -> ChildHits {
+			constexpr auto WIDEN = narrow_cast<T>(1)
+								   + narrow_cast<T>(2) * BoundingBox::ROUNDING_ERROR_BOUND;
+			auto hits = ChildHits();
+			const auto children = (1U << node.m_num_children) - 1U;
+
+			if constexpr(std::is_same_v<T, float>) {
+				using math::simd::Float4;
+
+				auto near = Float4::broadcast(min_length);
+				auto far = Float4::broadcast(max_length);
+				for(auto axis = 0ULL; axis < 3; ++axis) {
+					const auto index = static_cast<Vec3Idx>(axis);
+					const auto negative = inverse_direction[index] < 0.0F;
+					const auto origin_lanes = Float4::broadcast(origin[index]);
+					const auto inverse_lanes = Float4::broadcast(inverse_direction[index]);
+					// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+					const auto& near_bounds = negative ? node.m_max[axis] : node.m_min[axis];
+					// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+					const auto& far_bounds = negative ? node.m_min[axis] : node.m_max[axis];
+					const auto near_planes = planes(node, axis, near_bounds);
+					const auto far_planes = planes(node, axis, far_bounds);
+
+					// the running bounds are passed second, so they're kept when a slab distance
+					// is NaN (`0 * infinity`), as `General::max` and `min` do
+					near = max((near_planes - origin_lanes) * inverse_lanes, near);
+					const auto widen = Float4::broadcast(WIDEN);
+					far = min((far_planes - origin_lanes) * inverse_lanes * widen, far);
+				}
+
+				near.store(hits.m_near);
+				hits.m_lanes = (near <= far).bits() & children;
+			}
+			else {
+				for(auto child = 0ULL; child < node.m_num_children; ++child) {
+					auto near = min_length;
+					auto far = max_length;
+					for(auto axis = 0ULL; axis < 3; ++axis) {
+						const auto index = static_cast<Vec3Idx>(axis);
+						auto near_plane = (plane(node, axis, node.m_min[axis][child]) // NOLINT
+										   - origin[index])
+										  * inverse_direction[index];
+						auto far_plane = (plane(node, axis, node.m_max[axis][child]) // NOLINT
+										  - origin[index])
+										 * inverse_direction[index];
+						if(inverse_direction[index] < narrow_cast<T>(0)) {
+							std::swap(near_plane, far_plane);
+						}
+						near = General::max(near_plane, near);
+						far = General::min(far_plane * WIDEN, far);
+					}
+
+					if(near <= far) {
+						hits.m_near[child] = near; // NOLINT
+						hits.m_lanes |= 1U << child;
+					}
+				}
+			}
+			return hits;
+		}
+
+		/// @brief Loads the coordinates along `axis` of one bound of every child of `node`
+		[[nodiscard]] inline static auto
+		planes(const Node& node, size_t axis, const Bound (&bounds)[WIDTH]) noexcept
+			-> math::simd::Float4 {
+			using math::simd::Float4;
+
+			if constexpr(Quantized) {
+				return Float4::broadcast(node.m_origin[axis])						 // NOLINT
+					   + Float4::load_bytes(bounds)									 // NOLINT
+							 * Float4::broadcast(power_of_two(node.m_exponent[axis])); // NOLINT
+			}
+			else {
+				ignore(node, axis);
+				return Float4::load(bounds); // NOLINT
+			}
+		}
+	};
+} // namespace graphics
@@ -11,7 +11,7 @@ namespace graphics {
 	class Dielectric final : public Material<T> {
 	  public:
 		using Ray = Ray<T>;
-		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 		using Color = Color<T>;
 
 		constexpr Dielectric() noexcept = default;
@@ -22,8 +22,15 @@ namespace graphics {
 		constexpr Dielectric(Dielectric&& dielectric) noexcept = default;
 		constexpr ~Dielectric() noexcept final = default;
 
+		/// @brief Returns the index of refraction of the dielectric
+		///
+		/// @return The refraction index
+		[[nodiscard]] inline constexpr auto refraction_index() const noexcept -> T {
+			return m_refraction_index;
+		}
+
 		inline constexpr auto scatter(const Ray& ray,
-									  const HitRecord& record,
+									  const SurfaceRecord& record,
 									  NotNull<Color> attenuation,
 									  NotNull<Ray> scattered) const noexcept -> bool final {
 			*attenuation = Color(narrow_cast<T>(1), narrow_cast<T>(1), narrow_cast<T>(1));
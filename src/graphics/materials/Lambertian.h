@@ -10,7 +10,7 @@ namespace graphics {
 	class Lambertian final : public Material<T> {
 	  public:
 		using Ray = Ray<T>;
-		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 		using Color = Color<T>;
 		using Vec3 = Vec3<T>;
 
@@ -23,12 +23,20 @@ namespace graphics {
 		constexpr Lambertian(Lambertian&& lambertian) noexcept = default;
 		constexpr ~Lambertian() noexcept final = default;
 
+		/// @brief Returns the color of the surface
+		///
+		/// @return The albedo
+		[[nodiscard]] inline constexpr auto albedo() const noexcept -> const Color& {
+			return m_albedo;
+		}
+
 		inline constexpr auto scatter(const Ray& ray,
-									  const HitRecord& record,
+									  const SurfaceRecord& record,
 									  NotNull<Color> attenuation,
 									  NotNull<Ray> scattered) const noexcept -> bool final {
 			ignore(ray);
-			auto scatter_direction = record.m_normal + Vec3::random_in_unit_sphere().normalized();
+			// a unit vector offset from the normal is cosine-distributed about the normal
+			auto scatter_direction = record.m_normal + Vec3::template random_unit_vector<T>();
 			if(scatter_direction.is_approx_zero()) {
 				scatter_direction = record.m_normal;
 			}
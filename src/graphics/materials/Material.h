@@ -1,18 +1,29 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 #include "../../base/StandardIncludes.h"
 #include "../Color.h"
 #include "../Ray.h"
 
 namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
 	template<FloatingPoint T>
-	struct HitRecord;
+	struct SurfaceRecord;
+
+	/// The material id of a surface whose material isn't in a `MaterialTable`, but owned by the
+	/// geometry itself and referenced by `SurfaceRecord::m_material`
+	inline constexpr uint32_t NO_MATERIAL_ID = std::numeric_limits<uint32_t>::max();
 
 	template<FloatingPoint T = float>
 	class Material {
 	  public:
 		using Ray = Ray<T>;
-		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 		using Color = Color<T>;
 
 		constexpr Material() noexcept = default;
@@ -21,7 +32,7 @@ namespace graphics {
 		virtual constexpr ~Material() noexcept = default;
 
 		virtual constexpr auto scatter(const Ray&,
-									   const HitRecord& record,
+									   const SurfaceRecord& record,
 									   NotNull<Color> attenuation,
 									   NotNull<Ray> scattered) const noexcept -> bool
 			= 0;
@@ -33,7 +44,7 @@ namespace graphics {
 	class DefaultMaterial final : public Material<T> {
 	  public:
 		using Ray = Ray<T>;
-		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 		using Color = Color<T>;
 
 		constexpr DefaultMaterial() noexcept = default;
@@ -42,7 +53,7 @@ namespace graphics {
 		constexpr ~DefaultMaterial() noexcept final = default;
 
 		inline constexpr auto scatter(const Ray& ray,
-									  const HitRecord& record,
+									  const SurfaceRecord& record,
 									  NotNull<Color> attenuation,
 									  NotNull<Ray> scattered) const noexcept -> bool final {
 			ignore(ray, record, attenuation, scattered);
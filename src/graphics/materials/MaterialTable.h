@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "../../base/StandardIncludes.h"
+#include "../../utils/Instrumentation.h"
+#include "Dielectric.h"
+#include "Lambertian.h"
+#include "Material.h"
+#include "Metal.h"
+
+namespace graphics {
+#ifndef _MSC_VER
+	using std::uint32_t;
+#endif
+
+	/// @brief The materials of a scene, stored contiguously by value and referenced by 32-bit id.
+	/// The built-in materials (`Lambertian`, `Metal`, and `Dielectric`) form a closed set stored
+	/// in a `std::variant`, so scattering off one is a switch on the variant's index followed by
+	/// a direct, inlinable call, rather than a virtual call through a pointer into the heap.
+	///
+	/// Other materials can still be used through the virtual `Material` interface: add them as a
+	/// `std::unique_ptr`, and they are called virtually, as before.
+	///
+	/// Geometry refers to a material in the table by storing its id, and reports it in
+	/// `HitRecord::m_material_id` and `SurfaceRecord::m_material_id`
+	///
+	/// @tparam T - The floating point type used for rendering
+	template<FloatingPoint T = float>
+	class MaterialTable {
+	  public:
+		using Color = Color<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
+		using Material = Material<T>;
+		using Ray = Ray<T>;
+		/// A single material: one of the built-in materials, or any other through the virtual
+		/// interface
+		using Entry
+			= std::variant<Lambertian<T>, Metal<T>, Dielectric<T>, std::unique_ptr<Material>>;
+
+		/// The number of kinds of material. See `kind`
+		static constexpr size_t NUM_KINDS = std::variant_size_v<Entry>;
+		/// The kind of materials called through the virtual `Material` interface
+		static constexpr size_t VIRTUAL_KIND = NUM_KINDS - 1;
+
+		MaterialTable() noexcept = default;
+		MaterialTable(const MaterialTable& table) noexcept = delete;
+		MaterialTable(MaterialTable&& table) noexcept = default;
+		~MaterialTable() noexcept = default;
+
+		/// @brief Adds a built-in material to the table
+		///
+		/// @param material - The material to add
+		///
+		/// @return The id of the material
+		template<typename MaterialType>
+		requires std::is_same_v<MaterialType, Lambertian<T>>
+				 || std::is_same_v<MaterialType, Metal<T>>
+				 || std::is_same_v<MaterialType, Dielectric<T>>
+		inline auto add(MaterialType material) noexcept -> uint32_t {
+			m_entries.emplace_back(std::move(material));
+			return narrow_cast<uint32_t>(m_entries.size() - 1);
+		}
+
+		/// @brief Adds a material to the table that will be called through the virtual `Material`
+		/// interface
+		///
+		/// @param material - The material to add
+		///
+		/// @return The id of the material
+		template<typename MaterialType>
+		requires Derived<MaterialType, Material>
+		inline auto add(std::unique_ptr<MaterialType>&& material) noexcept -> uint32_t {
+			m_entries.emplace_back(std::unique_ptr<Material>(std::move(material)));
+			return narrow_cast<uint32_t>(m_entries.size() - 1);
+		}
+
+		/// @brief Reserves space for `capacity` materials in total
+		///
+		/// @param capacity - The number of materials to reserve space for
+		inline auto reserve(size_t capacity) noexcept -> void {
+			m_entries.reserve(capacity);
+		}
+
+		/// @brief Returns the number of materials in the table
+		///
+		/// @return The number of materials
+		[[nodiscard]] inline auto size() const noexcept -> size_t {
+			return m_entries.size();
+		}
+
+		/// @brief Returns the material with the given id
+		///
+		/// @param id - The id of the material
+		///
+		/// @return The material
+		[[nodiscard]] inline auto at(uint32_t id) const noexcept -> const Entry& {
+			return m_entries[id];
+		}
+
+		/// @brief Scatters `ray` off the surface described by `record`, using the material with
+		/// the id `record.m_material_id`, or, if that is `NO_MATERIAL_ID`, the material pointed to
+		/// by `record.m_material`. Surfaces with neither absorb the ray
+		///
+		/// @param ray - The incoming ray
+		/// @param record - The surface hit by `ray`
+		/// @param attenuation - Where to write the attenuation of the scattered ray
+		/// @param scattered - Where to write the scattered ray
+		///
+		/// @return Whether the ray was scattered (rather than absorbed)
+		inline auto scatter(const Ray& ray,
+							const SurfaceRecord& record,
+							NotNull<Color> attenuation,
+							NotNull<Ray> scattered) const noexcept -> bool {
+			if(record.m_material_id == NO_MATERIAL_ID) {
+				return scatter_unowned(ray, record, attenuation, scattered);
+			}
+
+			count_scatter(m_entries[record.m_material_id].index());
+			return std::visit(
+				[&](const auto& material) noexcept -> bool {
+					if constexpr(std::is_same_v<std::decay_t<decltype(material)>,
+												std::unique_ptr<Material>>) {
+						return material->scatter(ray, record, attenuation, scattered);
+					}
+					else {
+						return material.scatter(ray, record, attenuation, scattered);
+					}
+				},
+				m_entries[record.m_material_id]);
+		}
+
+		/// @brief Returns the kind of material of the surface described by `record`: the index of
+		/// its material's type in `Entry`. Surfaces without a material id are `VIRTUAL_KIND`.
+		///
+		/// Grouping surfaces by kind before scattering off them with `scatter_as` calls each
+		/// kind's scatter function over a run of surfaces, rather than switching between them
+		///
+		/// @param record - The surface
+		///
+		/// @return The kind of the surface's material
+		[[nodiscard]] inline auto kind(const SurfaceRecord& record) const noexcept -> size_t {
+			if(record.m_material_id == NO_MATERIAL_ID) {
+				return VIRTUAL_KIND;
+			}
+			return m_entries[record.m_material_id].index();
+		}
+
+		/// @brief Scatters `ray` off the surface described by `record`, whose material is known to
+		/// be of kind `Kind`, calling the material's scatter function directly
+		///
+		/// @tparam Kind - The kind of the surface's material, as returned by `kind`
+		/// @param ray - The incoming ray
+		/// @param record - The surface hit by `ray`
+		/// @param attenuation - Where to write the attenuation of the scattered ray
+		/// @param scattered - Where to write the scattered ray
+		///
+		/// @return Whether the ray was scattered (rather than absorbed)
+		template<size_t Kind>
+		requires(Kind < NUM_KINDS)
+		inline auto scatter_as(const Ray& ray,
+							   const SurfaceRecord& record,
+							   NotNull<Color> attenuation,
+							   NotNull<Ray> scattered) const noexcept -> bool {
+			if constexpr(Kind == VIRTUAL_KIND) {
+				if(record.m_material_id == NO_MATERIAL_ID) {
+					return scatter_unowned(ray, record, attenuation, scattered);
+				}
+				count_scatter(Kind);
+				return (*std::get_if<Kind>(&m_entries[record.m_material_id]))
+					->scatter(ray, record, attenuation, scattered);
+			}
+			else {
+				count_scatter(Kind);
+				return std::get_if<Kind>(&m_entries[record.m_material_id])
+					->scatter(ray, record, attenuation, scattered);
+			}
+		}
+
+		auto operator=(const MaterialTable& table) noexcept -> MaterialTable& = delete;
+		auto operator=(MaterialTable&& table) noexcept -> MaterialTable& = default;
+
+	  private:
+		std::vector<Entry> m_entries;
+
+		static_assert(NUM_KINDS
+						  == static_cast<size_t>(utils::instrumentation::Counter::VirtualScatters)
+								 - static_cast<size_t>(
+									 utils::instrumentation::Counter::LambertianScatters)
+								 + 1,
+					  "Each kind of material needs a scatter counter");
+
+		/// @brief Counts a scatter off a material of kind `kind`
+		inline static auto count_scatter(size_t kind) noexcept -> void {
+			using utils::instrumentation::Counter;
+			utils::instrumentation::count(
+				static_cast<Counter>(static_cast<size_t>(Counter::LambertianScatters) + kind));
+		}
+
+		/// @brief Scatters off a surface whose material isn't in the table, but pointed to by
+		/// `record.m_material`. Surfaces without a material absorb the ray
+		inline static auto scatter_unowned(const Ray& ray,
+										   const SurfaceRecord& record,
+										   NotNull<Color> attenuation,
+										   NotNull<Ray> scattered) noexcept -> bool {
+			if(record.m_material == nullptr) {
+				return false;
+			}
+			count_scatter(VIRTUAL_KIND);
+			return record.m_material->scatter(ray, record, attenuation, scattered);
+		}
+	};
+} // namespace graphics
@@ -10,7 +10,7 @@ namespace graphics {
 	  public:
 		using Color = Color<T>;
 		using Ray = Ray<T>;
-		using HitRecord = HitRecord<T>;
+		using SurfaceRecord = SurfaceRecord<T>;
 
 		constexpr Metal() noexcept = default;
 		explicit constexpr Metal(T reflection_fuzziness) noexcept
@@ -30,8 +30,22 @@ namespace graphics {
 		constexpr Metal(Metal&& metal) noexcept = default;
 		constexpr ~Metal() noexcept final = default;
 
+		/// @brief Returns the color of the metal
+		///
+		/// @return The albedo
+		[[nodiscard]] inline constexpr auto albedo() const noexcept -> const Color& {
+			return m_albedo;
+		}
+
+		/// @brief Returns how much reflections off the metal are randomly perturbed
+		///
+		/// @return The reflection fuzziness
+		[[nodiscard]] inline constexpr auto reflection_fuzziness() const noexcept -> T {
+			return m_reflection_fuzz;
+		}
+
 		inline constexpr auto scatter(const Ray& ray,
-									  const HitRecord& record,
+									  const SurfaceRecord& record,
 									  NotNull<Color> attenuation,
 									  NotNull<Ray> scattered) const noexcept -> bool final {
 			auto reflected = ray.direction().normalized().reflected(record.m_normal);
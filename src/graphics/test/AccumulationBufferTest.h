@@ -0,0 +1,87 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../AccumulationBuffer.h"
+
+namespace graphics::test {
+
+	inline auto accumulation_buffer_test_path(const std::string& name) noexcept -> std::string {
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	inline auto accumulation_buffer_test_buffer() noexcept -> AccumulationBuffer<float> {
+		auto buffer = AccumulationBuffer<float>({5ULL, 3ULL, 16ULL, 42ULL, 4ULL});
+		auto sums = buffer.sums();
+		for(auto i = 0ULL; i < sums.size(); ++i) {
+			const auto value = static_cast<float>(i);
+			sums[i] = Color<float>(value, value * 0.5F, value * 0.25F + 0.1F);
+		}
+		buffer.complete_pass(4ULL);
+		buffer.complete_pass(4ULL);
+		return buffer;
+	}
+
+	TEST(AccumulationBufferTest, preview) {
+		const auto empty = AccumulationBuffer<float>({5ULL, 3ULL, 16ULL, 42ULL, 4ULL});
+		ASSERT_EQ(empty.num_samples(), 0ULL);
+		ASSERT_EQ(empty.preview().at(4ULL, 2ULL).r(), 0.0F);
+
+		const auto buffer = accumulation_buffer_test_buffer();
+		ASSERT_EQ(buffer.num_passes(), 2ULL);
+		ASSERT_EQ(buffer.num_samples(), 8ULL);
+
+		const auto preview = buffer.preview();
+		ASSERT_EQ(preview.width(), 5ULL);
+		ASSERT_EQ(preview.height(), 3ULL);
+		// pixel (2, 1) is the 7th
+		ASSERT_FLOAT_EQ(preview.at(2ULL, 1ULL).r(), 7.0F / 8.0F);
+		ASSERT_FLOAT_EQ(preview.at(2ULL, 1ULL).g(), 3.5F / 8.0F);
+	}
+
+	TEST(AccumulationBufferTest, checkpointRoundTrip) {
+		const auto path = accumulation_buffer_test_path("hyperion_accumulation_test.checkpoint");
+		const auto buffer = accumulation_buffer_test_buffer();
+		ASSERT_TRUE(buffer.save(path));
+		// saving again replaces the previous checkpoint
+		ASSERT_TRUE(buffer.save(path));
+		ASSERT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+		const auto loaded = AccumulationBuffer<float>::load(path);
+		ASSERT_TRUE(loaded);
+		ASSERT_EQ(loaded->settings(), buffer.settings());
+		ASSERT_EQ(loaded->num_passes(), buffer.num_passes());
+		ASSERT_EQ(loaded->num_samples(), buffer.num_samples());
+		ASSERT_EQ(loaded->sums().size(), buffer.sums().size());
+		for(auto i = 0ULL; i < buffer.sums().size(); ++i) {
+			ASSERT_EQ(loaded->sums()[i].r(), buffer.sums()[i].r());
+			ASSERT_EQ(loaded->sums()[i].g(), buffer.sums()[i].g());
+			ASSERT_EQ(loaded->sums()[i].b(), buffer.sums()[i].b());
+		}
+		std::filesystem::remove(path);
+	}
+
+	TEST(AccumulationBufferTest, rejectsInvalidCheckpoints) {
+		ASSERT_FALSE(AccumulationBuffer<float>::load(
+			accumulation_buffer_test_path("hyperion_missing.checkpoint")));
+
+		const auto path = accumulation_buffer_test_path("hyperion_invalid.checkpoint");
+		{
+			auto file = std::ofstream(path, std::ios::binary);
+			file << "not a checkpoint";
+		}
+		ASSERT_FALSE(AccumulationBuffer<float>::load(path));
+
+		// a different floating point type has a different layout
+		ASSERT_TRUE(accumulation_buffer_test_buffer().save(path));
+		ASSERT_FALSE(AccumulationBuffer<double>::load(path));
+
+		// truncated sums
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+		ASSERT_FALSE(AccumulationBuffer<float>::load(path));
+		std::filesystem::remove(path);
+	}
+} // namespace graphics::test
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../BoundingVolumeHierarchy.h"
+#include "../GeometryList.h"
+#include "../Sphere.h"
+#include "../WideBvhTree.h"
+#include "../materials/Lambertian.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	inline auto bounding_volume_hierarchy_test_scene() noexcept -> GeometryList<float> {
+		math::seed_random(42ULL);
+		auto list = GeometryList<float>();
+		for(auto i = 0; i < 300; ++i) {
+			list.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+				Point3<float>(Vec3<float>::random(-10.0F, 10.0F)),
+				random_value(0.1F, 1.0F),
+				std::make_unique<Lambertian<float>>(Color<float>(0.5F, 0.5F, 0.5F))));
+		}
+		return list;
+	}
+
+	inline auto bounding_volume_hierarchy_test_expect_matches(
+		const GeometryList<float>& list,
+		const BoundingVolumeHierarchy<float>& hierarchy) noexcept -> void {
+		ASSERT_EQ(hierarchy.size(), list.size());
+
+		for(auto i = 0; i < 1000; ++i) {
+			const auto ray = Ray<float>(Point3<float>(Vec3<float>::random(-15.0F, 15.0F)),
+										Vec3<float>::random(-1.0F, 1.0F));
+			auto expected = HitRecord<float>();
+			auto actual = HitRecord<float>();
+			const auto expected_hit
+				= list.intersected(ray, 0.0F, Constants<float>::infinity, &expected);
+			const auto actual_hit
+				= hierarchy.intersected(ray, 0.0F, Constants<float>::infinity, &actual);
+
+			ASSERT_EQ(expected_hit, actual_hit);
+			if(expected_hit) {
+				ASSERT_NEAR(expected.m_length, actual.m_length, FLOAT_ACCEPTED_ERROR);
+			}
+		}
+	}
+
+	/// @brief Returns the bounds of `count` small boxes scattered at random
+	inline auto bvh_tree_test_bounds(size_t count) noexcept -> std::vector<BoundingBox<float>> {
+		math::seed_random(7ULL);
+		auto bounds = std::vector<BoundingBox<float>>();
+		bounds.reserve(count);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto center = Point3<float>(Vec3<float>::random(-100.0F, 100.0F));
+			const auto half_size = Vec3<float>::random(0.1F, 1.0F);
+			bounds.emplace_back(center - half_size, center + half_size);
+		}
+		return bounds;
+	}
+
+	inline auto bvh_tree_test_same_box(const BoundingBox<float>& lhs,
+									   const BoundingBox<float>& rhs) noexcept -> bool {
+		return lhs.min().x() == rhs.min().x() && lhs.min().y() == rhs.min().y()
+			   && lhs.min().z() == rhs.min().z() && lhs.max().x() == rhs.max().x()
+			   && lhs.max().y() == rhs.max().y() && lhs.max().z() == rhs.max().z();
+	}
+
+	/// @brief Checks that `nodes` form a tree whose leaves refer to every one of `bounds`
+	/// exactly once, through `order`, with every node bounding everything below it
+	inline auto bvh_tree_test_expect_valid(std::span<const BvhTree<float>::Node> nodes,
+										   std::span<const uint32_t> order,
+										   std::span<const BoundingBox<float>> bounds) noexcept
+		-> void {
+		const auto contains = [](const BoundingBox<float>& outer, const BoundingBox<float>& inner) {
+			return bvh_tree_test_same_box(outer.merged(inner), outer);
+		};
+
+		ASSERT_EQ(order.size(), bounds.size());
+		auto seen = std::vector<bool>(bounds.size());
+		auto num_visited = 0ULL;
+		// (index, depth) of each node to visit
+		auto to_visit = std::vector<std::pair<size_t, size_t>>{{0ULL, 0ULL}};
+		while(!to_visit.empty()) {
+			const auto [index, depth] = to_visit.back();
+			to_visit.pop_back();
+			ASSERT_LT(index, nodes.size());
+			ASSERT_LE(depth, BvhTree<float>::MAX_LEAF_DEPTH);
+			++num_visited;
+
+			const auto& node = nodes[index];
+			if(node.is_leaf()) {
+				for(auto i = node.m_offset; i < node.m_offset + node.m_count; ++i) {
+					ASSERT_LT(i, order.size());
+					ASSERT_FALSE(seen[order[i]]);
+					seen[order[i]] = true;
+					ASSERT_TRUE(contains(node.m_bounds, bounds[order[i]]));
+				}
+				continue;
+			}
+
+			ASSERT_GT(node.m_offset, index + 1);
+			ASSERT_LT(node.m_axis, 3);
+			ASSERT_TRUE(contains(node.m_bounds, nodes[index + 1].m_bounds));
+			ASSERT_TRUE(contains(node.m_bounds, nodes[node.m_offset].m_bounds));
+			to_visit.emplace_back(index + 1, depth + 1);
+			to_visit.emplace_back(node.m_offset, depth + 1);
+		}
+
+		ASSERT_EQ(num_visited, nodes.size());
+		for(const auto primitive_seen : seen) {
+			ASSERT_TRUE(primitive_seen);
+		}
+	}
+
+	/// @brief Checks that `tree` refers to every one of `bounds` exactly once, through `order`,
+	/// with the bounds of every child of every node containing everything below it
+	template<bool Quantized>
+	inline auto wide_bvh_tree_test_expect_valid(const WideBvhTree<float, Quantized>& tree,
+												std::span<const uint32_t> order,
+												std::span<const BoundingBox<float>> bounds) noexcept
+		-> void {
+		using Tree = WideBvhTree<float, Quantized>;
+		const auto nodes = tree.nodes();
+		ASSERT_EQ(order.size(), bounds.size());
+		auto seen = std::vector<bool>(bounds.size());
+		auto num_parents = std::vector<size_t>(nodes.size());
+		// children always follow their parents, so the bounds of everything below each node can
+		// be found from the last node back
+		auto below = std::vector<BoundingBox<float>>(nodes.size());
+		for(auto index = nodes.size(); index > 0; --index) {
+			const auto& node = nodes[index - 1];
+			ASSERT_GT(node.m_num_children, 0);
+			ASSERT_LE(node.m_num_children, Tree::WIDTH);
+			for(auto child = 0ULL; child < node.m_num_children; ++child) {
+				auto child_below = BoundingBox<float>();
+				if(node.m_count[child] != 0) {
+					const auto first = node.m_child[child];
+					for(auto i = first; i < first + node.m_count[child]; ++i) {
+						ASSERT_LT(i, order.size());
+						ASSERT_FALSE(seen[order[i]]);
+						seen[order[i]] = true;
+						child_below = child_below.merged(bounds[order[i]]);
+					}
+				}
+				else {
+					ASSERT_GT(node.m_child[child], index - 1);
+					ASSERT_LT(node.m_child[child], nodes.size());
+					++num_parents[node.m_child[child]];
+					child_below = below[node.m_child[child]];
+				}
+
+				const auto child_bounds = Tree::child_bounds(node, child);
+				if constexpr(Quantized) {
+					ASSERT_TRUE(bvh_tree_test_same_box(child_bounds.merged(child_below),
+													   child_bounds));
+				}
+				else {
+					ASSERT_TRUE(bvh_tree_test_same_box(child_bounds, child_below));
+				}
+				below[index - 1] = below[index - 1].merged(child_below);
+			}
+		}
+
+		ASSERT_TRUE(bvh_tree_test_same_box(below[0], tree.bounding_box()));
+		ASSERT_EQ(num_parents[0], 0ULL);
+		for(auto index = 1ULL; index < nodes.size(); ++index) {
+			ASSERT_EQ(num_parents[index], 1ULL);
+		}
+		for(const auto primitive_seen : seen) {
+			ASSERT_TRUE(primitive_seen);
+		}
+	}
+
+	/// @brief Checks that traversing a `WideBvhTree<T, Quantized>` offers up every primitive
+	/// whose bounds random rays pass through
+	template<typename T, bool Quantized>
+	inline auto wide_bvh_tree_test_expect_conservative() noexcept -> void {
+		math::seed_random(11ULL);
+		auto bounds = std::vector<BoundingBox<T>>();
+		for(auto i = 0; i < 2000; ++i) {
+			const auto center = Point3<T>(Vec3<T>::random(narrow_cast<T>(-50), narrow_cast<T>(50)));
+			const auto half_size = Vec3<T>::random(narrow_cast<T>(0.01), narrow_cast<T>(1));
+			bounds.emplace_back(center - half_size, center + half_size);
+		}
+		auto order = std::vector<uint32_t>();
+		const auto tree = WideBvhTree<T, Quantized>(bounds, &order);
+
+		for(auto i = 0; i < 200; ++i) {
+			const auto origin = Vec3<T>::random(narrow_cast<T>(-60), narrow_cast<T>(60));
+			const auto ray = Ray<T>(Point3<T>(origin),
+									Vec3<T>::random(narrow_cast<T>(-1), narrow_cast<T>(1)));
+			const auto inverse_direction = Vec3<T>(narrow_cast<T>(1) / ray.direction().x(),
+												   narrow_cast<T>(1) / ray.direction().y(),
+												   narrow_cast<T>(1) / ray.direction().z());
+			auto offered = std::vector<bool>(bounds.size());
+			auto record = HitRecord<T>();
+			ASSERT_FALSE(tree.intersected(ray,
+										  narrow_cast<T>(0),
+										  Constants<T>::infinity,
+										  &record,
+										  [&offered](uint32_t index, T /*closest*/) noexcept {
+											  offered[index] = true;
+											  return false;
+										  }));
+			for(auto index = 0ULL; index < order.size(); ++index) {
+				if(bounds[order[index]].intersected(ray,
+													inverse_direction,
+													narrow_cast<T>(0),
+													Constants<T>::infinity))
+				{
+					ASSERT_TRUE(offered[index]);
+				}
+			}
+		}
+	}
+
+	static constexpr auto BVH_TREE_TEST_METHODS = std::array<BvhBuildMethod, 3>{
+		BvhBuildMethod::Sweep,
+		BvhBuildMethod::Binned,
+		BvhBuildMethod::Linear,
+	};
+
+	TEST(BoundingBoxTest, mergedAndSurfaceArea) {
+		const auto box = BoundingBox<float>()
+							 .merged(Point3<float>(0.0F, 0.0F, 0.0F))
+							 .merged(BoundingBox<float>({1.0F, 2.0F, 3.0F}, {1.0F, 2.0F, 3.0F}));
+		ASSERT_FALSE(box.is_empty());
+		ASSERT_TRUE(BoundingBox<float>().is_empty());
+		ASSERT_FLOAT_EQ(box.surface_area(), 22.0F);
+		ASSERT_EQ(box.largest_axis(), Vec3Idx::Z);
+	}
+
+	TEST(BoundingBoxTest, intersected) {
+		const auto box = BoundingBox<float>({-1.0F, -1.0F, -1.0F}, {1.0F, 1.0F, 1.0F});
+		const auto hit = Ray<float>(Point3<float>(-5.0F, 0.5F, 0.5F), Vec3<float>(1.0F, 0.0F, 0.0F));
+		const auto miss = Ray<float>(Point3<float>(-5.0F, 2.0F, 0.5F), Vec3<float>(1.0F, 0.0F, 0.0F));
+		const auto inverse = Vec3<float>(1.0F, Constants<float>::infinity, Constants<float>::infinity);
+
+		ASSERT_TRUE(box.intersected(hit, inverse, 0.0F, Constants<float>::infinity));
+		ASSERT_FALSE(box.intersected(hit, inverse, 0.0F, 3.0F));
+		ASSERT_FALSE(box.intersected(miss, inverse, 0.0F, Constants<float>::infinity));
+	}
+
+	TEST(BoundingVolumeHierarchyTest, matchesGeometryList) {
+		const auto list = bounding_volume_hierarchy_test_scene();
+		const auto hierarchy = BoundingVolumeHierarchy<float>(bounding_volume_hierarchy_test_scene());
+		bounding_volume_hierarchy_test_expect_matches(list, hierarchy);
+	}
+
+	TEST(BoundingVolumeHierarchyTest, matchesGeometryListWithEveryBuildMethod) {
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			const auto list = bounding_volume_hierarchy_test_scene();
+			const auto hierarchy
+				= BoundingVolumeHierarchy<float>(bounding_volume_hierarchy_test_scene(),
+												 BvhBuildSettings{method, 1ULL});
+			bounding_volume_hierarchy_test_expect_matches(list, hierarchy);
+		}
+	}
+
+	TEST(BoundingVolumeHierarchyTest, empty) {
+		const auto hierarchy = BoundingVolumeHierarchy<float>(GeometryList<float>());
+		auto record = HitRecord<float>();
+		ASSERT_FALSE(hierarchy.intersected(Ray<float>(),
+										   0.0F,
+										   Constants<float>::infinity,
+										   &record));
+		ASSERT_TRUE(hierarchy.bounding_box().is_empty());
+	}
+
+	TEST(BvhTreeTest, buildsSameValidTreeOnAnyNumberOfThreads) {
+		// enough primitives that the top of the tree is built in parallel
+		const auto bounds = bvh_tree_test_bounds(3ULL * BvhTree<float>::MIN_PARALLEL_PRIMITIVES);
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			auto order = std::vector<uint32_t>();
+			const auto tree = BvhTree<float>(bounds, &order, {method, 1ULL});
+			bvh_tree_test_expect_valid(tree.nodes(), order, bounds);
+
+			auto parallel_order = std::vector<uint32_t>();
+			const auto parallel_tree = BvhTree<float>(bounds, &parallel_order, {method, 4ULL});
+			ASSERT_EQ(order, parallel_order);
+			ASSERT_EQ(tree.nodes().size(), parallel_tree.nodes().size());
+			for(auto i = 0ULL; i < tree.nodes().size(); ++i) {
+				const auto& node = tree.nodes()[i];
+				const auto& parallel_node = parallel_tree.nodes()[i];
+				ASSERT_TRUE(bvh_tree_test_same_box(node.m_bounds, parallel_node.m_bounds));
+				ASSERT_EQ(node.m_offset, parallel_node.m_offset);
+				ASSERT_EQ(node.m_count, parallel_node.m_count);
+				ASSERT_EQ(node.m_axis, parallel_node.m_axis);
+			}
+		}
+	}
+
+	TEST(BvhTreeTest, buildsValidTreesOverCoincidentPrimitives) {
+		const auto bounds = std::vector<BoundingBox<float>>(
+			100ULL,
+			BoundingBox<float>({1.0F, 2.0F, 3.0F}, {2.0F, 3.0F, 4.0F}));
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			auto order = std::vector<uint32_t>();
+			const auto tree = BvhTree<float>(bounds, &order, {method, 1ULL});
+			bvh_tree_test_expect_valid(tree.nodes(), order, bounds);
+		}
+	}
+
+	TEST(BvhTreeTest, splitsLeavesTooLargeToCount) {
+		// more primitives than a leaf can count, that can't be split apart by the SAH
+		const auto bounds = std::vector<BoundingBox<float>>(
+			2ULL * BvhTree<float>::MAX_PRIMITIVES_IN_ANY_LEAF + 3ULL,
+			BoundingBox<float>({1.0F, 2.0F, 3.0F}, {2.0F, 3.0F, 4.0F}));
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			auto order = std::vector<uint32_t>();
+			const auto tree = BvhTree<float>(bounds, &order, {method, 1ULL});
+			bvh_tree_test_expect_valid(tree.nodes(), order, bounds);
+			wide_bvh_tree_test_expect_valid(WideBvhTree<float>(tree), order, bounds);
+		}
+	}
+
+	TEST(BvhTreeTest, keepsLeavesAboveMinimumSize) {
+		const auto bounds = bvh_tree_test_bounds(1000ULL);
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			auto order = std::vector<uint32_t>();
+			const auto tree = BvhTree<float>(bounds, &order, {method, 1ULL, 6ULL});
+			bvh_tree_test_expect_valid(tree.nodes(), order, bounds);
+			for(const auto& node : tree.nodes()) {
+				ASSERT_TRUE(!node.is_leaf() || node.m_count >= 6U);
+			}
+		}
+	}
+
+	TEST(BvhTreeTest, reportsBuildTime) {
+		if constexpr(!utils::instrumentation::ENABLED) {
+			GTEST_SKIP();
+		}
+
+		const auto bounds = bvh_tree_test_bounds(1000ULL);
+		utils::instrumentation::reset();
+		auto order = std::vector<uint32_t>();
+		ignore(BvhTree<float>(bounds, &order));
+		const auto snapshot = utils::instrumentation::snapshot();
+		ASSERT_GT(snapshot.seconds(utils::instrumentation::Stage::BvhBuild), 0.0);
+	}
+
+	TEST(WideBvhTreeTest, collapsesIntoValidTrees) {
+		const auto bounds = bvh_tree_test_bounds(5000ULL);
+		for(const auto method : BVH_TREE_TEST_METHODS) {
+			auto order = std::vector<uint32_t>();
+			const auto binary = BvhTree<float>(bounds, &order, {method, 1ULL});
+			wide_bvh_tree_test_expect_valid(WideBvhTree<float>(binary), order, bounds);
+			wide_bvh_tree_test_expect_valid(WideBvhTree<float, false>(binary), order, bounds);
+		}
+
+		auto order = std::vector<uint32_t>();
+		const auto single = std::span(bounds).first(1ULL);
+		const auto tree = WideBvhTree<float>(single, &order);
+		ASSERT_EQ(tree.nodes().size(), 1ULL);
+		wide_bvh_tree_test_expect_valid(tree, order, single);
+		const auto empty = WideBvhTree<float>(std::span<const BoundingBox<float>>(), &order);
+		ASSERT_TRUE(empty.nodes().empty());
+		ASSERT_TRUE(empty.bounding_box().is_empty());
+	}
+
+	TEST(WideBvhTreeTest, offersEveryPrimitiveRaysPassThrough) {
+		wide_bvh_tree_test_expect_conservative<float, true>();
+		wide_bvh_tree_test_expect_conservative<float, false>();
+		wide_bvh_tree_test_expect_conservative<double, true>();
+		wide_bvh_tree_test_expect_conservative<double, false>();
+	}
+
+	TEST(WideBvhTreeTest, quantizedNodesTakeLessMemory) {
+		static_assert(sizeof(WideBvhTree<float>::Node) == 64, "A node should fit a cache line");
+
+		const auto bounds = bvh_tree_test_bounds(5000ULL);
+		auto order = std::vector<uint32_t>();
+		const auto binary = BvhTree<float>(bounds, &order);
+		const auto wide = WideBvhTree<float>(binary);
+		ASSERT_LT(wide.nodes().size_bytes() * 2, binary.nodes().size_bytes());
+	}
+} // namespace graphics::test
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+#include "../DistributedRenderer.h"
+
+namespace graphics::test {
+
+	static constexpr uint64_t DISTRIBUTED_TEST_SCENE_KEY = 0x5CE7E;
+
+	inline auto distributed_test_shade(const Ray<float>& ray) noexcept -> Color<float> {
+		return {ray.direction().x(), ray.direction().y(), random_value<float>()};
+	}
+
+	inline auto distributed_test_renderer(size_t num_threads) noexcept -> TileRenderer<float> {
+		return {61ULL, 37ULL, 3ULL, num_threads, 8ULL};
+	}
+
+	inline auto distributed_test_expect_local(const Framebuffer<float>& actual) noexcept -> void {
+		const auto expected
+			= distributed_test_renderer(1ULL).render(Camera<float>(), distributed_test_shade);
+		ASSERT_EQ(actual.width(), expected.width());
+		ASSERT_EQ(actual.height(), expected.height());
+		for(auto y = 0ULL; y < expected.height(); ++y) {
+			for(auto x = 0ULL; x < expected.width(); ++x) {
+				ASSERT_EQ(actual.at(x, y).r(), expected.at(x, y).r());
+				ASSERT_EQ(actual.at(x, y).g(), expected.at(x, y).g());
+				ASSERT_EQ(actual.at(x, y).b(), expected.at(x, y).b());
+			}
+		}
+	}
+
+	/// @brief Runs a worker with `num_threads` rendering threads on `connection`
+	inline auto distributed_test_worker(std::optional<utils::Socket> connection,
+										size_t num_threads,
+										uint64_t scene_key = DISTRIBUTED_TEST_SCENE_KEY) noexcept
+		-> bool {
+		return connection
+			   && RenderWorker<float>::run(std::move(*connection),
+										   distributed_test_renderer(num_threads),
+										   Camera<float>(),
+										   distributed_test_shade,
+										   scene_key);
+	}
+
+	TEST(DistributedRendererTest, matchesLocalRenderOverTcp) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+
+		auto workers = std::vector<std::jthread>();
+		auto finished = std::array<bool, 3>();
+		for(auto i = 0ULL; i < finished.size(); ++i) {
+			workers.emplace_back([&finished, i, port]() {
+				finished[i]
+					= distributed_test_worker(utils::Socket::connect("127.0.0.1", port), i + 1);
+			});
+		}
+
+		const auto framebuffer = coordinator.render();
+		workers.clear();
+		ASSERT_TRUE(framebuffer);
+		for(auto worker_finished : finished) {
+			ASSERT_TRUE(worker_finished);
+		}
+		distributed_test_expect_local(*framebuffer);
+	}
+
+#ifndef _WIN32
+	TEST(DistributedRendererTest, matchesLocalRenderOverUnixSockets) {
+		const auto path
+			= (std::filesystem::temp_directory_path() / "hyperion_distributed_test.sock").string();
+		auto listener = utils::Listener::listen_local(path);
+		ASSERT_TRUE(listener);
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+
+		auto finished = std::array<bool, 2>();
+		auto workers = std::vector<std::jthread>();
+		for(auto i = 0ULL; i < finished.size(); ++i) {
+			workers.emplace_back([&finished, &path, i]() {
+				finished[i] = distributed_test_worker(utils::Socket::connect_local(path), 2ULL);
+			});
+		}
+
+		const auto framebuffer = coordinator.render();
+		workers.clear();
+		ASSERT_TRUE(framebuffer);
+		ASSERT_TRUE(finished[0] && finished[1]);
+		distributed_test_expect_local(*framebuffer);
+	}
+
+	TEST(DistributedRendererTest, matchesLocalRenderWithWorkerProcesses) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+
+		// each worker is a process of its own, as when started with `--work`, sharing nothing
+		// with the coordinator but the connection. They're forked before the coordinator starts
+		// any threads, and exit straight away, without returning into the test
+		auto workers = std::vector<pid_t>();
+		for(auto i = 0ULL; i < 3; ++i) {
+			const auto pid = fork();
+			ASSERT_NE(pid, -1);
+			if(pid == 0) {
+				const auto finished
+					= distributed_test_worker(utils::Socket::connect("127.0.0.1", port), i + 1);
+				std::_Exit(finished ? EXIT_SUCCESS : EXIT_FAILURE);
+			}
+			workers.push_back(pid);
+		}
+
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+		const auto framebuffer = coordinator.render();
+		for(const auto pid : workers) {
+			auto status = 0;
+			ASSERT_EQ(waitpid(pid, &status, 0), pid);
+			ASSERT_TRUE(WIFEXITED(status));				  // NOLINT
+			ASSERT_EQ(WEXITSTATUS(status), EXIT_SUCCESS); // NOLINT
+		}
+		ASSERT_TRUE(framebuffer);
+		distributed_test_expect_local(*framebuffer);
+	}
+#endif
+
+	TEST(DistributedRendererTest, reassignsTilesOfDeadWorkers) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+
+		auto finished = false;
+		auto workers = std::vector<std::jthread>();
+		workers.emplace_back([&finished, port]() {
+			// a worker that dies after being handed its first tiles, before it joins
+			{
+				auto dying = utils::Socket::connect("127.0.0.1", port);
+				ASSERT_TRUE(dying);
+				auto hello = detail::WorkerHello();
+				hello.m_settings = detail::DistributedSettings::of(distributed_test_renderer(1ULL),
+																   DISTRIBUTED_TEST_SCENE_KEY);
+				ASSERT_TRUE(detail::send_message(&dying.value(), hello));
+				const auto job = detail::receive_message<detail::Job>(&dying.value());
+				ASSERT_TRUE(job);
+				ASSERT_EQ(job->m_kind, detail::JobKind::RenderTile);
+				ASSERT_EQ(job->m_tile, 0ULL);
+			}
+
+			finished = distributed_test_worker(utils::Socket::connect("127.0.0.1", port), 2ULL);
+		});
+
+		const auto framebuffer = coordinator.render();
+		workers.clear();
+		ASSERT_TRUE(framebuffer);
+		ASSERT_TRUE(finished);
+		distributed_test_expect_local(*framebuffer);
+	}
+
+	TEST(DistributedRendererTest, rejectsMismatchedWorkers) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+
+		auto mismatched_finished = true;
+		auto finished = false;
+		auto workers = std::vector<std::jthread>();
+		workers.emplace_back([&mismatched_finished, &finished, port]() {
+			mismatched_finished = distributed_test_worker(utils::Socket::connect("127.0.0.1", port),
+														  2ULL,
+														  DISTRIBUTED_TEST_SCENE_KEY + 1);
+			finished = distributed_test_worker(utils::Socket::connect("127.0.0.1", port), 2ULL);
+		});
+
+		const auto framebuffer = coordinator.render();
+		workers.clear();
+		ASSERT_TRUE(framebuffer);
+		ASSERT_FALSE(mismatched_finished);
+		ASSERT_TRUE(finished);
+		distributed_test_expect_local(*framebuffer);
+	}
+
+	TEST(DistributedRendererTest, silentConnectionsDontStallTheRender) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(20000));
+
+		// connects first, then sends only part of its greeting, and never the rest
+		auto silent = utils::Socket::connect("127.0.0.1", port);
+		ASSERT_TRUE(silent);
+		const auto partial = std::array<char, 4>{'H', 'Y', 'P', 'W'};
+		ASSERT_TRUE(silent->send_all(std::as_bytes(std::span<const char>(partial))));
+
+		auto finished = false;
+		auto workers = std::vector<std::jthread>();
+		workers.emplace_back([&finished, port]() {
+			finished = distributed_test_worker(utils::Socket::connect("127.0.0.1", port), 2ULL);
+		});
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto framebuffer = coordinator.render();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		workers.clear();
+		ASSERT_TRUE(framebuffer);
+		ASSERT_TRUE(finished);
+		// waiting on the silent connection would take the whole worker timeout
+		ASSERT_LT(elapsed, RenderCoordinator<float>::DEFAULT_WORKER_TIMEOUT / 2);
+		distributed_test_expect_local(*framebuffer);
+	}
+
+	TEST(DistributedRendererTest, givesUpWithoutWorkers) {
+		auto listener = utils::Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		auto coordinator = RenderCoordinator<float>(distributed_test_renderer(1ULL),
+													std::move(*listener),
+													DISTRIBUTED_TEST_SCENE_KEY);
+		coordinator.set_idle_timeout(std::chrono::milliseconds(200));
+		ASSERT_FALSE(coordinator.render());
+	}
+} // namespace graphics::test
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "../../test/TestConstants.h"
+#include "../ImageWriter.h"
+
+namespace graphics::test {
+
+	inline auto image_writer_test_framebuffer() noexcept -> Framebuffer<float> {
+		auto framebuffer = Framebuffer<float>(3ULL, 2ULL);
+		for(auto y = 0ULL; y < framebuffer.height(); ++y) {
+			for(auto x = 0ULL; x < framebuffer.width(); ++x) {
+				framebuffer.at(x, y) = Color<float>(narrow_cast<float>(x) * 0.25F,
+													narrow_cast<float>(y) * 0.5F,
+													1.0F);
+			}
+		}
+		return framebuffer;
+	}
+
+	TEST(ImageWriterTest, gammaEncoderMatchesPow) {
+		for(const auto gamma : {1.0F, 1.5F, 2.2F}) {
+			const auto encoder = GammaEncoder<float>(gamma);
+			for(auto i = 0; i <= 1000; ++i) {
+				const auto value = narrow_cast<float>(i) / 1000.0F;
+				const auto expected = narrow_cast<int>(
+					256.0F * clamp(std::pow(value, 1.0F / gamma), 0.0F, 0.999F));
+				// values within rounding of a code boundary may land on either side of it
+				ASSERT_NEAR(narrow_cast<int>(encoder.encode(value)), expected, 1);
+			}
+			ASSERT_EQ(encoder.encode(-1.0F), 0);
+			ASSERT_EQ(encoder.encode(0.0F), 0);
+			ASSERT_EQ(encoder.encode(1.0F), 255);
+			ASSERT_EQ(encoder.encode(100.0F), 255);
+		}
+	}
+
+	TEST(ImageWriterTest, writePpm) {
+		const auto framebuffer = image_writer_test_framebuffer();
+		auto out = std::ostringstream();
+		ASSERT_TRUE(ImageWriter<float>::write_ppm(out, framebuffer, 1.0F));
+
+		const auto header = std::string("P6\n3 2\n255\n");
+		const auto data = out.str();
+		ASSERT_EQ(data.size(), header.size() + 3ULL * 2ULL * 3ULL);
+		ASSERT_EQ(data.substr(0, header.size()), header);
+
+		const auto encoder = GammaEncoder<float>(1.0F);
+		const auto* pixels = data.data() + header.size();
+		for(auto y = 0ULL; y < framebuffer.height(); ++y) {
+			for(auto x = 0ULL; x < framebuffer.width(); ++x) {
+				const auto offset = 3 * (y * framebuffer.width() + x);
+				ASSERT_EQ(static_cast<uint8_t>(pixels[offset]), // NOLINT
+						  encoder.encode(framebuffer.at(x, y).r()));
+				ASSERT_EQ(static_cast<uint8_t>(pixels[offset + 1]), // NOLINT
+						  encoder.encode(framebuffer.at(x, y).g()));
+				ASSERT_EQ(static_cast<uint8_t>(pixels[offset + 2]), 255); // NOLINT
+			}
+		}
+	}
+
+	TEST(ImageWriterTest, writePfm) {
+		const auto framebuffer = image_writer_test_framebuffer();
+		auto out = std::ostringstream();
+		ASSERT_TRUE(ImageWriter<float>::write_pfm(out, framebuffer));
+
+		const auto header = std::string("PF\n3 2\n-1.0\n");
+		const auto data = out.str();
+		ASSERT_EQ(data.size(), header.size() + 3ULL * 2ULL * 3ULL * sizeof(float));
+		ASSERT_EQ(data.substr(0, header.size()), header);
+
+		// rows are stored bottom-to-top
+		auto values = std::array<float, 18>();
+		std::memcpy(values.data(), data.data() + header.size(), sizeof(values)); // NOLINT
+		ASSERT_FLOAT_EQ(values[0], framebuffer.at(0ULL, 1ULL).r());
+		ASSERT_FLOAT_EQ(values[1], framebuffer.at(0ULL, 1ULL).g());
+		ASSERT_FLOAT_EQ(values[3], framebuffer.at(1ULL, 1ULL).r());
+		ASSERT_FLOAT_EQ(values[10], framebuffer.at(0ULL, 0ULL).g());
+		ASSERT_FLOAT_EQ(values[17], framebuffer.at(2ULL, 0ULL).b());
+	}
+} // namespace graphics::test
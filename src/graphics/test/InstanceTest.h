@@ -0,0 +1,156 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../BoundingVolumeHierarchy.h"
+#include "../GeometryList.h"
+#include "../Instance.h"
+#include "../InstanceHierarchy.h"
+#include "../Sphere.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+	using Transform = math::Transform<float>;
+
+	inline auto instance_test_random_ray(float extent) noexcept -> Ray<float> {
+		return {Point3<float>(Vec3<float>::random(-extent, extent)),
+				Vec3<float>::random(-1.0F, 1.0F)};
+	}
+
+	/// @brief A cluster of spheres, in object space, to instance
+	inline auto instance_test_object() noexcept -> std::shared_ptr<const Geometry<float>> {
+		auto list = GeometryList<float>();
+		for(auto i = 0; i < 20; ++i) {
+			list.add<Sphere<float>>(
+				std::make_unique<Sphere<float>>(Point3<float>(Vec3<float>::random(-1.0F, 1.0F)),
+												random_value(0.1F, 0.4F),
+												narrow_cast<uint32_t>(i)));
+		}
+		return std::make_shared<const BoundingVolumeHierarchy<float>>(std::move(list));
+	}
+
+	TEST(InstanceTest, matchesTransformedGeometry) {
+		const auto object
+			= std::make_shared<const Sphere<float>>(Point3<float>(0.0F, 0.0F, 0.0F), 1.0F, 7U);
+		const auto instance = Instance<float>(
+			object,
+			Transform::translation(Vec3<float>(5.0F, 0.0F, 0.0F))
+				* Transform::rotation(Vec3<float>(0.0F, 1.0F, 0.0F), 1.0F)
+				* Transform::scaling(Vec3<float>(2.0F, 2.0F, 2.0F)));
+		const auto placed = Sphere<float>(Point3<float>(5.0F, 0.0F, 0.0F), 2.0F, 7U);
+
+		const auto bounds = instance.bounding_box();
+		ASSERT_LE(bounds.min().x(), 3.0F + FLOAT_ACCEPTED_ERROR);
+		ASSERT_GE(bounds.max().x(), 7.0F - FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(bounds.min().y(), -2.0F, FLOAT_ACCEPTED_ERROR);
+
+		math::seed_random(7ULL);
+		auto num_hits = 0;
+		for(auto i = 0; i < 1000; ++i) {
+			// aimed near the sphere, so most rays hit it
+			const auto origin = Point3<float>(Vec3<float>::random(-10.0F, 10.0F));
+			const auto target = Point3<float>(5.0F, 0.0F, 0.0F) + Vec3<float>::random(-2.5F, 2.5F);
+			const auto ray = Ray<float>(origin, (target - origin).as_vec());
+			auto expected = HitRecord<float>();
+			auto actual = HitRecord<float>();
+			const auto expected_hit
+				= placed.intersected(ray, 0.0F, Constants<float>::infinity, &expected);
+			const auto actual_hit
+				= instance.intersected(ray, 0.0F, Constants<float>::infinity, &actual);
+
+			ASSERT_EQ(expected_hit, actual_hit);
+			if(!expected_hit) {
+				continue;
+			}
+			++num_hits;
+			ASSERT_EQ(actual.m_instance, &instance);
+			ASSERT_EQ(actual.m_geometry, object.get());
+			ASSERT_EQ(actual.m_material_id, 7U);
+			ASSERT_NEAR(expected.m_length, actual.m_length, 1.0e-3F);
+
+			const auto expected_surface = expected.surface(ray);
+			const auto actual_surface = actual.surface(ray);
+			ASSERT_NEAR(expected_surface.m_point.x(), actual_surface.m_point.x(), 1.0e-3F);
+			ASSERT_NEAR(expected_surface.m_point.y(), actual_surface.m_point.y(), 1.0e-3F);
+			ASSERT_NEAR(expected_surface.m_point.z(), actual_surface.m_point.z(), 1.0e-3F);
+			ASSERT_NEAR(expected_surface.m_normal.x(), actual_surface.m_normal.x(), 1.0e-3F);
+			ASSERT_NEAR(expected_surface.m_normal.y(), actual_surface.m_normal.y(), 1.0e-3F);
+			ASSERT_NEAR(expected_surface.m_normal.z(), actual_surface.m_normal.z(), 1.0e-3F);
+			ASSERT_EQ(expected_surface.m_hit_outer_face, actual_surface.m_hit_outer_face);
+			ASSERT_EQ(actual_surface.m_material_id, 7U);
+		}
+		ASSERT_GT(num_hits, 100);
+	}
+
+	TEST(InstanceHierarchyTest, matchesGeometryList) {
+		math::seed_random(11ULL);
+		const auto object = instance_test_object();
+		auto list = GeometryList<float>();
+		auto hierarchy = InstanceHierarchy<float>();
+		for(auto i = 0; i < 200; ++i) {
+			const auto transform
+				= Transform::translation(Vec3<float>::random(-20.0F, 20.0F))
+				  * Transform::rotation(Vec3<float>::random(-1.0F, 1.0F), random_value(0.0F, 3.0F))
+				  * Transform::scaling(Vec3<float>::random(0.5F, 2.0F));
+			list.add<Instance<float>>(std::make_unique<Instance<float>>(object, transform));
+			ASSERT_EQ(hierarchy.add(object, transform), narrow_cast<size_t>(i));
+		}
+		hierarchy.rebuild();
+
+		// every instance shares the one object
+		ASSERT_EQ(object.use_count(), 401);
+		ASSERT_EQ(hierarchy.size(), 200ULL);
+
+		for(auto i = 0; i < 1000; ++i) {
+			const auto ray = instance_test_random_ray(25.0F);
+			auto expected = HitRecord<float>();
+			auto actual = HitRecord<float>();
+			const auto expected_hit
+				= list.intersected(ray, 0.0F, Constants<float>::infinity, &expected);
+			const auto actual_hit
+				= hierarchy.intersected(ray, 0.0F, Constants<float>::infinity, &actual);
+
+			ASSERT_EQ(expected_hit, actual_hit);
+			if(expected_hit) {
+				ASSERT_NEAR(expected.m_length, actual.m_length, FLOAT_ACCEPTED_ERROR);
+				ASSERT_EQ(expected.m_material_id, actual.m_material_id);
+
+				// containers of instances compute surfaces through the instance that was hit
+				const auto expected_surface = list.surface(ray, expected);
+				const auto actual_surface = actual.surface(ray);
+				ASSERT_NEAR(expected_surface.m_normal.x(), actual_surface.m_normal.x(), 1.0e-3F);
+				ASSERT_NEAR(expected_surface.m_normal.y(), actual_surface.m_normal.y(), 1.0e-3F);
+				ASSERT_NEAR(expected_surface.m_normal.z(), actual_surface.m_normal.z(), 1.0e-3F);
+			}
+		}
+	}
+
+	TEST(InstanceHierarchyTest, movedInstancesTracedAfterRebuild) {
+		const auto object
+			= std::make_shared<const Sphere<float>>(Point3<float>(0.0F, 0.0F, 0.0F), 1.0F, 0U);
+		auto hierarchy = InstanceHierarchy<float>(
+			{Instance<float>(object, Transform::translation(Vec3<float>(0.0F, 0.0F, -5.0F))),
+			 Instance<float>(object, Transform::translation(Vec3<float>(0.0F, 10.0F, -5.0F)))});
+		const auto ray
+			= Ray<float>(Point3<float>(0.0F, 0.0F, 0.0F), Vec3<float>(0.0F, 0.0F, -1.0F));
+
+		auto record = HitRecord<float>();
+		ASSERT_TRUE(hierarchy.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+		ASSERT_NEAR(record.m_length, 4.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_EQ(record.m_instance, &hierarchy.instances()[0]);
+
+		// move the second instance in front of the first
+		hierarchy.set_transform(1ULL, Transform::translation(Vec3<float>(0.0F, 0.0F, -2.5F)));
+		hierarchy.rebuild();
+		ASSERT_TRUE(hierarchy.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+		ASSERT_NEAR(record.m_length, 1.5F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_EQ(record.m_instance, &hierarchy.instances()[1]);
+
+		const auto surface = record.surface(ray);
+		ASSERT_NEAR(surface.m_point.z(), -1.5F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_normal.z(), 1.0F, FLOAT_ACCEPTED_ERROR);
+	}
+} // namespace graphics::test
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "../../test/TestConstants.h"
+#include "../GeometryList.h"
+#include "../PathIntegrator.h"
+#include "../Sphere.h"
+#include "../materials/MaterialTable.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	/// @brief Returns a record of a hit on the top of a unit sphere at the origin
+	inline auto material_table_test_record(uint32_t material_id) noexcept -> SurfaceRecord<float> {
+		auto record = SurfaceRecord<float>();
+		record.m_point = Point3<float>(0.0F, 1.0F, 0.0F);
+		record.m_normal = Vec3<float>(0.0F, 1.0F, 0.0F);
+		record.m_length = 1.0F;
+		record.m_hit_outer_face = true;
+		record.m_material_id = material_id;
+		return record;
+	}
+
+	TEST(MaterialTableTest, dispatchMatchesVirtual) {
+		const auto metal = Metal<float>(Color<float>(0.7F, 0.6F, 0.5F), 0.0F);
+		auto table = MaterialTable<float>();
+		const auto id = table.add(metal);
+		ASSERT_EQ(table.size(), 1ULL);
+
+		const auto ray
+			= Ray<float>(Point3<float>(-1.0F, 2.0F, 0.0F), Vec3<float>(1.0F, -1.0F, 0.0F));
+		const auto record = material_table_test_record(id);
+		auto expected_attenuation = Color<float>();
+		auto expected_scattered = Ray<float>();
+		const auto expected = static_cast<const Material<float>&>(metal).scatter(
+			ray,
+			record,
+			&expected_attenuation,
+			&expected_scattered);
+
+		auto attenuation = Color<float>();
+		auto scattered = Ray<float>();
+		ASSERT_EQ(table.scatter(ray, record, &attenuation, &scattered), expected);
+		ASSERT_FLOAT_EQ(attenuation.r(), expected_attenuation.r());
+		ASSERT_FLOAT_EQ(attenuation.g(), expected_attenuation.g());
+		ASSERT_FLOAT_EQ(attenuation.b(), expected_attenuation.b());
+		ASSERT_NEAR(scattered.direction().x(),
+					expected_scattered.direction().x(),
+					FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(scattered.direction().y(),
+					expected_scattered.direction().y(),
+					FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(MaterialTableTest, virtualMaterials) {
+		auto table = MaterialTable<float>();
+		ignore(table.add(Lambertian<float>()));
+		const auto id = table.add(std::make_unique<DefaultMaterial<float>>());
+		ASSERT_EQ(id, 1U);
+		ASSERT_EQ(table.size(), 2ULL);
+
+		// `DefaultMaterial` absorbs everything, so the table must have dispatched to it
+		auto attenuation = Color<float>();
+		auto scattered = Ray<float>();
+		ASSERT_FALSE(table.scatter(Ray<float>(Point3<float>(0.0F, 2.0F, 0.0F),
+											  Vec3<float>(0.0F, -1.0F, 0.0F)),
+								   material_table_test_record(id),
+								   &attenuation,
+								   &scattered));
+	}
+
+	TEST(MaterialTableTest, fallsBackToMaterialPointer) {
+		const auto table = MaterialTable<float>();
+		auto material = DefaultMaterial<float>();
+		auto record = material_table_test_record(NO_MATERIAL_ID);
+		record.m_material = &material;
+
+		auto attenuation = Color<float>();
+		auto scattered = Ray<float>();
+		ASSERT_FALSE(table.scatter(Ray<float>(Point3<float>(0.0F, 2.0F, 0.0F),
+											  Vec3<float>(0.0F, -1.0F, 0.0F)),
+								   record,
+								   &attenuation,
+								   &scattered));
+	}
+
+	TEST(MaterialTableTest, pathIntegratorUsesTable) {
+		// a sphere that absorbs everything, through the table
+		auto materials = MaterialTable<float>();
+		auto scene = GeometryList<float>();
+		const auto material = materials.add(std::make_unique<DefaultMaterial<float>>());
+		scene.add<Sphere<float>>(
+			std::make_unique<Sphere<float>>(Point3<float>(0.0F, 0.0F, -5.0F), 1.0F, material));
+		const auto integrator = PathIntegrator<float>(scene, materials);
+		const auto color = integrator(Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F)));
+		ASSERT_FLOAT_EQ(color.r(), 0.0F);
+		ASSERT_FLOAT_EQ(color.g(), 0.0F);
+		ASSERT_FLOAT_EQ(color.b(), 0.0F);
+	}
+} // namespace graphics::test
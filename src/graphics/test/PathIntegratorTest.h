@@ -0,0 +1,80 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../../test/TestConstants.h"
+#include "../GeometryList.h"
+#include "../PathIntegrator.h"
+#include "../Sphere.h"
+#include "../materials/Lambertian.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	TEST(PathIntegratorTest, missReturnsBackground) {
+		const auto scene = GeometryList<float>();
+		const auto integrator = PathIntegrator<float>(scene);
+		const auto ray = Ray<float>(Point3<float>(), Vec3<float>(0.0F, 1.0F, 0.0F));
+		const auto color = integrator(ray);
+		ASSERT_NEAR(color.r(), 0.5F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(color.g(), 0.7F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(color.b(), 1.0F, FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(PathIntegratorTest, absorbedPathIsBlack) {
+		auto scene = GeometryList<float>();
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(Point3<float>(0.0F, 0.0F, -5.0F),
+																 1.0F,
+																 std::make_unique<DefaultMaterial<float>>()));
+		const auto integrator = PathIntegrator<float>(scene);
+		const auto color = integrator(Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F)));
+		ASSERT_FLOAT_EQ(color.r(), 0.0F);
+		ASSERT_FLOAT_EQ(color.g(), 0.0F);
+		ASSERT_FLOAT_EQ(color.b(), 0.0F);
+	}
+
+	TEST(PathIntegratorTest, countsMaterialIdsWithoutATable) {
+		if constexpr(!utils::instrumentation::ENABLED) {
+			GTEST_SKIP();
+		}
+
+		auto scene = GeometryList<float>();
+		scene.add<Sphere<float>>(
+			std::make_unique<Sphere<float>>(Point3<float>(0.0F, 0.0F, -5.0F), 1.0F, 0U));
+		const auto integrator = PathIntegrator<float>(scene);
+		utils::instrumentation::reset();
+		ignore(integrator(Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F))));
+		const auto snapshot = utils::instrumentation::snapshot();
+		ASSERT_EQ(snapshot[utils::instrumentation::Counter::UnresolvedMaterialIds], 1ULL);
+	}
+
+	TEST(PathIntegratorTest, russianRouletteIsUnbiased) {
+		// a dim diffuse sphere, so most paths are cut short by Russian roulette
+		auto scene = GeometryList<float>();
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(0.0F, 0.0F, -3.0F),
+			1.0F,
+			std::make_unique<Lambertian<float>>(Color<float>(0.3F, 0.3F, 0.3F))));
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(0.0F, -101.0F, -3.0F),
+			100.0F,
+			std::make_unique<Lambertian<float>>(Color<float>(0.3F, 0.3F, 0.3F))));
+
+		const auto with_roulette = PathIntegrator<float>(scene, 50ULL, 1ULL);
+		const auto without_roulette = PathIntegrator<float>(scene, 50ULL, 50ULL);
+		const auto ray = Ray<float>(Point3<float>(), Vec3<float>(0.0F, -0.2F, -1.0F));
+
+		constexpr auto num_samples = 40000;
+		math::seed_random(3ULL);
+		auto expected = 0.0;
+		auto actual = 0.0;
+		for(auto i = 0; i < num_samples; ++i) {
+			expected += static_cast<double>(without_roulette(ray).g());
+			actual += static_cast<double>(with_roulette(ray).g());
+		}
+		expected /= num_samples;
+		actual /= num_samples;
+		ASSERT_GT(expected, 0.05);
+		ASSERT_NEAR(actual, expected, expected * 0.05);
+	}
+} // namespace graphics::test
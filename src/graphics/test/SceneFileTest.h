@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../test/TestConstants.h"
+#include "../SceneFile.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	inline auto scene_file_test_path(const std::string& name) noexcept -> std::string {
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	inline auto scene_file_test_mesh() noexcept -> TriangleMesh<float> {
+		math::seed_random(7ULL);
+		auto positions = std::vector<Point3<float>>();
+		auto indices = std::vector<uint32_t>();
+		for(auto i = 0U; i < 50; ++i) {
+			const auto center = Vec3<float>::random(-5.0F, 5.0F);
+			for(auto j = 0; j < 3; ++j) {
+				positions.emplace_back(center + Vec3<float>::random(-1.0F, 1.0F));
+			}
+			indices.insert(indices.end(), {3 * i, 3 * i + 1, 3 * i + 2});
+		}
+		return {std::move(positions), std::move(indices), 2};
+	}
+
+	TEST(SceneFileTest, roundTrip) {
+		auto materials = MaterialTable<float>();
+		materials.add(Lambertian<float>(Color<float>(0.1F, 0.2F, 0.3F)));
+		materials.add(Metal<float>(Color<float>(0.4F, 0.5F, 0.6F), 0.25F));
+		materials.add(Dielectric<float>(1.5F));
+
+		math::seed_random(42ULL);
+		auto spheres = SphereSet<float>();
+		for(auto i = 0U; i < 30; ++i) {
+			spheres.add(Point3<float>(Vec3<float>::random(-5.0F, 5.0F)),
+						random_value(0.1F, 1.0F),
+						i % 3);
+		}
+		const auto mesh = scene_file_test_mesh();
+		const auto* const meshes = &mesh;
+
+		const auto path = scene_file_test_path("hyperion_scene_file_test.scene");
+		ASSERT_TRUE(SceneFile<float>::write(path, materials, spheres, {&meshes, 1}));
+		const auto scene = SceneFile<float>::open(path);
+		ASSERT_TRUE(scene.has_value());
+
+		ASSERT_EQ(scene->materials().size(), 3ULL);
+		const auto& metal = std::get<Metal<float>>(scene->materials().at(1));
+		ASSERT_FLOAT_EQ(metal.albedo().g(), 0.5F);
+		ASSERT_FLOAT_EQ(metal.reflection_fuzziness(), 0.25F);
+		ASSERT_FLOAT_EQ(std::get<Dielectric<float>>(scene->materials().at(2)).refraction_index(),
+						1.5F);
+		ASSERT_EQ(scene->spheres().size(), spheres.size());
+		ASSERT_EQ(scene->meshes().size(), 1ULL);
+		ASSERT_EQ(scene->meshes()[0].num_triangles(), mesh.num_triangles());
+		ASSERT_EQ(scene->meshes()[0].material_id(), 2U);
+		const auto bounds = spheres.bounding_box().merged(mesh.bounding_box());
+		ASSERT_FLOAT_EQ(scene->bounding_box().min().x(), bounds.min().x());
+		ASSERT_FLOAT_EQ(scene->bounding_box().max().z(), bounds.max().z());
+
+		for(auto i = 0; i < 1000; ++i) {
+			const auto ray = Ray<float>(Point3<float>(Vec3<float>::random(-8.0F, 8.0F)),
+										Vec3<float>::random(-1.0F, 1.0F));
+			auto expected = HitRecord<float>();
+			auto expected_hit
+				= spheres.intersected(ray, 0.0F, Constants<float>::infinity, &expected);
+			const auto closest = expected_hit ? expected.m_length : Constants<float>::infinity;
+			expected_hit = mesh.intersected(ray, 0.0F, closest, &expected) || expected_hit;
+
+			auto actual = HitRecord<float>();
+			const auto actual_hit
+				= scene->intersected(ray, 0.0F, Constants<float>::infinity, &actual);
+			ASSERT_EQ(expected_hit, actual_hit);
+			if(expected_hit) {
+				ASSERT_NEAR(expected.m_length, actual.m_length, FLOAT_ACCEPTED_ERROR);
+				ASSERT_EQ(expected.m_material_id, actual.m_material_id);
+				ASSERT_EQ(expected.m_primitive_id, actual.m_primitive_id);
+			}
+		}
+
+		std::filesystem::remove(path);
+	}
+
+	TEST(SceneFileTest, rejectsInvalidFiles) {
+		ASSERT_FALSE(SceneFile<float>::open(scene_file_test_path("hyperion_missing.scene")));
+
+		const auto path = scene_file_test_path("hyperion_invalid.scene");
+		{
+			auto file = std::ofstream(path, std::ios::binary);
+			file << "HYPSCENE, but not really a scene file at all";
+		}
+		ASSERT_FALSE(SceneFile<float>::open(path));
+
+		// a valid file, truncated, has arrays extending past its end
+		auto materials = MaterialTable<float>();
+		materials.add(Dielectric<float>(1.5F));
+		const auto mesh = TriangleMesh<float>(
+			{{0.0F, 0.0F, 0.0F}, {1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}},
+			{0, 1, 2},
+			0);
+		const auto* const meshes = &mesh;
+		ASSERT_TRUE(SceneFile<float>::write(path, materials, SphereSet<float>(), {&meshes, 1}));
+		ASSERT_TRUE(SceneFile<float>::open(path));
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+		ASSERT_FALSE(SceneFile<float>::open(path));
+
+		// a tree whose nodes are shared between parents could hide its depth from the check
+		// against traversal's queue size
+		const auto positions = mesh.arrays().m_positions;
+		const auto indices = mesh.arrays().m_indices;
+		auto nodes = std::array<TriangleMesh<float>::Node, 3>();
+		nodes[0].m_num_children = 2;
+		nodes[0].m_child[0] = 1;
+		nodes[0].m_child[1] = 2;
+		nodes[1].m_num_children = 1;
+		nodes[1].m_child[0] = 2;
+		nodes[2].m_num_children = 1;
+		nodes[2].m_count[0] = 1;
+		const auto shared = TriangleMesh<float>({positions, {}, {}, indices, nodes}, 0);
+		const auto* const shared_meshes = &shared;
+		ASSERT_TRUE(
+			SceneFile<float>::write(path, materials, SphereSet<float>(), {&shared_meshes, 1}));
+		ASSERT_FALSE(SceneFile<float>::open(path));
+
+		// materials called through the virtual interface can't be written
+		materials.add(std::make_unique<Lambertian<float>>(Color<float>(0.5F, 0.5F, 0.5F)));
+		ASSERT_FALSE(SceneFile<float>::write(path, materials, SphereSet<float>(), {}));
+
+		std::filesystem::remove(path);
+	}
+
+	TEST(SceneFileTest, rejectsMalformedSphereBlocks) {
+		auto materials = MaterialTable<float>();
+		materials.add(Dielectric<float>(1.5F));
+		auto blocks = std::vector<SphereSet<float>::Block>(2);
+		blocks[0].m_radius[0] = 1.0F;
+		const auto path = scene_file_test_path("hyperion_sphere_blocks.scene");
+
+		ASSERT_TRUE(SceneFile<float>::write(path,
+											materials,
+											SphereSet<float>({blocks.data(), 1}, 1),
+											{}));
+		ASSERT_TRUE(SceneFile<float>::open(path));
+
+		// more blocks than the spheres need
+		ASSERT_TRUE(SceneFile<float>::write(path, materials, SphereSet<float>(blocks, 1), {}));
+		ASSERT_FALSE(SceneFile<float>::open(path));
+
+		// a sphere, with an unchecked material id, hiding in a padding lane
+		blocks[0].m_radius[1] = 1.0F;
+		blocks[0].m_material_id[1] = 7;
+		ASSERT_TRUE(SceneFile<float>::write(path,
+											materials,
+											SphereSet<float>({blocks.data(), 1}, 1),
+											{}));
+		ASSERT_FALSE(SceneFile<float>::open(path));
+
+		std::filesystem::remove(path);
+	}
+} // namespace graphics::test
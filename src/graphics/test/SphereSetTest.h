@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../Sphere.h"
+#include "../SphereSet.h"
+#include "../materials/MaterialTable.h"
+
+namespace graphics::test {
+	using ::test::DOUBLE_ACCEPTED_ERROR;
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	/// @brief Finds the closest hit of a ray against `spheres` by brute force, in double precision
+	inline auto
+	sphere_set_reference_hit(const std::vector<std::pair<Vec3<double>, double>>& spheres,
+							 const Vec3<double>& origin,
+							 const Vec3<double>& direction) noexcept -> double {
+		// `SphereSet` ignores hits closer than its hit threshold
+		constexpr auto min_length = 0.005;
+		auto closest = Constants<double>::infinity;
+		for(const auto& [center, radius] : spheres) {
+			const auto origin_to_center = origin - center;
+			const auto half_b = origin_to_center.dot_prod(direction);
+			const auto c = origin_to_center.dot_prod(origin_to_center) - radius * radius;
+			const auto discriminant = half_b * half_b - direction.dot_prod(direction) * c;
+			if(discriminant < 0.0) {
+				continue;
+			}
+
+			const auto near = (-half_b - std::sqrt(discriminant)) / direction.dot_prod(direction);
+			const auto far = (-half_b + std::sqrt(discriminant)) / direction.dot_prod(direction);
+			const auto root = near >= min_length ? near : far;
+			if(root >= min_length && root < closest) {
+				closest = root;
+			}
+		}
+		return closest;
+	}
+
+	template<FloatingPoint T>
+	inline auto sphere_set_matches_reference(double accepted_error) noexcept -> void {
+		// 301 spheres, so the last block is only partially filled
+		constexpr auto num_spheres = 301;
+		math::seed_random(7ULL);
+		auto spheres = std::vector<std::pair<Vec3<double>, double>>();
+		auto set = SphereSet<T>();
+		for(auto i = 0; i < num_spheres; ++i) {
+			const auto center = Vec3<double>::random(-10.0, 10.0);
+			const auto radius = random_value(0.1, 1.0);
+			spheres.emplace_back(center, radius);
+			set.add(Point3<T>(narrow_cast<T>(center.x()),
+							  narrow_cast<T>(center.y()),
+							  narrow_cast<T>(center.z())),
+					narrow_cast<T>(radius),
+					narrow_cast<uint32_t>(i));
+		}
+		ASSERT_EQ(set.size(), narrow_cast<size_t>(num_spheres));
+
+		for(auto i = 0; i < 1000; ++i) {
+			const auto origin = Vec3<double>::random(-15.0, 15.0);
+			const auto direction = Vec3<double>::random(-1.0, 1.0);
+			const auto expected = sphere_set_reference_hit(spheres, origin, direction);
+
+			auto record = HitRecord<T>();
+			const auto hit = set.intersected(Ray<T>(Point3<T>(narrow_cast<T>(origin.x()),
+															  narrow_cast<T>(origin.y()),
+															  narrow_cast<T>(origin.z())),
+													Vec3<T>(narrow_cast<T>(direction.x()),
+															narrow_cast<T>(direction.y()),
+															narrow_cast<T>(direction.z()))),
+											 narrow_cast<T>(0),
+											 Constants<T>::infinity,
+											 &record);
+
+			ASSERT_EQ(hit, expected != Constants<double>::infinity);
+			if(hit) {
+				ASSERT_NEAR(expected, static_cast<double>(record.m_length), accepted_error);
+			}
+		}
+	}
+
+	TEST(SphereSetTest, matchesReferenceFloat) {
+		sphere_set_matches_reference<float>(0.01);
+	}
+
+	TEST(SphereSetTest, matchesReferenceDouble) {
+		sphere_set_matches_reference<double>(DOUBLE_ACCEPTED_ERROR);
+	}
+
+	TEST(SphereSetTest, boundingBox) {
+		auto set = SphereSet<float>();
+		set.add(Point3<float>(0.0F, 0.0F, 0.0F), 1.0F, 0U);
+		set.add(Point3<float>(4.0F, 0.0F, 0.0F), 2.0F, 1U);
+		const auto box = set.bounding_box();
+		ASSERT_FLOAT_EQ(box.min().x(), -1.0F);
+		ASSERT_FLOAT_EQ(box.max().x(), 6.0F);
+		ASSERT_FLOAT_EQ(box.min().y(), -2.0F);
+	}
+
+	TEST(SphereSetTest, sharedMaterials) {
+		auto materials = MaterialTable<float>();
+		const auto material = materials.add(Lambertian<float>());
+		auto set = SphereSet<float>();
+		set.add(Point3<float>(0.0F, 0.0F, -5.0F), 1.0F, material);
+		set.add(Point3<float>(0.0F, 0.0F, -10.0F), 1.0F, material);
+		ASSERT_EQ(set.size(), 2ULL);
+		ASSERT_EQ(materials.size(), 1ULL);
+
+		auto record = HitRecord<float>();
+		const auto ray = Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F));
+		ASSERT_TRUE(set.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+		ASSERT_NEAR(record.m_length, 4.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_EQ(record.m_material_id, material);
+		const auto surface = record.surface(ray);
+		ASSERT_TRUE(surface.m_hit_outer_face);
+		ASSERT_NEAR(surface.m_point.z(), -4.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_normal.z(), 1.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_EQ(surface.m_material_id, material);
+		ASSERT_FALSE(set.intersected(ray, 0.0F, 3.0F, &record));
+	}
+
+	TEST(SphereTest, closestHitDoesntDependOnTestOrder) {
+		// hit 0.002 apart along the ray, well within the spheres' hit threshold of each other
+		const auto near = Sphere<float>(Point3<float>(0.0F, 0.0F, -5.0F), 1.0F, 0U);
+		const auto far = Sphere<float>(Point3<float>(0.0F, 0.0F, -5.002F), 1.0F, 1U);
+		const auto ray = Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F));
+		for(const auto& order : {std::array{&near, &far}, std::array{&far, &near}}) {
+			auto record = HitRecord<float>();
+			auto closest = Constants<float>::infinity;
+			for(const auto* sphere : order) {
+				if(sphere->intersected(ray, 0.0F, closest, &record)) {
+					closest = record.m_length;
+				}
+			}
+			ASSERT_NEAR(closest, 4.0F, FLOAT_ACCEPTED_ERROR);
+			ASSERT_EQ(record.m_material_id, 0U);
+		}
+	}
+
+	TEST(SphereSetTest, closestHitDoesntDependOnTestOrder) {
+		// as above, with the two spheres in different blocks, added in either order
+		for(const auto near_first : {true, false}) {
+			auto set = SphereSet<float>();
+			set.add(Point3<float>(0.0F, 0.0F, near_first ? -5.0F : -5.002F),
+					1.0F,
+					near_first ? 0U : 1U);
+			for(auto i = 0; i < 4; ++i) {
+				set.add(Point3<float>(10.0F, narrow_cast<float>(i), 0.0F), 0.5F, 2U);
+			}
+			set.add(Point3<float>(0.0F, 0.0F, near_first ? -5.002F : -5.0F),
+					1.0F,
+					near_first ? 1U : 0U);
+
+			auto record = HitRecord<float>();
+			const auto ray = Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F));
+			ASSERT_TRUE(set.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+			ASSERT_NEAR(record.m_length, 4.0F, FLOAT_ACCEPTED_ERROR);
+			ASSERT_EQ(record.m_material_id, 0U);
+		}
+	}
+
+	TEST(SphereSetTest, empty) {
+		const auto set = SphereSet<float>();
+		auto record = HitRecord<float>();
+		ASSERT_FALSE(set.intersected(Ray<float>(), 0.0F, Constants<float>::infinity, &record));
+		ASSERT_TRUE(set.bounding_box().is_empty());
+	}
+} // namespace graphics::test
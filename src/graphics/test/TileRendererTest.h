@@ -0,0 +1,305 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <span>
+
+#include "../../test/TestConstants.h"
+#include "../TileRenderer.h"
+
+namespace graphics::test {
+
+	inline auto tile_renderer_test_shade(const Ray<float>& ray) noexcept -> Color<float> {
+		return {ray.direction().x(), ray.direction().y(), random_value<float>()};
+	}
+
+	TEST(TileRendererTest, tilesCoverImage) {
+		const auto renderer = TileRenderer<float>(100ULL, 70ULL, 1ULL, 1ULL, 32ULL);
+		const auto tiles = renderer.tiles();
+		ASSERT_EQ(tiles.size(), 12ULL);
+
+		auto covered = 0ULL;
+		for(auto i = 0ULL; i < tiles.size(); ++i) {
+			ASSERT_EQ(tiles[i].m_index, i);
+			covered += tiles[i].m_width * tiles[i].m_height;
+		}
+		ASSERT_EQ(covered, 100ULL * 70ULL);
+		ASSERT_EQ(tiles.back().m_width, 4ULL);
+		ASSERT_EQ(tiles.back().m_height, 6ULL);
+	}
+
+	TEST(TileRendererTest, countsRaysAndTiles) {
+		if constexpr(!utils::instrumentation::ENABLED) {
+			GTEST_SKIP();
+		}
+
+		using utils::instrumentation::Counter;
+		const auto renderer = TileRenderer<float>(100ULL, 70ULL, 3ULL, 2ULL, 32ULL);
+		utils::instrumentation::reset();
+		ignore(renderer.render(Camera<float>(), tile_renderer_test_shade));
+
+		const auto snapshot = utils::instrumentation::snapshot();
+		ASSERT_EQ(snapshot[Counter::PrimaryRays], 100ULL * 70ULL * 3ULL);
+		ASSERT_EQ(snapshot[Counter::TilesQueued], 12ULL);
+		ASSERT_EQ(snapshot[Counter::TilesRendered], 12ULL);
+		ASSERT_GT(snapshot.seconds(utils::instrumentation::Stage::Tiles), 0.0);
+	}
+
+	TEST(TileRendererTest, deterministicAcrossThreadCounts) {
+		const auto camera = Camera<float>();
+		const auto single = TileRenderer<float>(67ULL, 45ULL, 4ULL, 1ULL, 16ULL);
+		const auto multi = TileRenderer<float>(67ULL, 45ULL, 4ULL, 4ULL, 16ULL);
+
+		const auto expected = single.render(camera, tile_renderer_test_shade);
+		const auto actual = multi.render(camera, tile_renderer_test_shade);
+
+		ASSERT_EQ(expected.width(), actual.width());
+		ASSERT_EQ(expected.height(), actual.height());
+		for(auto y = 0ULL; y < expected.height(); ++y) {
+			for(auto x = 0ULL; x < expected.width(); ++x) {
+				ASSERT_FLOAT_EQ(expected.at(x, y).r(), actual.at(x, y).r());
+				ASSERT_FLOAT_EQ(expected.at(x, y).g(), actual.at(x, y).g());
+				ASSERT_FLOAT_EQ(expected.at(x, y).b(), actual.at(x, y).b());
+			}
+		}
+	}
+
+	TEST(TileRendererTest, samplerDeterministicAcrossThreadCounts) {
+		const auto camera = Camera<float>();
+		auto single = TileRenderer<float>(67ULL, 45ULL, 4ULL, 1ULL, 16ULL);
+		auto multi = TileRenderer<float>(67ULL, 45ULL, 4ULL, 4ULL, 16ULL);
+		const auto sampler = std::make_shared<math::SobolSampler<float>>();
+		single.set_sampler(sampler);
+		multi.set_sampler(sampler);
+
+		const auto random = TileRenderer<float>(67ULL, 45ULL, 4ULL, 1ULL, 16ULL)
+								.render(camera, tile_renderer_test_shade);
+		const auto expected = single.render(camera, tile_renderer_test_shade);
+		const auto actual = multi.render(camera, tile_renderer_test_shade);
+
+		auto num_differing = 0ULL;
+		for(auto y = 0ULL; y < expected.height(); ++y) {
+			for(auto x = 0ULL; x < expected.width(); ++x) {
+				ASSERT_FLOAT_EQ(expected.at(x, y).r(), actual.at(x, y).r());
+				ASSERT_FLOAT_EQ(expected.at(x, y).g(), actual.at(x, y).g());
+				ASSERT_FLOAT_EQ(expected.at(x, y).b(), actual.at(x, y).b());
+				num_differing += expected.at(x, y).r() != random.at(x, y).r() ? 1ULL : 0ULL;
+			}
+		}
+		// the sampler, not the random number generator, positioned the samples
+		ASSERT_GT(num_differing, expected.width() * expected.height() / 2);
+	}
+
+	/// @brief A `BatchShader` whose colors match those of its per-ray counterpart, `color`
+	struct TileRendererTestBatchShader {
+		std::atomic_size_t* m_num_batches;
+
+		inline static auto color(const Ray<float>& ray) noexcept -> Color<float> {
+			return {ray.direction().x(), ray.direction().y(), 0.5F};
+		}
+
+		inline auto operator()(std::span<const Ray<float>> rays,
+							   std::span<Color<float>> colors) const noexcept -> void {
+			m_num_batches->fetch_add(1);
+			for(auto i = 0ULL; i < rays.size(); ++i) {
+				colors[i] = color(rays[i]);
+			}
+		}
+	};
+
+	TEST(TileRendererTest, batchShaderMatchesPerRayShader) {
+		const auto camera = Camera<float>();
+		auto renderer = TileRenderer<float>(67ULL, 45ULL, 8ULL, 2ULL, 16ULL);
+		for(const auto adaptive : {false, true}) {
+			if(adaptive) {
+				renderer.set_adaptive_sampling(AdaptiveSampling<float>{});
+			}
+
+			auto num_batches = std::atomic_size_t(0);
+			const auto expected = renderer.render(camera, &TileRendererTestBatchShader::color);
+			const auto actual = renderer.render(camera, TileRendererTestBatchShader{&num_batches});
+
+			ASSERT_GE(num_batches.load(), renderer.tiles().size());
+			for(auto y = 0ULL; y < expected.height(); ++y) {
+				for(auto x = 0ULL; x < expected.width(); ++x) {
+					ASSERT_FLOAT_EQ(expected.at(x, y).r(), actual.at(x, y).r());
+					ASSERT_FLOAT_EQ(expected.at(x, y).g(), actual.at(x, y).g());
+				}
+			}
+		}
+	}
+
+	TEST(TileRendererTest, adaptiveSamplingStopsConvergedPixels) {
+		auto renderer = TileRenderer<float>(40ULL, 30ULL, 64ULL, 2ULL, 16ULL);
+		renderer.set_adaptive_sampling(AdaptiveSampling<float>{});
+		auto num_samples = std::atomic_size_t(0);
+		const auto framebuffer = renderer.render(Camera<float>(),
+												 [&num_samples](const Ray<float>& ray) noexcept {
+													 ignore(ray);
+													 num_samples.fetch_add(1);
+													 return Color<float>(0.5F, 0.5F, 0.5F);
+												 });
+
+		// a constant color has zero variance, so every pixel converges after the minimum
+		ASSERT_EQ(num_samples.load(), 40ULL * 30ULL * AdaptiveSampling<float>().m_min_samples);
+		ASSERT_FLOAT_EQ(framebuffer.at(10ULL, 10ULL).g(), 0.5F);
+	}
+
+	TEST(TileRendererTest, adaptiveSamplingRespectsBudget) {
+		auto renderer = TileRenderer<float>(40ULL, 30ULL, 32ULL, 2ULL, 16ULL);
+		renderer.set_adaptive_sampling(AdaptiveSampling<float>{});
+		auto num_samples = std::atomic_size_t(0);
+		std::ignore = renderer.render(Camera<float>(),
+									  [&num_samples](const Ray<float>& ray) noexcept {
+										  num_samples.fetch_add(1);
+										  // only the left half of the image is noisy
+										  return ray.direction().x() < 0.0F ?
+													 Color<float>(random_value<float>(), 0.0F, 0.0F) :
+													 Color<float>(0.5F, 0.5F, 0.5F);
+									  });
+
+		ASSERT_LE(num_samples.load(), 40ULL * 30ULL * 32ULL);
+		ASSERT_GT(num_samples.load(), 40ULL * 30ULL * AdaptiveSampling<float>().m_min_samples);
+	}
+
+	TEST(TileRendererTest, adaptiveSamplingRespectsBudgetBelowMinSamples) {
+		auto renderer = TileRenderer<float>(40ULL, 30ULL, 4ULL, 2ULL, 16ULL);
+		renderer.set_adaptive_sampling(AdaptiveSampling<float>{});
+		auto num_samples = std::atomic_size_t(0);
+		std::ignore = renderer.render(Camera<float>(),
+									  [&num_samples](const Ray<float>& ray) noexcept {
+										  num_samples.fetch_add(1);
+										  return Color<float>(random_value<float>(),
+															  ray.direction().y(),
+															  0.0F);
+									  });
+
+		ASSERT_EQ(num_samples.load(), 40ULL * 30ULL * 4ULL);
+	}
+
+	TEST(TileRendererTest, adaptiveSamplingDeterministicAcrossThreadCounts) {
+		const auto camera = Camera<float>();
+		auto single = TileRenderer<float>(67ULL, 45ULL, 32ULL, 1ULL, 16ULL);
+		auto multi = TileRenderer<float>(67ULL, 45ULL, 32ULL, 4ULL, 16ULL);
+		single.set_adaptive_sampling(AdaptiveSampling<float>{});
+		multi.set_adaptive_sampling(AdaptiveSampling<float>{});
+
+		const auto expected = single.render(camera, tile_renderer_test_shade);
+		const auto actual = multi.render(camera, tile_renderer_test_shade);
+
+		for(auto y = 0ULL; y < expected.height(); ++y) {
+			for(auto x = 0ULL; x < expected.width(); ++x) {
+				ASSERT_FLOAT_EQ(expected.at(x, y).b(), actual.at(x, y).b());
+			}
+		}
+	}
+
+	TEST(TileRendererTest, progressiveTakesAllSamples) {
+		const auto renderer = TileRenderer<float>(40ULL, 30ULL, 5ULL, 2ULL, 16ULL);
+		auto accumulation = renderer.accumulation_buffer(2ULL);
+		auto num_samples = std::atomic_size_t(0);
+		auto previews = 0ULL;
+		const auto finished = renderer.render_progressive(
+			Camera<float>(),
+			[&num_samples](const Ray<float>& ray) noexcept {
+				ignore(ray);
+				num_samples.fetch_add(1);
+				return Color<float>(0.5F, 0.25F, 1.0F);
+			},
+			&accumulation,
+			[&previews](const AccumulationBuffer<float>& buffer) noexcept {
+				++previews;
+				EXPECT_FLOAT_EQ(buffer.preview().at(3ULL, 7ULL).g(), 0.25F);
+				return true;
+			});
+
+		ASSERT_TRUE(finished);
+		// passes of 2, 2, then 1 sample per pixel
+		ASSERT_EQ(previews, 3ULL);
+		ASSERT_EQ(accumulation.num_passes(), 3ULL);
+		ASSERT_EQ(accumulation.num_samples(), 5ULL);
+		ASSERT_EQ(num_samples.load(), 40ULL * 30ULL * 5ULL);
+		ASSERT_FLOAT_EQ(accumulation.preview().at(39ULL, 29ULL).r(), 0.5F);
+
+		// the render is complete, so there's nothing left to do
+		ASSERT_FALSE(
+			renderer.render_pass(Camera<float>(), tile_renderer_test_shade, &accumulation));
+	}
+
+	TEST(TileRendererTest, progressiveResumesBitIdentical) {
+		const auto camera = Camera<float>();
+		const auto sampler = std::make_shared<math::SobolSampler<float>>();
+		auto uninterrupted = TileRenderer<float>(67ULL, 45ULL, 12ULL, 1ULL, 16ULL);
+		auto resumed = TileRenderer<float>(67ULL, 45ULL, 12ULL, 4ULL, 16ULL);
+		uninterrupted.set_sampler(sampler);
+		resumed.set_sampler(sampler);
+
+		auto expected = uninterrupted.accumulation_buffer(4ULL);
+		ASSERT_TRUE(uninterrupted.render_progressive(
+			camera,
+			tile_renderer_test_shade,
+			&expected,
+			[](const AccumulationBuffer<float>& buffer) noexcept {
+				ignore(buffer);
+				return true;
+			}));
+
+		// stop after the first pass, and resume from a checkpoint with more threads
+		const auto path = (std::filesystem::temp_directory_path()
+						   / "hyperion_tile_renderer_test.checkpoint")
+							  .string();
+		auto interrupted = resumed.accumulation_buffer(4ULL);
+		ASSERT_FALSE(resumed.render_progressive(camera,
+												tile_renderer_test_shade,
+												&interrupted,
+												[&path](const AccumulationBuffer<float>& buffer) {
+													return !buffer.save(path);
+												}));
+		ASSERT_EQ(interrupted.num_passes(), 1ULL);
+
+		auto actual = AccumulationBuffer<float>::load(path);
+		ASSERT_TRUE(actual);
+		ASSERT_TRUE(resumed.render_progressive(
+			camera,
+			tile_renderer_test_shade,
+			&actual.value(),
+			[](const AccumulationBuffer<float>& buffer) noexcept {
+				ignore(buffer);
+				return true;
+			}));
+		std::filesystem::remove(path);
+
+		ASSERT_EQ(actual->num_samples(), 12ULL);
+		for(auto i = 0ULL; i < expected.sums().size(); ++i) {
+			ASSERT_EQ(expected.sums()[i].r(), actual->sums()[i].r());
+			ASSERT_EQ(expected.sums()[i].g(), actual->sums()[i].g());
+			ASSERT_EQ(expected.sums()[i].b(), actual->sums()[i].b());
+		}
+	}
+
+	TEST(TileRendererTest, progressiveRejectsIncompatibleBuffers) {
+		const auto renderer = TileRenderer<float>(40ULL, 30ULL, 4ULL, 1ULL, 16ULL);
+		const auto other_seed = TileRenderer<float>(40ULL, 30ULL, 4ULL, 1ULL, 16ULL, 7ULL);
+		const auto other_tiles = TileRenderer<float>(40ULL, 30ULL, 4ULL, 1ULL, 8ULL);
+		auto accumulation = renderer.accumulation_buffer(2ULL);
+
+		ASSERT_TRUE(renderer.is_compatible(accumulation));
+		ASSERT_FALSE(other_seed.is_compatible(accumulation));
+		ASSERT_FALSE(other_tiles.is_compatible(accumulation));
+
+		// samplers of a different kind, or with different parameters, take different samples
+		auto other_sampler = TileRenderer<float>(40ULL, 30ULL, 4ULL, 1ULL, 16ULL);
+		other_sampler.set_sampler(std::make_shared<math::SobolSampler<float>>());
+		ASSERT_FALSE(other_sampler.is_compatible(accumulation));
+		const auto sampled = other_sampler.accumulation_buffer(2ULL);
+		ASSERT_TRUE(other_sampler.is_compatible(sampled));
+		other_sampler.set_sampler(std::make_shared<math::SobolSampler<float>>(3ULL));
+		ASSERT_FALSE(other_sampler.is_compatible(sampled));
+		other_sampler.set_sampler(std::make_shared<math::HaltonSampler<float>>());
+		ASSERT_FALSE(other_sampler.is_compatible(sampled));
+		ASSERT_FALSE(
+			other_seed.render_pass(Camera<float>(), tile_renderer_test_shade, &accumulation));
+		ASSERT_EQ(accumulation.num_passes(), 0ULL);
+	}
+} // namespace graphics::test
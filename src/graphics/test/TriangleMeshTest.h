@@ -0,0 +1,220 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "../../test/TestConstants.h"
+#include "../BoundingVolumeHierarchy.h"
+#include "../TriangleMesh.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	/// @brief A unit quad in the z = 0 plane, split into two triangles, facing +z
+	inline auto triangle_mesh_test_quad() noexcept -> TriangleMesh<float> {
+		return TriangleMesh<float>({{0.0F, 0.0F, 0.0F},
+									{1.0F, 0.0F, 0.0F},
+									{1.0F, 1.0F, 0.0F},
+									{0.0F, 1.0F, 0.0F}},
+								   {0, 1, 2, 0, 2, 3},
+								   0,
+								   {},
+								   {{0.0F, 0.0F}, {1.0F, 0.0F}, {1.0F, 1.0F}, {0.0F, 1.0F}});
+	}
+
+	/// @brief A fan of triangles around the origin in the z = 0 plane
+	inline auto triangle_mesh_test_fan(uint32_t num_triangles) noexcept -> TriangleMesh<float> {
+		auto positions = std::vector<Point3<float>>{{0.0F, 0.0F, 0.0F}};
+		auto indices = std::vector<uint32_t>();
+		for(auto i = 0U; i < num_triangles; ++i) {
+			const auto angle = 2.0F * Constants<float>::pi * narrow_cast<float>(i)
+							   / narrow_cast<float>(num_triangles);
+			positions.emplace_back(Trig::cos(angle), Trig::sin(angle), 0.0F);
+			indices.insert(indices.end(), {0, i + 1, (i + 1) % num_triangles + 1});
+		}
+		return {std::move(positions), std::move(indices), 0};
+	}
+
+	TEST(TriangleMeshTest, hitAndSurface) {
+		const auto quad = triangle_mesh_test_quad();
+		ASSERT_EQ(quad.num_triangles(), 2ULL);
+		ASSERT_EQ(quad.num_vertices(), 4ULL);
+
+		const auto ray
+			= Ray<float>(Point3<float>(0.25F, 0.75F, 2.0F), Vec3<float>(0.0F, 0.0F, -1.0F));
+		auto record = HitRecord<float>();
+		ASSERT_TRUE(quad.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+		ASSERT_NEAR(record.m_length, 2.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_EQ(record.m_material_id, 0U);
+
+		const auto surface = record.surface(ray);
+		ASSERT_NEAR(surface.m_point.x(), 0.25F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_point.y(), 0.75F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_point.z(), 0.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_normal.z(), 1.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_TRUE(surface.m_hit_outer_face);
+		ASSERT_NEAR(surface.m_uv.x(), 0.25F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(surface.m_uv.y(), 0.75F, FLOAT_ACCEPTED_ERROR);
+
+		// from behind, the normal faces the ray
+		const auto back
+			= Ray<float>(Point3<float>(0.5F, 0.25F, -1.0F), Vec3<float>(0.0F, 0.0F, 1.0F));
+		ASSERT_TRUE(quad.intersected(back, 0.0F, Constants<float>::infinity, &record));
+		const auto back_surface = record.surface(back);
+		ASSERT_NEAR(back_surface.m_normal.z(), -1.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_FALSE(back_surface.m_hit_outer_face);
+	}
+
+	TEST(TriangleMeshTest, miss) {
+		const auto quad = triangle_mesh_test_quad();
+		auto record = HitRecord<float>();
+		ASSERT_FALSE(quad.intersected(
+			Ray<float>(Point3<float>(1.5F, 0.5F, 1.0F), Vec3<float>(0.0F, 0.0F, -1.0F)),
+			0.0F,
+			Constants<float>::infinity,
+			&record));
+		ASSERT_FALSE(quad.intersected(
+			Ray<float>(Point3<float>(0.5F, 0.5F, 1.0F), Vec3<float>(0.0F, 0.0F, -1.0F)),
+			0.0F,
+			0.5F,
+			&record));
+
+		const auto box = quad.bounding_box();
+		ASSERT_FLOAT_EQ(box.min().x(), 0.0F);
+		ASSERT_FLOAT_EQ(box.max().y(), 1.0F);
+	}
+
+	TEST(TriangleMeshTest, closestHitDoesntDependOnTestOrder) {
+		// two triangles hit 0.002 apart along the ray, well within the meshes' hit threshold of
+		// each other
+		const auto triangle_at = [](float z, uint32_t material_id) {
+			return TriangleMesh<float>({{-1.0F, -1.0F, z}, {1.0F, -1.0F, z}, {0.0F, 1.0F, z}},
+									   {0, 1, 2},
+									   material_id);
+		};
+		const auto near = triangle_at(0.0F, 0U);
+		const auto far = triangle_at(-0.002F, 1U);
+		const auto ray
+			= Ray<float>(Point3<float>(0.0F, 0.0F, 2.0F), Vec3<float>(0.0F, 0.0F, -1.0F));
+		for(const auto& order : {std::array{&near, &far}, std::array{&far, &near}}) {
+			auto record = HitRecord<float>();
+			auto closest = Constants<float>::infinity;
+			for(const auto* mesh : order) {
+				if(mesh->intersected(ray, 0.0F, closest, &record)) {
+					closest = record.m_length;
+				}
+			}
+			ASSERT_NEAR(closest, 2.0F, FLOAT_ACCEPTED_ERROR);
+			ASSERT_EQ(record.m_material_id, 0U);
+		}
+	}
+
+	TEST(TriangleMeshTest, watertight) {
+		// rays through the fan's shared edges and center vertex must hit one of its triangles
+		const auto fan = triangle_mesh_test_fan(7);
+		math::seed_random(42ULL);
+		for(auto i = 0; i < 1000; ++i) {
+			const auto target = i % 2 == 0 ?
+									Point3<float>() :
+									Point3<float>(Vec3<float>(Trig::cos(2.0F * Constants<float>::pi
+																		* narrow_cast<float>(i % 7)
+																		/ 7.0F),
+															  Trig::sin(2.0F * Constants<float>::pi
+																		* narrow_cast<float>(i % 7)
+																		/ 7.0F),
+															  0.0F)
+												  * random_value(0.0F, 0.99F));
+			const auto origin = Point3<float>(Vec3<float>::random(-1.0F, 1.0F)
+											  + Vec3<float>(0.0F, 0.0F, 3.0F));
+			const auto ray = Ray<float>(origin, (target - origin).as_vec());
+			auto record = HitRecord<float>();
+			ASSERT_TRUE(fan.intersected(ray, 0.0F, Constants<float>::infinity, &record));
+		}
+	}
+
+	TEST(TriangleMeshTest, matchesBruteForce) {
+		math::seed_random(42ULL);
+		auto positions = std::vector<Point3<float>>();
+		auto indices = std::vector<uint32_t>();
+		for(auto i = 0U; i < 200; ++i) {
+			const auto center = Vec3<float>::random(-5.0F, 5.0F);
+			for(auto j = 0; j < 3; ++j) {
+				positions.emplace_back(center + Vec3<float>::random(-1.0F, 1.0F));
+			}
+			indices.insert(indices.end(), {3 * i, 3 * i + 1, 3 * i + 2});
+		}
+
+		auto triangles = std::vector<TriangleMesh<float>>();
+		for(auto i = 0U; i < 200; ++i) {
+			triangles.emplace_back(std::vector<Point3<float>>{positions[3ULL * i],
+															  positions[3ULL * i + 1],
+															  positions[3ULL * i + 2]},
+								   std::vector<uint32_t>{0, 1, 2},
+								   0);
+		}
+		const auto mesh = TriangleMesh<float>(std::move(positions), std::move(indices), 0);
+
+		for(auto i = 0; i < 1000; ++i) {
+			const auto ray = Ray<float>(Point3<float>(Vec3<float>::random(-8.0F, 8.0F)),
+										Vec3<float>::random(-1.0F, 1.0F));
+			auto expected = HitRecord<float>();
+			auto expected_hit = false;
+			auto closest = Constants<float>::infinity;
+			for(const auto& triangle : triangles) {
+				if(triangle.intersected(ray, 0.0F, closest, &expected)) {
+					expected_hit = true;
+					closest = expected.m_length;
+				}
+			}
+
+			auto actual = HitRecord<float>();
+			const auto actual_hit
+				= mesh.intersected(ray, 0.0F, Constants<float>::infinity, &actual);
+			ASSERT_EQ(expected_hit, actual_hit);
+			if(expected_hit) {
+				ASSERT_NEAR(expected.m_length, actual.m_length, FLOAT_ACCEPTED_ERROR);
+				const auto expected_point = expected.surface(ray).m_point;
+				const auto actual_point = actual.surface(ray).m_point;
+				ASSERT_NEAR(expected_point.x(), actual_point.x(), FLOAT_ACCEPTED_ERROR);
+				ASSERT_NEAR(expected_point.y(), actual_point.y(), FLOAT_ACCEPTED_ERROR);
+				ASSERT_NEAR(expected_point.z(), actual_point.z(), FLOAT_ACCEPTED_ERROR);
+			}
+		}
+	}
+
+	TEST(TriangleMeshTest, fitsByteBudget) {
+		// a rippled heightfield of 2 * 128 * 128 triangles
+		constexpr auto size = 128U;
+		auto positions = std::vector<Point3<float>>();
+		auto indices = std::vector<uint32_t>();
+		for(auto y = 0U; y <= size; ++y) {
+			for(auto x = 0U; x <= size; ++x) {
+				const auto u = narrow_cast<float>(x) / narrow_cast<float>(size);
+				const auto v = narrow_cast<float>(y) / narrow_cast<float>(size);
+				positions.emplace_back(u, v, 0.05F * Trig::sin(20.0F * u) * Trig::cos(15.0F * v));
+			}
+		}
+		for(auto y = 0U; y < size; ++y) {
+			for(auto x = 0U; x < size; ++x) {
+				const auto corner = y * (size + 1) + x;
+				const auto above = corner + size + 1;
+				indices.insert(indices.end(), {corner, corner + 1, above + 1});
+				indices.insert(indices.end(), {corner, above + 1, above});
+			}
+		}
+		const auto mesh = TriangleMesh<float>(std::move(positions), std::move(indices), 0);
+
+		// the indices and the tree, besides the shared vertices, take at most 16 bytes a triangle
+		const auto arrays = mesh.arrays();
+		const auto bytes = arrays.m_indices.size_bytes() + arrays.m_nodes.size_bytes();
+		ASSERT_LE(bytes, 16ULL * mesh.num_triangles());
+
+		for(const auto& node : arrays.m_nodes) {
+			for(auto child = 0ULL; child < node.m_num_children; ++child) {
+				const auto count = node.m_count[child]; // NOLINT
+				ASSERT_TRUE(count == 0 || count >= TriangleMesh<float>::MIN_LEAF_SIZE);
+			}
+		}
+	}
+} // namespace graphics::test
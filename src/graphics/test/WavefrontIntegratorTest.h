@@ -0,0 +1,114 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../GeometryList.h"
+#include "../PathIntegrator.h"
+#include "../Sphere.h"
+#include "../WavefrontIntegrator.h"
+#include "../materials/MaterialTable.h"
+
+namespace graphics::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	/// @brief Builds a scene with one sphere of every kind of material, over a diffuse floor
+	inline auto wavefront_integrator_test_scene(MaterialTable<float>& materials) noexcept
+		-> GeometryList<float> {
+		auto scene = GeometryList<float>();
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(0.0F, -101.0F, -3.0F),
+			100.0F,
+			materials.add(Lambertian<float>(Color<float>(0.5F, 0.5F, 0.5F)))));
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(-1.0F, 0.0F, -3.0F),
+			0.5F,
+			materials.add(Metal<float>(Color<float>(0.8F, 0.6F, 0.2F), 0.3F))));
+		scene.add<Sphere<float>>(
+			std::make_unique<Sphere<float>>(Point3<float>(0.0F, 0.0F, -3.0F),
+											0.5F,
+											materials.add(Dielectric<float>(1.5F))));
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(1.0F, 0.0F, -3.0F),
+			0.5F,
+			materials.add(std::make_unique<Lambertian<float>>(Color<float>(0.2F, 0.3F, 0.8F)))));
+		// a sphere with its own material, outside the table
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(0.0F, 1.0F, -3.0F),
+			0.5F,
+			std::make_unique<Lambertian<float>>(Color<float>(0.9F, 0.9F, 0.9F))));
+		return scene;
+	}
+
+	TEST(WavefrontIntegratorTest, missReturnsBackground) {
+		const auto scene = GeometryList<float>();
+		const auto materials = MaterialTable<float>();
+		const auto integrator = WavefrontIntegrator<float>(scene, materials);
+		const auto rays = std::vector<Ray<float>>(
+			3,
+			Ray<float>(Point3<float>(), Vec3<float>(0.0F, 1.0F, 0.0F)));
+		auto colors = std::vector<Color<float>>(rays.size());
+		integrator(rays, colors);
+		for(const auto& color : colors) {
+			ASSERT_NEAR(color.r(), 0.5F, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(color.g(), 0.7F, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(color.b(), 1.0F, FLOAT_ACCEPTED_ERROR);
+		}
+	}
+
+	TEST(WavefrontIntegratorTest, absorbedPathIsBlack) {
+		auto materials = MaterialTable<float>();
+		auto scene = GeometryList<float>();
+		scene.add<Sphere<float>>(std::make_unique<Sphere<float>>(
+			Point3<float>(0.0F, 0.0F, -5.0F),
+			1.0F,
+			materials.add(std::make_unique<DefaultMaterial<float>>())));
+		const auto integrator = WavefrontIntegrator<float>(scene, materials);
+		const auto rays = std::vector<Ray<float>>{
+			Ray<float>(Point3<float>(), Vec3<float>(0.0F, 0.0F, -1.0F)),
+			Ray<float>(Point3<float>(), Vec3<float>(0.0F, 1.0F, 0.0F))};
+		auto colors = std::vector<Color<float>>(rays.size());
+		integrator(rays, colors);
+		ASSERT_FLOAT_EQ(colors[0].g(), 0.0F);
+		// each path's color lands in its own slot
+		ASSERT_NEAR(colors[1].g(), 0.7F, FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(WavefrontIntegratorTest, matchesPathIntegrator) {
+		auto materials = MaterialTable<float>();
+		const auto scene = wavefront_integrator_test_scene(materials);
+		const auto wavefront = WavefrontIntegrator<float>(scene, materials);
+		const auto path = PathIntegrator<float>(scene, materials);
+
+		// rays fanning out across every sphere
+		constexpr auto num_directions = 16;
+		constexpr auto num_samples = 4000;
+		auto rays = std::vector<Ray<float>>();
+		for(auto direction = 0; direction < num_directions; ++direction) {
+			const auto x = -0.5F + narrow_cast<float>(direction % 4) / 3.0F;
+			const auto y = -0.3F + narrow_cast<float>(direction / 4) / 6.0F;
+			for(auto sample = 0; sample < num_samples; ++sample) {
+				rays.emplace_back(Point3<float>(), Vec3<float>(x, y, -1.0F));
+			}
+		}
+
+		math::seed_random(5ULL);
+		auto colors = std::vector<Color<float>>(rays.size());
+		wavefront(rays, colors);
+
+		for(auto direction = 0; direction < num_directions; ++direction) {
+			auto expected = 0.0;
+			auto actual = 0.0;
+			for(auto sample = 0; sample < num_samples; ++sample) {
+				const auto index = narrow_cast<size_t>(direction * num_samples + sample);
+				expected += static_cast<double>(path(rays[index]).luminance());
+				actual += static_cast<double>(colors[index].luminance());
+			}
+			expected /= num_samples;
+			actual /= num_samples;
+			ASSERT_NEAR(actual, expected, 0.05 * expected + 0.01);
+		}
+	}
+} // namespace graphics::test
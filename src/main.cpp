@@ -1,120 +1,99 @@
+#include <charconv>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
-#include <tuple>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 
 #include "base/StandardIncludes.h"
+#include "graphics/AccumulationBuffer.h"
+#include "graphics/BoundingVolumeHierarchy.h"
 #include "graphics/Camera.h"
 #include "graphics/Color.h"
+#include "graphics/DistributedRenderer.h"
 #include "graphics/Geometry.h"
-#include "graphics/GeometryList.h"
+#include "graphics/ImageWriter.h"
+#include "graphics/PathIntegrator.h"
+#include "graphics/RandomScene.h"
 #include "graphics/Ray.h"
-#include "graphics/Sphere.h"
-#include "graphics/materials/Dielectric.h"
-#include "graphics/materials/Lambertian.h"
-#include "graphics/materials/Metal.h"
+#include "graphics/TileRenderer.h"
+#include "graphics/materials/MaterialTable.h"
 #include "math/Point3.h"
 #include "math/Random.h"
+#include "math/Sampler.h"
 #include "math/Vec3.h"
+#include "utils/Instrumentation.h"
+#include "utils/Socket.h"
 
+using AccumulationBuffer = graphics::AccumulationBuffer<float>;
+using AdaptiveSampling = graphics::AdaptiveSampling<float>;
+using BoundingVolumeHierarchy = graphics::BoundingVolumeHierarchy<float>;
 using Camera = graphics::Camera<float>;
 using Color = graphics::Color<float>;
 using Ray = graphics::Ray<float>;
+using RenderCoordinator = graphics::RenderCoordinator<float>;
+using RenderWorker = graphics::RenderWorker<float>;
 using Geometry = graphics::Geometry<float>;
-using GeometryList = graphics::GeometryList<float>;
-using HitRecord = graphics::HitRecord<float>;
-using Sphere = graphics::Sphere<float>;
-using Lambertian = graphics::Lambertian<float>;
-using Metal = graphics::Metal<float>;
-using Dielectric = graphics::Dielectric<float>;
-
-inline constexpr auto
-color_at(const Ray& ray, const GeometryList& geometries, size_t depth) noexcept -> Color {
-	if(depth == 0) {
-		return {0.0F, 0.0F, 0.0F};
-	}
-
-	HitRecord record;
-	if(geometries.intersected(ray, 0.0F, Constants<float>::infinity, &record)) {
-		// auto val = 0.5F * (record.m_normal + Vec3(1.0F, 1.0F, 1.0F));
-		// return {val.x(), val.y(), val.z()};
-		Ray scattered;
-		Color attenuation;
-		if(record.m_material->scatter(ray, record, &attenuation, &scattered)) {
-			return attenuation * color_at(scattered, geometries, depth - 1);
+using ImageWriter = graphics::ImageWriter<float>;
+using PathIntegrator = graphics::PathIntegrator<float>;
+using SobolSampler = math::SobolSampler<float>;
+using MaterialTable = graphics::MaterialTable<float>;
+using TileRenderer = graphics::TileRenderer<float>;
+
+/// @brief The address given for a distributed render: `<host>:<port>` for TCP, or `unix:<path>`
+/// for a Unix domain socket
+struct Address {
+	std::string m_host;
+	uint16_t m_port = 0;
+	bool m_is_local = false;
+
+	[[nodiscard]] inline static auto
+	parse(std::string_view address) noexcept -> std::optional<Address> {
+		constexpr auto local_prefix = std::string_view("unix:");
+		if(address.starts_with(local_prefix)) {
+			return Address{std::string(address.substr(local_prefix.size())), 0, true};
 		}
-		return {0.0F, 0.0F, 0.0F};
-	}
-
-	const auto normalized_dir = ray.direction().normalized();
-	const auto length = 0.5F * (normalized_dir.y() + 1.0F);
-	return (1.0F - length) * Color(1.0F, 1.0F, 1.0F) + length * Color(0.5F, 0.7F, 1.0F);
-}
 
-inline static auto random_scene() noexcept -> GeometryList {
-	GeometryList list;
-
-	// ground material
-	list.add<Sphere>(
-		std::make_unique<Sphere>(Point3(0.0F, -1000.0F, 0.0F),
-								 1000.0F,
-								 std::make_unique<Lambertian>(Color(0.5F, 0.5F, 0.5F))));
-
-	for(auto a = -11; a < 11; ++a) {
-		for(auto b = -11; b < 11; ++b) {
-			auto choose_mat = random_value<float>();
-			auto center = Point3(narrow_cast<float>(a) + 0.9F * random_value<float>(),
-								 0.2F,
-								 narrow_cast<float>(b) + 0.9F * random_value<float>());
-
-			if((center - Point3(4.0F, 0.2F, 0.0F)).as_vec().magnitude() > 0.9F) {
-				if(choose_mat < 0.8F) {
-					auto albedo = Color(Vec3<float>::random()) * Color(Vec3<float>::random());
-					list.add<Sphere>(
-						std::make_unique<Sphere>(center,
-												 0.2F,
-												 std::make_unique<Lambertian>(albedo)));
-				}
-				else if(choose_mat < 0.95F) {
-					auto albedo = Color(Vec3<float>::random(0.5F, 1.0F));
-					auto fuzz = random_value(0.0F, 0.5F);
-					list.add<Sphere>(
-						std::make_unique<Sphere>(center,
-												 0.2F,
-												 std::make_unique<Metal>(albedo, fuzz)));
-				}
-				else {
-					list.add<Sphere>(
-						std::make_unique<Sphere>(center, 0.2F, std::make_unique<Dielectric>(1.5F)));
-				}
-			}
+		const auto separator = address.rfind(':');
+		if(separator == std::string_view::npos) {
+			return std::nullopt;
 		}
+		auto port = uint16_t(0);
+		const auto* const last = address.data() + address.size();
+		const auto [end, error] = std::from_chars(address.data() + separator + 1, last, port);
+		if(error != std::errc() || end != last) {
+			return std::nullopt;
+		}
+		return Address{std::string(address.substr(0, separator)), port, false};
 	}
 
-	list.add<Sphere>(std::make_unique<Sphere>(Point3(0.0F, 1.0F, 0.0F),
-											  1.0F,
-											  std::make_unique<Dielectric>(1.5F)));
-
-	list.add<Sphere>(
-		std::make_unique<Sphere>(Point3(-4.0F, 1.0F, 0.0F),
-								 1.0F,
-								 std::make_unique<Lambertian>(Color(0.4F, 0.2F, 0.1F))));
+	[[nodiscard]] inline auto listen() const noexcept -> std::optional<utils::Listener> {
+		return m_is_local ? utils::Listener::listen_local(m_host) :
+							utils::Listener::listen(m_host, m_port);
+	}
 
-	list.add<Sphere>(
-			std::make_unique<Sphere>(Point3(4.0F, 1.0F, 0.0F),
-									 1.0F,
-									 std::make_unique<Metal>(Color(0.7F, 0.6F, 0.5F), 0.0F)));
-	return list;
-}
+	[[nodiscard]] inline auto connect() const noexcept -> std::optional<utils::Socket> {
+		return m_is_local ? utils::Socket::connect_local(m_host) :
+							utils::Socket::connect(m_host, m_port);
+	}
+};
 
 auto main(int argc, char** argv) noexcept -> int {
-	std::ignore = argc;
-	std::ignore = argv;
+	const auto args = std::span(argv, narrow_cast<size_t>(argc));
 
 	constexpr auto aspect_ratio = 16.0F / 9.0F;
 	constexpr auto image_width = 2560;
 	constexpr auto image_height = narrow_cast<int>(narrow_cast<float>(image_width) / aspect_ratio);
-	constexpr auto samples_per_pixel = 200;
+	constexpr auto samples_per_pixel = 200ULL;
+	constexpr auto samples_per_pass = 8ULL;
+	constexpr auto checkpoint_interval = std::chrono::seconds(60);
 	constexpr auto max_depth = 50ULL;
 	constexpr auto gamma = 1.5F;
+	// identifies the scene and camera below to distributed workers; change it when they change
+	constexpr auto scene_key = 1ULL;
 	constexpr auto origin = Point3(13.0F, 2.0F, 3.0F);
 	constexpr auto focal_point = Point3(0.0F, 0.0F, 0.0F);
 	// WHY CAN'T THIS BE CONSTEXPR??? HOW IS THIS NOT A CONSTEXPR EXPRESSION??????
@@ -131,28 +110,110 @@ auto main(int argc, char** argv) noexcept -> int {
 							   focal_point,
 							   Vec3(0.0F, 1.0F, 0.0F));
 
-	const auto list = random_scene();
-
-	Ray ray;
-	Color pixel;
-	auto u = 0.0F;
-	auto v = 0.0F;
-
-	std::cout << "P3\n" << image_width << ' ' << image_height << "\n255\n";
-	for(auto y = image_height - 1; y >= 0; --y) {
-		std::cerr << "\rScanlines remaining: " << y << ' ' << std::flush;
-		for(auto x = 0; x < image_width; ++x) {
-			pixel = Color(0.0F, 0.0F, 0.0F);
-			for(auto sample = 0; sample < samples_per_pixel; ++sample) {
-				u = (narrow_cast<float>(x) + random_value()) / narrow_cast<float>(image_width - 1);
-				v = (narrow_cast<float>(y) + random_value()) / narrow_cast<float>(image_height - 1);
-				ray = camera.get_ray(u, v);
-				pixel += color_at(ray, list, max_depth);
-			}
-			pixel.write(std::cout, samples_per_pixel, gamma);
+	auto materials = MaterialTable();
+	const auto scene = BoundingVolumeHierarchy(graphics::random_scene(materials));
+
+	auto renderer = TileRenderer(narrow_cast<size_t>(image_width),
+								 narrow_cast<size_t>(image_height),
+								 samples_per_pixel);
+	renderer.set_adaptive_sampling(AdaptiveSampling());
+	renderer.set_sampler(std::make_shared<SobolSampler>());
+	const auto integrator = PathIntegrator(scene, materials, max_depth);
+
+	// with `--coordinate <address>`, hand the image's tiles out to the worker processes started
+	// with `--work <address>`, on this machine or others
+	const auto mode = args.size() > 1 ? std::string_view(args[1]) : std::string_view();
+	const auto is_distributed = mode == "--coordinate" || mode == "--work";
+	const auto address = is_distributed && args.size() > 2 ? Address::parse(args[2]) : std::nullopt;
+	if(is_distributed && !address) {
+		std::cerr << "Expected an address of the form <host>:<port> or unix:<path>\n";
+		return 1;
+	}
+	if(mode == "--work") {
+		auto connection = address->connect();
+		if(!connection) {
+			std::cerr << "Failed to connect to the coordinator\n";
+			return 1;
+		}
+		if(!RenderWorker::run(std::move(*connection), renderer, camera, integrator, scene_key)) {
+			std::cerr << "The coordinator turned this worker away or disconnected\n";
+			return 1;
 		}
+
+		std::cerr << "Done\n";
+		return 0;
+	}
+
+	auto coordinator = std::optional<RenderCoordinator>();
+	if(is_distributed) {
+		auto listener = address->listen();
+		if(!listener) {
+			std::cerr << "Failed to listen for workers\n";
+			return 1;
+		}
+		std::cerr << "Waiting for workers on port " << listener->port() << "\n";
+		coordinator.emplace(renderer, std::move(*listener), scene_key);
+	}
+
+	// the image file, then the checkpoint file, follow the mode and address, if given
+	const auto outputs = args.subspan(is_distributed ? 3 : 1);
+	// with a checkpoint file given after the image file, render progressively (without adaptive
+	// sampling), resuming from the checkpoint if it's of this same render
+	const auto checkpoint
+		= !is_distributed && outputs.size() > 1 ? std::string(outputs[1]) : std::string();
+	const auto framebuffer = [&]() noexcept {
+		// report progress and ray throughput to stderr as JSON lines, once a second
+		utils::instrumentation::reset();
+		const auto reporter = utils::instrumentation::Reporter(std::cerr, std::chrono::seconds(1));
+		if(coordinator) {
+			// without an idle timeout, the coordinator waits for workers for as long as it takes
+			return coordinator->render().value();
+		}
+		if(checkpoint.empty()) {
+			return renderer.render(camera, integrator);
+		}
+
+		auto accumulation = AccumulationBuffer::load(checkpoint)
+								.value_or(renderer.accumulation_buffer(samples_per_pass));
+		if(!renderer.is_compatible(accumulation)) {
+			accumulation = renderer.accumulation_buffer(samples_per_pass);
+		}
+		else if(accumulation.num_passes() > 0) {
+			std::cerr << "Resuming from " << accumulation.num_samples() << " samples per pixel\n";
+		}
+
+		// periodically replace the checkpoint, and write the image so far as a preview
+		auto last_checkpoint = std::chrono::steady_clock::now();
+		ignore(renderer.render_progressive(
+			camera,
+			integrator,
+			&accumulation,
+			[&](const AccumulationBuffer& buffer) noexcept {
+				const auto now = std::chrono::steady_clock::now();
+				if(now - last_checkpoint >= checkpoint_interval) {
+					last_checkpoint = now;
+					if(!buffer.save(checkpoint)
+					   || !ImageWriter::write(outputs[0], buffer.preview(), gamma)) {
+						std::cerr << "Failed to write the checkpoint\n";
+					}
+				}
+				return true;
+			}));
+		return accumulation.preview();
+	}();
+
+	// write to the given file (".pfm" for linear HDR output), or as a binary PPM to stdout
+	const auto written = !outputs.empty() ? ImageWriter::write(outputs[0], framebuffer, gamma) :
+											ImageWriter::write_ppm(std::cout, framebuffer, gamma);
+	if(!written) {
+		std::cerr << "Failed to write the image\n";
+		return 1;
+	}
+	if(!checkpoint.empty()) {
+		// the render is finished, so the checkpoint is no longer needed
+		ignore(std::remove(checkpoint.c_str()));
 	}
 
-	std::cerr << "\nDone\n";
+	std::cerr << "Done\n";
 	return 0;
 }
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cstdint>
+#include <span>
+#include <utility>
 
 #include "../utils/Concepts.h"
 #include "General.h"
@@ -8,6 +12,7 @@
 namespace math {
 
 #ifndef _MSC_VER
+	using std::int32_t;
 	using std::uint32_t;
 	using std::uint64_t;
 #endif
@@ -133,6 +138,45 @@ namespace math {
 			}
 		}
 
+		/// @brief Fast approximation calculation of e^x for each of the given values, several at
+		/// a time, with the same approximation as the scalar `exp`
+		///
+		/// @param values - The exponents
+		/// @param out - Where to store the results, for the first `min(values.size(), out.size())`
+		/// values. May alias `values`
+		template<FloatingPoint T>
+		inline static constexpr auto exp(std::span<const T> values, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(values, out, [](T x) noexcept { return exp_lane(x); });
+		}
+
+		/// @brief Fast approximation calculation of ln(x) for each of the given values, several at
+		/// a time, with the same approximation as the scalar `ln`
+		///
+		/// @param values - The inputs
+		/// @param out - Where to store the results, for the first `min(values.size(), out.size())`
+		/// values. May alias `values`
+		template<FloatingPoint T>
+		inline static constexpr auto ln(std::span<const T> values, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(values, out, [](T x) noexcept { return ln_lane(x); });
+		}
+
+		/// @brief Fast approximation calculation of base^exponent for each of the given bases,
+		/// several at a time, with the same approximation as the scalar `pow`
+		///
+		/// @param bases - The bases to use
+		/// @param exponent - The exponent to use
+		/// @param out - Where to store the results, for the first `min(bases.size(), out.size())`
+		/// bases. May alias `bases`
+		template<FloatingPoint T>
+		inline static constexpr auto
+		pow(std::span<const T> bases, T exponent, std::span<T> out) noexcept -> void {
+			detail::transform_batch(bases, out, [exponent](T base) noexcept {
+				return pow2_lane(exponent * (ln_lane(base) / static_cast<T>(LN_2)));
+			});
+		}
+
 	  private :
 		  /// @brief Calculates the mantissa and exponent of `x`,
 		  /// in the representation x = mantissa * 2^exponent
@@ -630,5 +674,132 @@ namespace math {
 		pow_internal(double base, double exponent) noexcept -> double {
 			return pow2_internal(exponent * log2_internal(base));
 		}
+	
+		/// ln(2), for converting between natural and base 2 logarithms and exponents
+		static constexpr double LN_2
+			= 0.6931471805599453094172321214581765680755001343602552541206800094;
+		/// The upper bounds of the ranges `exp` reduces its argument by
+		static constexpr auto EXP_BOUNDS = std::array<double, 17>{-10.0,
+																 -8.0,
+																 -6.0,
+																 -4.0,
+																 -2.0,
+																 -1.0,
+																 -0.5,
+																 0.0,
+																 0.5,
+																 1.0,
+																 2.0,
+																 4.0,
+																 6.0,
+																 8.0,
+																 10.0,
+																 12.0,
+																 14.0};
+		/// e raised to each of `EXP_BOUNDS`
+		static constexpr auto EXP_SCALES = std::array<double, 17>{
+			0.0000453999297624848515355915155605506102379180888665649692590713,
+			0.0003354626279025118388213891257808610193109001337203193605445757,
+			0.0024787521766663584230451674308166678915064795855339450508786240,
+			0.0183156388887341802937180212732412422119120675534755947695999274,
+			0.1353352832366126918939994949724844034076315459095758814681588726,
+			0.3678794411714423215955237701614608674458111310317678345078368016,
+			0.6065306597126334236037995349911804534419181354871869556828921587,
+			1.0,
+			1.6487212707001281468486507878141635716537761007101480115750793116,
+			2.7182818284590452353602874713526624977572470936999595749669676277,
+			7.3890560989306502272304274605750078131803155705518473240871278225,
+			54.598150033144239078110261202860878402790737038614068725826593958,
+			403.42879349273512260838718054338827960589989735712920261396718832,
+			2980.9579870417282747435920994528886737559679391328357022089635303,
+			22026.465794806716516957900645284244366353512618556781074235426355,
+			162754.79141900392080800520489848678317020928447872077044355624813,
+			1.20260428416477677774923677076785944941248654337610224031329063319746294708334267e6};
+		/// e^16, for arguments above the last of `EXP_BOUNDS`
+		static constexpr double EXP_SCALE_MAX
+			= 8.88611052050787263676302374078145035080271982185663883978398831704898093732147815e6;
+
+		/// @brief Branch-free `exp`, for the batch functions to vectorize.
+		/// Rather than branching on the range `x` is in, this selects the range's bound and
+		/// scale, as `e^x = e^bound * e^(x - bound)`
+		///
+		/// @param x - The exponent
+		/// @return - e^x
+		[[nodiscard]] inline static constexpr auto exp_lane(FloatingPoint auto x) noexcept
+			-> decltype(x) {
+			using T = decltype(x);
+			auto bound = static_cast<T>(16);
+			auto scale = static_cast<T>(EXP_SCALE_MAX);
+			const auto select_range = [&](size_t range) noexcept {
+				const auto in_range = x < static_cast<T>(EXP_BOUNDS[range]);
+				bound = detail::select(in_range, static_cast<T>(EXP_BOUNDS[range]), bound);
+				scale = detail::select(in_range, static_cast<T>(EXP_SCALES[range]), scale);
+			};
+			// from the last range down, so the lowest range containing x is the one left
+			// selected. Unrolled with a fold, so that the compiler sees straight-line code
+			[&]<size_t... Range>(std::index_sequence<Range...>) noexcept {
+				(select_range(EXP_BOUNDS.size() - 1 - Range), ...);
+			}(std::make_index_sequence<EXP_BOUNDS.size()>());
+			if constexpr(std::is_same_v<T, float>) {
+				return scale * exp_helperf(x - bound);
+			}
+			else {
+				return scale * exp_helper(x - bound);
+			}
+		}
+
+		/// @brief Branch-free `ln`, for the batch functions to vectorize
+		///
+		/// @param x - The input
+		/// @return - ln(x)
+		[[nodiscard]] inline static constexpr auto ln_lane(FloatingPoint auto x) noexcept
+			-> decltype(x) {
+			using T = decltype(x);
+			const auto ln_x_plus_1 = [](T value) noexcept {
+				if constexpr(std::is_same_v<T, float>) {
+					return lnXPlus1f(value);
+				}
+				else {
+					return lnXPlus1(value);
+				}
+			};
+			// subtract one, because we'll be using an ln(x + 1) approximation
+			const auto in = x - static_cast<T>(1);
+			// if we're outside the accurate range, we'll reduce to the accurate range. The
+			// conditions are combined with `|`, not `||`, so neither becomes a branch
+			const auto above = in >= static_cast<T>(5);
+			const auto below = in <= static_cast<T>(-0.5);
+			const auto condition = static_cast<T>(above | below);
+			auto divVal = detail::select(below, static_cast<T>(-0.5), static_cast<T>(1));
+			divVal = detail::select(above, static_cast<T>(5), divVal);
+			return condition
+					   * (ln_x_plus_1(((in + static_cast<T>(1)) / (divVal + static_cast<T>(1)))
+									  - static_cast<T>(1))
+						  + ln_x_plus_1(divVal))
+				   + (static_cast<T>(1) - condition) * ln_x_plus_1(in);
+		}
+
+		/// @brief Branch-free `pow2`, for the batch functions to vectorize
+		///
+		/// @param x - The exponent
+		/// @return 2^x
+		[[nodiscard]] inline static constexpr auto pow2_lane(FloatingPoint auto x) noexcept
+			-> decltype(x) {
+			using T = decltype(x);
+			const auto integer = static_cast<int32_t>(x);
+			// integral exponents are exact, as in the scalar versions, so the power of two is
+			// built directly from the exponent bits
+			auto exact = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				const auto biased = General::min(General::max(integer, -126), 127) + 127;
+				exact = std::bit_cast<float>(static_cast<uint32_t>(biased) << 23U);
+			}
+			else {
+				const auto biased = General::min(General::max(integer, -1022), 1023) + 1023;
+				exact = std::bit_cast<double>(static_cast<uint64_t>(biased) << 52U);
+			}
+			const auto approximate = exp_lane(x * static_cast<T>(LN_2));
+			return detail::select(static_cast<T>(integer) == x, exact, approximate);
+		}
 	};
 } // namespace math
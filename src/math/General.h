@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstdint>
+#include <span>
 
 #include "../utils/Concepts.h"
 
@@ -8,9 +12,64 @@ namespace math {
 #ifndef _MSC_VER
 	using std::int32_t;
 	using std::size_t;
+	using std::uint32_t;
+	using std::uint64_t;
 #endif //_MSC_VER
 
 	using utils::concepts::Numeric, utils::concepts::FloatingPoint;
+
+	namespace detail {
+		/// The number of values the batch math functions compute at once. Each block has a fixed
+		/// size so the compiler can turn its loop into straight-line vector code: four 4-lane,
+		/// two 8-lane, or one 16-lane operation per step, depending on the target
+		inline constexpr size_t BATCH_LANES = 16;
+
+		/// @brief Selects `if_true` or `if_false` by masking their bits, for the batch math
+		/// kernels. Unlike `?:`, this can't be turned back into a branch, which would keep the
+		/// compiler from vectorizing the kernel
+		///
+		/// @param condition - Whether to select `if_true`
+		/// @param if_true - The value to select if `condition` is true
+		/// @param if_false - The value to select otherwise
+		///
+		/// @return The selected value
+		template<FloatingPoint T>
+		[[nodiscard]] inline constexpr auto select(bool condition, T if_true, T if_false) noexcept
+			-> T {
+			using Bits = std::conditional_t<std::is_same_v<T, float>, uint32_t, uint64_t>;
+			const auto mask = static_cast<Bits>(0) - static_cast<Bits>(condition);
+			return std::bit_cast<T>((std::bit_cast<Bits>(if_true) & mask)
+									| (std::bit_cast<Bits>(if_false) & ~mask));
+		}
+
+		/// @brief Applies `kernel` to each of `input`, storing the results in `output`, a block
+		/// of `BATCH_LANES` values at a time. `kernel` should be branch-free, so that it can be
+		/// vectorized across the block
+		///
+		/// @param input - The values to apply `kernel` to
+		/// @param output - Where to store the results. `output[i]` is `kernel(input[i])`, for the
+		/// first `min(input.size(), output.size())` values. May alias `input`
+		/// @param kernel - The function to apply
+		template<FloatingPoint T, typename Kernel>
+		inline constexpr auto
+		transform_batch(std::span<const T> input, std::span<T> output, Kernel kernel) noexcept
+			-> void {
+			const auto size = std::min(input.size(), output.size());
+			for(auto start = static_cast<size_t>(0); start < size; start += BATCH_LANES) {
+				const auto count = std::min(BATCH_LANES, size - start);
+				// working on a local copy means the compiler doesn't need to guard the vector code
+				// against `input` and `output` aliasing, and the last partial block is padded out
+				// to a full one
+				auto lanes = std::array<T, BATCH_LANES>();
+				std::copy_n(input.subspan(start).begin(), count, lanes.begin());
+				for(auto& lane : lanes) {
+					lane = kernel(lane);
+				}
+				std::copy_n(lanes.begin(), count, output.subspan(start).begin());
+			}
+		}
+	} // namespace detail
+
 	class General {
 	  public:
 		/// @brief Calculates the maximum of the two values
@@ -57,6 +116,18 @@ namespace math {
 			}
 		}
 
+		/// @brief Fast approximation calculation of the square roots of the given values, several
+		/// at a time, with the same approximation as the scalar `sqrt`
+		///
+		/// @param values - The values to take the square roots of
+		/// @param roots - Where to store the square roots. `roots[i]` is the square root of
+		/// `values[i]`, for the first `min(values.size(), roots.size())` values. May alias `values`
+		template<FloatingPoint T>
+		inline static constexpr auto sqrt(std::span<const T> values, std::span<T> roots) noexcept
+			-> void {
+			detail::transform_batch(values, roots, [](T x) noexcept { return sqrt_lane(x); });
+		}
+
 		/// @brief Calculates the truncation of x
 		///
 		/// @param x - The value to truncate
@@ -156,5 +227,27 @@ namespace math {
 			u.f = u.f * (1.5 - xhalf * u.f * u.f); // NOLINT
 			return x * u.f;						   // NOLINT
 		}
+
+		/// @brief Branch-free `sqrt`, for the batch version to vectorize
+		///
+		/// @param x - The value to take the square root of
+		/// @return - The square root of x
+		[[nodiscard]] static constexpr inline auto sqrt_lane(FloatingPoint auto x) noexcept
+			-> decltype(x) {
+			using T = decltype(x);
+			const auto xhalf = static_cast<T>(0.5) * x;
+			// same initial guess as the scalar versions, on unsigned bits since x >= 0
+			auto y = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				y = std::bit_cast<float>(0x5F375A86U - (std::bit_cast<uint32_t>(x) >> 1U));
+			}
+			else {
+				y = std::bit_cast<double>(0x5fe6ec85e7de30daULL
+										  - (std::bit_cast<uint64_t>(x) >> 1U));
+			}
+			y = y * (static_cast<T>(1.5) - xhalf * y * y);
+			y = y * (static_cast<T>(1.5) - xhalf * y * y);
+			return x * y;
+		}
 	};
 } // namespace math
@@ -57,6 +57,20 @@ namespace math {
 			return m_vec;
 		}
 
+		/// @brief Returns the component-wise minimum of this and `point`
+		[[nodiscard]] inline constexpr auto min(const Point3& point) const noexcept -> Point3 {
+			auto result = Point3();
+			result.m_vec = m_vec.min(point.m_vec);
+			return result;
+		}
+
+		/// @brief Returns the component-wise maximum of this and `point`
+		[[nodiscard]] inline constexpr auto max(const Point3& point) const noexcept -> Point3 {
+			auto result = Point3();
+			result.m_vec = m_vec.max(point.m_vec);
+			return result;
+		}
+
 		constexpr auto operator=(const Point3& point) noexcept -> Point3& = default;
 		constexpr auto operator=(Point3&& point) noexcept -> Point3& = default;
 
@@ -1,7 +1,6 @@
 /// based on https://mklimenko.github.io/english/2018/06/04/constexpr-random/
 #pragma once
 
-#include <atomic>
 #include <cstdint>
 #include <gsl/gsl>
 #include <limits>
@@ -274,42 +273,160 @@ namespace math {
 		std::unique_ptr<EngineType> m_engine;
 	};
 
-	template<utils::concepts::Numeric T = float>
-	[[clang::no_destroy]] static math::UniformDistribution<math::LinearCongruentialEngine<>, T>
-		GLOBAL_UNIFORM_DISTRIBUTION;
+	/// @brief PCG32 (XSH-RR variant) Permuted Congruential Generator.
+	/// See https://www.pcg-random.org
+	///
+	/// A small, fast, statistically strong engine with 2^63 selectable streams. Engines seeded
+	/// identically but on different streams produce uncorrelated sequences, which lets parallel
+	/// work (eg: render tiles) each use their own stream and still be reproducible.
+	/// Deliberately not derived from `Engine`: it is a trivially copyable value type with no
+	/// virtual calls, so it is cheap to store per-thread
+	class PermutedCongruentialEngine {
+	  public:
+		/// The default initial state, from the PCG reference implementation
+		static constexpr std::uint64_t DEFAULT_STATE = 0x853C49E6748FEA9BULL;
+		/// The default stream increment, from the PCG reference implementation
+		static constexpr std::uint64_t DEFAULT_INCREMENT = 0xDA3E39CB94B95BDBULL;
+
+		constexpr PermutedCongruentialEngine() noexcept = default;
+
+		/// @brief Creates a `PermutedCongruentialEngine` with the given seed and stream
+		///
+		/// @param seed - The initial seed
+		/// @param stream - The stream to generate values from
+		explicit constexpr PermutedCongruentialEngine(std::uint64_t seed,
+													  std::uint64_t stream = 0) noexcept {
+			this->seed(seed, stream);
+		}
+		constexpr PermutedCongruentialEngine(const PermutedCongruentialEngine& engine) noexcept
+			= default;
+		constexpr PermutedCongruentialEngine(PermutedCongruentialEngine&& engine) noexcept
+			= default;
+		constexpr ~PermutedCongruentialEngine() noexcept = default;
+
+		/// @brief Reseeds the engine with the given seed and stream
+		///
+		/// @param seed - The initial seed
+		/// @param stream - The stream to generate values from
+		inline constexpr auto seed(std::uint64_t seed, std::uint64_t stream = 0) noexcept -> void {
+			m_state = 0;
+			m_increment = (stream << 1U) | 1U;
+			step();
+			m_state += seed;
+			step();
+		}
 
-	template<utils::concepts::Numeric T = float>
-	static std::atomic_bool GLOBAL_UNIFORM_DISTRIBUTION_INITIALIZED;
+		/// @brief Generates the next value in the sequence
+		///
+		/// @return The next value, in [0, `max_value()`]
+		[[nodiscard]] inline constexpr auto generate() noexcept -> std::uint32_t {
+			const auto old_state = m_state;
+			step();
+			const auto xor_shifted
+				= narrow_cast<std::uint32_t>(((old_state >> 18U) ^ old_state) >> 27U); // NOLINT
+			const auto rotation = narrow_cast<std::uint32_t>(old_state >> 59U);		// NOLINT
+			return (xor_shifted >> rotation) | (xor_shifted << ((~rotation + 1U) & 31U)); // NOLINT
+		}
 
-	template<utils::concepts::Numeric T = float>
-	inline static constexpr auto initialize_global_uniform_distribution() noexcept -> void {
-		bool initialized = false;
-		if(GLOBAL_UNIFORM_DISTRIBUTION_INITIALIZED<T>.compare_exchange_strong(
-			   initialized,
-			   true,
-			   std::memory_order_seq_cst))
-		{
-			GLOBAL_UNIFORM_DISTRIBUTION<
-				T> = math::UniformDistribution<math::LinearCongruentialEngine<>, T>();
+		/// @brief Generates the next value in the sequence as a floating point value in [0, 1)
+		///
+		/// @return The next value, normalized to [0, 1)
+		template<utils::concepts::FloatingPoint T = float>
+		[[nodiscard]] inline constexpr auto generate_canonical() noexcept -> T {
+			if constexpr(std::is_same_v<T, float>) {
+				// top 24 bits fill a float's mantissa exactly, so the result is never 1
+				return narrow_cast<float>(generate() >> 8U) * 0x1.0P-24F; // NOLINT
+			}
+			else {
+				const auto high = narrow_cast<std::uint64_t>(generate()) << 32U;
+				const auto bits = (high | generate()) >> 11U;			   // NOLINT
+				return narrow_cast<T>(narrow_cast<double>(bits) * 0x1.0P-53); // NOLINT
+			}
+		}
+
+		/// @brief Advances the engine `delta` steps in O(log(delta)) time, as if `generate` had
+		/// been called `delta` times
+		///
+		/// @param delta - The number of steps to advance
+		inline constexpr auto advance(std::uint64_t delta) noexcept -> void {
+			auto multiplier = MULTIPLIER;
+			auto increment = m_increment;
+			auto accumulated_multiplier = std::uint64_t(1);
+			auto accumulated_increment = std::uint64_t(0);
+			while(delta > 0) {
+				if((delta & 1U) != 0) {
+					accumulated_multiplier *= multiplier;
+					accumulated_increment = accumulated_increment * multiplier + increment;
+				}
+				increment = (multiplier + 1) * increment;
+				multiplier *= multiplier;
+				delta >>= 1U;
+			}
+			m_state = accumulated_multiplier * m_state + accumulated_increment;
 		}
+
+		/// @brief Returns the maximum value `generate` can return
+		///
+		/// @return The maximum value
+		[[nodiscard]] inline static constexpr auto max_value() noexcept -> std::uint32_t {
+			return std::numeric_limits<std::uint32_t>::max();
+		}
+
+		constexpr auto operator=(const PermutedCongruentialEngine& engine) noexcept
+			-> PermutedCongruentialEngine& = default;
+		constexpr auto operator=(PermutedCongruentialEngine&& engine) noexcept
+			-> PermutedCongruentialEngine& = default;
+
+		inline constexpr auto operator()() noexcept -> std::uint32_t {
+			return generate();
+		}
+
+	  private:
+		static constexpr std::uint64_t MULTIPLIER = 6364136223846793005ULL;
+		std::uint64_t m_state = DEFAULT_STATE;
+		std::uint64_t m_increment = DEFAULT_INCREMENT;
+
+		inline constexpr auto step() noexcept -> void {
+			m_state = m_state * MULTIPLIER + m_increment;
+		}
+	};
+
+	/// The engine backing `random_value`. Each thread has its own, so calls never contend or
+	/// race, and a thread's sequence depends only on how that thread last seeded it
+	inline thread_local PermutedCongruentialEngine GLOBAL_RANDOM_ENGINE; // NOLINT
+
+	/// @brief Seeds the calling thread's engine backing `random_value`, so that the sequence of
+	/// values it subsequently produces is reproducible.
+	/// Use the same `seed` with distinct `stream`s to get uncorrelated sequences for work
+	/// distributed across threads
+	///
+	/// @param seed - The seed
+	/// @param stream - The stream to generate values from
+	inline auto seed_random(size_t seed, size_t stream = 0) noexcept -> void {
+		GLOBAL_RANDOM_ENGINE.seed(seed, stream);
 	}
 
+	/// @brief Generates a random value in [0, 1) from the calling thread's engine
+	///
+	/// @return The random value
 	template<utils::concepts::FloatingPoint T = float>
 	inline auto random_value() noexcept -> T {
-		initialize_global_uniform_distribution<T>();
-		GLOBAL_UNIFORM_DISTRIBUTION<T>.set_min(narrow_cast<T>(0));
-		GLOBAL_UNIFORM_DISTRIBUTION<T>.set_max(narrow_cast<T>(1));
-
-		return GLOBAL_UNIFORM_DISTRIBUTION<T>();
+		return GLOBAL_RANDOM_ENGINE.generate_canonical<T>();
 	}
 
+	/// @brief Generates a random value in [min, max) from the calling thread's engine
+	///
+	/// @param min - The minimum value
+	/// @param max - The maximum value
+	///
+	/// @return The random value
 	template<utils::concepts::Numeric T = float>
 	inline auto random_value(T min, T max) noexcept -> T {
-		initialize_global_uniform_distribution<T>();
-
-		GLOBAL_UNIFORM_DISTRIBUTION<T>.set_min(min);
-		GLOBAL_UNIFORM_DISTRIBUTION<T>.set_max(max);
-
-		return GLOBAL_UNIFORM_DISTRIBUTION<T>();
+		if constexpr(utils::concepts::FloatingPoint<T>) {
+			return min + (max - min) * random_value<T>();
+		}
+		else {
+			return min + narrow_cast<T>(random_value<double>() * narrow_cast<double>(max - min));
+		}
 	}
 } // namespace math
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <gsl/gsl>
+#include <limits>
+#include <type_traits>
+
+#include "../utils/Concepts.h"
+#include "General.h"
+#include "Point2.h"
+
+namespace math {
+	using gsl::narrow_cast;
+	using utils::concepts::FloatingPoint;
+#ifndef _MSC_VER
+	using std::size_t;
+	using std::uint32_t;
+	using std::uint64_t;
+#endif //_MSC_VER
+
+	/// @brief The kinds of `Sampler`
+	enum class SamplerKind : uint32_t {
+		/// No sampler: sample values are drawn from the random number generator
+		None = 0,
+		Stratified,
+		Halton,
+		Sobol
+	};
+
+	/// @brief A sampler's kind and parameters. Samplers with equal descriptions generate the
+	/// same sample values, so a render can only be resumed with a sampler described the same way
+	struct SamplerDescription {
+		SamplerKind m_kind = SamplerKind::None;
+		/// The number of strata per dimension, for `StratifiedSampler`s
+		uint32_t m_num_strata = 0;
+		/// The sampler's seed, after hashing
+		uint64_t m_seed = 0;
+
+		auto operator==(const SamplerDescription& description) const noexcept -> bool = default;
+	};
+
+	/// @brief Base class for generators of sample values in [0, 1), addressed by pixel, sample
+	/// index, and dimension.
+	/// Sample values are pure functions of their address, so any sample of any pixel can be
+	/// generated independently, on any thread, in any order. Each dimension of a sample is used
+	/// for one decision made while computing it (eg: dimensions 0 and 1 jitter the position in
+	/// the pixel, 2 and 3 pick the point on the camera lens), so the samples of a pixel are
+	/// well distributed in every dimension, and every pair of consecutive dimensions
+	///
+	/// @tparam T - The floating point type of the sample values
+	template<FloatingPoint T = float>
+	class Sampler {
+	  public:
+		using Point2 = Point2<T>;
+
+		constexpr Sampler(const Sampler& sampler) noexcept = default;
+		constexpr Sampler(Sampler&& sampler) noexcept = default;
+		virtual constexpr ~Sampler() noexcept = default;
+
+		/// @brief Returns one dimension of a sample
+		///
+		/// @param pixel - The index of the pixel being sampled
+		/// @param index - The index of the sample within the pixel
+		/// @param dimension - The dimension of the sample
+		///
+		/// @return The sample value, in [0, 1)
+		[[nodiscard]] virtual auto
+		sample(size_t pixel, size_t index, size_t dimension) const noexcept -> T = 0;
+
+		/// @brief Returns the sampler's kind and parameters
+		///
+		/// @return The description
+		[[nodiscard]] virtual auto description() const noexcept -> SamplerDescription = 0;
+
+		/// @brief Returns two consecutive dimensions of a sample, `dimension` and
+		/// `dimension + 1`, as a point in [0, 1)^2
+		///
+		/// @param pixel - The index of the pixel being sampled
+		/// @param index - The index of the sample within the pixel
+		/// @param dimension - The first of the two dimensions
+		///
+		/// @return The sample point
+		[[nodiscard]] inline auto
+		sample_2d(size_t pixel, size_t index, size_t dimension) const noexcept -> Point2 {
+			return {sample(pixel, index, dimension), sample(pixel, index, dimension + 1)};
+		}
+
+		constexpr auto operator=(const Sampler& sampler) noexcept -> Sampler& = default;
+		constexpr auto operator=(Sampler&& sampler) noexcept -> Sampler& = default;
+
+	  protected:
+		constexpr Sampler() noexcept = default;
+
+		/// @brief Hashes `value` to a well mixed 32-bit value (Wellons' "lowbias32")
+		[[nodiscard]] inline static constexpr auto hash(uint32_t value) noexcept -> uint32_t {
+			value ^= value >> 16U;	  // NOLINT
+			value *= 0x7FEB352DU;	  // NOLINT
+			value ^= value >> 15U;	  // NOLINT
+			value *= 0x846CA68BU;	  // NOLINT
+			value ^= value >> 16U;	  // NOLINT
+			return value;
+		}
+
+		/// @brief Hashes `value` into `seed`, for deriving seeds from several values
+		[[nodiscard]] inline static constexpr auto
+		hash(uint32_t seed, uint64_t value) noexcept -> uint32_t {
+			const auto folded = narrow_cast<uint32_t>(value ^ (value >> 32U)); // NOLINT
+			return hash(seed
+						^ (hash(folded) + 0x9E3779B9U + (seed << 6U) + (seed >> 2U))); // NOLINT
+		}
+
+		/// @brief Converts 32 random bits to a value in [0, 1)
+		[[nodiscard]] inline static constexpr auto to_unit(uint32_t bits) noexcept -> T {
+			if constexpr(std::is_same_v<T, float>) {
+				// top 24 bits fill a float's mantissa exactly, so the result is never 1
+				return narrow_cast<float>(bits >> 8U) * 0x1.0P-24F; // NOLINT
+			}
+			else {
+				return narrow_cast<T>(narrow_cast<double>(bits) * 0x1.0P-32); // NOLINT
+			}
+		}
+	};
+
+	/// @brief Jittered, stratified sampling.
+	/// Each dimension is split into `num_strata` equal strata, and the first `num_strata` samples
+	/// of a pixel take one jittered value from each, in a random order chosen per pixel and
+	/// dimension. Shuffling each dimension independently decorrelates the dimensions from one
+	/// another (ie: each group of `num_strata` samples forms a Latin hypercube), so stratifying
+	/// doesn't require the number of samples to be a perfect square or cube.
+	/// Each further group of `num_strata` samples is stratified again, with a new order and jitter
+	///
+	/// @tparam T - The floating point type of the sample values
+	template<FloatingPoint T = float>
+	class StratifiedSampler final : public Sampler<T> {
+		using Sampler = Sampler<T>;
+
+	  public:
+		/// @brief Creates a `StratifiedSampler`
+		///
+		/// @param num_strata - The number of strata per dimension. This should be the number of
+		/// samples taken per pixel
+		/// @param seed - The seed randomizing the order and jitter of samples
+		explicit constexpr StratifiedSampler(size_t num_strata, size_t seed = 0) noexcept
+			: m_num_strata(narrow_cast<uint32_t>(General::max(num_strata, narrow_cast<size_t>(1)))),
+			  m_seed(Sampler::hash(0U, seed)) {
+		}
+		constexpr StratifiedSampler(const StratifiedSampler& sampler) noexcept = default;
+		constexpr StratifiedSampler(StratifiedSampler&& sampler) noexcept = default;
+		constexpr ~StratifiedSampler() noexcept final = default;
+
+		[[nodiscard]] inline auto
+		sample(size_t pixel, size_t index, size_t dimension) const noexcept -> T final {
+			const auto group = index / m_num_strata;
+			const auto seed = Sampler::hash(Sampler::hash(Sampler::hash(m_seed, pixel), dimension),
+											group);
+			const auto stratum = permute(narrow_cast<uint32_t>(index % m_num_strata), seed);
+			const auto jitter = Sampler::to_unit(Sampler::hash(seed, stratum));
+			const auto value = (narrow_cast<T>(stratum) + jitter) / narrow_cast<T>(m_num_strata);
+			return General::min(value, ONE_MINUS_EPSILON);
+		}
+
+		[[nodiscard]] inline auto description() const noexcept -> SamplerDescription final {
+			return {SamplerKind::Stratified, m_num_strata, m_seed};
+		}
+
+		constexpr auto
+		operator=(const StratifiedSampler& sampler) noexcept -> StratifiedSampler& = default;
+		constexpr auto
+		operator=(StratifiedSampler&& sampler) noexcept -> StratifiedSampler& = default;
+
+	  private:
+		static constexpr T ONE_MINUS_EPSILON
+			= narrow_cast<T>(1) - std::numeric_limits<T>::epsilon() / narrow_cast<T>(2);
+
+		uint32_t m_num_strata;
+		uint32_t m_seed;
+
+		/// @brief Maps `index` to its position in a random permutation of [0, `m_num_strata`)
+		/// selected by `seed`, without storing the permutation (Kensler, "Correlated
+		/// Multi-Jittered Sampling")
+		[[nodiscard]] inline constexpr auto
+		permute(uint32_t index, uint32_t seed) const noexcept -> uint32_t {
+			const auto length = m_num_strata;
+			// the smallest all-ones mask covering [0, length)
+			const auto mask = length == 1 ? 0U : ~0U >> narrow_cast<uint32_t>(
+													  std::countl_zero(length - 1));
+			// cycle-walk the bijection on [0, mask] until we land back in [0, length)
+			do {
+				index ^= seed;								  // NOLINT
+				index *= 0xE170893DU;						  // NOLINT
+				index ^= seed >> 16U;						  // NOLINT
+				index ^= (index & mask) >> 4U;				  // NOLINT
+				index ^= seed >> 8U;						  // NOLINT
+				index *= 0x0929EB3FU;						  // NOLINT
+				index ^= seed >> 23U;						  // NOLINT
+				index ^= (index & mask) >> 1U;				  // NOLINT
+				index *= 1U | seed >> 27U;					  // NOLINT
+				index *= 0x6935FA69U;						  // NOLINT
+				index ^= (index & mask) >> 11U;				  // NOLINT
+				index *= 0x74DCB303U;						  // NOLINT
+				index ^= (index & mask) >> 2U;				  // NOLINT
+				index *= 0x9E501CC3U;						  // NOLINT
+				index ^= (index & mask) >> 2U;				  // NOLINT
+				index *= 0xC860A3DFU;						  // NOLINT
+				index &= mask;								  // NOLINT
+				index ^= index >> 5U;						  // NOLINT
+			} while(index >= length);
+			return (index + seed) % length;
+		}
+	};
+
+	/// @brief Samples from the Halton sequence, randomized per pixel.
+	/// Dimension `d` of sample `i` is the radical inverse of `i` in the `d`th prime base. Each
+	/// digit of the radical inverse is randomly shifted (mod the base), by an amount chosen from
+	/// the pixel, the dimension, and the digits before it (a nested, Owen-style scrambling), so
+	/// pixels get decorrelated sequences that keep the Halton sequence's low discrepancy.
+	/// Dimensions beyond the number of tabulated primes reuse the primes, with differently
+	/// scrambled digits
+	///
+	/// @tparam T - The floating point type of the sample values
+	template<FloatingPoint T = float>
+	class HaltonSampler final : public Sampler<T> {
+		using Sampler = Sampler<T>;
+
+	  public:
+		/// @brief Creates a `HaltonSampler`
+		///
+		/// @param seed - The seed randomizing the digit scrambling
+		explicit constexpr HaltonSampler(size_t seed = 0) noexcept
+			: m_seed(Sampler::hash(0U, seed)) {
+		}
+		constexpr HaltonSampler(const HaltonSampler& sampler) noexcept = default;
+		constexpr HaltonSampler(HaltonSampler&& sampler) noexcept = default;
+		constexpr ~HaltonSampler() noexcept final = default;
+
+		[[nodiscard]] inline auto
+		sample(size_t pixel, size_t index, size_t dimension) const noexcept -> T final {
+			const auto base = PRIMES[dimension % PRIMES.size()]; // NOLINT
+			const auto seed = Sampler::hash(Sampler::hash(m_seed, pixel), dimension);
+			const auto inverse_base = 1.0 / narrow_cast<double>(base);
+
+			// sum the scrambled digits of `index`, least significant first, until further digits
+			// no longer change the result. Once `index` runs out of digits, its remaining (zero)
+			// digits still scramble to non-zero values
+			auto remaining = narrow_cast<uint64_t>(index);
+			auto prefix = 0ULL;
+			auto prefix_scale = 1ULL;
+			auto scale = inverse_base;
+			auto value = 0.0;
+			while(scale > PRECISION) {
+				const auto digit = narrow_cast<uint32_t>(remaining % base);
+				const auto offset = Sampler::hash(Sampler::hash(seed, prefix), prefix_scale) % base;
+				value += narrow_cast<double>((digit + offset) % base) * scale;
+				prefix += digit * prefix_scale;
+				prefix_scale *= base;
+				remaining /= base;
+				scale *= inverse_base;
+			}
+
+			return General::min(narrow_cast<T>(value), ONE_MINUS_EPSILON);
+		}
+
+		[[nodiscard]] inline auto description() const noexcept -> SamplerDescription final {
+			return {SamplerKind::Halton, 0U, m_seed};
+		}
+
+		constexpr auto operator=(const HaltonSampler& sampler) noexcept -> HaltonSampler& = default;
+		constexpr auto operator=(HaltonSampler&& sampler) noexcept -> HaltonSampler& = default;
+
+	  private:
+		static constexpr T ONE_MINUS_EPSILON
+			= narrow_cast<T>(1) - std::numeric_limits<T>::epsilon() / narrow_cast<T>(2);
+		/// Digits worth less than this are below the precision of the result
+		static constexpr double PRECISION = 0x1.0P-32;
+		static constexpr std::array<uint32_t, 32> PRIMES = {
+			2,	3,	5,	7,	11, 13, 17, 19, 23, 29, 31, 37, 41, 43,	 47,  53,
+			59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131}; // NOLINT
+
+		uint32_t m_seed;
+	};
+
+	/// @brief Samples from the Sobol sequence with hash-based Owen scrambling.
+	/// Dimensions are taken in groups of four, each group drawn from the first four dimensions
+	/// of the Sobol sequence, and given its own Owen scrambling and sample order per pixel
+	/// (Burley, "Practical Hash-based Owen Scrambling"). Owen scrambling randomizes each pixel's
+	/// sequence while keeping it a (0, 2)-sequence in every pair of dimensions within a group,
+	/// and reduces variance further than unscrambled or randomly shifted points.
+	///
+	/// Sample counts that are powers of two are best distributed
+	///
+	/// @tparam T - The floating point type of the sample values
+	template<FloatingPoint T = float>
+	class SobolSampler final : public Sampler<T> {
+		using Sampler = Sampler<T>;
+
+	  public:
+		/// @brief Creates a `SobolSampler`
+		///
+		/// @param seed - The seed randomizing the scrambling
+		explicit constexpr SobolSampler(size_t seed = 0) noexcept
+			: m_seed(Sampler::hash(0U, seed)) {
+		}
+		constexpr SobolSampler(const SobolSampler& sampler) noexcept = default;
+		constexpr SobolSampler(SobolSampler&& sampler) noexcept = default;
+		constexpr ~SobolSampler() noexcept final = default;
+
+		[[nodiscard]] inline auto
+		sample(size_t pixel, size_t index, size_t dimension) const noexcept -> T final {
+			const auto group_seed
+				= Sampler::hash(Sampler::hash(m_seed, pixel), dimension / GROUP_SIZE);
+			const auto shuffled = nested_uniform_scramble(narrow_cast<uint32_t>(index), group_seed);
+			const auto value = sobol(shuffled, dimension % GROUP_SIZE);
+			return Sampler::to_unit(
+				nested_uniform_scramble(value, Sampler::hash(group_seed, dimension)));
+		}
+
+		[[nodiscard]] inline auto description() const noexcept -> SamplerDescription final {
+			return {SamplerKind::Sobol, 0U, m_seed};
+		}
+
+		/// @brief Returns dimension `dimension` of point `index` of the unscrambled Sobol
+		/// sequence, as a 32-bit fixed point fraction
+		///
+		/// @param index - The index of the point
+		/// @param dimension - The dimension. Must be less than 4
+		///
+		/// @return The value
+		[[nodiscard]] inline static constexpr auto
+		sobol(uint32_t index, size_t dimension) noexcept -> uint32_t {
+			// xor together the direction numbers of the set bits of `index`, a nibble at a time
+			const auto& table = NIBBLE_TABLE[dimension]; // NOLINT
+			auto value = 0U;
+			for(auto nibble = 0U; nibble < NUM_NIBBLES; ++nibble, index >>= 4U) {
+				value ^= table[nibble][index & 0xFU]; // NOLINT
+			}
+			return value;
+		}
+
+		constexpr auto operator=(const SobolSampler& sampler) noexcept -> SobolSampler& = default;
+		constexpr auto operator=(SobolSampler&& sampler) noexcept -> SobolSampler& = default;
+
+	  private:
+		static constexpr size_t GROUP_SIZE = 4;
+		static constexpr size_t NUM_BITS = 32;
+		using Directions = std::array<std::array<uint32_t, NUM_BITS>, GROUP_SIZE>;
+
+		/// @brief Computes the direction numbers of the first four Sobol dimensions, from the
+		/// primitive polynomials and initial values of Joe and Kuo's "new-joe-kuo-6.21201"
+		[[nodiscard]] inline static constexpr auto compute_directions() noexcept -> Directions {
+			struct Polynomial {
+				uint32_t m_degree;
+				uint32_t m_coefficients;
+				std::array<uint32_t, 3> m_initial;
+			};
+			constexpr auto polynomials = std::array<Polynomial, GROUP_SIZE - 1>{
+				Polynomial{1, 0, {1, 0, 0}},
+				Polynomial{2, 1, {1, 3, 0}},
+				Polynomial{3, 1, {1, 3, 1}}};
+
+			auto directions = Directions();
+			// the first dimension is the van der Corput sequence
+			for(auto bit = 0U; bit < NUM_BITS; ++bit) {
+				directions[0][bit] = 1U << (31U - bit); // NOLINT
+			}
+			for(auto dim = 1U; dim < GROUP_SIZE; ++dim) {
+				const auto& poly = polynomials[dim - 1]; // NOLINT
+				auto& dirs = directions[dim];			  // NOLINT
+				for(auto bit = 0U; bit < NUM_BITS; ++bit) {
+					if(bit < poly.m_degree) {
+						dirs[bit] = poly.m_initial[bit] << (31U - bit); // NOLINT
+					}
+					else {
+						auto dir = dirs[bit - poly.m_degree]
+								   ^ (dirs[bit - poly.m_degree] >> poly.m_degree); // NOLINT
+						for(auto k = 1U; k < poly.m_degree; ++k) {
+							const auto coefficient
+								= (poly.m_coefficients >> (poly.m_degree - 1U - k)) & 1U;
+							dir ^= coefficient != 0 ? dirs[bit - k] : 0U; // NOLINT
+						}
+						dirs[bit] = dir; // NOLINT
+					}
+				}
+			}
+			return directions;
+		}
+
+		static constexpr size_t NUM_NIBBLES = NUM_BITS / 4;
+		using NibbleTable
+			= std::array<std::array<std::array<uint32_t, 16>, NUM_NIBBLES>, GROUP_SIZE>;
+
+		/// @brief Computes, for each dimension, nibble of the index, and value of that nibble, the
+		/// xor of the direction numbers selected by the nibble's set bits
+		[[nodiscard]] inline static constexpr auto compute_nibble_table() noexcept -> NibbleTable {
+			const auto directions = compute_directions();
+			auto table = NibbleTable();
+			for(auto dim = 0U; dim < GROUP_SIZE; ++dim) {
+				for(auto nibble = 0U; nibble < NUM_NIBBLES; ++nibble) {
+					for(auto value = 0U; value < 16U; ++value) {
+						auto combined = 0U;
+						for(auto bit = 0U; bit < 4U; ++bit) {
+							combined ^= ((value >> bit) & 1U) != 0 ?
+											directions[dim][nibble * 4U + bit] : // NOLINT
+											0U;
+						}
+						table[dim][nibble][value] = combined; // NOLINT
+					}
+				}
+			}
+			return table;
+		}
+
+		static constexpr NibbleTable NIBBLE_TABLE = compute_nibble_table();
+
+		uint32_t m_seed;
+
+		/// @brief Owen-scrambles the fixed point fraction `value`: every bit is flipped based on
+		/// a hash of the bits above it. Implemented as a Laine-Karras permutation of the
+		/// bit-reversed value, with Burley's improved constants
+		[[nodiscard]] inline static constexpr auto
+		nested_uniform_scramble(uint32_t value, uint32_t seed) noexcept -> uint32_t {
+			value = reverse_bits(value);
+			value ^= value * 0x3D20ADEAU;	// NOLINT
+			value += seed;					// NOLINT
+			value *= (seed >> 16U) | 1U;	// NOLINT
+			value ^= value * 0x05526C56U;	// NOLINT
+			value ^= value * 0x53A22864U;	// NOLINT
+			return reverse_bits(value);
+		}
+
+		[[nodiscard]] inline static constexpr auto
+		reverse_bits(uint32_t value) noexcept -> uint32_t {
+			value = ((value >> 1U) & 0x55555555U) | ((value & 0x55555555U) << 1U); // NOLINT
+			value = ((value >> 2U) & 0x33333333U) | ((value & 0x33333333U) << 2U); // NOLINT
+			value = ((value >> 4U) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4U); // NOLINT
+			value = ((value >> 8U) & 0x00FF00FFU) | ((value & 0x00FF00FFU) << 8U); // NOLINT
+			return (value >> 16U) | (value << 16U);								   // NOLINT
+		}
+	};
+} // namespace math
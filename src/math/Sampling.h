@@ -0,0 +1,376 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <gsl/gsl>
+#include <span>
+#include <type_traits>
+
+#include "../utils/Concepts.h"
+#include "Constants.h"
+#include "General.h"
+#include "Simd.h"
+
+namespace math {
+	using gsl::narrow_cast;
+	using utils::concepts::FloatingPoint;
+#ifndef _MSC_VER
+	using std::size_t;
+	using std::uint32_t;
+	using std::uint64_t;
+#endif //_MSC_VER
+
+	/// @brief The lane types the sampling kernels operate on: a single value, or four packed
+	/// `float`s
+	template<typename T>
+	concept SampleLane = FloatingPoint<T> || std::is_same_v<T, simd::Float4>;
+
+	/// @brief Closed-form mappings from uniform samples in [0, 1) to points distributed over
+	/// common domains (the unit disk, sphere, ball, and hemisphere).
+	/// Unlike rejection sampling, every mapping consumes a fixed number of samples and has no
+	/// data-dependent branches, so it has a fixed, predictable cost, and can be run over many
+	/// samples at once. Each mapping is written once over a `SampleLane`, and comes in a scalar
+	/// form and a batch form operating on spans, which for `float` processes
+	/// `simd::LANES` samples at a time with `simd::Float4`.
+	///
+	/// The mappings also preserve the stratification of their input, so they work well with
+	/// low-discrepancy samples (see `Sampler`)
+	class Sampling {
+	  public:
+		/// @brief A point in two dimensions, or a lane of them
+		template<SampleLane Lane>
+		struct Coordinates2 {
+			Lane m_x;
+			Lane m_y;
+		};
+
+		/// @brief A point in three dimensions, or a lane of them
+		template<SampleLane Lane>
+		struct Coordinates3 {
+			Lane m_x;
+			Lane m_y;
+			Lane m_z;
+		};
+
+		/// @brief Maps a uniform sample in [0, 1)^2 to a uniformly distributed point in the unit
+		/// disk, with Shirley and Chiu's concentric mapping. Concentric squares map to concentric
+		/// circles, so nearby samples stay nearby and the square's strata are barely distorted
+		///
+		/// @param u - The first dimension of the sample
+		/// @param v - The second dimension of the sample
+		///
+		/// @return The point in the unit disk
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto
+		unit_disk(const Lane& u, const Lane& v) noexcept -> Coordinates2<Lane> {
+			const auto a = splat<Lane>(2.0) * u - splat<Lane>(1.0);
+			const auto b = splat<Lane>(2.0) * v - splat<Lane>(1.0);
+
+			// the larger of |a| and |b| selects the radius, the ratio of the two the angle,
+			// which is then within [-pi / 4, pi / 4]
+			const auto horizontal = abs_of(a) > abs_of(b);
+			const auto radius = pick(horizontal, a, b);
+			const auto other = pick(horizontal, b, a);
+			// a and b are both zero only at the center; avoid dividing by zero there
+			const auto divisor = pick(abs_of(radius) > splat<Lane>(0.0), radius, splat<Lane>(1.0));
+			const auto angle = splat<Lane>(Constants<double>::piOver4) * other / divisor;
+
+			const auto cos = cos_quarter(angle);
+			const auto sin = sin_quarter(angle);
+			return {radius * pick(horizontal, cos, sin), radius * pick(horizontal, sin, cos)};
+		}
+
+		/// @brief Maps a uniform sample in [0, 1)^2 to a uniformly distributed unit vector (a
+		/// point on the unit sphere), by the Lambert equal-area projection of `unit_disk`
+		///
+		/// @param u - The first dimension of the sample
+		/// @param v - The second dimension of the sample
+		///
+		/// @return The unit vector
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto
+		unit_vector(const Lane& u, const Lane& v) noexcept -> Coordinates3<Lane> {
+			const auto disk = unit_disk(u, v);
+			const auto radius_squared = disk.m_x * disk.m_x + disk.m_y * disk.m_y;
+			const auto remaining = max_of(splat<Lane>(1.0) - radius_squared, splat<Lane>(0.0));
+			const auto scale = splat<Lane>(2.0) * sqrt_of(remaining);
+			return {disk.m_x * scale,
+					disk.m_y * scale,
+					splat<Lane>(1.0) - splat<Lane>(2.0) * radius_squared};
+		}
+
+		/// @brief Maps a uniform sample in [0, 1)^3 to a uniformly distributed point in the unit
+		/// ball
+		///
+		/// @param u - The first dimension of the sample
+		/// @param v - The second dimension of the sample
+		/// @param w - The third dimension of the sample
+		///
+		/// @return The point in the unit ball
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto
+		unit_ball(const Lane& u, const Lane& v, const Lane& w) noexcept -> Coordinates3<Lane> {
+			// the volume within radius r grows as r^3
+			const auto direction = unit_vector(u, v);
+			const auto radius = cbrt_of(w);
+			return {direction.m_x * radius, direction.m_y * radius, direction.m_z * radius};
+		}
+
+		/// @brief Maps a uniform sample in [0, 1)^2 to a cosine-weighted direction in the
+		/// hemisphere around +z, by projecting `unit_disk` up onto the hemisphere (Malley's
+		/// method)
+		///
+		/// @param u - The first dimension of the sample
+		/// @param v - The second dimension of the sample
+		///
+		/// @return The unit direction
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto
+		cosine_hemisphere(const Lane& u, const Lane& v) noexcept -> Coordinates3<Lane> {
+			const auto disk = unit_disk(u, v);
+			const auto z_squared = splat<Lane>(1.0) - disk.m_x * disk.m_x - disk.m_y * disk.m_y;
+			return {disk.m_x, disk.m_y, sqrt_of(max_of(z_squared, splat<Lane>(0.0)))};
+		}
+
+		/// @brief Maps each of a batch of uniform samples to a point in the unit disk. See
+		/// `unit_disk`
+		///
+		/// @param u - The first dimension of each sample
+		/// @param v - The second dimension of each sample. Must be the same size as `u`
+		/// @param x - Where to write the x coordinate of each point. Must be the same size as `u`
+		/// @param y - Where to write the y coordinate of each point. Must be the same size as `u`
+		template<FloatingPoint T>
+		inline static auto unit_disk(std::span<const T> u,
+									 std::span<const T> v,
+									 std::span<T> x,
+									 std::span<T> y) noexcept -> void {
+			batch<T>(u.size(), [&]<SampleLane Lane>(size_t index) noexcept {
+				const auto point = unit_disk(load<Lane>(u, index), load<Lane>(v, index));
+				store(point.m_x, x, index);
+				store(point.m_y, y, index);
+			});
+		}
+
+		/// @brief Maps each of a batch of uniform samples to a unit vector. See `unit_vector`
+		///
+		/// @param u - The first dimension of each sample
+		/// @param v - The second dimension of each sample. Must be the same size as `u`
+		/// @param x - Where to write the x component of each vector. Must be the same size as `u`
+		/// @param y - Where to write the y component of each vector. Must be the same size as `u`
+		/// @param z - Where to write the z component of each vector. Must be the same size as `u`
+		template<FloatingPoint T>
+		inline static auto unit_vector(std::span<const T> u,
+									   std::span<const T> v,
+									   std::span<T> x,
+									   std::span<T> y,
+									   std::span<T> z) noexcept -> void {
+			batch<T>(u.size(), [&]<SampleLane Lane>(size_t index) noexcept {
+				store(unit_vector(load<Lane>(u, index), load<Lane>(v, index)), x, y, z, index);
+			});
+		}
+
+		/// @brief Maps each of a batch of uniform samples to a point in the unit ball. See
+		/// `unit_ball`
+		///
+		/// @param u - The first dimension of each sample
+		/// @param v - The second dimension of each sample. Must be the same size as `u`
+		/// @param w - The third dimension of each sample. Must be the same size as `u`
+		/// @param x - Where to write the x coordinate of each point. Must be the same size as `u`
+		/// @param y - Where to write the y coordinate of each point. Must be the same size as `u`
+		/// @param z - Where to write the z coordinate of each point. Must be the same size as `u`
+		template<FloatingPoint T>
+		inline static auto unit_ball(std::span<const T> u,
+									 std::span<const T> v,
+									 std::span<const T> w,
+									 std::span<T> x,
+									 std::span<T> y,
+									 std::span<T> z) noexcept -> void {
+			batch<T>(u.size(), [&]<SampleLane Lane>(size_t index) noexcept {
+				store(unit_ball(load<Lane>(u, index), load<Lane>(v, index), load<Lane>(w, index)),
+					  x,
+					  y,
+					  z,
+					  index);
+			});
+		}
+
+		/// @brief Maps each of a batch of uniform samples to a cosine-weighted direction in the
+		/// hemisphere around +z. See `cosine_hemisphere`
+		///
+		/// @param u - The first dimension of each sample
+		/// @param v - The second dimension of each sample. Must be the same size as `u`
+		/// @param x - Where to write the x component of each vector. Must be the same size as `u`
+		/// @param y - Where to write the y component of each vector. Must be the same size as `u`
+		/// @param z - Where to write the z component of each vector. Must be the same size as `u`
+		template<FloatingPoint T>
+		inline static auto cosine_hemisphere(std::span<const T> u,
+											 std::span<const T> v,
+											 std::span<T> x,
+											 std::span<T> y,
+											 std::span<T> z) noexcept -> void {
+			batch<T>(u.size(), [&]<SampleLane Lane>(size_t index) noexcept {
+				store(cosine_hemisphere(load<Lane>(u, index), load<Lane>(v, index)),
+					  x,
+					  y,
+					  z,
+					  index);
+			});
+		}
+
+	  private:
+		/// @brief Runs `kernel` over `count` samples: `simd::LANES` at a time with `simd::Float4`
+		/// when `T` is `float`, then one at a time for any remainder
+		template<FloatingPoint T, typename Kernel>
+		inline static auto batch(size_t count, Kernel&& kernel) noexcept -> void {
+			auto index = 0ULL;
+			if constexpr(std::is_same_v<T, float>) {
+				for(; index + simd::LANES <= count; index += simd::LANES) {
+					kernel.template operator()<simd::Float4>(index);
+				}
+			}
+			for(; index < count; ++index) {
+				kernel.template operator()<T>(index);
+			}
+		}
+
+		template<SampleLane Lane, FloatingPoint T>
+		[[nodiscard]] inline static auto load(std::span<const T> values, size_t index) noexcept
+			-> Lane {
+			if constexpr(std::is_same_v<Lane, simd::Float4>) {
+				return simd::Float4::load_unaligned(&values[index]);
+			}
+			else {
+				return values[index];
+			}
+		}
+
+		template<SampleLane Lane, FloatingPoint T>
+		inline static auto store(const Lane& lane, std::span<T> values, size_t index) noexcept
+			-> void {
+			if constexpr(std::is_same_v<Lane, simd::Float4>) {
+				lane.store_unaligned(&values[index]);
+			}
+			else {
+				values[index] = lane;
+			}
+		}
+
+		template<SampleLane Lane, FloatingPoint T>
+		inline static auto store(const Coordinates3<Lane>& point,
+								 std::span<T> x,
+								 std::span<T> y,
+								 std::span<T> z,
+								 size_t index) noexcept -> void {
+			store(point.m_x, x, index);
+			store(point.m_y, y, index);
+			store(point.m_z, z, index);
+		}
+
+		/// @brief Returns `value` in every lane of a `Lane`
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto splat(double value) noexcept -> Lane {
+			if constexpr(std::is_same_v<Lane, simd::Float4>) {
+				return simd::Float4::broadcast(narrow_cast<float>(value));
+			}
+			else {
+				return narrow_cast<Lane>(value);
+			}
+		}
+
+		// lane-wise operations, for both single values and `simd::Float4`
+
+		template<FloatingPoint T>
+		[[nodiscard]] inline static constexpr auto
+		pick(bool mask, T if_set, T if_unset) noexcept -> T {
+			return mask ? if_set : if_unset;
+		}
+		[[nodiscard]] inline static auto pick(const simd::Mask4& mask,
+											  const simd::Float4& if_set,
+											  const simd::Float4& if_unset) noexcept
+			-> simd::Float4 {
+			return select(mask, if_set, if_unset);
+		}
+
+		template<FloatingPoint T>
+		[[nodiscard]] inline static constexpr auto abs_of(T value) noexcept -> T {
+			return General::abs(value);
+		}
+		[[nodiscard]] inline static auto abs_of(const simd::Float4& value) noexcept
+			-> simd::Float4 {
+			return abs(value);
+		}
+
+		template<FloatingPoint T>
+		[[nodiscard]] inline static constexpr auto max_of(T lhs, T rhs) noexcept -> T {
+			return General::max(lhs, rhs);
+		}
+		[[nodiscard]] inline static auto
+		max_of(const simd::Float4& lhs, const simd::Float4& rhs) noexcept -> simd::Float4 {
+			return max(lhs, rhs);
+		}
+
+		template<FloatingPoint T>
+		[[nodiscard]] inline static constexpr auto sqrt_of(T value) noexcept -> T {
+			return General::sqrt(value);
+		}
+		[[nodiscard]] inline static auto sqrt_of(const simd::Float4& value) noexcept
+			-> simd::Float4 {
+			return sqrt(value);
+		}
+
+		/// @brief Cube root of a non-negative value: an initial estimate from its bit pattern,
+		/// refined by Newton iterations. See `simd::Float4`'s `cbrt`
+		template<FloatingPoint T>
+		[[nodiscard]] inline static constexpr auto cbrt_of(T value) noexcept -> T {
+			using Bits = std::conditional_t<std::is_same_v<T, float>, uint32_t, uint64_t>;
+			// two thirds of the bit pattern of 1 (for `float`, tuned to minimize the estimate's
+			// error)
+			constexpr auto magic = std::is_same_v<T, float> ? Bits(709921077U) :		// NOLINT
+															  Bits(0x2AA0000000000000ULL); // NOLINT
+			constexpr auto iterations = std::is_same_v<T, float> ? 3 : 4;
+
+			auto estimate = std::bit_cast<T>(narrow_cast<Bits>(std::bit_cast<Bits>(value) / 3U)
+											 + magic);
+			for(auto i = 0; i < iterations; ++i) {
+				estimate = (narrow_cast<T>(2) * estimate + value / (estimate * estimate))
+						   / narrow_cast<T>(3);
+			}
+			return estimate;
+		}
+		[[nodiscard]] inline static auto cbrt_of(const simd::Float4& value) noexcept
+			-> simd::Float4 {
+			return cbrt(value);
+		}
+
+		/// @brief Cosine of an angle within [-pi / 4, pi / 4], by its Taylor series
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto cos_quarter(const Lane& angle) noexcept
+			-> Lane {
+			const auto x2 = angle * angle;
+			return splat<Lane>(1.0)
+				   + x2
+						 * (splat<Lane>(-1.0 / 2.0)
+							+ x2
+								  * (splat<Lane>(1.0 / 24.0)
+									 + x2
+										   * (splat<Lane>(-1.0 / 720.0)
+											  + x2 * splat<Lane>(1.0 / 40320.0))));
+		}
+
+		/// @brief Sine of an angle within [-pi / 4, pi / 4], by its Taylor series
+		template<SampleLane Lane>
+		[[nodiscard]] inline static constexpr auto sin_quarter(const Lane& angle) noexcept
+			-> Lane {
+			const auto x2 = angle * angle;
+			return angle
+				   * (splat<Lane>(1.0)
+					  + x2
+							* (splat<Lane>(-1.0 / 6.0)
+							   + x2
+									 * (splat<Lane>(1.0 / 120.0)
+										+ x2
+											  * (splat<Lane>(-1.0 / 5040.0)
+												 + x2 * splat<Lane>(1.0 / 362880.0)))));
+		}
+	};
+} // namespace math
@@ -0,0 +1,622 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// clang-format off
+#if !defined(RAY_TRACER_DISABLE_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#include <emmintrin.h>
+		#define RAY_TRACER_SIMD_SSE 1
+	#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+		#include <arm_neon.h>
+		#define RAY_TRACER_SIMD_NEON 1
+	#endif
+#endif
+// clang-format on
+
+/// @brief Backend-agnostic kernels operating on 4 packed `float` lanes.
+///
+/// The backend (SSE2, AArch64 NEON, or scalar) is selected at compile time from the target architecture.
+/// Defining `RAY_TRACER_DISABLE_SIMD` forces the scalar backend.
+/// All kernels take pointers to 4 contiguous `float`s. They do not require any particular
+/// alignment, though 16-byte aligned data will be faster on some targets
+namespace math::simd {
+
+#if defined(RAY_TRACER_SIMD_SSE) || defined(RAY_TRACER_SIMD_NEON)
+	/// Whether a vector (non-scalar) backend is in use
+	inline constexpr bool ENABLED = true;
+#else
+	/// Whether a vector (non-scalar) backend is in use
+	inline constexpr bool ENABLED = false;
+#endif
+
+	/// The number of `float` lanes operated on by each kernel
+	inline constexpr auto LANES = 4ULL;
+
+	/// @brief Lane-wise addition: out = lhs + rhs
+	inline auto add(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vaddq_f32(vld1q_f32(lhs), vld1q_f32(rhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = lhs[i] + rhs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Lane-wise subtraction: out = lhs - rhs
+	inline auto subtract(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_sub_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vsubq_f32(vld1q_f32(lhs), vld1q_f32(rhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = lhs[i] - rhs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Lane-wise multiplication: out = lhs * rhs
+	inline auto multiply(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vmulq_f32(vld1q_f32(lhs), vld1q_f32(rhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = lhs[i] * rhs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Multiplies every lane by a scalar: out = lhs * scalar
+	inline auto scale(const float* lhs, float scalar, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(lhs), _mm_set1_ps(scalar)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vmulq_n_f32(vld1q_f32(lhs), scalar));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = lhs[i] * scalar; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Divides every lane by a scalar: out = lhs / scalar
+	inline auto divide(const float* lhs, float scalar, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_div_ps(_mm_loadu_ps(lhs), _mm_set1_ps(scalar)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vdivq_f32(vld1q_f32(lhs), vdupq_n_f32(scalar)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = lhs[i] / scalar; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Divides the first three lanes by a scalar: out = lhs / scalar. The fourth lane is
+	/// divided by one instead, so a zero padding lane stays zero rather than becoming NaN
+	inline auto divide3(const float* lhs, float scalar, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		const auto divisor = _mm_setr_ps(scalar, scalar, scalar, 1.0F);
+		_mm_storeu_ps(out, _mm_div_ps(_mm_loadu_ps(lhs), divisor));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vdivq_f32(vld1q_f32(lhs), vsetq_lane_f32(1.0F, vdupq_n_f32(scalar), 3)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			out[i] = lhs[i] / (i < LANES - 1 ? scalar : 1.0F);
+		}
+#endif
+	}
+
+	/// @brief Lane-wise negation: out = -lhs
+	inline auto negate(const float* lhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_xor_ps(_mm_loadu_ps(lhs), _mm_set1_ps(-0.0F)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vnegq_f32(vld1q_f32(lhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = -lhs[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		}
+#endif
+	}
+
+	/// @brief Lane-wise minimum: out = min(lhs, rhs)
+	inline auto min(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_min_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vminq_f32(vld1q_f32(lhs), vld1q_f32(rhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			out[i] = lhs[i] < rhs[i] ? lhs[i] : rhs[i];
+		}
+#endif
+	}
+
+	/// @brief Lane-wise maximum: out = max(lhs, rhs)
+	inline auto max(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		_mm_storeu_ps(out, _mm_max_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		vst1q_f32(out, vmaxq_f32(vld1q_f32(lhs), vld1q_f32(rhs)));
+#else
+		for(auto i = 0ULL; i < LANES; ++i) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			out[i] = lhs[i] > rhs[i] ? lhs[i] : rhs[i];
+		}
+#endif
+	}
+
+	/// @brief Dot product of the first three lanes. The fourth lane is ignored
+	[[nodiscard]] inline auto dot3(const float* lhs, const float* rhs) noexcept -> float {
+#if defined(RAY_TRACER_SIMD_SSE)
+		const auto product = _mm_mul_ps(_mm_loadu_ps(lhs), _mm_loadu_ps(rhs));
+		const auto y = _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)); // NOLINT
+		const auto z = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2)); // NOLINT
+		return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(product, y), z));
+#elif defined(RAY_TRACER_SIMD_NEON)
+		const auto product = vmulq_f32(vld1q_f32(lhs), vld1q_f32(rhs));
+		return vgetq_lane_f32(product, 0) + vgetq_lane_f32(product, 1)
+			   + vgetq_lane_f32(product, 2);
+#else
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		return lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2];
+#endif
+	}
+
+	/// @brief Cross product of the first three lanes. The fourth lane of `out` is set to
+	/// `lhs[3] * rhs[3] - lhs[3] * rhs[3]`, ie: zero for finite inputs
+	inline auto cross3(const float* lhs, const float* rhs, float* out) noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+		const auto left = _mm_loadu_ps(lhs);
+		const auto right = _mm_loadu_ps(rhs);
+		// (y, z, x) * (z, x, y) - (z, x, y) * (y, z, x)
+		const auto left_yzx = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1));	  // NOLINT
+		const auto left_zxy = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 1, 0, 2));	  // NOLINT
+		const auto right_yzx = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 2, 1)); // NOLINT
+		const auto right_zxy = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 1, 0, 2)); // NOLINT
+		_mm_storeu_ps(out,
+					  _mm_sub_ps(_mm_mul_ps(left_yzx, right_zxy), _mm_mul_ps(left_zxy, right_yzx)));
+#else
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		const float result[LANES] = {lhs[1] * rhs[2] - lhs[2] * rhs[1],
+									 lhs[2] * rhs[0] - lhs[0] * rhs[2],
+									 lhs[0] * rhs[1] - lhs[1] * rhs[0],
+									 lhs[3] * rhs[3] - lhs[3] * rhs[3]};
+		for(auto i = 0ULL; i < LANES; ++i) {
+			out[i] = result[i]; // NOLINT
+		}
+#endif
+	}
+
+	class Float4;
+
+	/// @brief The result of a lane-wise comparison of two `Float4`s: one boolean per lane
+	class Mask4 {
+	  public:
+		/// @brief Returns whether any lane is set
+		///
+		/// @return `true` if at least one lane is set
+		[[nodiscard]] inline auto any() const noexcept -> bool {
+			return bits() != 0U;
+		}
+
+		/// @brief Returns the lanes as a bitmask, with lane `i` in bit `i`
+		///
+		/// @return The bitmask
+		[[nodiscard]] inline auto bits() const noexcept -> std::uint32_t {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return static_cast<std::uint32_t>(_mm_movemask_ps(m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			alignas(16) static constexpr std::uint32_t weights[LANES] = {1U, 2U, 4U, 8U};
+			return vaddvq_u32(vandq_u32(m_lanes, vld1q_u32(weights)));
+#else
+			return m_lanes;
+#endif
+		}
+
+		inline auto operator&(const Mask4& mask) const noexcept -> Mask4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Mask4(_mm_and_ps(m_lanes, mask.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Mask4(vandq_u32(m_lanes, mask.m_lanes));
+#else
+			return Mask4(m_lanes & mask.m_lanes);
+#endif
+		}
+
+		inline auto operator|(const Mask4& mask) const noexcept -> Mask4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Mask4(_mm_or_ps(m_lanes, mask.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Mask4(vorrq_u32(m_lanes, mask.m_lanes));
+#else
+			return Mask4(m_lanes | mask.m_lanes);
+#endif
+		}
+
+	  private:
+		friend class Float4;
+
+#if defined(RAY_TRACER_SIMD_SSE)
+		using Native = __m128;
+#elif defined(RAY_TRACER_SIMD_NEON)
+		using Native = uint32x4_t;
+#else
+		using Native = std::uint32_t;
+#endif
+
+		explicit Mask4(Native lanes) noexcept : m_lanes(lanes) {
+		}
+
+		Native m_lanes;
+	};
+
+	/// @brief Four packed `float` lanes, for writing structure-of-arrays kernels (eg: one ray
+	/// against four primitives) once for every backend.
+	/// All operations are lane-wise unless stated otherwise
+	class Float4 {
+	  public:
+		/// @brief Loads four contiguous `float`s. `data` must be 16-byte aligned
+		///
+		/// @param data - The `float`s to load
+		///
+		/// @return The loaded lanes
+		[[nodiscard]] inline static auto load(const float* data) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_load_ps(data));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vld1q_f32(data));
+#else
+			auto lanes = Native();
+			for(auto i = 0ULL; i < LANES; ++i) {
+				lanes[i] = data[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			}
+			return Float4(lanes);
+#endif
+		}
+
+		/// @brief Loads four contiguous `float`s, with no alignment requirement
+		///
+		/// @param data - The `float`s to load
+		///
+		/// @return The loaded lanes
+		[[nodiscard]] inline static auto load_unaligned(const float* data) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_loadu_ps(data));
+#else
+			return load(data);
+#endif
+		}
+
+		/// @brief Loads four contiguous unsigned bytes, converting each to a `float`, with no
+		/// alignment requirement
+		///
+		/// @param data - The bytes to load
+		///
+		/// @return The loaded lanes
+		[[nodiscard]] inline static auto load_bytes(const std::uint8_t* data) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			auto packed = 0;
+			std::memcpy(&packed, data, sizeof(packed));
+			const auto zero = _mm_setzero_si128();
+			const auto words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+			return Float4(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			auto packed = 0U;
+			std::memcpy(&packed, data, sizeof(packed));
+			const auto words = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)));
+			return Float4(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))));
+#else
+			auto lanes = Native();
+			for(auto i = 0ULL; i < LANES; ++i) {
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				lanes[i] = static_cast<float>(data[i]);
+			}
+			return Float4(lanes);
+#endif
+		}
+
+		/// @brief Returns a `Float4` with every lane set to `value`
+		///
+		/// @param value - The value to set the lanes to
+		///
+		/// @return The broadcast lanes
+		[[nodiscard]] inline static auto broadcast(float value) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_set1_ps(value));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vdupq_n_f32(value));
+#else
+			return Float4({value, value, value, value});
+#endif
+		}
+
+		/// @brief Stores the lanes to four contiguous `float`s. `data` must be 16-byte aligned
+		///
+		/// @param data - Where to store the lanes
+		inline auto store(float* data) const noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+			_mm_store_ps(data, m_lanes);
+#elif defined(RAY_TRACER_SIMD_NEON)
+			vst1q_f32(data, m_lanes);
+#else
+			for(auto i = 0ULL; i < LANES; ++i) {
+				data[i] = m_lanes[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			}
+#endif
+		}
+
+		/// @brief Stores the lanes to four contiguous `float`s, with no alignment requirement
+		///
+		/// @param data - Where to store the lanes
+		inline auto store_unaligned(float* data) const noexcept -> void {
+#if defined(RAY_TRACER_SIMD_SSE)
+			_mm_storeu_ps(data, m_lanes);
+#else
+			store(data);
+#endif
+		}
+
+		/// @brief Returns the smallest of the four lanes
+		///
+		/// @return The minimum lane
+		[[nodiscard]] inline auto horizontal_min() const noexcept -> float {
+#if defined(RAY_TRACER_SIMD_SSE)
+			const auto swapped_pairs = _mm_min_ps(m_lanes,
+												  _mm_shuffle_ps(m_lanes,
+																 m_lanes,
+																 _MM_SHUFFLE(2, 3, 0, 1))); // NOLINT
+			return _mm_cvtss_f32(_mm_min_ss(
+				swapped_pairs,
+				_mm_shuffle_ps(swapped_pairs, swapped_pairs, _MM_SHUFFLE(1, 0, 3, 2)))); // NOLINT
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return vminvq_f32(m_lanes);
+#else
+			const auto low = m_lanes[0] < m_lanes[1] ? m_lanes[0] : m_lanes[1];
+			const auto high = m_lanes[2] < m_lanes[3] ? m_lanes[2] : m_lanes[3];
+			return low < high ? low : high;
+#endif
+		}
+
+		inline auto operator+(const Float4& rhs) const noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_add_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vaddq_f32(m_lanes, rhs.m_lanes));
+#else
+			return map(rhs, [](float lhs, float right) { return lhs + right; });
+#endif
+		}
+
+		inline auto operator-(const Float4& rhs) const noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_sub_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vsubq_f32(m_lanes, rhs.m_lanes));
+#else
+			return map(rhs, [](float lhs, float right) { return lhs - right; });
+#endif
+		}
+
+		inline auto operator*(const Float4& rhs) const noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_mul_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vmulq_f32(m_lanes, rhs.m_lanes));
+#else
+			return map(rhs, [](float lhs, float right) { return lhs * right; });
+#endif
+		}
+
+		inline auto operator/(const Float4& rhs) const noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_div_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vdivq_f32(m_lanes, rhs.m_lanes));
+#else
+			return map(rhs, [](float lhs, float right) { return lhs / right; });
+#endif
+		}
+
+		inline auto operator-() const noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_xor_ps(m_lanes, _mm_set1_ps(-0.0F)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vnegq_f32(m_lanes));
+#else
+			return map(*this, [](float lhs, [[maybe_unused]] float right) { return -lhs; });
+#endif
+		}
+
+		inline auto operator<(const Float4& rhs) const noexcept -> Mask4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Mask4(_mm_cmplt_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Mask4(vcltq_f32(m_lanes, rhs.m_lanes));
+#else
+			return compare(rhs, [](float lhs, float right) { return lhs < right; });
+#endif
+		}
+
+		inline auto operator<=(const Float4& rhs) const noexcept -> Mask4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Mask4(_mm_cmple_ps(m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Mask4(vcleq_f32(m_lanes, rhs.m_lanes));
+#else
+			return compare(rhs, [](float lhs, float right) { return lhs <= right; });
+#endif
+		}
+
+		inline auto operator>(const Float4& rhs) const noexcept -> Mask4 {
+			return rhs < *this;
+		}
+
+		inline auto operator>=(const Float4& rhs) const noexcept -> Mask4 {
+			return rhs <= *this;
+		}
+
+		/// @brief Returns the lane-wise square root of `value`
+		[[nodiscard]] inline friend auto sqrt(const Float4& value) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_sqrt_ps(value.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vsqrtq_f32(value.m_lanes));
+#else
+			return value.map(value, [](float lhs, [[maybe_unused]] float right) {
+				return std::sqrt(lhs);
+			});
+#endif
+		}
+
+		/// @brief Returns the lane-wise absolute value of `value`
+		[[nodiscard]] inline friend auto abs(const Float4& value) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_andnot_ps(_mm_set1_ps(-0.0F), value.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vabsq_f32(value.m_lanes));
+#else
+			return value.map(value, [](float lhs, [[maybe_unused]] float right) {
+				return std::abs(lhs);
+			});
+#endif
+		}
+
+		/// @brief Returns the lane-wise cube root of `value`, which must be non-negative.
+		/// With a vector backend, this is an initial estimate from the lanes' bit patterns
+		/// refined by three Newton iterations, accurate to about one `float` ulp
+		[[nodiscard]] inline friend auto cbrt(const Float4& value) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE) || defined(RAY_TRACER_SIMD_NEON)
+			// dividing the bit pattern (roughly the log2) by three roughly takes the cube root
+			constexpr auto one_third = 1.0F / 3.0F;
+	#if defined(RAY_TRACER_SIMD_SSE)
+			const auto bits = _mm_cvtepi32_ps(_mm_castps_si128(value.m_lanes));
+			const auto estimate_bits = _mm_add_epi32(
+				_mm_cvttps_epi32(_mm_mul_ps(bits, _mm_set1_ps(one_third))),
+				_mm_set1_epi32(CBRT_MAGIC));
+			auto estimate = Float4(_mm_castsi128_ps(estimate_bits));
+	#else
+			const auto bits = vcvtq_f32_s32(vreinterpretq_s32_f32(value.m_lanes));
+			const auto estimate_bits = vaddq_s32(vcvtq_s32_f32(vmulq_n_f32(bits, one_third)),
+												 vdupq_n_s32(CBRT_MAGIC));
+			auto estimate = Float4(vreinterpretq_f32_s32(estimate_bits));
+	#endif
+			const auto two = broadcast(2.0F);
+			const auto third = broadcast(one_third);
+			for(auto i = 0; i < 3; ++i) {
+				estimate = (two * estimate + value / (estimate * estimate)) * third;
+			}
+			return estimate;
+#else
+			return value.map(value, [](float lhs, [[maybe_unused]] float right) {
+				return std::cbrt(lhs);
+			});
+#endif
+		}
+
+		/// @brief Returns the lane-wise maximum of `lhs` and `rhs`
+		[[nodiscard]] inline friend auto max(const Float4& lhs, const Float4& rhs) noexcept
+			-> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_max_ps(lhs.m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vmaxq_f32(lhs.m_lanes, rhs.m_lanes));
+#else
+			return lhs.map(rhs, [](float left, float right) { return left > right ? left : right; });
+#endif
+		}
+
+		/// @brief Returns the lane-wise minimum of `lhs` and `rhs`
+		[[nodiscard]] inline friend auto min(const Float4& lhs, const Float4& rhs) noexcept
+			-> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_min_ps(lhs.m_lanes, rhs.m_lanes));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vminq_f32(lhs.m_lanes, rhs.m_lanes));
+#else
+			return lhs.map(rhs, [](float left, float right) { return left < right ? left : right; });
+#endif
+		}
+
+		/// @brief Selects, per lane, the lane from `if_set` where `mask` is set and the lane from
+		/// `if_unset` where it is not
+		[[nodiscard]] inline friend auto
+		select(const Mask4& mask, const Float4& if_set, const Float4& if_unset) noexcept -> Float4 {
+			return blend(mask, if_set, if_unset);
+		}
+
+	  private:
+		/// Added to a third of a `float`'s bit pattern to estimate its cube root: two thirds of
+		/// the bit pattern of 1, tuned to minimize the estimate's error (Kahan)
+		static constexpr std::int32_t CBRT_MAGIC = 709921077;
+
+		/// @brief Implementation of `select`, as a member so it can access `Mask4`'s lanes
+		[[nodiscard]] inline static auto
+		blend(const Mask4& mask, const Float4& if_set, const Float4& if_unset) noexcept -> Float4 {
+#if defined(RAY_TRACER_SIMD_SSE)
+			return Float4(_mm_or_ps(_mm_and_ps(mask.m_lanes, if_set.m_lanes),
+									_mm_andnot_ps(mask.m_lanes, if_unset.m_lanes)));
+#elif defined(RAY_TRACER_SIMD_NEON)
+			return Float4(vbslq_f32(mask.m_lanes, if_set.m_lanes, if_unset.m_lanes));
+#else
+			auto lanes = Native();
+			for(auto i = 0ULL; i < LANES; ++i) {
+				lanes[i] = (mask.m_lanes & (1U << i)) != 0U ? if_set.m_lanes[i] :
+																if_unset.m_lanes[i];
+			}
+			return Float4(lanes);
+#endif
+		}
+
+#if defined(RAY_TRACER_SIMD_SSE)
+		using Native = __m128;
+#elif defined(RAY_TRACER_SIMD_NEON)
+		using Native = float32x4_t;
+#else
+		struct Native {
+			float m_values[LANES];
+
+			inline constexpr auto operator[](size_t index) noexcept -> float& {
+				return m_values[index]; // NOLINT
+			}
+			inline constexpr auto operator[](size_t index) const noexcept -> const float& {
+				return m_values[index]; // NOLINT
+			}
+		};
+
+		template<typename Op>
+		[[nodiscard]] inline auto map(const Float4& rhs, Op op) const noexcept -> Float4 {
+			auto lanes = Native();
+			for(auto i = 0ULL; i < LANES; ++i) {
+				lanes[i] = op(m_lanes[i], rhs.m_lanes[i]);
+			}
+			return Float4(lanes);
+		}
+
+		template<typename Op>
+		[[nodiscard]] inline auto compare(const Float4& rhs, Op op) const noexcept -> Mask4 {
+			auto bits = 0U;
+			for(auto i = 0ULL; i < LANES; ++i) {
+				bits |= op(m_lanes[i], rhs.m_lanes[i]) ? (1U << i) : 0U;
+			}
+			return Mask4(bits);
+		}
+#endif
+
+		explicit Float4(Native lanes) noexcept : m_lanes(lanes) {
+		}
+
+		Native m_lanes;
+	};
+} // namespace math::simd
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <gsl/gsl>
+
+#include "../utils/Concepts.h"
+#include "General.h"
+#include "Point3.h"
+#include "TrigFuncs.h"
+#include "Vec3.h"
+
+namespace math {
+
+	using gsl::narrow_cast;
+	using utils::concepts::FloatingPoint;
+
+	using std::size_t;
+
+	/// @brief An affine transform of 3D space: a linear map (rotation, scaling, shearing)
+	/// followed by a translation, stored as the top three rows of a 4x4 matrix.
+	/// A default constructed `Transform` is the identity
+	///
+	/// @tparam T - The floating point type of the transform's elements
+	template<FloatingPoint T = float>
+	class Transform {
+	  public:
+		using Point3 = Point3<T>;
+		using Vec3 = Vec3<T>;
+
+		/// The number of rows of the matrix stored
+		static constexpr size_t NUM_ROWS = 3;
+		/// The number of columns of the matrix: three for the linear map, then the translation
+		static constexpr size_t NUM_COLUMNS = 4;
+
+		constexpr Transform() noexcept = default;
+
+		/// @brief Creates a `Transform` from the elements of its matrix
+		///
+		/// @param elements - The top three rows of the matrix, row-major
+		explicit constexpr Transform(const std::array<T, NUM_ROWS * NUM_COLUMNS>& elements) noexcept
+			: m_elements(elements) {
+		}
+		constexpr Transform(const Transform& transform) noexcept = default;
+		constexpr Transform(Transform&& transform) noexcept = default;
+		constexpr ~Transform() noexcept = default;
+
+		/// @brief Returns a `Transform` moving points by `offset`
+		///
+		/// @param offset - The translation
+		///
+		/// @return The translation
+		[[nodiscard]] inline static constexpr auto
+		translation(const Vec3& offset) noexcept -> Transform {
+			auto transform = Transform();
+			transform.at(0, 3) = offset.x();
+			transform.at(1, 3) = offset.y();
+			transform.at(2, 3) = offset.z();
+			return transform;
+		}
+
+		/// @brief Returns a `Transform` scaling each axis by the corresponding element of `scale`
+		///
+		/// @param scale - The scale along each axis
+		///
+		/// @return The scaling
+		[[nodiscard]] inline static constexpr auto
+		scaling(const Vec3& scale) noexcept -> Transform {
+			auto transform = Transform();
+			transform.at(0, 0) = scale.x();
+			transform.at(1, 1) = scale.y();
+			transform.at(2, 2) = scale.z();
+			return transform;
+		}
+
+		/// @brief Returns a `Transform` rotating counter-clockwise by `radians` about `axis`
+		/// (when looking down the axis towards the origin)
+		///
+		/// @param axis - The axis to rotate about. Doesn't need to be normalized
+		/// @param radians - The angle to rotate by
+		///
+		/// @return The rotation
+		[[nodiscard]] inline static constexpr auto
+		rotation(const Vec3& axis, T radians) noexcept -> Transform {
+			const auto unit = axis.normalized();
+			const auto x = unit.x();
+			const auto y = unit.y();
+			const auto z = unit.z();
+			const auto cos = Trig::cos(radians);
+			const auto sin = Trig::sin(radians);
+			const auto one_minus_cos = narrow_cast<T>(1) - cos;
+
+			// Rodrigues' rotation formula
+			return Transform({x * x * one_minus_cos + cos,
+							  x * y * one_minus_cos - z * sin,
+							  x * z * one_minus_cos + y * sin,
+							  narrow_cast<T>(0),
+							  y * x * one_minus_cos + z * sin,
+							  y * y * one_minus_cos + cos,
+							  y * z * one_minus_cos - x * sin,
+							  narrow_cast<T>(0),
+							  z * x * one_minus_cos - y * sin,
+							  z * y * one_minus_cos + x * sin,
+							  z * z * one_minus_cos + cos,
+							  narrow_cast<T>(0)});
+		}
+
+		/// @brief Returns the element of the matrix at the given row and column
+		///
+		/// @param row - The row of the element
+		/// @param column - The column of the element
+		///
+		/// @return The element
+		[[nodiscard]] inline constexpr auto at(size_t row, size_t column) const noexcept -> T {
+			return m_elements[row * NUM_COLUMNS + column]; // NOLINT
+		}
+
+		/// @brief Returns the element of the matrix at the given row and column
+		///
+		/// @param row - The row of the element
+		/// @param column - The column of the element
+		///
+		/// @return The element
+		[[nodiscard]] inline constexpr auto at(size_t row, size_t column) noexcept -> T& {
+			return m_elements[row * NUM_COLUMNS + column]; // NOLINT
+		}
+
+		/// @brief Applies the transform to `point`
+		///
+		/// @param point - The point to transform
+		///
+		/// @return The transformed point
+		[[nodiscard]] inline constexpr auto
+		transform_point(const Point3& point) const noexcept -> Point3 {
+			return {row_dot(0, point.x(), point.y(), point.z()) + at(0, 3),
+					row_dot(1, point.x(), point.y(), point.z()) + at(1, 3),
+					row_dot(2, point.x(), point.y(), point.z()) + at(2, 3)};
+		}
+
+		/// @brief Applies the transform's linear map to `vec`, ignoring the translation
+		///
+		/// @param vec - The vector (eg: a direction) to transform
+		///
+		/// @return The transformed vector
+		[[nodiscard]] inline constexpr auto
+		transform_vector(const Vec3& vec) const noexcept -> Vec3 {
+			return {row_dot(0, vec.x(), vec.y(), vec.z()),
+					row_dot(1, vec.x(), vec.y(), vec.z()),
+					row_dot(2, vec.x(), vec.y(), vec.z())};
+		}
+
+		/// @brief Applies the transpose of the transform's linear map to `normal`.
+		/// Surface normals stay perpendicular to their surface when the surface is transformed by
+		/// the inverse of this transform. The result isn't normalized
+		///
+		/// @param normal - The normal to transform
+		///
+		/// @return The transformed normal
+		[[nodiscard]] inline constexpr auto
+		transform_normal(const Vec3& normal) const noexcept -> Vec3 {
+			return {at(0, 0) * normal.x() + at(1, 0) * normal.y() + at(2, 0) * normal.z(),
+					at(0, 1) * normal.x() + at(1, 1) * normal.y() + at(2, 1) * normal.z(),
+					at(0, 2) * normal.x() + at(1, 2) * normal.y() + at(2, 2) * normal.z()};
+		}
+
+		/// @brief Returns the determinant of the transform's linear map. Zero if the transform
+		/// can't be inverted
+		///
+		/// @return The determinant
+		[[nodiscard]] inline constexpr auto determinant() const noexcept -> T {
+			return at(0, 0) * (at(1, 1) * at(2, 2) - at(1, 2) * at(2, 1))
+				   - at(0, 1) * (at(1, 0) * at(2, 2) - at(1, 2) * at(2, 0))
+				   + at(0, 2) * (at(1, 0) * at(2, 1) - at(1, 1) * at(2, 0));
+		}
+
+		/// @brief Returns the inverse of the transform, undoing it.
+		/// The transform must be invertible (have a non-zero `determinant`)
+		///
+		/// @return The inverse
+		[[nodiscard]] inline constexpr auto inverse() const noexcept -> Transform {
+			const auto inverse_determinant = narrow_cast<T>(1) / determinant();
+			auto inverse = Transform();
+			// the inverse of the linear map is its adjugate over its determinant
+			inverse.at(0, 0) = (at(1, 1) * at(2, 2) - at(1, 2) * at(2, 1)) * inverse_determinant;
+			inverse.at(0, 1) = (at(0, 2) * at(2, 1) - at(0, 1) * at(2, 2)) * inverse_determinant;
+			inverse.at(0, 2) = (at(0, 1) * at(1, 2) - at(0, 2) * at(1, 1)) * inverse_determinant;
+			inverse.at(1, 0) = (at(1, 2) * at(2, 0) - at(1, 0) * at(2, 2)) * inverse_determinant;
+			inverse.at(1, 1) = (at(0, 0) * at(2, 2) - at(0, 2) * at(2, 0)) * inverse_determinant;
+			inverse.at(1, 2) = (at(0, 2) * at(1, 0) - at(0, 0) * at(1, 2)) * inverse_determinant;
+			inverse.at(2, 0) = (at(1, 0) * at(2, 1) - at(1, 1) * at(2, 0)) * inverse_determinant;
+			inverse.at(2, 1) = (at(0, 1) * at(2, 0) - at(0, 0) * at(2, 1)) * inverse_determinant;
+			inverse.at(2, 2) = (at(0, 0) * at(1, 1) - at(0, 1) * at(1, 0)) * inverse_determinant;
+
+			// and the translation is undone after the linear map
+			const auto translation = inverse.transform_vector(Vec3(at(0, 3), at(1, 3), at(2, 3)));
+			inverse.at(0, 3) = -translation.x();
+			inverse.at(1, 3) = -translation.y();
+			inverse.at(2, 3) = -translation.z();
+			return inverse;
+		}
+
+		constexpr auto operator=(const Transform& transform) noexcept -> Transform& = default;
+		constexpr auto operator=(Transform&& transform) noexcept -> Transform& = default;
+
+		/// @brief Composes this transform with `transform`, which is applied first
+		///
+		/// @param transform - The transform to apply before this one
+		///
+		/// @return The composed transform
+		inline constexpr auto
+		operator*(const Transform& transform) const noexcept -> Transform {
+			auto composed = Transform();
+			for(auto row = 0ULL; row < NUM_ROWS; ++row) {
+				for(auto column = 0ULL; column < NUM_COLUMNS; ++column) {
+					composed.at(row, column) = row_dot(row,
+													   transform.at(0, column),
+													   transform.at(1, column),
+													   transform.at(2, column))
+											   + (column == NUM_COLUMNS - 1 ? at(row, 3) :
+																			  narrow_cast<T>(0));
+				}
+			}
+			return composed;
+		}
+
+		inline constexpr auto operator==(const Transform& transform) const noexcept -> bool {
+			return m_elements == transform.m_elements;
+		}
+
+	  private:
+		std::array<T, NUM_ROWS * NUM_COLUMNS> m_elements = {narrow_cast<T>(1),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(1),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(0),
+															narrow_cast<T>(1),
+															narrow_cast<T>(0)};
+
+		[[nodiscard]] inline constexpr auto
+		row_dot(size_t row, T x, T y, T z) const noexcept -> T {
+			return at(row, 0) * x + at(row, 1) * y + at(row, 2) * z;
+		}
+	};
+} // namespace math
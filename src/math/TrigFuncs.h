@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+
 #include "../utils/Concepts.h"
 #include "Constants.h"
 #include "General.h"
@@ -81,6 +84,68 @@ namespace math {
 			}
 		}
 
+		/// @brief Fast approximation calculation of the cosines of the given angles, several at a
+		/// time, with the same approximation as the scalar `cos`
+		///
+		/// @param angles - The angles to calculate the cosines of
+		/// @param out - Where to store the cosines, for the first `min(angles.size(), out.size())`
+		/// angles. May alias `angles`
+		template<FloatingPoint T>
+		static constexpr inline auto cos(std::span<const T> angles, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(angles, out, [](T angle) noexcept { return cos_lane(angle); });
+		}
+
+		/// @brief Fast approximation calculation of the sines of the given angles, several at a
+		/// time, with the same approximation as the scalar `sin`
+		///
+		/// @param angles - The angles to calculate the sines of
+		/// @param out - Where to store the sines, for the first `min(angles.size(), out.size())`
+		/// angles. May alias `angles`
+		template<FloatingPoint T>
+		static constexpr inline auto sin(std::span<const T> angles, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(angles, out, [](T angle) noexcept {
+				return cos_lane(Constants<T>::piOver2 - angle);
+			});
+		}
+
+		/// @brief Fast approximation calculation of the tangents of the given angles, several at
+		/// a time, with the same approximation as the scalar `tan`
+		///
+		/// @param angles - The angles to calculate the tangents of
+		/// @param out - Where to store the tangents, for the first `min(angles.size(), out.size())`
+		/// angles. May alias `angles`
+		template<FloatingPoint T>
+		static constexpr inline auto tan(std::span<const T> angles, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(angles, out, [](T angle) noexcept { return tan_lane(angle); });
+		}
+
+		/// @brief Fast approximation calculation of the arctangents of the given values, several
+		/// at a time, with the same approximation as the scalar `atan`
+		///
+		/// @param values - The values to calculate the arctangents of
+		/// @param out - Where to store the arctangents, for the first
+		/// `min(values.size(), out.size())` values. May alias `values`
+		template<FloatingPoint T>
+		static constexpr inline auto atan(std::span<const T> values, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(values, out, [](T value) noexcept { return atan_lane(value); });
+		}
+
+		/// @brief Fast approximation calculation of the hyperbolic tangents of the given values,
+		/// several at a time, with the same approximation as the scalar `tanh`
+		///
+		/// @param values - The values to calculate the hyperbolic tangents of
+		/// @param out - Where to store the hyperbolic tangents, for the first
+		/// `min(values.size(), out.size())` values. May alias `values`
+		template<FloatingPoint T>
+		static constexpr inline auto tanh(std::span<const T> values, std::span<T> out) noexcept
+			-> void {
+			detail::transform_batch(values, out, [](T value) noexcept { return tanh_lane(value); });
+		}
+
 	  private:
 		/// @brief Helper function for `cosf`; Don't use on its own
 		///
@@ -239,32 +304,26 @@ namespace math {
 			return y;
 		}
 
+		/// @brief Helper function for `tanhf`; Don't use on its own
+		///
+		/// @param x - the angle. Must be non-negative
+		/// @return - tanh(x)
+		[[nodiscard]] static constexpr inline auto tanh_helperf(float x) noexcept -> float {
+			return (-0.67436811832e-5F
+					+ (0.2468149110712040F + (0.0583691066395175F + 0.03357335044280075F * x) * x)
+						  * x)
+				   / (0.2464845986383725F
+					  + (0.0609347197060491F + (0.1086202599228572F + 0.02874707922475963F * x) * x)
+							* x);
+		}
+
 		/// @brief Fast approximation calculation of the hyperbolic tangent ("tanch") of the angle
 		///
 		/// @param angle - The angle to calculate the hyperbolic tanget of
 		/// @return - The hyperbolic tangent of the angle
 		[[nodiscard]] static constexpr inline auto tanhf_internal(float angle) noexcept -> float {
-			if(angle < 0.0F) {
-				angle *= -1.0F;
-				return -(-0.67436811832e-5F
-						 + (0.2468149110712040F
-							+ (0.0583691066395175F + 0.03357335044280075F * angle) * angle)
-							   * angle)
-					   / (0.2464845986383725F
-						  + (0.0609347197060491F
-							 + (0.1086202599228572F + 0.02874707922475963F * angle) * angle)
-								* angle);
-			}
-			else {
-				return (-0.67436811832e-5F
-						+ (0.2468149110712040F
-						   + (0.0583691066395175F + 0.03357335044280075F * angle) * angle)
-							  * angle)
-					   / (0.2464845986383725F
-						  + (0.0609347197060491F
-							 + (0.1086202599228572F + 0.02874707922475963F * angle) * angle)
-								* angle);
-			}
+			// tanh(-x) = -tanh(x)
+			return angle < 0.0F ? -tanh_helperf(-angle) : tanh_helperf(angle);
 		}
 
 		/// @brief Helper function for `cos`; Don't use on its own
@@ -424,32 +483,151 @@ namespace math {
 			return y;
 		}
 
+		/// @brief Helper function for `tanh`; Don't use on its own
+		///
+		/// @param x - the angle. Must be non-negative
+		/// @return - tanh(x)
+		[[nodiscard]] static constexpr inline auto tanh_helper(double x) noexcept -> double {
+			return (-0.67436811832e-5
+					+ (0.2468149110712040 + (0.0583691066395175 + 0.03357335044280075 * x) * x)
+						  * x)
+				   / (0.2464845986383725
+					  + (0.0609347197060491 + (0.1086202599228572 + 0.02874707922475963 * x) * x)
+							* x);
+		}
+
 		/// @brief Fast approximation calculation of the hyperbolic tangent ("tanch") of the angle
 		///
 		/// @param angle - The angle to calculate the hyperbolic tanget of
 		/// @return - The hyperbolic tangent of the angle
 		[[nodiscard]] static constexpr inline auto tanh_internal(double angle) noexcept -> double {
-			if(angle < 0.0) {
-				angle *= -1.0;
-				return -(-0.67436811832e-5
-						 + (0.2468149110712040
-							+ (0.0583691066395175 + 0.03357335044280075 * angle) * angle)
-							   * angle)
-					   / (0.2464845986383725
-						  + (0.0609347197060491
-							 + (0.1086202599228572 + 0.02874707922475963 * angle) * angle)
-								* angle);
+			// tanh(-x) = -tanh(x)
+			return angle < 0.0 ? -tanh_helper(-angle) : tanh_helper(angle);
+		}
+
+		/// @brief Branch-free `General::fmod(angle, twoPi)`, for the batch functions.
+		/// Truncates through 32-bit integers, which vectorize on every target, so is only
+		/// equivalent for |angle| < 2^31 * twoPi
+		///
+		/// @param angle - The angle to reduce
+		/// @return - angle mod twoPi
+		[[nodiscard]] static constexpr inline auto reduce_lane(FloatingPoint auto angle) noexcept
+			-> decltype(angle) {
+			using T = decltype(angle);
+			const auto turns = static_cast<T>(static_cast<int32_t>(angle / Constants<T>::twoPi));
+			return angle - turns * Constants<T>::twoPi;
+		}
+
+		/// @brief Branch-free `cos`, for the batch functions to vectorize.
+		/// Rather than branching on the quadrant, the argument and sign for every quadrant are
+		/// computed, then the right ones selected
+		///
+		/// @param angle - The angle to calculate the cosine of
+		/// @return - The cosine of the angle
+		[[nodiscard]] static constexpr inline auto cos_lane(FloatingPoint auto angle) noexcept
+			-> decltype(angle) {
+			using T = decltype(angle);
+			using detail::select;
+			angle = reduce_lane(angle);
+			angle = select(angle < static_cast<T>(0), -angle, angle); // cos(-x) = cos(x)
+			const auto quad = static_cast<int32_t>(angle * Constants<T>::twoOverPi);
+			auto x = select(quad == 1, Constants<T>::pi - angle, angle);
+			x = select(quad == 2, angle - Constants<T>::pi, x);
+			x = select(quad == 3, Constants<T>::twoPi - angle, x);
+			auto result = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				result = cos_helperf(x);
+			}
+			else {
+				result = cos_helper(x);
+			}
+			result = select((quad == 1) | (quad == 2), -result, result);
+			return select(quad > 3, static_cast<T>(0), result);
+		}
+
+		/// @brief Branch-free `tan`, for the batch functions to vectorize
+		///
+		/// @param angle - The angle to calculate the tangent of
+		/// @return - The tangent of the angle
+		[[nodiscard]] static constexpr inline auto tan_lane(FloatingPoint auto angle) noexcept
+			-> decltype(angle) {
+			using T = decltype(angle);
+			using detail::select;
+			angle = reduce_lane(angle);
+			const auto octant = static_cast<int32_t>(angle / Constants<T>::fourOverPi);
+			// each octant is the helper, or its reciprocal, of the distance to the octant's
+			// nearest multiple of pi / 2, possibly negated
+			auto pivot = static_cast<T>(0);
+			pivot = select(octant >= 1, Constants<T>::piOver2, pivot);
+			pivot = select(octant >= 3, Constants<T>::pi, pivot);
+			pivot = select(octant >= 5, Constants<T>::threePiOver2, pivot);
+			pivot = select(octant >= 7, Constants<T>::twoPi, pivot);
+			const auto x = select(octant % 2 == 0, angle - pivot, pivot - angle)
+						   * Constants<T>::fourOverPi;
+			auto result = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				result = tan_helperf(x);
+			}
+			else {
+				result = tan_helper(x);
+			}
+			// bitwise, rather than logical, so the conditions aren't short-circuiting branches
+			const auto reciprocal = (octant == 1) | (octant == 2) | (octant == 5) | (octant == 6);
+			const auto negative = (octant == 2) | (octant == 3) | (octant == 6) | (octant == 7);
+			result = select(reciprocal, static_cast<T>(1) / result, result);
+			result = select(negative, -result, result);
+			return select((octant < 0) | (octant > 7), static_cast<T>(0), result);
+		}
+
+		/// @brief Branch-free `atan`, for the batch functions to vectorize
+		///
+		/// @param value - The value to calculate the arctangent of
+		/// @return - The arctangent of the value
+		[[nodiscard]] static constexpr inline auto atan_lane(FloatingPoint auto value) noexcept
+			-> decltype(value) {
+			using T = decltype(value);
+			using detail::select;
+			constexpr auto tanPiOver12 = tan(Constants<T>::piOver12);
+			constexpr auto tanPiOver6 = tan(Constants<T>::piOver6);
+
+			const auto sign = value < static_cast<T>(0); // arctan(-x)=-arctan(x)
+			auto x = select(sign, -value, value);
+			const auto complement = x > static_cast<T>(1); // keep arg between 0 and 1
+			x = select(complement, static_cast<T>(1) / x, x);
+			const auto region = x > tanPiOver12; // reduce arg to under tan(pi/12)
+			x = select(region, (x - tanPiOver6) / (static_cast<T>(1) + tanPiOver6 * x), x);
+
+			auto y = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				y = atan_helperf(x);
+			}
+			else {
+				y = atan_helper(x);
+			}
+			y = select(region, y + Constants<T>::piOver6, y);
+			y = select(complement, Constants<T>::piOver2 - y, y);
+			return select(sign, -y, y);
+		}
+
+		/// @brief Branch-free `tanh`, for the batch functions to vectorize
+		///
+		/// @param value - The value to calculate the hyperbolic tangent of
+		/// @return - The hyperbolic tangent of the value
+		[[nodiscard]] static constexpr inline auto tanh_lane(FloatingPoint auto value) noexcept
+			-> decltype(value) {
+			using T = decltype(value);
+			using detail::select;
+			// tanh(-x) = -tanh(x)
+			const auto negative = value < static_cast<T>(0);
+			const auto x = select(negative, -value, value);
+			auto y = static_cast<T>(0);
+			if constexpr(std::is_same_v<T, float>) {
+				y = tanh_helperf(x);
 			}
 			else {
-				return (-0.67436811832e-5
-						+ (0.2468149110712040
-						   + (0.0583691066395175 + 0.03357335044280075 * angle) * angle)
-							  * angle)
-					   / (0.2464845986383725
-						  + (0.0609347197060491
-							 + (0.1086202599228572 + 0.02874707922475963 * angle) * angle)
-								* angle);
+				y = tanh_helper(x);
 			}
+			return select(negative, -y, y);
 		}
 	};
 } // namespace math
@@ -6,6 +6,7 @@
 #include "../utils/Concepts.h"
 #include "General.h"
 #include "Random.h"
+#include "Sampling.h"
 
 namespace math {
 	using gsl::narrow_cast;
@@ -143,12 +144,8 @@ namespace math {
 
 		template<FloatingPoint TT = float>
 		[[nodiscard]] inline static constexpr auto random_in_unit_circle() noexcept -> Vec2<TT> {
-			do {
-				auto val = random(narrow_cast<TT>(-1), narrow_cast<TT>(1));
-				if(val.magnitude_squared() < narrow_cast<TT>(1)) {
-					return val;
-				}
-			} while(true);
+			const auto point = Sampling::unit_disk(random_value<TT>(), random_value<TT>());
+			return {point.m_x, point.m_y};
 		}
 
 		constexpr auto operator=(const Vec2& vec) noexcept -> Vec2& = default;
@@ -2,10 +2,13 @@
 
 #include <gsl/gsl>
 #include <iostream>
+#include <type_traits>
 
 #include "../utils/Concepts.h"
 #include "General.h"
 #include "Random.h"
+#include "Sampling.h"
+#include "Simd.h"
 
 namespace math {
 	using gsl::narrow_cast;
@@ -19,6 +22,12 @@ namespace math {
 		Z
 	};
 
+	/// @brief A three-dimensional vector.
+	/// When a SIMD backend is available (see `Simd.h`), `Vec3<float>` is stored padded to four
+	/// 16-byte aligned lanes and its arithmetic runs through the SIMD kernels. Constant evaluation
+	/// always takes the scalar path, so every operation remains usable in `constexpr` contexts
+	///
+	/// @tparam T - The numeric type of the components
 	template<SignedNumeric T = float>
 	class Vec3 {
 	  public:
@@ -93,6 +102,11 @@ namespace math {
 		/// @return The dot product
 		template<FloatingPoint TT = float>
 		[[nodiscard]] inline constexpr auto dot_prod(const Vec3<TT>& vec) const noexcept -> TT {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					return simd::dot3(elements, vec.elements);
+				}
+			}
 			return narrow_cast<TT>(x()) * vec.x() + narrow_cast<TT>(y()) * vec.y()
 				   + narrow_cast<TT>(z()) * vec.z();
 		}
@@ -116,6 +130,13 @@ namespace math {
 		template<FloatingPoint TT = float>
 		[[nodiscard]] inline constexpr auto
 		cross_prod(const Vec3<TT>& vec) const noexcept -> Vec3<TT> {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::cross3(elements, vec.elements, result.elements);
+					return result;
+				}
+			}
 			const auto _x = narrow_cast<TT>(y()) * vec.z() - narrow_cast<TT>(z()) * vec.y();
 			const auto _y = narrow_cast<TT>(z()) * vec.x() - narrow_cast<TT>(x()) * vec.z();
 			const auto _z = narrow_cast<TT>(x()) * vec.y() - narrow_cast<TT>(y()) * vec.x();
@@ -152,6 +173,42 @@ namespace math {
 			return std::move(*this / magnitude<TT>());
 		}
 
+		/// @brief Returns the component-wise minimum of this and `vec`
+		///
+		/// @param vec - The vector to take the minimum with
+		///
+		/// @return The component-wise minimum
+		[[nodiscard]] inline constexpr auto min(const Vec3& vec) const noexcept -> Vec3 {
+			if constexpr(USE_SIMD) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::min(elements, vec.elements, result.elements);
+					return result;
+				}
+			}
+			return {General::min(x(), vec.x()),
+					General::min(y(), vec.y()),
+					General::min(z(), vec.z())};
+		}
+
+		/// @brief Returns the component-wise maximum of this and `vec`
+		///
+		/// @param vec - The vector to take the maximum with
+		///
+		/// @return The component-wise maximum
+		[[nodiscard]] inline constexpr auto max(const Vec3& vec) const noexcept -> Vec3 {
+			if constexpr(USE_SIMD) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::max(elements, vec.elements, result.elements);
+					return result;
+				}
+			}
+			return {General::max(x(), vec.x()),
+					General::max(y(), vec.y()),
+					General::max(z(), vec.z())};
+		}
+
 		template<SignedNumeric TT = float>
 		[[nodiscard]] inline static constexpr auto random() noexcept -> Vec3<TT> {
 			return {random_value<TT>(), random_value<TT>(), random_value<TT>()};
@@ -164,25 +221,32 @@ namespace math {
 					random_value<TT>(min, max)};
 		}
 
+		/// @brief Returns a uniformly distributed random point in the unit sphere
+		///
+		/// @return The point
 		template<FloatingPoint TT = float>
 		[[nodiscard]] inline static constexpr auto random_in_unit_sphere() noexcept -> Vec3<TT> {
-			do {
-				auto val = random<TT>(narrow_cast<TT>(-1), narrow_cast<TT>(1));
-				if(narrow_cast<TT>(val.magnitude_squared()) < narrow_cast<TT>(1)) {
-					return val;
-				}
-			} while(true);
+			const auto point
+				= Sampling::unit_ball(random_value<TT>(), random_value<TT>(), random_value<TT>());
+			return {point.m_x, point.m_y, point.m_z};
 		}
 
+		/// @brief Returns a uniformly distributed random unit vector
+		///
+		/// @return The unit vector
+		template<FloatingPoint TT = float>
+		[[nodiscard]] inline static constexpr auto random_unit_vector() noexcept -> Vec3<TT> {
+			const auto point = Sampling::unit_vector(random_value<TT>(), random_value<TT>());
+			return {point.m_x, point.m_y, point.m_z};
+		}
+
+		/// @brief Returns a uniformly distributed random point in the unit disk in the xy plane
+		///
+		/// @return The point
 		template<FloatingPoint TT = float>
 		[[nodiscard]] inline static constexpr auto random_in_unit_disk() noexcept -> Vec3<TT> {
-			do {
-				auto val = random(narrow_cast<TT>(-1), narrow_cast<TT>(1));
-				val.z() = narrow_cast<TT>(0);
-				if(narrow_cast<TT>(val.magnitude_squared()) < narrow_cast<TT>(1)) {
-					return val;
-				}
-			} while(true);
+			const auto point = Sampling::unit_disk(random_value<TT>(), random_value<TT>());
+			return {point.m_x, point.m_y, narrow_cast<TT>(0)};
 		}
 
 		[[nodiscard]] inline constexpr auto is_approx_zero() noexcept -> bool {
@@ -247,6 +311,13 @@ namespace math {
 		}
 
 		inline constexpr auto operator-() const noexcept -> Vec3 {
+			if constexpr(USE_SIMD) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::negate(elements, result.elements);
+					return result;
+				}
+			}
 			return {-x(), -y(), -z()};
 		}
 
@@ -261,6 +332,13 @@ namespace math {
 
 		template<FloatingPoint TT = float>
 		inline constexpr auto operator+(const Vec3<TT>& vec) const noexcept -> Vec3<TT> {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::add(elements, vec.elements, result.elements);
+					return result;
+				}
+			}
 			return {narrow_cast<TT>(x()) + vec.x(),
 					narrow_cast<TT>(y()) + vec.y(),
 					narrow_cast<TT>(z()) + vec.z()};
@@ -275,6 +353,12 @@ namespace math {
 
 		template<SignedNumeric TT = T>
 		inline constexpr auto operator+=(const Vec3<TT>& vec) noexcept -> Vec3 {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					simd::add(elements, vec.elements, elements);
+					return *this;
+				}
+			}
 			x() += narrow_cast<T>(vec.x());
 			y() += narrow_cast<T>(vec.y());
 			z() += narrow_cast<T>(vec.z());
@@ -283,6 +367,13 @@ namespace math {
 
 		template<FloatingPoint TT = float>
 		inline constexpr auto operator-(const Vec3<TT>& vec) const noexcept -> Vec3<TT> {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::subtract(elements, vec.elements, result.elements);
+					return result;
+				}
+			}
 			return {narrow_cast<TT>(x()) - vec.x(),
 					narrow_cast<TT>(y()) - vec.y(),
 					narrow_cast<TT>(z()) - vec.z()};
@@ -297,6 +388,12 @@ namespace math {
 
 		template<SignedNumeric TT = T>
 		inline constexpr auto operator-=(const Vec3<TT>& vec) noexcept -> Vec3& {
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					simd::subtract(elements, vec.elements, elements);
+					return *this;
+				}
+			}
 			x() -= narrow_cast<T>(vec.x());
 			y() -= narrow_cast<T>(vec.y());
 			z() -= narrow_cast<T>(vec.z());
@@ -305,6 +402,13 @@ namespace math {
 
 		inline constexpr auto operator*(FloatingPoint auto s) const noexcept -> Vec3<decltype(s)> {
 			using TT = decltype(s);
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::scale(elements, s, result.elements);
+					return result;
+				}
+			}
 			return {narrow_cast<TT>(x()) * s, narrow_cast<TT>(y()) * s, narrow_cast<TT>(z()) * s};
 		}
 
@@ -325,6 +429,12 @@ namespace math {
 
 		inline constexpr auto operator*=(FloatingPoint auto s) noexcept -> Vec3& {
 			using TT = decltype(s);
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					simd::scale(elements, s, elements);
+					return *this;
+				}
+			}
 			x() = narrow_cast<T>(narrow_cast<TT>(x()) * s);
 			y() = narrow_cast<T>(narrow_cast<TT>(y()) * s);
 			z() = narrow_cast<T>(narrow_cast<TT>(z()) * s);
@@ -341,6 +451,13 @@ namespace math {
 
 		inline constexpr auto operator/(FloatingPoint auto s) const noexcept -> Vec3<decltype(s)> {
 			using TT = decltype(s);
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					auto result = Vec3();
+					simd::divide3(elements, s, result.elements);
+					return result;
+				}
+			}
 			return {narrow_cast<TT>(x()) / s, narrow_cast<TT>(y()) / s, narrow_cast<TT>(z()) / s};
 		}
 
@@ -361,6 +478,12 @@ namespace math {
 
 		inline constexpr auto operator/=(FloatingPoint auto s) noexcept -> Vec3& {
 			using TT = decltype(s);
+			if constexpr(use_simd_with<TT>()) {
+				if(!std::is_constant_evaluated()) {
+					simd::divide3(elements, s, elements);
+					return *this;
+				}
+			}
 			x() = narrow_cast<T>(narrow_cast<TT>(x()) / s);
 			y() = narrow_cast<T>(narrow_cast<TT>(y()) / s);
 			z() = narrow_cast<T>(narrow_cast<TT>(z()) / s);
@@ -381,14 +504,35 @@ namespace math {
 		}
 
 	  private:
+		template<SignedNumeric>
+		friend class Vec3;
+
+		/// Whether this is stored padded to, and operated on as, SIMD lanes
+		static constexpr bool USE_SIMD = simd::ENABLED && std::is_same_v<T, float>;
 		static constexpr size_t NUM_ELEMENTS = static_cast<size_t>(Vec3Idx::Z) + 1;
-		T elements[NUM_ELEMENTS] // NOLINT
+		static constexpr size_t NUM_LANES = USE_SIMD ? simd::LANES : NUM_ELEMENTS;
+		/// The padding lane, when present, is zero, and kept zero by every operation on finite
+		/// values (division divides it by one, see `simd::divide3`)
+		alignas(USE_SIMD ? sizeof(T) * NUM_LANES : alignof(T)) T elements[NUM_LANES] // NOLINT
 			= {narrow_cast<T>(0), narrow_cast<T>(0), narrow_cast<T>(0)};
 
+		/// @brief Returns whether operations between this and a `Vec3<TT>` use the SIMD kernels
+		///
+		/// @return Whether the SIMD kernels are used
+		template<typename TT>
+		[[nodiscard]] inline static constexpr auto use_simd_with() noexcept -> bool {
+			return USE_SIMD && std::is_same_v<TT, T>;
+		}
+
 		/// @brief Calculates the magnitude squared of this vector
 		///
 		/// @return The magnitude squared
 		[[nodiscard]] inline constexpr auto magnitude_squared() const noexcept -> T {
+			if constexpr(USE_SIMD) {
+				if(!std::is_constant_evaluated()) {
+					return simd::dot3(elements, elements);
+				}
+			}
 			return x() * x() + y() * y() + z() * z();
 		}
 
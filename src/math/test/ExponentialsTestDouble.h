@@ -4,6 +4,8 @@
 	#include <cmath>
 #endif
 
+#include <vector>
+
 #include "../../test/TestConstants.h"
 #include "../Exponentials.h"
 #include "gtest/gtest.h"
@@ -192,4 +194,33 @@ namespace math::test {
 					std::pow(base, exponent),
 					DOUBLE_ACCEPTED_ERROR); // close enough
 	}
+
+	TEST(ExponentialsTestDouble, batchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<double>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = -15.0 + 0.3 * static_cast<double>(i);
+		}
+		auto outputs = std::vector<double>(inputs.size());
+
+		Exponentials::exp<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Exponentials::exp(inputs[i]));
+		}
+
+		for(auto& input : inputs) {
+			input = input + 15.1;
+		}
+		Exponentials::ln<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Exponentials::ln(inputs[i]));
+		}
+		// both integral and fractional exponents
+		for(const auto exponent : {2.0, -3.0, 0.5, 1.0 / 2.2}) {
+			Exponentials::pow<double>(inputs, exponent, outputs);
+			for(auto i = 0ULL; i < inputs.size(); ++i) {
+				ASSERT_DOUBLE_EQ(outputs[i], Exponentials::pow(inputs[i], exponent));
+			}
+		}
+	}
 } // namespace math::test
@@ -4,6 +4,8 @@
 	#include <cmath>
 #endif
 
+#include <vector>
+
 #include "../../test/TestConstants.h"
 #include "../Exponentials.h"
 #include "gtest/gtest.h"
@@ -200,4 +202,33 @@ namespace math::test {
 					std::pow(base, exponent),
 					FLOAT_ACCEPTED_ERROR + 0.0001); // close enough
 	}
+
+	TEST(ExponentialsTestFloat, batchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<float>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = -15.0F + 0.3F * static_cast<float>(i);
+		}
+		auto outputs = std::vector<float>(inputs.size());
+
+		Exponentials::exp<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Exponentials::exp(inputs[i]));
+		}
+
+		for(auto& input : inputs) {
+			input = input + 15.1F;
+		}
+		Exponentials::ln<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Exponentials::ln(inputs[i]));
+		}
+		// both integral and fractional exponents
+		for(const auto exponent : {2.0F, -3.0F, 0.5F, 1.0F / 2.2F}) {
+			Exponentials::pow<float>(inputs, exponent, outputs);
+			for(auto i = 0ULL; i < inputs.size(); ++i) {
+				ASSERT_FLOAT_EQ(outputs[i], Exponentials::pow(inputs[i], exponent));
+			}
+		}
+	}
 } // namespace math::test
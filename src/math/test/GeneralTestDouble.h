@@ -5,6 +5,7 @@
 #endif
 
 #include <limits>
+#include <vector>
 
 #include "../../test/TestConstants.h"
 #include "../General.h"
@@ -150,4 +151,18 @@ namespace math::test {
 		double input = -1.5;
 		ASSERT_EQ(General::roundU(input), std::numeric_limits<size_t>::max());
 	}
+
+	TEST(GeneralTestDouble, sqrtBatchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<double>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = 0.37 * static_cast<double>(i * i);
+		}
+		auto outputs = std::vector<double>(inputs.size());
+
+		General::sqrt<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], General::sqrt(inputs[i]));
+		}
+	}
 } // namespace math::test
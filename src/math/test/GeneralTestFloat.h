@@ -5,6 +5,7 @@
 #endif
 
 #include <limits>
+#include <vector>
 
 #include "../../test/TestConstants.h"
 #include "../General.h"
@@ -150,4 +151,18 @@ namespace math::test {
 		float input = -1.5F;
 		ASSERT_EQ(General::roundU(input), std::numeric_limits<size_t>::max());
 	}
+
+	TEST(GeneralTestFloat, sqrtBatchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<float>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = 0.37F * static_cast<float>(i * i);
+		}
+		auto outputs = std::vector<float>(inputs.size());
+
+		General::sqrt<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], General::sqrt(inputs[i]));
+		}
+	}
 } // namespace math::test
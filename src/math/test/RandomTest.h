@@ -0,0 +1,69 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../../test/TestConstants.h"
+#include "../Random.h"
+
+namespace math::test {
+
+	TEST(RandomTest, permutedCongruentialEngineReferenceSequence) {
+		// first outputs of the PCG reference implementation's pcg32-demo, seeded with (42, 54)
+		auto engine = PermutedCongruentialEngine(42ULL, 54ULL);
+		ASSERT_EQ(engine(), 0xA15C02B7U);
+		ASSERT_EQ(engine(), 0x7B47F409U);
+		ASSERT_EQ(engine(), 0xBA1D3330U);
+		ASSERT_EQ(engine(), 0x83D2F293U);
+		ASSERT_EQ(engine(), 0xBFA4784BU);
+		ASSERT_EQ(engine(), 0xCBED606EU);
+	}
+
+	TEST(RandomTest, permutedCongruentialEngineAdvance) {
+		auto stepped = PermutedCongruentialEngine(7ULL, 3ULL);
+		auto advanced = stepped;
+		for(auto i = 0; i < 1000; ++i) {
+			std::ignore = stepped();
+		}
+		advanced.advance(1000ULL);
+		ASSERT_EQ(stepped(), advanced());
+	}
+
+	TEST(RandomTest, permutedCongruentialEngineStreamsDiffer) {
+		auto first = PermutedCongruentialEngine(7ULL, 0ULL);
+		auto second = PermutedCongruentialEngine(7ULL, 1ULL);
+		auto num_equal = 0;
+		for(auto i = 0; i < 100; ++i) {
+			num_equal += first() == second() ? 1 : 0;
+		}
+		ASSERT_LT(num_equal, 2);
+	}
+
+	TEST(RandomTest, randomValueReproducible) {
+		seed_random(1234ULL, 5ULL);
+		const auto first = random_value<float>();
+		const auto second = random_value<double>();
+		seed_random(1234ULL, 5ULL);
+		ASSERT_EQ(random_value<float>(), first);
+		ASSERT_EQ(random_value<double>(), second);
+	}
+
+	TEST(RandomTest, randomValueInRange) {
+		seed_random(99ULL);
+		auto sum = 0.0;
+		for(auto i = 0; i < 10000; ++i) {
+			const auto value = random_value<float>();
+			ASSERT_GE(value, 0.0F);
+			ASSERT_LT(value, 1.0F);
+			sum += static_cast<double>(value);
+
+			const auto ranged = random_value(-2.0, 3.0);
+			ASSERT_GE(ranged, -2.0);
+			ASSERT_LT(ranged, 3.0);
+
+			const auto integral = random_value(-3, 4);
+			ASSERT_GE(integral, -3);
+			ASSERT_LT(integral, 4);
+		}
+		ASSERT_NEAR(sum / 10000.0, 0.5, 0.02);
+	}
+} // namespace math::test
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../Random.h"
+#include "../Sampler.h"
+
+namespace math::test {
+
+	/// @brief Returns whether the first `num_samples` values of `dimension` of `pixel` fall one
+	/// per stratum when [0, 1) is split into `num_samples` equal strata
+	inline auto sampler_test_is_stratified(const Sampler<float>& sampler,
+										   size_t pixel,
+										   size_t dimension,
+										   size_t num_samples) noexcept -> bool {
+		auto strata = std::vector<bool>(num_samples, false);
+		for(auto index = 0ULL; index < num_samples; ++index) {
+			const auto value = sampler.sample(pixel, index, dimension);
+			const auto stratum = static_cast<size_t>(value * static_cast<float>(num_samples));
+			if(value < 0.0F || value >= 1.0F || strata[stratum]) {
+				return false;
+			}
+			strata[stratum] = true;
+		}
+		return true;
+	}
+
+	/// @brief Returns the RMS error, over `num_pixels` pixels, of estimating the integral of
+	/// x * y over [0, 1)^2 with `num_samples` samples drawn by `sample`
+	template<typename SampleFunction>
+	inline auto sampler_test_integration_error(size_t num_pixels,
+											   size_t num_samples,
+											   SampleFunction sample) noexcept -> double {
+		auto squared_error = 0.0;
+		for(auto pixel = 0ULL; pixel < num_pixels; ++pixel) {
+			auto sum = 0.0;
+			for(auto index = 0ULL; index < num_samples; ++index) {
+				const auto point = sample(pixel, index);
+				sum += static_cast<double>(point.x()) * static_cast<double>(point.y());
+			}
+			const auto error = sum / static_cast<double>(num_samples) - 0.25;
+			squared_error += error * error;
+		}
+		return std::sqrt(squared_error / static_cast<double>(num_pixels));
+	}
+
+	TEST(SamplerTest, valuesInRangeAndDeterministic) {
+		const auto stratified = StratifiedSampler<double>(7ULL, 3ULL);
+		const auto halton = HaltonSampler<double>(3ULL);
+		const auto sobol = SobolSampler<double>(3ULL);
+		const auto samplers = std::vector<const Sampler<double>*>{&stratified, &halton, &sobol};
+
+		for(const auto* sampler : samplers) {
+			for(auto pixel = 0ULL; pixel < 4ULL; ++pixel) {
+				for(auto index = 0ULL; index < 64ULL; ++index) {
+					for(auto dimension = 0ULL; dimension < 40ULL; ++dimension) {
+						const auto value = sampler->sample(pixel, index, dimension);
+						ASSERT_GE(value, 0.0);
+						ASSERT_LT(value, 1.0);
+						ASSERT_EQ(value, sampler->sample(pixel, index, dimension));
+					}
+				}
+			}
+		}
+	}
+
+	TEST(SamplerTest, pixelsAreDecorrelated) {
+		const auto sobol = SobolSampler<float>();
+		const auto halton = HaltonSampler<float>();
+		auto num_equal = 0;
+		for(auto index = 0ULL; index < 16ULL; ++index) {
+			num_equal += sobol.sample(0ULL, index, 0ULL) == sobol.sample(1ULL, index, 0ULL) ? 1 : 0;
+			num_equal
+				+= halton.sample(0ULL, index, 0ULL) == halton.sample(1ULL, index, 0ULL) ? 1 : 0;
+		}
+		ASSERT_LT(num_equal, 2);
+	}
+
+	TEST(SamplerTest, sobolReferenceSequence) {
+		// dimensions 0 and 1 of the unscrambled Sobol sequence
+		constexpr auto half = 0x80000000U;
+		constexpr auto quarter = 0x40000000U;
+		ASSERT_EQ(SobolSampler<float>::sobol(0U, 0ULL), 0U);
+		ASSERT_EQ(SobolSampler<float>::sobol(1U, 0ULL), half);
+		ASSERT_EQ(SobolSampler<float>::sobol(2U, 0ULL), quarter);
+		ASSERT_EQ(SobolSampler<float>::sobol(3U, 0ULL), half + quarter);
+		ASSERT_EQ(SobolSampler<float>::sobol(1U, 1ULL), half);
+		ASSERT_EQ(SobolSampler<float>::sobol(2U, 1ULL), half + quarter);
+		ASSERT_EQ(SobolSampler<float>::sobol(3U, 1ULL), quarter);
+	}
+
+	TEST(SamplerTest, stratifiedSamplerStratifies) {
+		const auto sampler = StratifiedSampler<float>(24ULL, 11ULL);
+		for(auto pixel = 0ULL; pixel < 8ULL; ++pixel) {
+			for(auto dimension = 0ULL; dimension < 6ULL; ++dimension) {
+				ASSERT_TRUE(sampler_test_is_stratified(sampler, pixel, dimension, 24ULL));
+			}
+		}
+	}
+
+	TEST(SamplerTest, haltonSamplerStratifies) {
+		const auto sampler = HaltonSampler<float>(5ULL);
+		for(auto pixel = 0ULL; pixel < 8ULL; ++pixel) {
+			ASSERT_TRUE(sampler_test_is_stratified(sampler, pixel, 0ULL, 64ULL));
+			ASSERT_TRUE(sampler_test_is_stratified(sampler, pixel, 1ULL, 81ULL));
+			ASSERT_TRUE(sampler_test_is_stratified(sampler, pixel, 2ULL, 25ULL));
+		}
+	}
+
+	TEST(SamplerTest, sobolSamplerIsNet) {
+		// Owen scrambling preserves the (0, 2)-net property of power-of-two prefixes: with 16
+		// points, every 1x16, 2x8, 4x4, 8x2, and 16x1 grid cell holds exactly one point
+		const auto sampler = SobolSampler<float>(9ULL);
+		constexpr auto num_samples = 16ULL;
+		for(auto pixel = 0ULL; pixel < 8ULL; ++pixel) {
+			for(auto dimension = 0ULL; dimension < 12ULL; dimension += 2) {
+				for(auto columns = 1ULL; columns <= num_samples; columns *= 2) {
+					const auto rows = num_samples / columns;
+					auto cells = std::vector<bool>(num_samples, false);
+					for(auto index = 0ULL; index < num_samples; ++index) {
+						const auto point = sampler.sample_2d(pixel, index, dimension);
+						const auto cell
+							= static_cast<size_t>(point.x() * static_cast<float>(columns)) * rows
+							  + static_cast<size_t>(point.y() * static_cast<float>(rows));
+						ASSERT_FALSE(cells[cell]);
+						cells[cell] = true;
+					}
+				}
+			}
+		}
+	}
+
+	TEST(SamplerTest, lowDiscrepancyConvergesFaster) {
+		constexpr auto num_pixels = 64ULL;
+		constexpr auto num_samples = 64ULL;
+		const auto sobol = SobolSampler<float>();
+		const auto halton = HaltonSampler<float>();
+		const auto stratified = StratifiedSampler<float>(num_samples);
+
+		seed_random(17ULL);
+		const auto random_error
+			= sampler_test_integration_error(num_pixels, num_samples, [](size_t, size_t) {
+				  return Point2<float>(random_value<float>(), random_value<float>());
+			  });
+		const auto error_of = [&](const Sampler<float>& sampler) {
+			return sampler_test_integration_error(
+				num_pixels,
+				num_samples,
+				[&sampler](size_t pixel, size_t index) {
+					return sampler.sample_2d(pixel, index, 2ULL);
+				});
+		};
+
+		ASSERT_LT(error_of(sobol), random_error / 8.0);
+		ASSERT_LT(error_of(halton), random_error / 3.0);
+		ASSERT_LT(error_of(stratified), random_error / 1.5);
+	}
+} // namespace math::test
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../../test/TestConstants.h"
+#include "../Sampling.h"
+#include "../Vec3.h"
+
+namespace math::test {
+	using ::test::DOUBLE_ACCEPTED_ERROR;
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	/// @brief Returns `count` samples spread evenly over [0, 1), in a shuffled order
+	template<FloatingPoint T>
+	inline auto sampling_test_samples(size_t count, size_t stride) noexcept -> std::vector<T> {
+		auto samples = std::vector<T>(count);
+		for(auto i = 0ULL; i < count; ++i) {
+			samples[i] = (static_cast<T>((i * stride) % count) + static_cast<T>(0.5))
+						 / static_cast<T>(count);
+		}
+		return samples;
+	}
+
+	/// @brief Returns the center of cell `index` of a 64-cell grid over [0, 1)
+	inline auto sampling_test_grid(size_t index) noexcept -> double {
+		return (static_cast<double>(index) + 0.5) / 64.0;
+	}
+
+	TEST(SamplingTest, unitDiskIsUniform) {
+		// 64x64 evenly spaced samples: a quarter of the disk's area is within radius 0.5
+		constexpr auto resolution = 64ULL;
+		auto num_inner = 0ULL;
+		for(auto i = 0ULL; i < resolution; ++i) {
+			for(auto j = 0ULL; j < resolution; ++j) {
+				const auto point = Sampling::unit_disk(static_cast<float>(sampling_test_grid(i)),
+													   static_cast<float>(sampling_test_grid(j)));
+				const auto radius_squared = point.m_x * point.m_x + point.m_y * point.m_y;
+				ASSERT_LE(radius_squared, 1.0F + FLOAT_ACCEPTED_ERROR);
+				num_inner += radius_squared < 0.25F ? 1ULL : 0ULL;
+			}
+		}
+		ASSERT_NEAR(static_cast<double>(num_inner) / (resolution * resolution), 0.25, 0.01);
+
+		const auto center = Sampling::unit_disk(0.5, 0.5);
+		ASSERT_DOUBLE_EQ(center.m_x, 0.0);
+		ASSERT_DOUBLE_EQ(center.m_y, 0.0);
+	}
+
+	TEST(SamplingTest, unitVectorIsUniform) {
+		constexpr auto count = 4096ULL;
+		auto mean_z = 0.0;
+		auto mean_z_squared = 0.0;
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto vec = Sampling::unit_vector(sampling_test_grid(i % 64ULL),
+												   sampling_test_grid(i / 64ULL));
+			ASSERT_NEAR(vec.m_x * vec.m_x + vec.m_y * vec.m_y + vec.m_z * vec.m_z,
+						1.0,
+						DOUBLE_ACCEPTED_ERROR);
+			mean_z += vec.m_z / count;
+			mean_z_squared += vec.m_z * vec.m_z / count;
+		}
+		ASSERT_NEAR(mean_z, 0.0, 0.01);
+		ASSERT_NEAR(mean_z_squared, 1.0 / 3.0, 0.01);
+	}
+
+	TEST(SamplingTest, unitBallRadius) {
+		// the radius of a point in the ball is the cube root of the third sample
+		for(auto i = 0ULL; i < 1000ULL; ++i) {
+			const auto w = (static_cast<double>(i) + 0.5) / 1000.0;
+			const auto point = Sampling::unit_ball(0.3, 0.8, w);
+			const auto radius = std::sqrt(point.m_x * point.m_x + point.m_y * point.m_y
+										  + point.m_z * point.m_z);
+			ASSERT_NEAR(radius, std::cbrt(w), DOUBLE_ACCEPTED_ERROR);
+
+			const auto point_float = Sampling::unit_ball(0.3F, 0.8F, static_cast<float>(w));
+			const auto radius_float
+				= std::sqrt(point_float.m_x * point_float.m_x + point_float.m_y * point_float.m_y
+							+ point_float.m_z * point_float.m_z);
+			ASSERT_NEAR(radius_float, std::cbrt(static_cast<float>(w)), FLOAT_ACCEPTED_ERROR);
+		}
+	}
+
+	TEST(SamplingTest, cosineHemisphereIsCosineWeighted) {
+		constexpr auto count = 4096ULL;
+		auto mean_z = 0.0;
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto dir = Sampling::cosine_hemisphere(sampling_test_grid(i % 64ULL),
+														 sampling_test_grid(i / 64ULL));
+			ASSERT_GE(dir.m_z, 0.0);
+			ASSERT_NEAR(dir.m_x * dir.m_x + dir.m_y * dir.m_y + dir.m_z * dir.m_z,
+						1.0,
+						DOUBLE_ACCEPTED_ERROR);
+			mean_z += dir.m_z / count;
+		}
+		// E[cos(theta)] under a cosine-weighted distribution is 2 / 3
+		ASSERT_NEAR(mean_z, 2.0 / 3.0, 0.01);
+	}
+
+	TEST(SamplingTest, batchMatchesScalar) {
+		// an odd count exercises both the SIMD lanes and the remainder
+		constexpr auto count = 103ULL;
+		const auto u = sampling_test_samples<float>(count, 1ULL);
+		const auto v = sampling_test_samples<float>(count, 37ULL);
+		const auto w = sampling_test_samples<float>(count, 59ULL);
+		auto x = std::vector<float>(count);
+		auto y = std::vector<float>(count);
+		auto z = std::vector<float>(count);
+
+		Sampling::unit_disk<float>(u, v, x, y);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto point = Sampling::unit_disk(u[i], v[i]);
+			ASSERT_NEAR(x[i], point.m_x, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(y[i], point.m_y, FLOAT_ACCEPTED_ERROR);
+		}
+
+		Sampling::unit_vector<float>(u, v, x, y, z);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto point = Sampling::unit_vector(u[i], v[i]);
+			ASSERT_NEAR(x[i], point.m_x, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(y[i], point.m_y, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(z[i], point.m_z, FLOAT_ACCEPTED_ERROR);
+		}
+
+		Sampling::unit_ball<float>(u, v, w, x, y, z);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto point = Sampling::unit_ball(u[i], v[i], w[i]);
+			ASSERT_NEAR(x[i], point.m_x, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(y[i], point.m_y, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(z[i], point.m_z, FLOAT_ACCEPTED_ERROR);
+		}
+
+		Sampling::cosine_hemisphere<float>(u, v, x, y, z);
+		for(auto i = 0ULL; i < count; ++i) {
+			const auto point = Sampling::cosine_hemisphere(u[i], v[i]);
+			ASSERT_NEAR(x[i], point.m_x, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(y[i], point.m_y, FLOAT_ACCEPTED_ERROR);
+			ASSERT_NEAR(z[i], point.m_z, FLOAT_ACCEPTED_ERROR);
+		}
+	}
+
+	TEST(SamplingTest, vec3RandomSamples) {
+		seed_random(3ULL);
+		for(auto i = 0; i < 1000; ++i) {
+			const auto in_sphere = Vec3<double>::random_in_unit_sphere<double>();
+			ASSERT_LT(in_sphere.dot_prod(in_sphere), 1.0 + DOUBLE_ACCEPTED_ERROR);
+			const auto unit = Vec3<double>::random_unit_vector<double>();
+			ASSERT_NEAR(unit.dot_prod(unit), 1.0, DOUBLE_ACCEPTED_ERROR);
+			const auto disk = Vec3<float>::random_in_unit_disk<float>();
+			ASSERT_LT(disk.dot_prod(disk), 1.0F + FLOAT_ACCEPTED_ERROR);
+			ASSERT_EQ(disk.z(), 0.0F);
+		}
+	}
+} // namespace math::test
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "../../test/TestConstants.h"
+#include "../Transform.h"
+
+namespace math::test {
+	using ::test::FLOAT_ACCEPTED_ERROR;
+
+	inline auto transform_test_expect_near(const Point3<float>& actual,
+										   const Point3<float>& expected) noexcept -> void {
+		ASSERT_NEAR(actual.x(), expected.x(), FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(actual.y(), expected.y(), FLOAT_ACCEPTED_ERROR);
+		ASSERT_NEAR(actual.z(), expected.z(), FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(TransformTest, identity) {
+		const auto point = Point3(1.0F, -2.0F, 3.0F);
+		ASSERT_EQ(Transform<float>().transform_point(point).x(), 1.0F);
+		ASSERT_EQ(Transform<float>().transform_point(point).y(), -2.0F);
+		ASSERT_EQ(Transform<float>().transform_point(point).z(), 3.0F);
+		ASSERT_FLOAT_EQ(Transform<float>().determinant(), 1.0F);
+	}
+
+	TEST(TransformTest, composesRightToLeft) {
+		const auto translate = Transform<float>::translation(Vec3(1.0F, 0.0F, 0.0F));
+		const auto scale = Transform<float>::scaling(Vec3(2.0F, 2.0F, 2.0F));
+		const auto point = Point3(1.0F, 1.0F, 1.0F);
+
+		// scaled first, then translated
+		transform_test_expect_near((translate * scale).transform_point(point), {3.0F, 2.0F, 2.0F});
+		transform_test_expect_near((scale * translate).transform_point(point), {4.0F, 2.0F, 2.0F});
+		// directions aren't translated
+		const auto direction = (translate * scale).transform_vector(Vec3(0.0F, 1.0F, 0.0F));
+		ASSERT_FLOAT_EQ(direction.x(), 0.0F);
+		ASSERT_FLOAT_EQ(direction.y(), 2.0F);
+	}
+
+	TEST(TransformTest, rotation) {
+		const auto rotate
+			= Transform<float>::rotation(Vec3(0.0F, 0.0F, 2.0F), Constants<float>::pi / 2.0F);
+		transform_test_expect_near(rotate.transform_point(Point3(1.0F, 0.0F, 5.0F)),
+								   {0.0F, 1.0F, 5.0F});
+		ASSERT_NEAR(rotate.determinant(), 1.0F, FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(TransformTest, inverse) {
+		const auto transform
+			= Transform<float>::translation(Vec3(3.0F, -1.0F, 2.0F))
+			  * Transform<float>::rotation(Vec3(1.0F, 1.0F, 0.0F), 0.7F)
+			  * Transform<float>::scaling(Vec3(2.0F, 0.5F, 3.0F));
+		const auto inverse = transform.inverse();
+		const auto point = Point3(0.3F, -4.0F, 1.5F);
+
+		const auto there = transform.transform_point(point);
+		const auto back = inverse.transform_point(point);
+		transform_test_expect_near(inverse.transform_point(there), point);
+		transform_test_expect_near(transform.transform_point(back), point);
+		ASSERT_NEAR(transform.determinant() * inverse.determinant(), 1.0F, FLOAT_ACCEPTED_ERROR);
+	}
+
+	TEST(TransformTest, normalsStayPerpendicular) {
+		// a non-uniform scale and shear would tilt a normal transformed as a direction
+		auto transform = Transform<float>::scaling(Vec3(4.0F, 1.0F, 0.5F));
+		transform.at(0, 1) = 1.5F;
+		const auto tangent = Vec3(1.0F, -1.0F, 0.0F);
+		const auto normal = Vec3(1.0F, 1.0F, 0.0F);
+
+		const auto transformed_tangent = transform.transform_vector(tangent);
+		const auto transformed_normal = transform.inverse().transform_normal(normal);
+		ASSERT_NEAR(transformed_tangent.dot_prod(transformed_normal), 0.0F, FLOAT_ACCEPTED_ERROR);
+		ASSERT_GT(transform.transform_vector(normal).dot_prod(transformed_tangent), 0.1F);
+	}
+} // namespace math::test
@@ -4,6 +4,8 @@
 	#include <cmath>
 #endif
 
+#include <vector>
+
 #include "../../test/TestConstants.h"
 #include "../TrigFuncs.h"
 #include "gtest/gtest.h"
@@ -110,4 +112,37 @@ namespace math::test {
 		double input = -Constants<double>::piOver4;
 		ASSERT_NEAR(Trig::tanh(input), std::tanh(input), DOUBLE_ACCEPTED_ERROR);
 	}
+
+	TEST(TrigFuncsTestDouble, batchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<double>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = -10.0 + 0.2 * static_cast<double>(i);
+		}
+		auto outputs = std::vector<double>(inputs.size());
+
+		Trig::cos<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Trig::cos(inputs[i]));
+		}
+		Trig::sin<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Trig::sin(inputs[i]));
+		}
+		Trig::tan<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Trig::tan(inputs[i]));
+		}
+		Trig::atan<double>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(outputs[i], Trig::atan(inputs[i]));
+		}
+
+		// in place
+		auto values = inputs;
+		Trig::tanh<double>(values, values);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_DOUBLE_EQ(values[i], Trig::tanh(inputs[i]));
+		}
+	}
 } // namespace math::test
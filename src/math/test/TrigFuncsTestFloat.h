@@ -4,6 +4,8 @@
 	#include <cmath>
 #endif
 
+#include <vector>
+
 #include "../../test/TestConstants.h"
 #include "../TrigFuncs.h"
 #include "gtest/gtest.h"
@@ -110,4 +112,37 @@ namespace math::test {
 		float input = -Constants<>::piOver4;
 		ASSERT_NEAR(Trig::tanh(input), std::tanh(input), FLOAT_ACCEPTED_ERROR);
 	}
+
+	TEST(TrigFuncsTestFloat, batchMatchesScalar) {
+		// an odd count, so the last block of lanes is a partial one
+		auto inputs = std::vector<float>(101);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			inputs[i] = -10.0F + 0.2F * static_cast<float>(i);
+		}
+		auto outputs = std::vector<float>(inputs.size());
+
+		Trig::cos<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Trig::cos(inputs[i]));
+		}
+		Trig::sin<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Trig::sin(inputs[i]));
+		}
+		Trig::tan<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Trig::tan(inputs[i]));
+		}
+		Trig::atan<float>(inputs, outputs);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(outputs[i], Trig::atan(inputs[i]));
+		}
+
+		// in place
+		auto values = inputs;
+		Trig::tanh<float>(values, values);
+		for(auto i = 0ULL; i < inputs.size(); ++i) {
+			ASSERT_FLOAT_EQ(values[i], Trig::tanh(inputs[i]));
+		}
+	}
 } // namespace math::test
@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstring>
+
 #include "../../test/TestConstants.h"
 #include "../Vec3.h"
 
@@ -147,4 +150,66 @@ namespace math::test {
 		vec /= 2.5;
 		ASSERT_EQ(vec, Vec3(1, 2, 2));
 	}
+	TEST(Vec3Test, constexprEvaluation) {
+		constexpr auto sum = Vec3(1.0F, 2.0F, 3.0F) + Vec3(1.0F, 1.0F, 1.0F) * 2.0F;
+		static_assert(sum.x() == 3.0F && sum.y() == 4.0F && sum.z() == 5.0F);
+		constexpr auto cross = Vec3(1.0F, 0.0F, 0.0F).cross_prod(Vec3(0.0F, 1.0F, 0.0F));
+		static_assert(cross.z() == 1.0F);
+		constexpr auto dot = Vec3(1.0F, 2.0F, 3.0F).dot_prod(Vec3(4.0F, 5.0F, 6.0F));
+		static_assert(dot == 32.0F);
+		ASSERT_EQ(sum, Vec3<float>(3.0F, 4.0F, 5.0F));
+	}
+
+	TEST(Vec3Test, simdMatchesScalar) {
+		constexpr auto lhs = Vec3(3.5F, -8.4F, 10.2F);
+		constexpr auto rhs = Vec3(4.3F, 9.2F, -1.2F);
+		constexpr auto sum = lhs + rhs;
+		constexpr auto difference = lhs - rhs;
+		constexpr auto scaled = lhs * 2.5F;
+		constexpr auto divided = lhs / 2.5F;
+		constexpr auto negated = -lhs;
+		constexpr auto cross = lhs.cross_prod(rhs);
+		constexpr auto dot = lhs.dot_prod(rhs);
+		constexpr auto minimum = lhs.min(rhs);
+		constexpr auto maximum = lhs.max(rhs);
+		static_assert(minimum.x() == 3.5F && minimum.y() == -8.4F && minimum.z() == -1.2F);
+		static_assert(maximum.x() == 4.3F && maximum.y() == 9.2F && maximum.z() == 10.2F);
+
+		auto runtime_lhs = lhs;
+		const auto runtime_rhs = rhs;
+		ASSERT_EQ(runtime_lhs + runtime_rhs, sum);
+		ASSERT_EQ(runtime_lhs - runtime_rhs, difference);
+		ASSERT_EQ(runtime_lhs * 2.5F, scaled);
+		ASSERT_EQ(runtime_lhs / 2.5F, divided);
+		ASSERT_EQ(-runtime_lhs, negated);
+		ASSERT_EQ(runtime_lhs.cross_prod(runtime_rhs), cross);
+		ASSERT_FLOAT_EQ(runtime_lhs.dot_prod(runtime_rhs), dot);
+		ASSERT_EQ(runtime_lhs.min(runtime_rhs), minimum);
+		ASSERT_EQ(runtime_lhs.max(runtime_rhs), maximum);
+
+		runtime_lhs += runtime_rhs;
+		ASSERT_EQ(runtime_lhs, sum);
+		runtime_lhs -= runtime_rhs;
+		runtime_lhs *= 2.5F;
+		ASSERT_EQ(runtime_lhs, scaled);
+		runtime_lhs /= 2.5F;
+		ASSERT_EQ(runtime_lhs, lhs);
+	}
+
+	TEST(Vec3Test, divisionKeepsPaddingLaneZero) {
+		if constexpr(sizeof(Vec3<float>) != sizeof(std::array<float, 4>)) {
+			GTEST_SKIP();
+		}
+		else {
+			auto vec = Vec3(1.0F, 2.0F, 3.0F);
+			const auto divided = vec / 0.0F;
+			vec /= 0.0F;
+			// not `std::bit_cast`: this branch must still compile when `Vec3` has no padding lane
+			auto lanes = std::array<float, 4>();
+			std::memcpy(lanes.data(), &divided, sizeof(lanes));
+			ASSERT_EQ(lanes[3], 0.0F);
+			std::memcpy(lanes.data(), &vec, sizeof(lanes));
+			ASSERT_EQ(lanes[3], 0.0F);
+		}
+	}
 } // namespace math::test
@@ -1,12 +1,32 @@
+#include "../graphics/test/AccumulationBufferTest.h"
+#include "../graphics/test/BoundingVolumeHierarchyTest.h"
+#include "../graphics/test/DistributedRendererTest.h"
+#include "../graphics/test/ImageWriterTest.h"
+#include "../graphics/test/InstanceTest.h"
+#include "../graphics/test/MaterialTableTest.h"
+#include "../graphics/test/PathIntegratorTest.h"
+#include "../graphics/test/SceneFileTest.h"
+#include "../graphics/test/SphereSetTest.h"
+#include "../graphics/test/TileRendererTest.h"
+#include "../graphics/test/TriangleMeshTest.h"
+#include "../graphics/test/WavefrontIntegratorTest.h"
 #include "../math/test/ExponentialsTestDouble.h"
 #include "../math/test/ExponentialsTestFloat.h"
 #include "../math/test/GeneralTestDouble.h"
 #include "../math/test/GeneralTestFloat.h"
+#include "../math/test/RandomTest.h"
+#include "../math/test/SamplerTest.h"
+#include "../math/test/SamplingTest.h"
+#include "../math/test/TransformTest.h"
 #include "../math/test/TrigFuncsTestDouble.h"
 #include "../math/test/TrigFuncsTestFloat.h"
 #include "../math/test/Vec2Test.h"
 #include "../math/test/Vec3Test.h"
+#include "../utils/test/ConcurrentRingBufferTest.h"
+#include "../utils/test/InstrumentationTest.h"
 #include "../utils/test/RingBufferTest.h"
+#include "../utils/test/SocketTest.h"
+#include "../utils/test/StaticRingBufferTest.h"
 #include "gtest/gtest.h"
 
 auto main(int argc, char** argv) -> int {
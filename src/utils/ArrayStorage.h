@@ -0,0 +1,94 @@
+#pragma once
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace utils {
+	/// @brief A contiguous array that either owns its elements, or borrows them from memory owned
+	/// elsewhere, such as a memory-mapped file.
+	/// Borrowing lets large, immutable arrays (geometry, BVH nodes) be used in place, without
+	/// copying or parsing them. Borrowed elements are copied into owned storage the first time
+	/// mutable access is requested.
+	///
+	/// A borrowing `ArrayStorage` must not outlive the memory it borrows
+	///
+	/// @tparam T - The type of the elements. Must be trivially copyable, so that it can be borrowed
+	/// from raw memory
+	template<typename T>
+	requires std::is_trivially_copyable_v<T>
+	class ArrayStorage {
+	  public:
+		constexpr ArrayStorage() noexcept = default;
+
+		/// @brief Creates an `ArrayStorage` owning the given elements
+		///
+		/// @param elements - The elements to own
+		explicit ArrayStorage(std::vector<T>&& elements) noexcept
+			: m_owned(std::move(elements)) {
+		}
+
+		/// @brief Creates an `ArrayStorage` borrowing the given elements
+		///
+		/// @param elements - The elements to borrow
+		explicit constexpr ArrayStorage(std::span<const T> elements) noexcept
+			: m_borrowed(elements), m_is_borrowed(true) {
+		}
+		ArrayStorage(const ArrayStorage& storage) noexcept = default;
+		ArrayStorage(ArrayStorage&& storage) noexcept = default;
+		~ArrayStorage() noexcept = default;
+
+		/// @brief Returns whether the elements are borrowed
+		///
+		/// @return Whether the elements are borrowed
+		[[nodiscard]] inline constexpr auto is_borrowed() const noexcept -> bool {
+			return m_is_borrowed;
+		}
+
+		/// @brief Returns the elements
+		///
+		/// @return The elements
+		[[nodiscard]] inline constexpr auto span() const noexcept -> std::span<const T> {
+			return m_is_borrowed ? m_borrowed : std::span<const T>(m_owned);
+		}
+
+		/// @brief Returns the number of elements
+		///
+		/// @return The number of elements
+		[[nodiscard]] inline constexpr auto size() const noexcept -> size_t {
+			return m_is_borrowed ? m_borrowed.size() : m_owned.size();
+		}
+
+		/// @brief Returns whether there are no elements
+		///
+		/// @return Whether there are no elements
+		[[nodiscard]] inline constexpr auto empty() const noexcept -> bool {
+			return size() == 0;
+		}
+
+		/// @brief Returns the owned elements for modification, first copying them into owned
+		/// storage if they are borrowed
+		///
+		/// @return The owned elements
+		[[nodiscard]] inline auto owned() noexcept -> std::vector<T>& {
+			if(m_is_borrowed) {
+				m_owned.assign(m_borrowed.begin(), m_borrowed.end());
+				m_borrowed = {};
+				m_is_borrowed = false;
+			}
+			return m_owned;
+		}
+
+		[[nodiscard]] inline constexpr auto operator[](size_t index) const noexcept -> const T& {
+			return m_is_borrowed ? m_borrowed[index] : m_owned[index];
+		}
+
+		auto operator=(const ArrayStorage& storage) noexcept -> ArrayStorage& = default;
+		auto operator=(ArrayStorage&& storage) noexcept -> ArrayStorage& = default;
+
+	  private:
+		std::vector<T> m_owned;
+		std::span<const T> m_borrowed;
+		bool m_is_borrowed = false;
+	};
+} // namespace utils
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "Concepts.h"
+
+namespace utils {
+	using concepts::DefaultConstructible, concepts::Movable, concepts::Copyable,
+		concepts::ConstructibleFrom;
+
+	/// @brief Which threads may use a `ConcurrentRingBuffer` concurrently
+	enum class ConcurrencyMode {
+		/// Exactly one thread pushes and exactly one (possibly different) thread pops
+		SingleProducerSingleConsumer,
+		/// Any number of threads push and any number of threads pop
+		MultiProducerMultiConsumer
+	};
+
+	/// @brief A fixed-capacity, lock-free Ring Buffer for passing elements between threads.
+	/// Unlike `RingBuffer`, this never overwrites: pushing to a full buffer or popping from an
+	/// empty one fails instead, and it is up to the caller to retry or back off.
+	///
+	/// The producer's and consumer's indices live on separate cache lines, so producers and
+	/// consumers only contend on a line when the buffer is nearly full or nearly empty.
+	///
+	/// In `SingleProducerSingleConsumer` mode, bulk `push` and `pop` copy contiguous runs of
+	/// elements and publish them with a single store. In `MultiProducerMultiConsumer` mode each
+	/// slot carries its own sequence number (Dmitry Vyukov's bounded MPMC queue), so bulk
+	/// operations are performed element by element and may interleave with other threads'.
+	///
+	/// @tparam T - The type to store in the `ConcurrentRingBuffer`
+	/// @tparam Mode - Which threads may push and pop concurrently
+	template<typename T, ConcurrencyMode Mode = ConcurrencyMode::SingleProducerSingleConsumer>
+	requires DefaultConstructible<T> && Movable<T>
+	class ConcurrentRingBuffer {
+	  public:
+		/// Default capacity of `ConcurrentRingBuffer`
+		static const constexpr size_t DEFAULT_CAPACITY = 16;
+		/// The cache line size assumed when separating the producer and consumer indices
+		static const constexpr size_t CACHE_LINE_SIZE = 64;
+
+		/// @brief Constructs a `ConcurrentRingBuffer` with (at least) the given capacity
+		///
+		/// @param capacity - The minimum capacity. This is rounded up to a power of two
+		explicit ConcurrentRingBuffer(size_t capacity = DEFAULT_CAPACITY) noexcept
+			: m_capacity(std::bit_ceil(std::max(capacity, static_cast<size_t>(1)))),
+			  m_mask(m_capacity - 1),
+			  m_buffer(std::make_unique<Cell[]>(m_capacity)) // NOLINT
+		{
+			if constexpr(Mode == ConcurrencyMode::MultiProducerMultiConsumer) {
+				for(auto i = 0ULL; i < m_capacity; ++i) {
+					m_buffer[i].m_sequence.store(i, std::memory_order_relaxed); // NOLINT
+				}
+			}
+		}
+
+		ConcurrentRingBuffer(const ConcurrentRingBuffer& buffer) = delete;
+		ConcurrentRingBuffer(ConcurrentRingBuffer&& buffer) = delete;
+		~ConcurrentRingBuffer() noexcept = default;
+
+		/// @brief Attempts to insert the given element at the back of the `ConcurrentRingBuffer`
+		///
+		/// @param value - The element to insert
+		///
+		/// @return Whether the element was inserted. `false` if the buffer was full
+		inline auto try_push(T value) noexcept -> bool {
+			return try_emplace(std::move(value));
+		}
+
+		/// @brief Attempts to construct an element in place at the back of the
+		/// `ConcurrentRingBuffer`
+		///
+		/// @tparam Args - The types of the element's constructor arguments
+		/// @param args - The constructor arguments for the element
+		///
+		/// @return Whether the element was constructed. `false` if the buffer was full
+		template<typename... Args>
+		requires ConstructibleFrom<T, Args...>
+		inline auto try_emplace(Args&&... args) noexcept -> bool {
+			if constexpr(Mode == ConcurrencyMode::SingleProducerSingleConsumer) {
+				const auto tail = m_producer.m_index.load(std::memory_order_relaxed);
+				if(free_slots(tail, 1) == 0) {
+					return false;
+				}
+
+				slot(tail) = T(std::forward<Args>(args)...);
+				m_producer.m_index.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+			else {
+				auto* cell = claim_for_push();
+				if(cell == nullptr) {
+					return false;
+				}
+
+				const auto position = cell->m_sequence.load(std::memory_order_relaxed);
+				cell->m_value = T(std::forward<Args>(args)...);
+				cell->m_sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+
+		/// @brief Attempts to remove the element at the front of the `ConcurrentRingBuffer`
+		///
+		/// @return The removed element, or `std::nullopt` if the buffer was empty
+		inline auto try_pop() noexcept -> std::optional<T> {
+			if constexpr(Mode == ConcurrencyMode::SingleProducerSingleConsumer) {
+				const auto head = m_consumer.m_index.load(std::memory_order_relaxed);
+				if(available(head, 1) == 0) {
+					return std::nullopt;
+				}
+
+				auto value = std::optional<T>(std::move(slot(head)));
+				m_consumer.m_index.store(head + 1, std::memory_order_release);
+				return value;
+			}
+			else {
+				auto* cell = claim_for_pop();
+				if(cell == nullptr) {
+					return std::nullopt;
+				}
+
+				const auto position = cell->m_sequence.load(std::memory_order_relaxed) - 1;
+				auto value = std::optional<T>(std::move(cell->m_value));
+				cell->m_sequence.store(position + m_capacity, std::memory_order_release);
+				return value;
+			}
+		}
+
+		/// @brief Inserts as many of the given elements as fit at the back of the
+		/// `ConcurrentRingBuffer`, in order
+		///
+		/// @param values - The elements to insert
+		///
+		/// @return The number of elements inserted; always a prefix of `values`
+		inline auto push(std::span<const T> values) noexcept -> size_t requires Copyable<T> {
+			if constexpr(Mode == ConcurrencyMode::SingleProducerSingleConsumer) {
+				const auto tail = m_producer.m_index.load(std::memory_order_relaxed);
+				const auto count = free_slots(tail, values.size());
+				const auto first = std::min(count, m_capacity - (tail & m_mask));
+
+				auto buffer = std::span<Cell>(m_buffer.get(), m_capacity);
+				std::copy_n(values.begin(), first, buffer.begin() + (tail & m_mask));
+				std::copy_n(values.begin() + first, count - first, buffer.begin());
+				m_producer.m_index.store(tail + count, std::memory_order_release);
+				return count;
+			}
+			else {
+				auto count = 0ULL;
+				while(count < values.size() && try_emplace(values[count])) {
+					++count;
+				}
+				return count;
+			}
+		}
+
+		/// @brief Removes as many elements as are available, up to `values.size()`, from the
+		/// front of the `ConcurrentRingBuffer` into `values`, in order
+		///
+		/// @param values - Where to write the removed elements
+		///
+		/// @return The number of elements removed; these are written to the front of `values`
+		inline auto pop(std::span<T> values) noexcept -> size_t {
+			if constexpr(Mode == ConcurrencyMode::SingleProducerSingleConsumer) {
+				const auto head = m_consumer.m_index.load(std::memory_order_relaxed);
+				const auto count = available(head, values.size());
+				const auto first = std::min(count, m_capacity - (head & m_mask));
+
+				auto buffer = std::span<Cell>(m_buffer.get(), m_capacity);
+				auto start = buffer.begin() + (head & m_mask);
+				std::move(start, start + first, values.begin());
+				std::move(buffer.begin(), buffer.begin() + (count - first), values.begin() + first);
+				m_consumer.m_index.store(head + count, std::memory_order_release);
+				return count;
+			}
+			else {
+				auto count = 0ULL;
+				for(; count < values.size(); ++count) {
+					auto value = try_pop();
+					if(!value) {
+						break;
+					}
+					values[count] = std::move(*value);
+				}
+				return count;
+			}
+		}
+
+		/// @brief Returns the number of elements currently in the `ConcurrentRingBuffer`.
+		/// @note While other threads are pushing or popping, this is only a snapshot
+		///
+		/// @return The number of elements
+		[[nodiscard]] inline auto size() const noexcept -> size_t {
+			const auto head = m_consumer.m_index.load(std::memory_order_acquire);
+			const auto tail = m_producer.m_index.load(std::memory_order_acquire);
+			// producers can advance the tail between the two loads, but the head can't
+			// overtake the tail we load after it
+			return std::min(tail - head, m_capacity);
+		}
+
+		/// @brief Returns whether the `ConcurrentRingBuffer` is empty
+		/// @note While other threads are pushing or popping, this is only a snapshot
+		///
+		/// @return Whether the buffer is empty
+		[[nodiscard]] inline auto empty() const noexcept -> bool {
+			return size() == 0;
+		}
+
+		/// @brief Returns the capacity of the `ConcurrentRingBuffer`
+		///
+		/// @return The capacity
+		[[nodiscard]] inline auto capacity() const noexcept -> size_t {
+			return m_capacity;
+		}
+
+	  private:
+		/// @brief A slot in an MPMC buffer; the sequence number says whose turn it is: a
+		/// producer's when equal to the push position, a consumer's when one past it
+		struct MultiCell {
+			std::atomic<size_t> m_sequence = 0;
+			T m_value = T();
+		};
+		using Cell = std::conditional_t<Mode == ConcurrencyMode::SingleProducerSingleConsumer,
+										T,
+										MultiCell>;
+
+		/// @brief One side's index, along with that side's last view of the other side's index,
+		/// so the other side's cache line is only read when this one seems to have run out of
+		/// room (SPSC only)
+		struct alignas(CACHE_LINE_SIZE) Index {
+			std::atomic<size_t> m_index = 0;
+			size_t m_cached_other = 0;
+		};
+
+		size_t m_capacity;
+		size_t m_mask;
+		std::unique_ptr<Cell[]> m_buffer; // NOLINT
+		Index m_producer = {};
+		Index m_consumer = {};
+
+		[[nodiscard]] inline auto slot(size_t position) noexcept -> Cell& {
+			return m_buffer[position & m_mask]; // NOLINT
+		}
+
+		/// @brief Returns how many of `wanted` slots the producer can fill from `tail` (SPSC)
+		[[nodiscard]] inline auto free_slots(size_t tail, size_t wanted) noexcept -> size_t {
+			auto free = m_capacity - (tail - m_producer.m_cached_other);
+			if(free < wanted) {
+				m_producer.m_cached_other = m_consumer.m_index.load(std::memory_order_acquire);
+				free = m_capacity - (tail - m_producer.m_cached_other);
+			}
+			return std::min(free, wanted);
+		}
+
+		/// @brief Returns how many of `wanted` elements the consumer can take from `head` (SPSC)
+		[[nodiscard]] inline auto available(size_t head, size_t wanted) noexcept -> size_t {
+			auto count = m_consumer.m_cached_other - head;
+			if(count < wanted) {
+				m_consumer.m_cached_other = m_producer.m_index.load(std::memory_order_acquire);
+				count = m_consumer.m_cached_other - head;
+			}
+			return std::min(count, wanted);
+		}
+
+		/// @brief Claims the slot at the tail for the calling producer (MPMC)
+		///
+		/// @return The claimed slot, or `nullptr` if the buffer was full
+		[[nodiscard]] inline auto claim_for_push() noexcept -> MultiCell* {
+			auto position = m_producer.m_index.load(std::memory_order_relaxed);
+			while(true) {
+				auto& cell = slot(position);
+				const auto sequence = cell.m_sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+				if(difference == 0) {
+					if(m_producer.m_index.compare_exchange_weak(position,
+															   position + 1,
+															   std::memory_order_relaxed))
+					{
+						return &cell;
+					}
+				}
+				else if(difference < 0) {
+					return nullptr;
+				}
+				else {
+					position = m_producer.m_index.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/// @brief Claims the slot at the head for the calling consumer (MPMC)
+		///
+		/// @return The claimed slot, or `nullptr` if the buffer was empty
+		[[nodiscard]] inline auto claim_for_pop() noexcept -> MultiCell* {
+			auto position = m_consumer.m_index.load(std::memory_order_relaxed);
+			while(true) {
+				auto& cell = slot(position);
+				const auto sequence = cell.m_sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+				if(difference == 0) {
+					if(m_consumer.m_index.compare_exchange_weak(position,
+															   position + 1,
+															   std::memory_order_relaxed))
+					{
+						return &cell;
+					}
+				}
+				else if(difference < 0) {
+					return nullptr;
+				}
+				else {
+					position = m_consumer.m_index.load(std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+
+	/// @brief A `ConcurrentRingBuffer` for one producer thread and one consumer thread
+	template<typename T>
+	using SpscRingBuffer = ConcurrentRingBuffer<T, ConcurrencyMode::SingleProducerSingleConsumer>;
+
+	/// @brief A `ConcurrentRingBuffer` for any number of producer and consumer threads
+	template<typename T>
+	using MpmcRingBuffer = ConcurrentRingBuffer<T, ConcurrencyMode::MultiProducerMultiConsumer>;
+} // namespace utils
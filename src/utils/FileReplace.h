@@ -0,0 +1,72 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <cstdio>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace utils {
+	/// @brief Flushes the contents of the file at `path` through the OS's caches to the storage
+	/// device, so they survive a crash or power loss
+	///
+	/// @param path - The path of the file to flush
+	///
+	/// @return Whether the file was flushed successfully
+	[[nodiscard]] inline auto sync_file(const std::string& path) noexcept -> bool {
+#ifdef _WIN32
+		const auto file = CreateFileW(std::filesystem::path(path).c_str(),
+									  GENERIC_WRITE,
+									  0,
+									  nullptr,
+									  OPEN_EXISTING,
+									  FILE_ATTRIBUTE_NORMAL,
+									  nullptr);
+		if(file == INVALID_HANDLE_VALUE) { // NOLINT
+			return false;
+		}
+		const auto flushed = FlushFileBuffers(file) != 0;
+		CloseHandle(file);
+		return flushed;
+#else
+		const auto file = ::open(path.c_str(), O_WRONLY); // NOLINT
+		if(file < 0) {
+			return false;
+		}
+		const auto flushed = ::fsync(file) == 0;
+		::close(file);
+		return flushed;
+#endif
+	}
+
+	/// @brief Moves the file at `from` to `to`, atomically replacing any file already at `to`:
+	/// at every point, `to` is either the previous file or the new one, in its entirety
+	///
+	/// @param from - The path of the file to move
+	/// @param to - The path to move it to
+	///
+	/// @return Whether the file was moved successfully
+	[[nodiscard]] inline auto replace_file(const std::string& from, const std::string& to) noexcept
+		-> bool {
+#ifdef _WIN32
+		return MoveFileExW(std::filesystem::path(from).c_str(),
+						   std::filesystem::path(to).c_str(),
+						   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)
+			   != 0;
+#else
+		// POSIX `rename` replaces an existing `to` atomically
+		return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+	}
+} // namespace utils
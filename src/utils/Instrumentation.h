@@ -0,0 +1,385 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// @brief Lightweight counters and stage timers, reported as JSON.
+///
+/// Each thread counts into its own block of counters, so counting is a thread-local load and
+/// store, without atomic read-modify-write operations or contention between threads. Blocks are
+/// merged whenever a `Snapshot` is taken, which can be done at any time from any thread, eg: by a
+/// `Reporter`, periodically.
+///
+/// Defining `RAY_TRACER_DISABLE_INSTRUMENTATION` compiles counting and timing out entirely.
+namespace utils::instrumentation {
+#ifndef _MSC_VER
+	using std::uint64_t;
+#endif
+
+#if defined(RAY_TRACER_DISABLE_INSTRUMENTATION)
+	/// Whether instrumentation is compiled in
+	static constexpr bool ENABLED = false;
+#else
+	/// Whether instrumentation is compiled in
+	static constexpr bool ENABLED = true;
+#endif
+
+	/// @brief The events counted
+	enum class Counter : size_t
+	{
+		/// Rays cast from the camera
+		PrimaryRays = 0ULL,
+		/// Rays scattered off surfaces
+		SecondaryRays,
+		/// Ray-primitive intersection tests
+		IntersectionTests,
+		/// BVH nodes whose bounds were tested against a ray
+		BvhNodesVisited,
+		/// Scatters off each kind of material, in `MaterialTable::Entry` order
+		LambertianScatters,
+		MetalScatters,
+		DielectricScatters,
+		VirtualScatters,
+		/// Surfaces with a material id scattered by an integrator without a `MaterialTable` to
+		/// look it up in. These fall back to their `Material`, and absorb the ray without one
+		UnresolvedMaterialIds,
+		/// Tiles queued for rendering
+		TilesQueued,
+		/// Tiles finished rendering
+		TilesRendered,
+		NUM_COUNTERS
+	};
+
+	/// @brief The stages of rendering timed
+	enum class Stage : size_t
+	{
+		/// Rendering whole tiles, including all the following stages
+		Tiles = 0ULL,
+		/// Finding the closest hits of a wavefront of rays
+		Extend,
+		/// Scattering a wavefront of rays off the surfaces they hit
+		Shade,
+		/// Building Bounding Volume Hierarchies, on the thread that started each build
+		BvhBuild,
+		NUM_STAGES
+	};
+
+	static constexpr size_t NUM_COUNTERS = static_cast<size_t>(Counter::NUM_COUNTERS);
+	static constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::NUM_STAGES);
+
+	/// The names of the counters, as reported
+	static constexpr std::array<std::string_view, NUM_COUNTERS> COUNTER_NAMES = {
+		"primary_rays",
+		"secondary_rays",
+		"intersection_tests",
+		"bvh_nodes_visited",
+		"lambertian_scatters",
+		"metal_scatters",
+		"dielectric_scatters",
+		"virtual_scatters",
+		"unresolved_material_ids",
+		"tiles_queued",
+		"tiles_rendered",
+	};
+
+	/// The names of the stages, as reported
+	static constexpr std::array<std::string_view, NUM_STAGES> STAGE_NAMES = {
+		"tiles",
+		"extend",
+		"shade",
+		"bvh_build",
+	};
+
+	/// @brief The counters of all threads, merged, and the time spent in each stage, summed over
+	/// all threads
+	struct Snapshot {
+		std::array<uint64_t, NUM_COUNTERS> m_counters = {};
+		std::array<uint64_t, NUM_STAGES> m_stage_nanoseconds = {};
+		/// Wall-clock time since the counters were last reset
+		double m_elapsed_seconds = 0.0;
+
+		[[nodiscard]] inline constexpr auto operator[](Counter counter) const noexcept -> uint64_t {
+			return m_counters[static_cast<size_t>(counter)]; // NOLINT
+		}
+
+		/// @brief Returns the seconds spent in `stage`, summed over all threads
+		///
+		/// @param stage - The stage
+		///
+		/// @return The seconds spent in the stage
+		[[nodiscard]] inline constexpr auto seconds(Stage stage) const noexcept -> double {
+			return static_cast<double>(m_stage_nanoseconds[static_cast<size_t>(stage)]) // NOLINT
+				   * 1.0e-9;
+		}
+
+		/// @brief Returns the number of rays cast (primary and secondary), in millions per
+		/// second of wall-clock time
+		///
+		/// @return The rate rays were cast at
+		[[nodiscard]] inline constexpr auto mrays_per_second() const noexcept -> double {
+			if(m_elapsed_seconds <= 0.0) {
+				return 0.0;
+			}
+			const auto rays = (*this)[Counter::PrimaryRays] + (*this)[Counter::SecondaryRays];
+			return static_cast<double>(rays) / m_elapsed_seconds * 1.0e-6;
+		}
+
+		/// @brief Writes the snapshot to `out` as a single line of JSON
+		///
+		/// @param out - The stream to write to
+		inline auto write_json(std::ostream& out) const noexcept -> void {
+			const auto flags = out.flags();
+			const auto precision = out.precision();
+			out << std::fixed << std::setprecision(6) << R"({"elapsed_seconds":)"
+				<< m_elapsed_seconds << R"(,"mrays_per_second":)" << mrays_per_second()
+				<< R"(,"counters":{)";
+			for(auto i = 0ULL; i < NUM_COUNTERS; ++i) {
+				out << (i == 0 ? "" : ",") << '"' << COUNTER_NAMES[i] << "\":" // NOLINT
+					<< m_counters[i];											// NOLINT
+			}
+			out << R"(},"stage_seconds":{)";
+			for(auto i = 0ULL; i < NUM_STAGES; ++i) {
+				out << (i == 0 ? "" : ",") << '"' << STAGE_NAMES[i] << "\":" // NOLINT
+					<< seconds(static_cast<Stage>(i));
+			}
+			out << "}}\n";
+			out.flags(flags);
+			out.precision(precision);
+		}
+	};
+
+	namespace detail {
+		/// @brief The counters of one thread. Only ever written by that thread, so updated with
+		/// relaxed loads and stores rather than read-modify-write operations, but atomic so that
+		/// other threads can read them while taking a snapshot
+		struct alignas(64) ThreadCounters {
+			std::array<std::atomic<uint64_t>, NUM_COUNTERS> m_counters = {};
+			std::array<std::atomic<uint64_t>, NUM_STAGES> m_stage_nanoseconds = {};
+			/// Whether a thread is currently counting into this block
+			bool m_in_use = true;
+		};
+
+		/// @brief Every thread's counters. Blocks outlive their threads, so counts are never
+		/// lost, and are reused by later threads
+		class Registry {
+		  public:
+			[[nodiscard]] inline static auto instance() noexcept -> Registry& {
+				static auto registry = Registry();
+				return registry;
+			}
+
+			/// @brief Returns an unused block of counters for the calling thread
+			[[nodiscard]] inline auto acquire() noexcept -> ThreadCounters* {
+				auto lock = std::scoped_lock(m_mutex);
+				for(auto& block : m_blocks) {
+					if(!block->m_in_use) {
+						block->m_in_use = true;
+						return block.get();
+					}
+				}
+				m_blocks.push_back(std::make_unique<ThreadCounters>());
+				return m_blocks.back().get();
+			}
+
+			/// @brief Marks `block` as unused, once its thread has exited
+			inline auto release(ThreadCounters* block) noexcept -> void {
+				auto lock = std::scoped_lock(m_mutex);
+				block->m_in_use = false;
+			}
+
+			/// @brief Returns the sum of every thread's counters since the last `reset`
+			[[nodiscard]] inline auto snapshot() noexcept -> Snapshot {
+				auto lock = std::scoped_lock(m_mutex);
+				auto snapshot = totals();
+				for(auto i = 0ULL; i < NUM_COUNTERS; ++i) {
+					snapshot.m_counters[i] -= m_baseline.m_counters[i]; // NOLINT
+				}
+				for(auto i = 0ULL; i < NUM_STAGES; ++i) {
+					snapshot.m_stage_nanoseconds[i] -= m_baseline.m_stage_nanoseconds[i]; // NOLINT
+				}
+				snapshot.m_elapsed_seconds
+					= std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start)
+						  .count();
+				return snapshot;
+			}
+
+			/// @brief Resets the counters and the elapsed time to zero
+			inline auto reset() noexcept -> void {
+				auto lock = std::scoped_lock(m_mutex);
+				// threads own their counters, so rather than zeroing them, count from here on
+				m_baseline = totals();
+				m_start = std::chrono::steady_clock::now();
+			}
+
+		  private:
+			std::mutex m_mutex = std::mutex();
+			std::vector<std::unique_ptr<ThreadCounters>> m_blocks = {};
+			Snapshot m_baseline = Snapshot();
+			std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+			Registry() noexcept = default;
+
+			[[nodiscard]] inline auto totals() const noexcept -> Snapshot {
+				auto totals = Snapshot();
+				for(const auto& block : m_blocks) {
+					for(auto i = 0ULL; i < NUM_COUNTERS; ++i) {
+						totals.m_counters[i] // NOLINT
+							+= block->m_counters[i].load(std::memory_order_relaxed); // NOLINT
+					}
+					for(auto i = 0ULL; i < NUM_STAGES; ++i) {
+						totals.m_stage_nanoseconds[i] // NOLINT
+							+= block->m_stage_nanoseconds[i].load( // NOLINT
+								std::memory_order_relaxed);
+					}
+				}
+				return totals;
+			}
+		};
+
+		/// The calling thread's counters. A plain pointer, so accessing it needs no thread-local
+		/// initialization check
+		inline thread_local ThreadCounters* t_counters = nullptr; // NOLINT
+
+		/// @brief Releases a thread's counters when the thread exits
+		struct ThreadRelease {
+			ThreadCounters* m_block = nullptr;
+
+			ThreadRelease() noexcept = default;
+			ThreadRelease(const ThreadRelease& release) noexcept = delete;
+			ThreadRelease(ThreadRelease&& release) noexcept = delete;
+			~ThreadRelease() noexcept {
+				if(m_block != nullptr) {
+					t_counters = nullptr;
+					Registry::instance().release(m_block);
+				}
+			}
+			auto operator=(const ThreadRelease& release) noexcept -> ThreadRelease& = delete;
+			auto operator=(ThreadRelease&& release) noexcept -> ThreadRelease& = delete;
+		};
+
+		/// @brief Acquires counters for the calling thread, on its first count
+		[[nodiscard]] inline auto acquire_thread_counters() noexcept -> ThreadCounters* {
+			thread_local auto release = ThreadRelease();
+			release.m_block = Registry::instance().acquire();
+			t_counters = release.m_block;
+			return t_counters;
+		}
+
+		[[nodiscard]] inline auto thread_counters() noexcept -> ThreadCounters* {
+			auto* counters = t_counters;
+			return counters != nullptr ? counters : acquire_thread_counters();
+		}
+
+		inline auto add(std::atomic<uint64_t>& value, uint64_t amount) noexcept -> void {
+			value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+	} // namespace detail
+
+	/// @brief Adds `amount` to `counter`, for the calling thread
+	///
+	/// @param counter - The counter to add to
+	/// @param amount - The amount to add
+	inline auto count(Counter counter, uint64_t amount = 1) noexcept -> void {
+		if constexpr(ENABLED) {
+			auto* counters = detail::thread_counters();
+			detail::add(counters->m_counters[static_cast<size_t>(counter)], amount); // NOLINT
+		}
+	}
+
+	/// @brief Returns the counters of all threads, merged, since the last call to `reset`
+	///
+	/// @return The counters
+	[[nodiscard]] inline auto snapshot() noexcept -> Snapshot {
+		return detail::Registry::instance().snapshot();
+	}
+
+	/// @brief Resets all counters, stage times, and the elapsed time to zero
+	inline auto reset() noexcept -> void {
+		detail::Registry::instance().reset();
+	}
+
+	/// @brief Adds the time from its construction to its destruction to a `Stage`, for the
+	/// calling thread
+	class ScopedTimer {
+	  public:
+		explicit ScopedTimer(Stage stage) noexcept : m_stage(stage) {
+			if constexpr(ENABLED) {
+				m_start = std::chrono::steady_clock::now();
+			}
+		}
+		ScopedTimer(const ScopedTimer& timer) noexcept = delete;
+		ScopedTimer(ScopedTimer&& timer) noexcept = delete;
+		~ScopedTimer() noexcept {
+			if constexpr(ENABLED) {
+				const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - m_start);
+				detail::add(
+					detail::thread_counters()->m_stage_nanoseconds[static_cast<size_t>(m_stage)],
+					static_cast<uint64_t>(elapsed.count()));
+			}
+		}
+
+		auto operator=(const ScopedTimer& timer) noexcept -> ScopedTimer& = delete;
+		auto operator=(ScopedTimer&& timer) noexcept -> ScopedTimer& = delete;
+
+	  private:
+		Stage m_stage;
+		std::chrono::steady_clock::time_point m_start = {};
+	};
+
+	/// @brief Periodically writes a `Snapshot` of the counters to a stream, as JSON lines, from
+	/// a background thread, and a final one when destroyed
+	class Reporter {
+	  public:
+		/// @brief Starts reporting
+		///
+		/// @param out - The stream to write reports to. Must outlive the `Reporter`
+		/// @param interval - The time between reports
+		Reporter(std::ostream& out, std::chrono::milliseconds interval) noexcept
+			: m_out(&out), m_thread([this, interval](const std::stop_token& stop) noexcept {
+				  auto lock = std::unique_lock(m_mutex);
+				  while(true) {
+					  // nothing notifies the condition, so this waits out the interval, or until
+					  // a stop is requested
+					  m_condition.wait_for(lock, stop, interval, [] { return false; });
+					  if(stop.stop_requested()) {
+						  break;
+					  }
+					  report();
+				  }
+			  }) {
+		}
+		Reporter(const Reporter& reporter) noexcept = delete;
+		Reporter(Reporter&& reporter) noexcept = delete;
+		~Reporter() noexcept {
+			m_thread.request_stop();
+			m_thread.join();
+			report();
+		}
+
+		auto operator=(const Reporter& reporter) noexcept -> Reporter& = delete;
+		auto operator=(Reporter&& reporter) noexcept -> Reporter& = delete;
+
+	  private:
+		std::ostream* m_out;
+		std::mutex m_mutex = std::mutex();
+		std::condition_variable_any m_condition = std::condition_variable_any();
+		std::jthread m_thread;
+
+		inline auto report() noexcept -> void {
+			snapshot().write_json(*m_out);
+			m_out->flush();
+		}
+	};
+} // namespace utils::instrumentation
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace utils {
+	/// @brief A file mapped read-only into memory.
+	/// The file's contents are paged in on demand by the OS, and pages are shared with every
+	/// other process mapping the same file, through the page cache
+	class MappedFile {
+	  public:
+		MappedFile(const MappedFile& file) noexcept = delete;
+		MappedFile(MappedFile&& file) noexcept
+			: m_data(std::exchange(file.m_data, nullptr)), m_size(std::exchange(file.m_size, 0)) {
+		}
+		~MappedFile() noexcept {
+			unmap();
+		}
+
+		/// @brief Maps the file at `path` into memory
+		///
+		/// @param path - The path of the file to map
+		///
+		/// @return The mapped file, or `std::nullopt` if it couldn't be opened or mapped
+		[[nodiscard]] inline static auto
+		open(const std::string& path) noexcept -> std::optional<MappedFile> {
+#ifdef _WIN32
+			const auto file = CreateFileA(path.c_str(),
+										  GENERIC_READ,
+										  FILE_SHARE_READ,
+										  nullptr,
+										  OPEN_EXISTING,
+										  FILE_ATTRIBUTE_NORMAL,
+										  nullptr);
+			if(file == INVALID_HANDLE_VALUE) { // NOLINT
+				return std::nullopt;
+			}
+
+			auto size = LARGE_INTEGER();
+			if(GetFileSizeEx(file, &size) == 0 || size.QuadPart == 0) {
+				CloseHandle(file);
+				return std::nullopt;
+			}
+
+			const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			if(mapping == nullptr) {
+				return std::nullopt;
+			}
+
+			auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			// the view keeps the mapping alive
+			CloseHandle(mapping);
+			if(data == nullptr) {
+				return std::nullopt;
+			}
+			return MappedFile(static_cast<std::byte*>(data), static_cast<size_t>(size.QuadPart));
+#else
+			const auto file = ::open(path.c_str(), O_RDONLY); // NOLINT
+			if(file < 0) {
+				return std::nullopt;
+			}
+
+			struct stat status = {};
+			if(fstat(file, &status) != 0 || status.st_size <= 0) {
+				close(file);
+				return std::nullopt;
+			}
+
+			const auto size = static_cast<size_t>(status.st_size);
+			auto* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+			// the mapping keeps the file alive
+			close(file);
+			if(data == MAP_FAILED) { // NOLINT
+				return std::nullopt;
+			}
+			return MappedFile(static_cast<std::byte*>(data), size);
+#endif
+		}
+
+		/// @brief Returns the contents of the file
+		///
+		/// @return The contents of the file
+		[[nodiscard]] inline auto bytes() const noexcept -> std::span<const std::byte> {
+			return {m_data, m_size};
+		}
+
+		auto operator=(const MappedFile& file) noexcept -> MappedFile& = delete;
+		auto operator=(MappedFile&& file) noexcept -> MappedFile& {
+			if(this != &file) {
+				unmap();
+				m_data = std::exchange(file.m_data, nullptr);
+				m_size = std::exchange(file.m_size, 0);
+			}
+			return *this;
+		}
+
+	  private:
+		std::byte* m_data = nullptr;
+		size_t m_size = 0;
+
+		MappedFile(std::byte* data, size_t size) noexcept : m_data(data), m_size(size) {
+		}
+
+		inline auto unmap() noexcept -> void {
+			if(m_data == nullptr) {
+				return;
+			}
+#ifdef _WIN32
+			UnmapViewOfFile(m_data);
+#else
+			munmap(m_data, m_size);
+#endif
+			m_data = nullptr;
+			m_size = 0;
+		}
+	};
+} // namespace utils
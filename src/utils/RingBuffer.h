@@ -496,12 +496,13 @@ namespace utils {
 		constexpr inline auto reserve(size_t newCapacity) noexcept -> void {
 			// we only need to do anything if `newCapacity` is actually larger than `mCapacity`
 			if(newCapacity > mCapacity) {
-				gsl::owner<T*> temp = new T[newCapacity]; // NOLINT
-				auto span = gsl::make_span(temp, newCapacity);
+				// one more than the capacity, for the "invalid" spacer element for `end()`
+				gsl::owner<T*> temp = new T[newCapacity + 1]; // NOLINT
+				auto span = gsl::make_span(temp, newCapacity + 1);
 				std::copy(begin(), end(), span.begin());
 				mBuffer.reset(temp);
 				mStartIndex = 0;
-				mWriteIndex = mLoopIndex + 1;
+				mWriteIndex = mSize;
 				mLoopIndex = newCapacity;
 				mCapacity = newCapacity;
 			}
@@ -877,13 +878,15 @@ namespace utils {
 			mWriteIndex++;
 			mSize = math::General::min(mSize + 1, mCapacity);
 
-			// if write index is at start - 1, we need to push start forward to maintain
-			// the "invalid" spacer element for this.end()
-			if(mWriteIndex > mLoopIndex && mStartIndex == 0) {
+			// the write index can pass the end of the array whether or not the start index
+			// is at 0 (eg. after `erase`ing from the middle of a looped `RingBuffer`)
+			if(mWriteIndex > mLoopIndex) {
 				mWriteIndex = 0;
-				mStartIndex = 1;
 			}
-			else if(mWriteIndex == mStartIndex) {
+
+			// if write index is at start - 1, we need to push start forward to maintain
+			// the "invalid" spacer element for this.end()
+			if(mWriteIndex == mStartIndex) {
 				mStartIndex++;
 				if(mStartIndex > mLoopIndex) {
 					mStartIndex = 0;
@@ -0,0 +1,538 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <netdb.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <poll.h>
+	#include <sys/socket.h>
+	#include <sys/types.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#endif
+
+namespace utils {
+#ifndef _MSC_VER
+	using std::uint16_t;
+#endif
+
+#ifdef _WIN32
+	using NativeSocket = SOCKET;
+	static constexpr NativeSocket INVALID_NATIVE_SOCKET = INVALID_SOCKET;
+#else
+	using NativeSocket = int;
+	static constexpr NativeSocket INVALID_NATIVE_SOCKET = -1;
+#endif
+
+	namespace detail {
+		/// @brief Initializes the platform's socket library, once, before the first socket is
+		/// created
+		///
+		/// @return Whether sockets are available
+		inline auto initialize_sockets() noexcept -> bool {
+#ifdef _WIN32
+			static const auto initialized = []() noexcept {
+				auto data = WSADATA();
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+			return initialized;
+#else
+			return true;
+#endif
+		}
+
+		inline auto close_socket(NativeSocket socket) noexcept -> void {
+#ifdef _WIN32
+			closesocket(socket);
+#else
+			close(socket);
+#endif
+		}
+	} // namespace detail
+
+	/// @brief A connected stream socket: TCP, or (except on Windows) a Unix domain socket.
+	/// Sends and receives are blocking, and (except for `receive_some`) transfer whole buffers
+	class Socket {
+	  public:
+		Socket(const Socket& socket) noexcept = delete;
+		Socket(Socket&& socket) noexcept
+			: m_socket(std::exchange(socket.m_socket, INVALID_NATIVE_SOCKET)) {
+		}
+		~Socket() noexcept {
+			close();
+		}
+
+		/// @brief Connects to the TCP server listening on `host`:`port`
+		///
+		/// @param host - The host name or address of the server
+		/// @param port - The port the server is listening on
+		///
+		/// @return The connected socket, or `std::nullopt` if the connection couldn't be made
+		[[nodiscard]] inline static auto
+		connect(const std::string& host, uint16_t port) noexcept -> std::optional<Socket> {
+			if(!detail::initialize_sockets()) {
+				return std::nullopt;
+			}
+
+			auto hints = addrinfo();
+			hints.ai_family = AF_UNSPEC;
+			hints.ai_socktype = SOCK_STREAM;
+			addrinfo* addresses = nullptr;
+			if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+				return std::nullopt;
+			}
+
+			auto connected = std::optional<Socket>();
+			for(auto* address = addresses; address != nullptr && !connected;
+				address = address->ai_next) {
+				auto socket
+					= Socket(::socket(address->ai_family,
+									  address->ai_socktype,
+									  address->ai_protocol));
+				if(socket.is_open()
+				   && ::connect(socket.m_socket,
+								address->ai_addr,
+								static_cast<socklen_t>(address->ai_addrlen))
+						  == 0)
+				{
+					socket.configure(true);
+					connected = std::move(socket);
+				}
+			}
+			freeaddrinfo(addresses);
+			return connected;
+		}
+
+		/// @brief Connects to the Unix domain socket server listening at `path`.
+		/// Unix domain sockets are unsupported on Windows, where this always fails
+		///
+		/// @param path - The path the server is listening at
+		///
+		/// @return The connected socket, or `std::nullopt` if the connection couldn't be made
+		[[nodiscard]] inline static auto
+		connect_local(const std::string& path) noexcept -> std::optional<Socket> {
+#ifdef _WIN32
+			static_cast<void>(path);
+			return std::nullopt;
+#else
+			auto address = sockaddr_un();
+			if(!local_address(path, &address)) {
+				return std::nullopt;
+			}
+
+			auto socket = Socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+			if(!socket.is_open()
+			   || ::connect(socket.m_socket,
+							reinterpret_cast<const sockaddr*>(&address), // NOLINT
+							sizeof(address))
+					  != 0)
+			{
+				return std::nullopt;
+			}
+			socket.configure(false);
+			return socket;
+#endif
+		}
+
+		/// @brief Returns whether the socket is open
+		///
+		/// @return Whether the socket is open
+		[[nodiscard]] inline auto is_open() const noexcept -> bool {
+			return m_socket != INVALID_NATIVE_SOCKET;
+		}
+
+		/// @brief Returns the platform's handle for the socket
+		///
+		/// @return The native socket
+		[[nodiscard]] inline auto native() const noexcept -> NativeSocket {
+			return m_socket;
+		}
+
+		/// @brief Sends all of `bytes`, blocking until they've been sent
+		///
+		/// @param bytes - The bytes to send
+		///
+		/// @return Whether all the bytes were sent. `false` if the connection failed or was closed
+		[[nodiscard]] inline auto send_all(std::span<const std::byte> bytes) noexcept -> bool {
+			while(!bytes.empty()) {
+				const auto size = std::min(bytes.size(), MAX_TRANSFER_SIZE);
+				const auto sent = ::send(m_socket,
+										 reinterpret_cast<const char*>(bytes.data()), // NOLINT
+										 static_cast<TransferSize>(size),
+										 SEND_FLAGS);
+				if(sent <= 0) {
+					return false;
+				}
+				bytes = bytes.subspan(static_cast<size_t>(sent));
+			}
+			return true;
+		}
+
+		/// @brief Receives exactly `bytes.size()` bytes into `bytes`, blocking until they've been
+		/// received, or the receive timeout (if any) expires
+		///
+		/// @param bytes - Where to write the received bytes
+		///
+		/// @return Whether all the bytes were received. `false` if the connection failed, was
+		/// closed, or timed out
+		[[nodiscard]] inline auto receive_all(std::span<std::byte> bytes) noexcept -> bool {
+			while(!bytes.empty()) {
+				const auto size = std::min(bytes.size(), MAX_TRANSFER_SIZE);
+				const auto received = ::recv(m_socket,
+											 reinterpret_cast<char*>(bytes.data()), // NOLINT
+											 static_cast<TransferSize>(size),
+											 0);
+				if(received <= 0) {
+					return false;
+				}
+				bytes = bytes.subspan(static_cast<size_t>(received));
+			}
+			return true;
+		}
+
+		/// @brief Receives at most `bytes.size()` bytes into `bytes`: whatever has arrived, waiting
+		/// only if nothing has. Once `wait_readable` reports the socket ready, this doesn't wait,
+		/// so a message can be received a piece at a time without blocking on a slow sender
+		///
+		/// @param bytes - Where to write the received bytes
+		///
+		/// @return The number of bytes received, or `std::nullopt` if the connection failed, was
+		/// closed, or timed out
+		[[nodiscard]] inline auto
+		receive_some(std::span<std::byte> bytes) noexcept -> std::optional<size_t> {
+			const auto size = std::min(bytes.size(), MAX_TRANSFER_SIZE);
+			const auto received = ::recv(m_socket,
+										 reinterpret_cast<char*>(bytes.data()), // NOLINT
+										 static_cast<TransferSize>(size),
+										 0);
+			if(received <= 0) {
+				return std::nullopt;
+			}
+			return static_cast<size_t>(received);
+		}
+
+		/// @brief Sets how long a receive can wait for data before failing. Zero waits forever
+		///
+		/// @param timeout - The receive timeout
+		///
+		/// @return Whether the timeout was set
+		inline auto set_receive_timeout(std::chrono::milliseconds timeout) noexcept -> bool {
+#ifdef _WIN32
+			const auto value = static_cast<DWORD>(timeout.count());
+#else
+			const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+			auto value = timeval();
+			value.tv_sec = static_cast<decltype(value.tv_sec)>(seconds.count());
+			value.tv_usec = static_cast<decltype(value.tv_usec)>(
+				std::chrono::duration_cast<std::chrono::microseconds>(timeout - seconds).count());
+#endif
+			return setsockopt(m_socket,
+							  SOL_SOCKET,
+							  SO_RCVTIMEO,
+							  reinterpret_cast<const char*>(&value), // NOLINT
+							  sizeof(value))
+				   == 0;
+		}
+
+		/// @brief Closes the socket
+		inline auto close() noexcept -> void {
+			if(is_open()) {
+				detail::close_socket(std::exchange(m_socket, INVALID_NATIVE_SOCKET));
+			}
+		}
+
+		auto operator=(const Socket& socket) noexcept -> Socket& = delete;
+		auto operator=(Socket&& socket) noexcept -> Socket& {
+			if(this != &socket) {
+				close();
+				m_socket = std::exchange(socket.m_socket, INVALID_NATIVE_SOCKET);
+			}
+			return *this;
+		}
+
+	  private:
+#ifdef _WIN32
+		using TransferSize = int;
+		static constexpr int SEND_FLAGS = 0;
+#else
+		using TransferSize = size_t;
+	#ifdef MSG_NOSIGNAL
+		// a peer closing the connection shouldn't kill the process with `SIGPIPE`
+		static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+	#else
+		static constexpr int SEND_FLAGS = 0;
+	#endif
+#endif
+		/// The most bytes sent or received by a single call
+		static constexpr size_t MAX_TRANSFER_SIZE = 1ULL << 30U;
+
+		NativeSocket m_socket = INVALID_NATIVE_SOCKET;
+
+		explicit Socket(NativeSocket socket) noexcept : m_socket(socket) {
+		}
+
+		/// @brief Configures a newly connected socket
+		///
+		/// @param is_tcp - Whether this is a TCP socket
+		inline auto configure(bool is_tcp) noexcept -> void {
+			const auto enable = 1;
+			if(is_tcp) {
+				// messages are small and latency sensitive, so send them immediately
+				setsockopt(m_socket,
+						   IPPROTO_TCP,
+						   TCP_NODELAY,
+						   reinterpret_cast<const char*>(&enable), // NOLINT
+						   sizeof(enable));
+			}
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+			setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+		}
+
+#ifndef _WIN32
+		/// @brief Fills in the address of the Unix domain socket at `path`
+		///
+		/// @return Whether `path` is short enough to be a socket address
+		[[nodiscard]] inline static auto
+		local_address(const std::string& path, sockaddr_un* address) noexcept -> bool {
+			address->sun_family = AF_UNIX;
+			if(path.size() >= sizeof(address->sun_path)) {
+				return false;
+			}
+			std::memcpy(static_cast<char*>(address->sun_path), path.c_str(), path.size() + 1);
+			return true;
+		}
+#endif
+
+		friend class Listener;
+	};
+
+	/// @brief A socket listening for connections: on a TCP port, or (except on Windows) at a Unix
+	/// domain socket path
+	class Listener {
+	  public:
+		Listener(const Listener& listener) noexcept = delete;
+		Listener(Listener&& listener) noexcept = default;
+		~Listener() noexcept {
+			close();
+		}
+
+		/// @brief Listens for TCP connections on `host`:`port`
+		///
+		/// @param host - The address to listen on, eg: "127.0.0.1" for local connections only, or
+		/// "0.0.0.0" for all IPv4 interfaces
+		/// @param port - The port to listen on. Zero picks any free port (see `port()`)
+		///
+		/// @return The listener, or `std::nullopt` if it couldn't listen there
+		[[nodiscard]] inline static auto
+		listen(const std::string& host, uint16_t port) noexcept -> std::optional<Listener> {
+			if(!detail::initialize_sockets()) {
+				return std::nullopt;
+			}
+
+			auto hints = addrinfo();
+			hints.ai_family = AF_UNSPEC;
+			hints.ai_socktype = SOCK_STREAM;
+			hints.ai_flags = AI_PASSIVE;
+			addrinfo* addresses = nullptr;
+			if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+				return std::nullopt;
+			}
+
+			auto listener = std::optional<Listener>();
+			for(auto* address = addresses; address != nullptr && !listener;
+				address = address->ai_next) {
+				auto socket
+					= Socket(::socket(address->ai_family,
+									  address->ai_socktype,
+									  address->ai_protocol));
+				if(!socket.is_open()) {
+					continue;
+				}
+
+				const auto enable = 1;
+				setsockopt(socket.m_socket,
+						   SOL_SOCKET,
+						   SO_REUSEADDR,
+						   reinterpret_cast<const char*>(&enable), // NOLINT
+						   sizeof(enable));
+				if(::bind(socket.m_socket,
+						  address->ai_addr,
+						  static_cast<socklen_t>(address->ai_addrlen))
+					   == 0
+				   && ::listen(socket.m_socket, SOMAXCONN) == 0)
+				{
+					listener = Listener(std::move(socket), std::string(), true);
+				}
+			}
+			freeaddrinfo(addresses);
+			return listener;
+		}
+
+		/// @brief Listens for Unix domain socket connections at `path`, replacing any stale socket
+		/// file there. The socket file is removed again when the listener is closed.
+		/// Unix domain sockets are unsupported on Windows, where this always fails
+		///
+		/// @param path - The path to listen at
+		///
+		/// @return The listener, or `std::nullopt` if it couldn't listen there
+		[[nodiscard]] inline static auto
+		listen_local(const std::string& path) noexcept -> std::optional<Listener> {
+#ifdef _WIN32
+			static_cast<void>(path);
+			return std::nullopt;
+#else
+			auto address = sockaddr_un();
+			if(!Socket::local_address(path, &address)) {
+				return std::nullopt;
+			}
+
+			auto socket = Socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+			unlink(path.c_str());
+			if(!socket.is_open()
+			   || ::bind(socket.m_socket,
+						 reinterpret_cast<const sockaddr*>(&address), // NOLINT
+						 sizeof(address))
+					  != 0
+			   || ::listen(socket.m_socket, SOMAXCONN) != 0)
+			{
+				return std::nullopt;
+			}
+			return Listener(std::move(socket), path, false);
+#endif
+		}
+
+		/// @brief Returns the TCP port being listened on, or zero for a Unix domain socket
+		///
+		/// @return The port
+		[[nodiscard]] inline auto port() const noexcept -> uint16_t {
+			if(!m_is_tcp) {
+				return 0;
+			}
+
+			auto address = sockaddr_storage();
+			auto size = static_cast<socklen_t>(sizeof(address));
+			if(getsockname(m_socket.m_socket,
+						   reinterpret_cast<sockaddr*>(&address), // NOLINT
+						   &size)
+			   != 0)
+			{
+				return 0;
+			}
+			const auto network_port
+				= address.ss_family == AF_INET6 ?
+					  reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port : // NOLINT
+					  reinterpret_cast<const sockaddr_in*>(&address)->sin_port;	   // NOLINT
+			return ntohs(network_port);
+		}
+
+		/// @brief Returns the platform's handle for the listening socket
+		///
+		/// @return The native socket
+		[[nodiscard]] inline auto native() const noexcept -> NativeSocket {
+			return m_socket.native();
+		}
+
+		/// @brief Accepts the next connection, blocking until one is made
+		///
+		/// @return The connected socket, or `std::nullopt` if accepting failed
+		[[nodiscard]] inline auto accept() noexcept -> std::optional<Socket> {
+			auto socket = Socket(::accept(m_socket.m_socket, nullptr, nullptr));
+			if(!socket.is_open()) {
+				return std::nullopt;
+			}
+			socket.configure(m_is_tcp);
+			return socket;
+		}
+
+		/// @brief Stops listening, removing the socket file of a Unix domain socket
+		inline auto close() noexcept -> void {
+			if(m_socket.is_open()) {
+				m_socket.close();
+#ifndef _WIN32
+				if(!m_path.empty()) {
+					unlink(m_path.c_str());
+				}
+#endif
+			}
+		}
+
+		auto operator=(const Listener& listener) noexcept -> Listener& = delete;
+		auto operator=(Listener&& listener) noexcept -> Listener& {
+			if(this != &listener) {
+				close();
+				m_socket = std::move(listener.m_socket);
+				m_path = std::move(listener.m_path);
+				m_is_tcp = listener.m_is_tcp;
+			}
+			return *this;
+		}
+
+	  private:
+		Socket m_socket;
+		/// The path of a Unix domain socket
+		std::string m_path;
+		bool m_is_tcp;
+
+		Listener(Socket&& socket, std::string path, bool is_tcp) noexcept
+			: m_socket(std::move(socket)), m_path(std::move(path)), m_is_tcp(is_tcp) {
+		}
+	};
+
+	/// @brief Waits until at least one of `sockets` has data to receive (or, for a `Listener`, a
+	/// connection to accept), has been closed by its peer, or has failed
+	///
+	/// @param sockets - The sockets to wait on
+	/// @param timeout - The longest time to wait
+	///
+	/// @return Whether each socket in `sockets` is ready. None are if the wait timed out or failed
+	[[nodiscard]] inline auto wait_readable(std::span<const NativeSocket> sockets,
+											std::chrono::milliseconds timeout) noexcept
+		-> std::vector<bool> {
+#ifdef _WIN32
+		using PollDescriptor = WSAPOLLFD;
+#else
+		using PollDescriptor = pollfd;
+#endif
+		auto descriptors = std::vector<PollDescriptor>(sockets.size());
+		for(auto i = 0ULL; i < sockets.size(); ++i) {
+			descriptors[i].fd = sockets[i];
+			descriptors[i].events = POLLIN;
+		}
+
+#ifdef _WIN32
+		const auto result = WSAPoll(descriptors.data(),
+									static_cast<ULONG>(descriptors.size()),
+									static_cast<INT>(timeout.count()));
+#else
+		const auto result = ::poll(descriptors.data(),
+								   static_cast<nfds_t>(descriptors.size()),
+								   static_cast<int>(timeout.count()));
+#endif
+		auto ready = std::vector<bool>(sockets.size());
+		for(auto i = 0ULL; i < sockets.size(); ++i) {
+			ready[i] = result > 0 && descriptors[i].revents != 0;
+		}
+		return ready;
+	}
+} // namespace utils
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Concepts.h"
+
+namespace utils {
+	using concepts::DefaultConstructible, concepts::Integral, concepts::Copyable, concepts::Movable,
+		concepts::ConstructibleFrom;
+
+	/// @brief A fixed-capacity Ring Buffer with inline storage.
+	/// Has the same overwrite-on-full semantics as `RingBuffer`, but never allocates, wraps
+	/// indices by masking with the (power of two) capacity, and is usable in constant
+	/// expressions, making it suitable for small per-thread or per-pixel queues in hot loops.
+	///
+	/// # Iterator Invalidation
+	/// Iterators refer to a logical index into the `StaticRingBuffer`, so any operation that
+	/// changes which element is at a given index (`push_back` when full, `pop_front`, `clear`)
+	/// changes what they point to
+	///
+	/// @tparam T - The type to store in the `StaticRingBuffer`; Must be Default Constructible
+	/// @tparam N - The capacity of the `StaticRingBuffer`; Must be a power of two
+	template<DefaultConstructible T, size_t N>
+	requires(std::has_single_bit(N))
+	class StaticRingBuffer {
+	  public:
+		/// @brief Random-Access iterator for `StaticRingBuffer`
+		///
+		/// @tparam IsConst - Whether this is a read-only iterator
+		template<bool IsConst>
+		class Iterator {
+		  public:
+			using iterator_category = std::random_access_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = T;
+			using pointer = std::conditional_t<IsConst, const T*, T*>;
+			using reference = std::conditional_t<IsConst, const T&, T&>;
+			using container
+				= std::conditional_t<IsConst, const StaticRingBuffer*, StaticRingBuffer*>;
+
+			constexpr Iterator() noexcept = default;
+			constexpr Iterator(container containerPtr, size_t index) noexcept
+				: m_container_ptr(containerPtr), m_index(index) {
+			}
+
+			[[nodiscard]] constexpr inline auto operator*() const noexcept -> reference {
+				return (*m_container_ptr)[m_index];
+			}
+
+			[[nodiscard]] constexpr inline auto operator->() const noexcept -> pointer {
+				return &(*m_container_ptr)[m_index];
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator[](difference_type offset) const noexcept -> reference {
+				return *(*this + offset);
+			}
+
+			constexpr inline auto operator++() noexcept -> Iterator& {
+				++m_index;
+				return *this;
+			}
+
+			constexpr inline auto operator++(int) noexcept -> Iterator {
+				auto copy = *this;
+				++m_index;
+				return copy;
+			}
+
+			constexpr inline auto operator--() noexcept -> Iterator& {
+				--m_index;
+				return *this;
+			}
+
+			constexpr inline auto operator--(int) noexcept -> Iterator {
+				auto copy = *this;
+				--m_index;
+				return copy;
+			}
+
+			constexpr inline auto operator+=(difference_type offset) noexcept -> Iterator& {
+				m_index = static_cast<size_t>(static_cast<difference_type>(m_index) + offset);
+				return *this;
+			}
+
+			constexpr inline auto operator-=(difference_type offset) noexcept -> Iterator& {
+				return *this += -offset;
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator+(difference_type offset) const noexcept -> Iterator {
+				auto copy = *this;
+				return copy += offset;
+			}
+
+			[[nodiscard]] friend constexpr inline auto
+			operator+(difference_type offset, const Iterator& iter) noexcept -> Iterator {
+				return iter + offset;
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator-(difference_type offset) const noexcept -> Iterator {
+				auto copy = *this;
+				return copy -= offset;
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator-(const Iterator& rhs) const noexcept -> difference_type {
+				return static_cast<difference_type>(m_index)
+					   - static_cast<difference_type>(rhs.m_index);
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator==(const Iterator& rhs) const noexcept -> bool {
+				return m_index == rhs.m_index;
+			}
+
+			[[nodiscard]] constexpr inline auto
+			operator<=>(const Iterator& rhs) const noexcept -> std::strong_ordering {
+				return m_index <=> rhs.m_index;
+			}
+
+		  private:
+			container m_container_ptr = nullptr;
+			size_t m_index = 0;
+		};
+
+		constexpr StaticRingBuffer() noexcept = default;
+
+		/// @brief Constructs a `StaticRingBuffer` filled with `N` copies of `defaultValue`
+		///
+		/// @param defaultValue - The value to fill the `StaticRingBuffer` with
+		explicit constexpr StaticRingBuffer(const T& defaultValue) noexcept requires Copyable<T>
+			: m_size(N) {
+			m_buffer.fill(defaultValue);
+		}
+		constexpr StaticRingBuffer(const StaticRingBuffer& buffer) noexcept = default;
+		constexpr StaticRingBuffer(StaticRingBuffer&& buffer) noexcept = default;
+		constexpr ~StaticRingBuffer() noexcept = default;
+
+		/// @brief Unchecked access-by-index operator
+		///
+		/// @param index - The index to get the corresponding element for
+		///
+		/// @return - The element at index
+		[[nodiscard]] constexpr inline auto operator[](Integral auto index) noexcept -> T& {
+			return m_buffer[internal_index(index)]; // NOLINT
+		}
+
+		/// @brief Unchecked access-by-index operator
+		///
+		/// @param index - The index to get the corresponding element for
+		///
+		/// @return - The element at index
+		[[nodiscard]] constexpr inline auto
+		operator[](Integral auto index) const noexcept -> const T& {
+			return m_buffer[internal_index(index)]; // NOLINT
+		}
+
+		/// @brief Returns the element at the given index.
+		/// @note This is checked such that accesses at or past `size()` return the last element
+		///
+		/// @param index - The index of the desired element
+		///
+		/// @return The element at the given index, or the last element if out of bounds
+		[[nodiscard]] constexpr inline auto at(Integral auto index) noexcept -> T& {
+			const auto i = static_cast<size_t>(index);
+			return (*this)[i < m_size ? i : m_size - 1];
+		}
+
+		/// @brief Returns the element at the given index.
+		/// @note This is checked such that accesses at or past `size()` return the last element
+		///
+		/// @param index - The index of the desired element
+		///
+		/// @return The element at the given index, or the last element if out of bounds
+		[[nodiscard]] constexpr inline auto at(Integral auto index) const noexcept -> const T& {
+			const auto i = static_cast<size_t>(index);
+			return (*this)[i < m_size ? i : m_size - 1];
+		}
+
+		/// @brief Returns the first element in the `StaticRingBuffer`
+		///
+		/// @return The first element
+		[[nodiscard]] constexpr inline auto front() noexcept -> T& {
+			return (*this)[0ULL];
+		}
+
+		/// @brief Returns the first element in the `StaticRingBuffer`
+		///
+		/// @return The first element
+		[[nodiscard]] constexpr inline auto front() const noexcept -> const T& {
+			return (*this)[0ULL];
+		}
+
+		/// @brief Returns the last element in the `StaticRingBuffer`
+		///
+		/// @return The last element
+		[[nodiscard]] constexpr inline auto back() noexcept -> T& {
+			return (*this)[m_size - 1];
+		}
+
+		/// @brief Returns the last element in the `StaticRingBuffer`
+		///
+		/// @return The last element
+		[[nodiscard]] constexpr inline auto back() const noexcept -> const T& {
+			return (*this)[m_size - 1];
+		}
+
+		/// @brief Returns whether the `StaticRingBuffer` is empty
+		///
+		/// @return `true` if empty, `false` otherwise
+		[[nodiscard]] constexpr inline auto empty() const noexcept -> bool {
+			return m_size == 0;
+		}
+
+		/// @brief Returns whether the `StaticRingBuffer` is full, IE the next `push_back` will
+		/// overwrite `front()`
+		///
+		/// @return `true` if full, `false` otherwise
+		[[nodiscard]] constexpr inline auto full() const noexcept -> bool {
+			return m_size == N;
+		}
+
+		/// @brief Returns the current number of elements in the `StaticRingBuffer`
+		///
+		/// @return The current number of elements
+		[[nodiscard]] constexpr inline auto size() const noexcept -> size_t {
+			return m_size;
+		}
+
+		/// @brief Returns the capacity of the `StaticRingBuffer`
+		///
+		/// @return The capacity
+		[[nodiscard]] static constexpr inline auto capacity() noexcept -> size_t {
+			return N;
+		}
+
+		/// @brief Erases all elements from the `StaticRingBuffer`
+		constexpr inline auto clear() noexcept -> void {
+			m_start = 0;
+			m_size = 0;
+		}
+
+		/// @brief Inserts the given element at the end of the `StaticRingBuffer`
+		/// @note if `size() == capacity()` then this loops and overwrites `front()`
+		///
+		/// @param value - the element to insert
+		constexpr inline auto push_back(const T& value) noexcept -> void requires Copyable<T> {
+			m_buffer[next_slot()] = value; // NOLINT
+		}
+
+		/// @brief Inserts the given element at the end of the `StaticRingBuffer`
+		/// @note if `size() == capacity()` then this loops and overwrites `front()`
+		///
+		/// @param value - the element to insert
+		constexpr inline auto push_back(T&& value) noexcept -> void requires Movable<T> {
+			m_buffer[next_slot()] = std::move(value); // NOLINT
+		}
+
+		/// @brief Constructs the given element in place at the end of the `StaticRingBuffer`
+		/// @note if `size() == capacity()` then this loops and overwrites `front()`
+		///
+		/// @tparam Args - The types of the element's constructor arguments
+		/// @param args - The constructor arguments for the element
+		///
+		/// @return A reference to the element constructed at the end of the `StaticRingBuffer`
+		template<typename... Args>
+		requires ConstructibleFrom<T, Args...>
+		constexpr inline auto emplace_back(Args&&... args) noexcept -> T& requires Movable<T> {
+			auto& slot = m_buffer[next_slot()]; // NOLINT
+			slot = T(std::forward<Args>(args)...);
+			return slot;
+		}
+
+		/// @brief Removes the last element in the `StaticRingBuffer` and returns it
+		///
+		/// @return The last element in the `StaticRingBuffer`
+		[[nodiscard]] constexpr inline auto pop_back() noexcept -> T requires Movable<T> {
+			auto value = std::move(back());
+			m_size--;
+			return value;
+		}
+
+		/// @brief Removes the first element in the `StaticRingBuffer` and returns it
+		///
+		/// @return The first element in the `StaticRingBuffer`
+		[[nodiscard]] constexpr inline auto pop_front() noexcept -> T requires Movable<T> {
+			auto value = std::move(front());
+			m_start = (m_start + 1) & MASK;
+			m_size--;
+			return value;
+		}
+
+		/// @brief Returns a Random Access iterator over the `StaticRingBuffer`, at the beginning
+		///
+		/// @return The iterator, at the beginning
+		[[nodiscard]] constexpr inline auto begin() noexcept -> Iterator<false> {
+			return Iterator<false>(this, 0ULL);
+		}
+
+		/// @brief Returns a Random Access iterator over the `StaticRingBuffer`, at the end
+		///
+		/// @return The iterator, at the end
+		[[nodiscard]] constexpr inline auto end() noexcept -> Iterator<false> {
+			return Iterator<false>(this, m_size);
+		}
+
+		/// @brief Returns a Random Access read-only iterator over the `StaticRingBuffer`, at the
+		/// beginning
+		///
+		/// @return The iterator, at the beginning
+		[[nodiscard]] constexpr inline auto begin() const noexcept -> Iterator<true> {
+			return Iterator<true>(this, 0ULL);
+		}
+
+		/// @brief Returns a Random Access read-only iterator over the `StaticRingBuffer`, at the
+		/// end
+		///
+		/// @return The iterator, at the end
+		[[nodiscard]] constexpr inline auto end() const noexcept -> Iterator<true> {
+			return Iterator<true>(this, m_size);
+		}
+
+		/// @brief Returns a Random Access read-only iterator over the `StaticRingBuffer`, at the
+		/// beginning
+		///
+		/// @return The iterator, at the beginning
+		[[nodiscard]] constexpr inline auto cbegin() const noexcept -> Iterator<true> {
+			return begin();
+		}
+
+		/// @brief Returns a Random Access read-only iterator over the `StaticRingBuffer`, at the
+		/// end
+		///
+		/// @return The iterator, at the end
+		[[nodiscard]] constexpr inline auto cend() const noexcept -> Iterator<true> {
+			return end();
+		}
+
+		constexpr auto operator=(const StaticRingBuffer& buffer) noexcept
+			-> StaticRingBuffer& = default;
+		constexpr auto operator=(StaticRingBuffer&& buffer) noexcept
+			-> StaticRingBuffer& = default;
+
+	  private:
+		static constexpr size_t MASK = N - 1;
+
+		std::array<T, N> m_buffer = {};
+		size_t m_start = 0;
+		size_t m_size = 0;
+
+		/// @brief Converts the given `StaticRingBuffer` index into an index into the storage
+		[[nodiscard]] constexpr inline auto
+		internal_index(Integral auto index) const noexcept -> size_t {
+			return (m_start + static_cast<size_t>(index)) & MASK;
+		}
+
+		/// @brief Returns the storage index to write the next pushed element to, advancing the
+		/// start index over `front()` if the `StaticRingBuffer` is full
+		[[nodiscard]] constexpr inline auto next_slot() noexcept -> size_t {
+			const auto slot = (m_start + m_size) & MASK;
+			if(m_size == N) {
+				m_start = (m_start + 1) & MASK;
+			}
+			else {
+				m_size++;
+			}
+			return slot;
+		}
+	};
+} // namespace utils
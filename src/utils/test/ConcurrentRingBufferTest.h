@@ -0,0 +1,166 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../ConcurrentRingBuffer.h"
+
+namespace utils::test {
+
+	TEST(ConcurrentRingBufferTest, defaults) {
+		auto buffer = SpscRingBuffer<int>();
+		ASSERT_EQ(buffer.capacity(), SpscRingBuffer<int>::DEFAULT_CAPACITY);
+		ASSERT_EQ(buffer.size(), 0ULL);
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_FALSE(buffer.try_pop());
+
+		auto rounded = MpmcRingBuffer<int>(10ULL);
+		ASSERT_EQ(rounded.capacity(), 16ULL);
+	}
+
+	TEST(ConcurrentRingBufferTest, pushPopNoOverwrite) {
+		auto buffer = SpscRingBuffer<int>(8ULL);
+		for(auto i = 0; i < 8; ++i) {
+			ASSERT_TRUE(buffer.try_push(i));
+		}
+		ASSERT_EQ(buffer.size(), 8ULL);
+		ASSERT_FALSE(buffer.try_push(8));
+		ASSERT_FALSE(buffer.try_emplace(8));
+
+		// loop around the end of the storage a few times
+		for(auto i = 0; i < 20; ++i) {
+			ASSERT_EQ(buffer.try_pop(), i);
+			ASSERT_TRUE(buffer.try_push(i + 8));
+		}
+		for(auto i = 20; i < 28; ++i) {
+			ASSERT_EQ(buffer.try_pop(), i);
+		}
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_FALSE(buffer.try_pop());
+	}
+
+	TEST(ConcurrentRingBufferTest, mpmcPushPopNoOverwrite) {
+		auto buffer = MpmcRingBuffer<int>(8ULL);
+		for(auto i = 0; i < 8; ++i) {
+			ASSERT_TRUE(buffer.try_push(i));
+		}
+		ASSERT_FALSE(buffer.try_push(8));
+
+		for(auto i = 0; i < 20; ++i) {
+			ASSERT_EQ(buffer.try_pop(), i);
+			ASSERT_TRUE(buffer.try_emplace(i + 8));
+		}
+		for(auto i = 20; i < 28; ++i) {
+			ASSERT_EQ(buffer.try_pop(), i);
+		}
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_FALSE(buffer.try_pop());
+	}
+
+	TEST(ConcurrentRingBufferTest, bulkPushPop) {
+		auto buffer = SpscRingBuffer<int>(8ULL);
+		auto values = std::array<int, 6>{0, 1, 2, 3, 4, 5};
+		auto out = std::array<int, 6>{};
+
+		// offset the indices so the second bulk push wraps around the end of the storage
+		ASSERT_EQ(buffer.push(values), 6ULL);
+		ASSERT_EQ(buffer.pop(out), 6ULL);
+		ASSERT_EQ(out, values);
+
+		ASSERT_EQ(buffer.push(values), 6ULL);
+		// only two slots left
+		ASSERT_EQ(buffer.push(values), 2ULL);
+		ASSERT_EQ(buffer.size(), 8ULL);
+
+		ASSERT_EQ(buffer.pop(out), 6ULL);
+		ASSERT_EQ(out, values);
+		ASSERT_EQ(buffer.pop(out), 2ULL);
+		ASSERT_EQ(out[0], 0);
+		ASSERT_EQ(out[1], 1);
+		ASSERT_EQ(buffer.pop(out), 0ULL);
+	}
+
+	TEST(ConcurrentRingBufferTest, spscStream) {
+		constexpr auto count = 100000;
+		auto buffer = SpscRingBuffer<int>(64ULL);
+
+		auto producer = std::thread([&buffer]() {
+			auto batch = std::array<int, 7>{};
+			auto next = 0;
+			while(next < count) {
+				const auto size = std::min(static_cast<int>(batch.size()), count - next);
+				for(auto i = 0; i < size; ++i) {
+					batch.at(i) = next + i;
+				}
+				next += static_cast<int>(
+					buffer.push(std::span<const int>(batch.data(), static_cast<size_t>(size))));
+			}
+		});
+
+		auto received = std::vector<int>();
+		received.reserve(count);
+		auto batch = std::array<int, 5>{};
+		while(received.size() < static_cast<size_t>(count)) {
+			if(auto value = buffer.try_pop()) {
+				received.push_back(*value);
+			}
+			const auto popped = buffer.pop(batch);
+			received.insert(received.end(), batch.begin(), batch.begin() + popped);
+		}
+		producer.join();
+
+		for(auto i = 0; i < count; ++i) {
+			ASSERT_EQ(received.at(i), i);
+		}
+		ASSERT_TRUE(buffer.empty());
+	}
+
+	TEST(ConcurrentRingBufferTest, mpmcStream) {
+		constexpr auto numThreads = 4;
+		constexpr auto perThread = 20000;
+		auto buffer = MpmcRingBuffer<int>(64ULL);
+		auto counts = std::vector<int>(numThreads * perThread, 0);
+		auto popped = std::atomic<int>(0);
+
+		auto threads = std::vector<std::thread>();
+		for(auto t = 0; t < numThreads; ++t) {
+			threads.emplace_back([&buffer, t]() {
+				for(auto i = t * perThread; i < (t + 1) * perThread;) {
+					if(buffer.try_push(i)) {
+						++i;
+					}
+				}
+			});
+		}
+		auto consumed = std::vector<std::vector<int>>(numThreads);
+		for(auto t = 0; t < numThreads; ++t) {
+			threads.emplace_back([&buffer, &popped, &consumed, t]() {
+				while(popped.load() < numThreads * perThread) {
+					if(auto value = buffer.try_pop()) {
+						consumed.at(t).push_back(*value);
+						popped.fetch_add(1);
+					}
+				}
+			});
+		}
+		for(auto& thread : threads) {
+			thread.join();
+		}
+
+		for(const auto& values : consumed) {
+			for(auto value : values) {
+				counts.at(value)++;
+			}
+		}
+		for(auto count : counts) {
+			ASSERT_EQ(count, 1);
+		}
+		ASSERT_TRUE(buffer.empty());
+	}
+} // namespace utils::test
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Instrumentation.h"
+
+namespace utils::test {
+	using instrumentation::Counter;
+	using instrumentation::Stage;
+
+	TEST(InstrumentationTest, mergesThreads) {
+		if constexpr(!instrumentation::ENABLED) {
+			GTEST_SKIP();
+		}
+
+		instrumentation::reset();
+		{
+			auto threads = std::vector<std::jthread>();
+			for(auto i = 0; i < 4; ++i) {
+				threads.emplace_back([]() noexcept {
+					for(auto j = 0; j < 1000; ++j) {
+						instrumentation::count(Counter::IntersectionTests);
+					}
+					instrumentation::count(Counter::PrimaryRays, 10);
+				});
+			}
+		}
+		instrumentation::count(Counter::SecondaryRays, 3);
+
+		const auto snapshot = instrumentation::snapshot();
+		ASSERT_EQ(snapshot[Counter::IntersectionTests], 4000ULL);
+		ASSERT_EQ(snapshot[Counter::PrimaryRays], 40ULL);
+		ASSERT_EQ(snapshot[Counter::SecondaryRays], 3ULL);
+		ASSERT_EQ(snapshot[Counter::BvhNodesVisited], 0ULL);
+		ASSERT_GT(snapshot.mrays_per_second(), 0.0);
+
+		// counts from threads that have exited are kept, and reset clears them
+		instrumentation::reset();
+		ASSERT_EQ(instrumentation::snapshot()[Counter::IntersectionTests], 0ULL);
+	}
+
+	TEST(InstrumentationTest, timesStages) {
+		if constexpr(!instrumentation::ENABLED) {
+			GTEST_SKIP();
+		}
+
+		instrumentation::reset();
+		{
+			const auto timer = instrumentation::ScopedTimer(Stage::Extend);
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		const auto snapshot = instrumentation::snapshot();
+		ASSERT_GE(snapshot.seconds(Stage::Extend), 0.005);
+		ASSERT_EQ(snapshot.seconds(Stage::Shade), 0.0);
+		ASSERT_GE(snapshot.m_elapsed_seconds, snapshot.seconds(Stage::Extend));
+	}
+
+	TEST(InstrumentationTest, writesJson) {
+		auto snapshot = instrumentation::Snapshot();
+		snapshot.m_counters[static_cast<size_t>(Counter::PrimaryRays)] = 1500000;
+		snapshot.m_counters[static_cast<size_t>(Counter::SecondaryRays)] = 500000;
+		snapshot.m_stage_nanoseconds[static_cast<size_t>(Stage::Tiles)] = 250000000;
+		snapshot.m_elapsed_seconds = 2.0;
+
+		auto out = std::ostringstream();
+		snapshot.write_json(out);
+		const auto json = out.str();
+		ASSERT_EQ(json.front(), '{');
+		ASSERT_EQ(json.back(), '\n');
+		ASSERT_NE(json.find(R"("elapsed_seconds":2.000000)"), std::string::npos);
+		ASSERT_NE(json.find(R"("mrays_per_second":1.000000)"), std::string::npos);
+		ASSERT_NE(json.find(R"("primary_rays":1500000,"secondary_rays":500000)"),
+				  std::string::npos);
+		ASSERT_NE(json.find(R"("stage_seconds":{"tiles":0.250000,)"), std::string::npos);
+	}
+
+	TEST(InstrumentationTest, reporterWritesFinalReport) {
+		auto out = std::ostringstream();
+		{
+			const auto reporter = instrumentation::Reporter(out, std::chrono::seconds(60));
+		}
+		const auto json = out.str();
+		ASSERT_EQ(json.find(R"({"elapsed_seconds":)"), 0ULL);
+		ASSERT_EQ(json.find('\n'), json.size() - 1);
+	}
+} // namespace utils::test
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "../RingBuffer.h"
 
 namespace utils::test {
@@ -125,6 +127,8 @@ namespace utils::test {
 		}
 		auto newCapacity = 16ULL;
 		buffer.reserve(newCapacity);
+		ASSERT_EQ(buffer.size(), initialCapacity);
+		ASSERT_EQ(buffer.capacity(), newCapacity);
 		for(auto i = 0ULL; i < initialCapacity; ++i) {
 			ASSERT_EQ(buffer.at(i), i);
 		}
@@ -142,6 +146,48 @@ namespace utils::test {
 		}
 	}
 
+	TEST(RingBufferTest, pushBackAfterReserve) {
+		auto buffer = RingBuffer<int>(8ULL);
+		for(auto i = 0; i < 4; ++i) {
+			buffer.push_back(i);
+		}
+		buffer.reserve(16ULL);
+		ASSERT_EQ(buffer.size(), 4ULL);
+
+		// fill the new capacity exactly, then loop
+		for(auto i = 4; i < 20; ++i) {
+			buffer.push_back(i);
+		}
+		ASSERT_EQ(buffer.size(), 16ULL);
+		for(auto i = 0ULL; i < 16ULL; ++i) {
+			ASSERT_EQ(buffer.at(i), static_cast<int>(i) + 4);
+		}
+	}
+
+	TEST(RingBufferTest, pushBackWrapsAfterEraseFromLooped) {
+		auto buffer = RingBuffer<int>(8ULL);
+		for(auto i = 0; i < 12; ++i) {
+			buffer.push_back(i);
+		}
+		// erasing from the middle of a looped buffer moves its start away from the start of its
+		// storage, so pushing past the end of the storage must wrap regardless
+		buffer.erase(buffer.begin() + 2);
+		auto expected = std::vector<int>{4, 5, 7, 8, 9, 10, 11};
+		ASSERT_EQ(buffer.size(), expected.size());
+		for(auto i = 12; i < 40; ++i) {
+			buffer.push_back(i);
+			expected.push_back(i);
+			if(expected.size() > 8ULL) {
+				expected.erase(expected.begin());
+			}
+
+			ASSERT_EQ(buffer.size(), expected.size());
+			for(auto j = 0ULL; j < expected.size(); ++j) {
+				ASSERT_EQ(buffer.at(j), expected[j]);
+			}
+		}
+	}
+
 	TEST(RingBufferTest, front) {
 		auto buffer = RingBuffer<int>();
 		ASSERT_EQ(buffer.size(), 0ULL);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <thread>
+
+#include "../Socket.h"
+
+namespace utils::test {
+
+	inline auto socket_test_round_trip(Listener& listener, Socket& client) noexcept -> void {
+		auto server = listener.accept();
+		ASSERT_TRUE(server);
+
+		const auto sent = std::array<int, 4>{1, 2, 3, 4};
+		auto received = std::array<int, 4>();
+		ASSERT_TRUE(client.send_all(std::as_bytes(std::span<const int>(sent))));
+		ASSERT_TRUE(server->receive_all(std::as_writable_bytes(std::span<int>(received))));
+		ASSERT_EQ(sent, received);
+
+		// partial receives take what has arrived, however much room there is for more
+		ASSERT_TRUE(client.send_all(std::as_bytes(std::span<const int>(sent))));
+		auto buffer = std::array<std::byte, 4 * sizeof(sent)>();
+		auto num_received = 0ULL;
+		while(num_received < sizeof(sent)) {
+			const auto piece = server->receive_some(std::span(buffer).subspan(num_received));
+			ASSERT_TRUE(piece);
+			num_received += *piece;
+		}
+		ASSERT_EQ(num_received, sizeof(sent));
+
+		// a closed peer fails the receive instead of blocking
+		client.close();
+		ASSERT_FALSE(server->receive_all(std::as_writable_bytes(std::span<int>(received))));
+		ASSERT_FALSE(server->receive_some(buffer));
+	}
+
+	TEST(SocketTest, tcpRoundTrip) {
+		auto listener = Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		ASSERT_NE(listener->port(), 0);
+
+		auto client = Socket::connect("127.0.0.1", listener->port());
+		ASSERT_TRUE(client);
+		socket_test_round_trip(*listener, *client);
+	}
+
+#ifndef _WIN32
+	TEST(SocketTest, localRoundTrip) {
+		const auto path
+			= (std::filesystem::temp_directory_path() / "hyperion_socket_test.sock").string();
+		auto listener = Listener::listen_local(path);
+		ASSERT_TRUE(listener);
+
+		auto client = Socket::connect_local(path);
+		ASSERT_TRUE(client);
+		socket_test_round_trip(*listener, *client);
+
+		listener->close();
+		ASSERT_FALSE(std::filesystem::exists(path));
+	}
+#endif
+
+	TEST(SocketTest, waitReadable) {
+		auto listener = Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto sockets = std::array<NativeSocket, 1>{listener->native()};
+		ASSERT_FALSE(wait_readable(sockets, std::chrono::milliseconds(10))[0]);
+
+		auto client = Socket::connect("127.0.0.1", listener->port());
+		ASSERT_TRUE(client);
+		ASSERT_TRUE(wait_readable(sockets, std::chrono::milliseconds(5000))[0]);
+	}
+
+	TEST(SocketTest, connectFailure) {
+		auto listener = Listener::listen("127.0.0.1", 0);
+		ASSERT_TRUE(listener);
+		const auto port = listener->port();
+		listener->close();
+		ASSERT_FALSE(Socket::connect("127.0.0.1", port));
+		ASSERT_FALSE(Socket::connect_local(""));
+	}
+} // namespace utils::test
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "../StaticRingBuffer.h"
+
+namespace utils::test {
+
+	TEST(StaticRingBufferTest, defaults) {
+		auto buffer = StaticRingBuffer<int, 8>();
+		ASSERT_EQ(buffer.size(), 0ULL);
+		ASSERT_EQ(buffer.capacity(), 8ULL);
+		ASSERT_TRUE(buffer.empty());
+		ASSERT_FALSE(buffer.full());
+		ASSERT_EQ(buffer.begin(), buffer.end());
+
+		auto filled = StaticRingBuffer<bool, 4>(true);
+		ASSERT_EQ(filled.size(), 4ULL);
+		ASSERT_TRUE(filled.full());
+		for(auto elem : filled) {
+			ASSERT_TRUE(elem);
+		}
+	}
+
+	TEST(StaticRingBufferTest, pushAndLooping) {
+		auto buffer = StaticRingBuffer<int, 8>();
+		for(auto i = 0; i < 8; ++i) {
+			buffer.push_back(i);
+		}
+		for(auto i = 0; i < 8; ++i) {
+			ASSERT_EQ(buffer.at(i), i);
+		}
+
+		for(auto i = 8; i < 20; ++i) {
+			buffer.emplace_back(i);
+		}
+		ASSERT_EQ(buffer.size(), 8ULL);
+		ASSERT_EQ(buffer.front(), 12);
+		ASSERT_EQ(buffer.back(), 19);
+		for(auto i = 0; i < 8; ++i) {
+			ASSERT_EQ(buffer[i], i + 12);
+		}
+		// checked access clamps to the last element
+		ASSERT_EQ(buffer.at(100), 19);
+	}
+
+	TEST(StaticRingBufferTest, popFrontAndBack) {
+		auto buffer = StaticRingBuffer<int, 4>();
+		for(auto i = 0; i < 6; ++i) {
+			buffer.push_back(i);
+		}
+
+		ASSERT_EQ(buffer.pop_front(), 2);
+		ASSERT_EQ(buffer.pop_back(), 5);
+		ASSERT_EQ(buffer.size(), 2ULL);
+		ASSERT_EQ(buffer.front(), 3);
+		ASSERT_EQ(buffer.back(), 4);
+
+		buffer.push_back(6);
+		buffer.push_back(7);
+		ASSERT_TRUE(buffer.full());
+		ASSERT_EQ(buffer.pop_front(), 3);
+		ASSERT_EQ(buffer.pop_front(), 4);
+		ASSERT_EQ(buffer.pop_front(), 6);
+		ASSERT_EQ(buffer.pop_front(), 7);
+		ASSERT_TRUE(buffer.empty());
+
+		buffer.push_back(1);
+		buffer.clear();
+		ASSERT_TRUE(buffer.empty());
+	}
+
+	TEST(StaticRingBufferTest, iterators) {
+		auto buffer = StaticRingBuffer<int, 8>();
+		for(auto i = 0; i < 11; ++i) {
+			buffer.push_back(i);
+		}
+
+		ASSERT_EQ(buffer.end() - buffer.begin(), 8);
+		ASSERT_EQ(*(buffer.begin() + 2), 5);
+		ASSERT_EQ(buffer.begin()[7], 10);
+		ASSERT_EQ(*(buffer.cend() - 1), 10);
+		ASSERT_LT(buffer.begin(), buffer.end());
+
+		for(auto& elem : buffer) {
+			elem *= 2;
+		}
+		auto expected = 6;
+		for(auto elem : buffer) {
+			ASSERT_EQ(elem, expected);
+			expected += 2;
+		}
+
+		std::reverse(buffer.begin(), buffer.end());
+		ASSERT_EQ(buffer.front(), 20);
+		ASSERT_EQ(buffer.back(), 6);
+	}
+
+	TEST(StaticRingBufferTest, constantEvaluation) {
+		constexpr auto sum = []() {
+			auto buffer = StaticRingBuffer<int, 4>();
+			for(auto i = 0; i < 10; ++i) {
+				buffer.push_back(i);
+			}
+			auto total = buffer.pop_front();
+			for(auto elem : buffer) {
+				total += elem;
+			}
+			return total;
+		}();
+
+		static_assert(sum == 6 + 7 + 8 + 9);
+		ASSERT_EQ(sum, 30);
+	}
+} // namespace utils::test